@@ -0,0 +1,173 @@
+/**
+ * @file benchmark.cpp
+ *
+ * Implementation of the benchmark harness.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+
+BenchmarkState::BenchmarkState(const size_t minRepetitions,
+                               const double minTime,
+                               const double scale) :
+    minRepetitions(minRepetitions),
+    minTime(minTime),
+    scale(scale),
+    items(0)
+{
+  // Nothing to do.
+}
+
+void BenchmarkState::Run(const std::function<void()>& function)
+{
+  typedef std::chrono::steady_clock Clock;
+
+  // Warm up the caches (and the allocator).
+  function();
+
+  // Don't let very fast benchmarks run forever.
+  const size_t maxRepetitions = std::max(minRepetitions, (size_t) 100000);
+
+  times.clear();
+  double totalTime = 0.0;
+  while (times.size() < maxRepetitions &&
+      (times.size() < minRepetitions || totalTime < minTime))
+  {
+    const Clock::time_point start = Clock::now();
+    function();
+    const Clock::time_point end = Clock::now();
+
+    const double time = std::chrono::duration<double>(end - start).count();
+    times.push_back(time);
+    totalTime += time;
+  }
+}
+
+size_t BenchmarkState::Scaled(const size_t size) const
+{
+  return std::max((size_t) 1, (size_t) (scale * size));
+}
+
+std::vector<Benchmark>& mlpack::benchmark::Benchmarks()
+{
+  static std::vector<Benchmark> benchmarks;
+  return benchmarks;
+}
+
+BenchmarkRegistration::BenchmarkRegistration(
+    const std::string& name,
+    const std::function<void(BenchmarkState&)>& function)
+{
+  Benchmark benchmark;
+  benchmark.name = name;
+  benchmark.function = function;
+  Benchmarks().push_back(benchmark);
+}
+
+BenchmarkResult mlpack::benchmark::Summarize(const std::string& name,
+                                             const BenchmarkState& state)
+{
+  BenchmarkResult result;
+  result.name = name;
+  result.repetitions = state.Times().size();
+  result.items = state.Items();
+  result.min = result.median = result.mean = result.max = result.stddev = 0.0;
+
+  if (state.Times().empty())
+    return result;
+
+  const arma::vec times(state.Times());
+  result.min = times.min();
+  result.median = arma::median(times);
+  result.mean = arma::mean(times);
+  result.max = times.max();
+  result.stddev = (times.n_elem > 1) ? arma::stddev(times) : 0.0;
+
+  return result;
+}
+
+//! Write a string to the stream as a JSON string.
+static void WriteJSONString(std::ostream& stream, const std::string& str)
+{
+  stream << '"';
+  for (const char c : str)
+  {
+    if (c == '"' || c == '\\')
+      stream << '\\' << c;
+    else if ((unsigned char) c < 0x20)
+      stream << ' ';
+    else
+      stream << c;
+  }
+  stream << '"';
+}
+
+void mlpack::benchmark::WriteJSON(
+    std::ostream& stream,
+    const std::vector<std::pair<std::string, std::string>>& settings,
+    const std::vector<BenchmarkResult>& results)
+{
+  size_t threads = 1;
+  #ifdef HAS_OPENMP
+    threads = omp_get_max_threads();
+  #endif
+
+  stream << std::setprecision(9);
+  stream << "{" << std::endl << "  \"context\": {" << std::endl
+      << "    \"mlpack_version\": ";
+  WriteJSONString(stream, util::GetVersion());
+  stream << "," << std::endl << "    \"threads\": " << threads;
+  for (size_t i = 0; i < settings.size(); ++i)
+  {
+    stream << "," << std::endl << "    ";
+    WriteJSONString(stream, settings[i].first);
+    stream << ": ";
+    WriteJSONString(stream, settings[i].second);
+  }
+  stream << std::endl << "  }," << std::endl << "  \"benchmarks\": [";
+
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const BenchmarkResult& r = results[i];
+    stream << ((i == 0) ? "" : ",") << std::endl << "    { \"name\": ";
+    WriteJSONString(stream, r.name);
+    stream << ", \"repetitions\": " << r.repetitions
+        << ", \"items\": " << r.items
+        << ", \"min\": " << r.min
+        << ", \"median\": " << r.median
+        << ", \"mean\": " << r.mean
+        << ", \"max\": " << r.max
+        << ", \"stddev\": " << r.stddev;
+    if (r.items > 0 && r.median > 0.0)
+      stream << ", \"items_per_second\": " << (r.items / r.median);
+    stream << " }";
+  }
+
+  stream << std::endl << "  ]" << std::endl << "}" << std::endl;
+}
+
+void mlpack::benchmark::WriteCSV(std::ostream& stream,
+                                 const std::vector<BenchmarkResult>& results)
+{
+  stream << std::setprecision(9);
+  stream << "name,repetitions,items,min,median,mean,max,stddev,"
+      << "items_per_second" << std::endl;
+  for (const BenchmarkResult& r : results)
+  {
+    stream << r.name << "," << r.repetitions << "," << r.items << "," << r.min
+        << "," << r.median << "," << r.mean << "," << r.max << "," << r.stddev
+        << ",";
+    if (r.items > 0 && r.median > 0.0)
+      stream << (r.items / r.median);
+    stream << std::endl;
+  }
+}
@@ -0,0 +1,203 @@
+/**
+ * @file benchmark.hpp
+ *
+ * A small harness for timing mlpack code: benchmarks register themselves with
+ * MLPACK_BENCHMARK(), and the mlpack_benchmarks program runs them and writes
+ * the results as JSON or CSV.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BENCHMARKS_BENCHMARK_HPP
+#define MLPACK_BENCHMARKS_BENCHMARK_HPP
+
+#include <mlpack/core.hpp>
+
+#include <chrono>
+#include <functional>
+
+namespace mlpack {
+namespace benchmark {
+
+/**
+ * Make sure the compiler computes the given value, even though it is never
+ * used.  Use this for the results of micro-benchmarks.
+ */
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r"(&value) : "memory");
+#else
+  static const volatile void* sink;
+  sink = &value;
+#endif
+}
+
+/**
+ * The BenchmarkState is given to each benchmark.  The benchmark prepares its
+ * data (which is not timed) and then calls Run() with the code to be timed.
+ * Run() calls the code once to warm up, and then repeatedly until it has been
+ * run at least MinRepetitions() times and for at least MinTime() seconds.
+ *
+ * @code
+ * MLPACK_BENCHMARK("knn/kd/dual", [](BenchmarkState& state)
+ * {
+ *   arma::mat data = UniformDataset(3, state.Scaled(10000));
+ *   state.Run([&]()
+ *   {
+ *     KNN knn(data);
+ *     ...
+ *   });
+ * });
+ * @endcode
+ */
+class BenchmarkState
+{
+ public:
+  /**
+   * Create the state for one benchmark.
+   *
+   * @param minRepetitions Minimum number of timed runs.
+   * @param minTime Minimum total time of the timed runs, in seconds.
+   * @param scale Factor to multiply dataset sizes with.
+   */
+  BenchmarkState(const size_t minRepetitions,
+                 const double minTime,
+                 const double scale);
+
+  /**
+   * Time the given function, as described above.  This should be called only
+   * once by each benchmark.
+   */
+  void Run(const std::function<void()>& function);
+
+  /**
+   * Set the number of items (points, distance evaluations, ...) processed by
+   * each run, so that the throughput can be reported.
+   */
+  void SetItems(const size_t items) { this->items = items; }
+
+  /**
+   * Get the given dataset size multiplied by the scale factor (but at least
+   * one).
+   */
+  size_t Scaled(const size_t size) const;
+
+  //! Get the minimum number of timed runs.
+  size_t MinRepetitions() const { return minRepetitions; }
+  //! Get the minimum total time of the timed runs, in seconds.
+  double MinTime() const { return minTime; }
+  //! Get the factor that dataset sizes are multiplied with.
+  double Scale() const { return scale; }
+
+  //! Get the number of items processed by each run.
+  size_t Items() const { return items; }
+  //! Get the time of each timed run, in seconds.
+  const std::vector<double>& Times() const { return times; }
+
+ private:
+  //! Minimum number of timed runs.
+  size_t minRepetitions;
+  //! Minimum total time of the timed runs, in seconds.
+  double minTime;
+  //! Factor that dataset sizes are multiplied with.
+  double scale;
+  //! Number of items processed by each run.
+  size_t items;
+  //! Time of each timed run, in seconds.
+  std::vector<double> times;
+};
+
+//! A benchmark: a name and a function to run.
+struct Benchmark
+{
+  //! Name of the benchmark, as "group/benchmark/variant".
+  std::string name;
+  //! Function that runs the benchmark.
+  std::function<void(BenchmarkState&)> function;
+};
+
+//! Get all registered benchmarks, in order of registration.
+std::vector<Benchmark>& Benchmarks();
+
+/**
+ * Registering a benchmark is done by creating a static BenchmarkRegistration
+ * object; use MLPACK_BENCHMARK() for that.
+ */
+class BenchmarkRegistration
+{
+ public:
+  BenchmarkRegistration(const std::string& name,
+                        const std::function<void(BenchmarkState&)>& function);
+};
+
+//! The summary of the timed runs of one benchmark.
+struct BenchmarkResult
+{
+  //! Name of the benchmark.
+  std::string name;
+  //! Number of timed runs.
+  size_t repetitions;
+  //! Number of items processed by each run (0 if not given).
+  size_t items;
+  //! Time of the fastest run, in seconds.
+  double min;
+  //! Median time of the runs, in seconds.
+  double median;
+  //! Mean time of the runs, in seconds.
+  double mean;
+  //! Time of the slowest run, in seconds.
+  double max;
+  //! Standard deviation of the time of the runs, in seconds.
+  double stddev;
+};
+
+/**
+ * Summarize the timed runs held in the given state.
+ *
+ * @param name Name of the benchmark.
+ * @param state State that the benchmark was run with.
+ */
+BenchmarkResult Summarize(const std::string& name,
+                          const BenchmarkState& state);
+
+/**
+ * Write the given results as JSON: an object holding a "context" object (the
+ * mlpack version, the number of threads, and the given settings) and a
+ * "benchmarks" array with one object for each result.  Times are in seconds.
+ *
+ * @param stream Stream to write to.
+ * @param settings Settings to record in the context (name, value).
+ * @param results Results to write.
+ */
+void WriteJSON(std::ostream& stream,
+               const std::vector<std::pair<std::string, std::string>>& settings,
+               const std::vector<BenchmarkResult>& results);
+
+/**
+ * Write the given results as CSV, with a header line.  Times are in seconds.
+ *
+ * @param stream Stream to write to.
+ * @param results Results to write.
+ */
+void WriteCSV(std::ostream& stream,
+              const std::vector<BenchmarkResult>& results);
+
+} // namespace benchmark
+} // namespace mlpack
+
+#define MLPACK_BENCHMARK_JOIN2(A, B) A ## B
+#define MLPACK_BENCHMARK_JOIN(A, B) MLPACK_BENCHMARK_JOIN2(A, B)
+
+/**
+ * Register a benchmark with the given name; FUNCTION is called with a
+ * BenchmarkState& when the benchmark is run.
+ */
+#define MLPACK_BENCHMARK(NAME, FUNCTION) \
+    static mlpack::benchmark::BenchmarkRegistration \
+        MLPACK_BENCHMARK_JOIN(benchmarkRegistration, __LINE__)(NAME, FUNCTION)
+
+#endif
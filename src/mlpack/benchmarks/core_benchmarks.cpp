@@ -0,0 +1,211 @@
+/**
+ * @file core_benchmarks.cpp
+ *
+ * Benchmarks of core kernels: distance evaluations, bound computations, and
+ * tree construction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+#include "datasets.hpp"
+
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/rectangle_tree.hpp>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+using namespace mlpack::bound;
+using namespace mlpack::metric;
+using namespace mlpack::tree;
+
+/**
+ * Evaluate the given metric between corresponding columns of two matrices.
+ */
+template<typename MetricType>
+static void MetricBenchmark(BenchmarkState& state, const size_t dimensionality)
+{
+  const size_t points = state.Scaled(100000);
+  const arma::mat a = UniformDataset(dimensionality, points);
+  const arma::mat b = UniformDataset(dimensionality, points);
+
+  state.SetItems(points);
+  state.Run([&]()
+  {
+    double sum = 0.0;
+    for (size_t i = 0; i < points; ++i)
+      sum += MetricType::Evaluate(a.col(i), b.col(i));
+    DoNotOptimize(sum);
+  });
+}
+
+MLPACK_BENCHMARK("core/lmetric_evaluate/l2/d=3", [](BenchmarkState& state)
+{
+  MetricBenchmark<EuclideanDistance>(state, 3);
+});
+
+MLPACK_BENCHMARK("core/lmetric_evaluate/l2/d=64", [](BenchmarkState& state)
+{
+  MetricBenchmark<EuclideanDistance>(state, 64);
+});
+
+MLPACK_BENCHMARK("core/lmetric_evaluate/squared_l2/d=64",
+    [](BenchmarkState& state)
+{
+  MetricBenchmark<SquaredEuclideanDistance>(state, 64);
+});
+
+MLPACK_BENCHMARK("core/lmetric_evaluate/l1/d=64", [](BenchmarkState& state)
+{
+  MetricBenchmark<ManhattanDistance>(state, 64);
+});
+
+/**
+ * Build one bound around each group of a few random points.
+ */
+static std::vector<HRectBound<>> RandomBounds(const size_t dimensionality,
+                                              const size_t numBounds)
+{
+  std::vector<HRectBound<>> bounds(numBounds, HRectBound<>(dimensionality));
+  for (size_t i = 0; i < numBounds; ++i)
+  {
+    const arma::mat points = arma::randu<arma::mat>(dimensionality, 4);
+    bounds[i] |= points;
+  }
+
+  return bounds;
+}
+
+/**
+ * Compute the minimum distance between each bound and a point, or between
+ * pairs of bounds.
+ */
+static void BoundBenchmark(BenchmarkState& state,
+                           const size_t dimensionality,
+                           const bool pointToBound)
+{
+  const size_t numBounds = state.Scaled(20000);
+  const std::vector<HRectBound<>> bounds = RandomBounds(dimensionality,
+      numBounds);
+  const std::vector<HRectBound<>> others = RandomBounds(dimensionality,
+      numBounds);
+  const arma::mat points = UniformDataset(dimensionality, numBounds);
+
+  state.SetItems(numBounds);
+  state.Run([&]()
+  {
+    double sum = 0.0;
+    for (size_t i = 0; i < numBounds; ++i)
+    {
+      if (pointToBound)
+        sum += bounds[i].MinDistance(points.col(i));
+      else
+        sum += bounds[i].MinDistance(others[i]);
+    }
+    DoNotOptimize(sum);
+  });
+}
+
+MLPACK_BENCHMARK("core/hrectbound_min_distance/point/d=3",
+    [](BenchmarkState& state)
+{
+  BoundBenchmark(state, 3, true);
+});
+
+MLPACK_BENCHMARK("core/hrectbound_min_distance/point/d=32",
+    [](BenchmarkState& state)
+{
+  BoundBenchmark(state, 32, true);
+});
+
+MLPACK_BENCHMARK("core/hrectbound_min_distance/bound/d=3",
+    [](BenchmarkState& state)
+{
+  BoundBenchmark(state, 3, false);
+});
+
+MLPACK_BENCHMARK("core/hrectbound_min_distance/bound/d=32",
+    [](BenchmarkState& state)
+{
+  BoundBenchmark(state, 32, false);
+});
+
+/**
+ * Build a tree of the given type on a dataset.
+ */
+template<typename TreeType>
+static void TreeBenchmark(BenchmarkState& state,
+                          const arma::mat& dataset)
+{
+  state.SetItems(dataset.n_cols);
+  state.Run([&]()
+  {
+    TreeType tree(dataset);
+    DoNotOptimize(tree.NumDescendants());
+  });
+}
+
+typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> BenchmarkKDTree;
+typedef StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+    BenchmarkCoverTree;
+typedef RTree<EuclideanDistance, EmptyStatistic, arma::mat> BenchmarkRTree;
+
+MLPACK_BENCHMARK("tree/build/kd/uniform/d=3", [](BenchmarkState& state)
+{
+  TreeBenchmark<BenchmarkKDTree>(state,
+      UniformDataset(3, state.Scaled(100000)));
+});
+
+MLPACK_BENCHMARK("tree/build/kd/blobs/d=16", [](BenchmarkState& state)
+{
+  TreeBenchmark<BenchmarkKDTree>(state,
+      GaussianBlobsDataset(16, state.Scaled(100000), 20));
+});
+
+MLPACK_BENCHMARK("tree/build/cover/uniform/d=3", [](BenchmarkState& state)
+{
+  TreeBenchmark<BenchmarkCoverTree>(state,
+      UniformDataset(3, state.Scaled(20000)));
+});
+
+MLPACK_BENCHMARK("tree/build/cover/blobs/d=16", [](BenchmarkState& state)
+{
+  TreeBenchmark<BenchmarkCoverTree>(state,
+      GaussianBlobsDataset(16, state.Scaled(20000), 20));
+});
+
+MLPACK_BENCHMARK("tree/build/r/uniform/d=3", [](BenchmarkState& state)
+{
+  TreeBenchmark<BenchmarkRTree>(state,
+      UniformDataset(3, state.Scaled(20000)));
+});
+
+/**
+ * Bulk load an R tree on a dataset.
+ */
+static void BulkLoadBenchmark(BenchmarkState& state,
+                              const arma::mat& dataset,
+                              const BulkLoadType bulkLoad)
+{
+  state.SetItems(dataset.n_cols);
+  state.Run([&]()
+  {
+    BenchmarkRTree tree(dataset, bulkLoad);
+    DoNotOptimize(tree.NumDescendants());
+  });
+}
+
+MLPACK_BENCHMARK("tree/build/r/str/uniform/d=3", [](BenchmarkState& state)
+{
+  BulkLoadBenchmark(state, UniformDataset(3, state.Scaled(20000)),
+      STR_BULK_LOAD);
+});
+
+MLPACK_BENCHMARK("tree/build/r/hilbert/uniform/d=3", [](BenchmarkState& state)
+{
+  BulkLoadBenchmark(state, UniformDataset(3, state.Scaled(20000)),
+      HILBERT_BULK_LOAD);
+});
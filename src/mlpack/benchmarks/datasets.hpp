@@ -0,0 +1,94 @@
+/**
+ * @file datasets.hpp
+ *
+ * Synthetic datasets for the benchmarks.  All datasets are generated with
+ * mlpack's random number generator, which the benchmark program seeds before
+ * each benchmark, so every run sees the same data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BENCHMARKS_DATASETS_HPP
+#define MLPACK_BENCHMARKS_DATASETS_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace benchmark {
+
+/**
+ * Points drawn uniformly from the unit hypercube.
+ *
+ * @param dimensionality Dimensionality of the points.
+ * @param points Number of points.
+ */
+inline arma::mat UniformDataset(const size_t dimensionality,
+                                const size_t points)
+{
+  return arma::randu<arma::mat>(dimensionality, points);
+}
+
+/**
+ * Points drawn from a mixture of spherical Gaussians with unit variance, whose
+ * means are drawn uniformly from [0, spread]^d.  The component each point was
+ * drawn from is stored in labels.
+ *
+ * @param dimensionality Dimensionality of the points.
+ * @param points Number of points.
+ * @param clusters Number of Gaussians.
+ * @param spread Size of the hypercube the means are drawn from.
+ * @param labels Component of each point.
+ */
+inline arma::mat GaussianBlobsDataset(const size_t dimensionality,
+                                      const size_t points,
+                                      const size_t clusters,
+                                      const double spread,
+                                      arma::Row<size_t>& labels)
+{
+  const arma::mat means = spread * arma::randu<arma::mat>(dimensionality,
+      clusters);
+
+  arma::mat dataset = arma::randn<arma::mat>(dimensionality, points);
+  labels.set_size(points);
+  for (size_t i = 0; i < points; ++i)
+  {
+    labels[i] = math::RandInt(clusters);
+    dataset.col(i) += means.col(labels[i]);
+  }
+
+  return dataset;
+}
+
+//! Points drawn from a mixture of Gaussians; see above.
+inline arma::mat GaussianBlobsDataset(const size_t dimensionality,
+                                      const size_t points,
+                                      const size_t clusters,
+                                      const double spread = 10.0)
+{
+  arma::Row<size_t> labels;
+  return GaussianBlobsDataset(dimensionality, points, clusters, spread,
+      labels);
+}
+
+/**
+ * One-hot encoded labels for the given class of each point.
+ *
+ * @param labels Class of each point.
+ * @param classes Number of classes.
+ */
+inline arma::mat OneHotLabels(const arma::Row<size_t>& labels,
+                              const size_t classes)
+{
+  arma::mat responses(classes, labels.n_elem, arma::fill::zeros);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    responses(labels[i], i) = 1.0;
+
+  return responses;
+}
+
+} // namespace benchmark
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,180 @@
+/**
+ * @file ffn_benchmarks.cpp
+ *
+ * Benchmarks of the forward and backward passes of feedforward networks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+#include "datasets.hpp"
+
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
+#include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/core/optimizers/sgd/sgd.hpp>
+
+using namespace mlpack;
+using namespace mlpack::ann;
+using namespace mlpack::benchmark;
+
+typedef FFN<MeanSquaredError<>, RandomInitialization> BenchmarkNetwork;
+
+/**
+ * Build a multilayer perceptron with two hidden layers of the given size.
+ */
+static void BuildNetwork(BenchmarkNetwork& model,
+                         const size_t inputSize,
+                         const size_t hiddenSize,
+                         const size_t outputSize)
+{
+  model.Add<Linear<>>(inputSize, hiddenSize);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(hiddenSize, hiddenSize);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(hiddenSize, outputSize);
+  model.Add<SigmoidLayer<>>();
+  model.ResetParameters();
+}
+
+/**
+ * Predict the outputs for a dataset, in batches.
+ */
+static void PredictBenchmark(BenchmarkState& state, const size_t hiddenSize)
+{
+  const arma::mat dataset = GaussianBlobsDataset(32, state.Scaled(10000), 10);
+
+  BenchmarkNetwork model;
+  BuildNetwork(model, 32, hiddenSize, 10);
+
+  state.SetItems(dataset.n_cols);
+  state.Run([&]()
+  {
+    arma::mat predictions;
+    model.Predict(dataset, predictions);
+    DoNotOptimize(predictions);
+  });
+}
+
+MLPACK_BENCHMARK("ffn/predict/mlp/hidden=64", [](BenchmarkState& state)
+{
+  PredictBenchmark(state, 64);
+});
+
+MLPACK_BENCHMARK("ffn/predict/mlp/hidden=512", [](BenchmarkState& state)
+{
+  PredictBenchmark(state, 512);
+});
+
+/**
+ * Run the forward and backward pass for one batch of the given size.
+ */
+static void ForwardBackwardBenchmark(BenchmarkState& state,
+                                     const size_t hiddenSize,
+                                     const size_t batchSize)
+{
+  arma::Row<size_t> labels;
+  const arma::mat inputs = GaussianBlobsDataset(32, batchSize, 10, 10.0,
+      labels);
+  const arma::mat targets = OneHotLabels(labels, 10);
+
+  BenchmarkNetwork model;
+  BuildNetwork(model, 32, hiddenSize, 10);
+
+  state.SetItems(batchSize);
+  state.Run([&]()
+  {
+    arma::mat outputs, gradients;
+    model.Forward(inputs, outputs);
+    const double loss = model.Backward(targets, gradients);
+    DoNotOptimize(loss);
+    DoNotOptimize(gradients);
+  });
+}
+
+MLPACK_BENCHMARK("ffn/forward_backward/mlp/hidden=64/batch=1",
+    [](BenchmarkState& state)
+{
+  ForwardBackwardBenchmark(state, 64, 1);
+});
+
+MLPACK_BENCHMARK("ffn/forward_backward/mlp/hidden=64/batch=128",
+    [](BenchmarkState& state)
+{
+  ForwardBackwardBenchmark(state, 64, 128);
+});
+
+MLPACK_BENCHMARK("ffn/forward_backward/mlp/hidden=512/batch=128",
+    [](BenchmarkState& state)
+{
+  ForwardBackwardBenchmark(state, 512, 128);
+});
+
+/**
+ * Train the network for one epoch of shuffled mini-batches of the given size.
+ */
+static void TrainEpochBenchmark(BenchmarkState& state, const size_t batchSize)
+{
+  arma::Row<size_t> labels;
+  const arma::mat inputs = GaussianBlobsDataset(32, state.Scaled(10000), 10,
+      10.0, labels);
+  const arma::mat targets = OneHotLabels(labels, 10);
+
+  BenchmarkNetwork model;
+  BuildNetwork(model, 32, 64, 10);
+
+  optimization::SGD<> sgd(0.01, batchSize, inputs.n_cols, -1.0, true);
+
+  state.SetItems(inputs.n_cols);
+  state.Run([&]()
+  {
+    model.Train(inputs, targets, sgd);
+  });
+}
+
+MLPACK_BENCHMARK("ffn/train_epoch/mlp/hidden=64/batch=32",
+    [](BenchmarkState& state)
+{
+  TrainEpochBenchmark(state, 32);
+});
+
+/**
+ * Run the forward pass, backward pass and gradient of a convolution layer with
+ * the given convolution rules, on a batch of 28x28 images with 8 channels.
+ */
+template<typename LayerType>
+static void ConvolutionBenchmark(BenchmarkState& state, const size_t batchSize)
+{
+  LayerType layer(8, 16, 3, 3, 1, 1, 1, 1, 28, 28);
+  layer.Parameters().randn();
+  layer.Reset();
+
+  const arma::mat inputs = arma::randu<arma::mat>(28 * 28 * 8, batchSize);
+
+  state.SetItems(batchSize);
+  state.Run([&]()
+  {
+    arma::mat outputs, delta, gradient;
+    layer.Forward(std::move(inputs), std::move(outputs));
+    layer.Backward(std::move(inputs), std::move(outputs), std::move(delta));
+    layer.Gradient(std::move(inputs), std::move(outputs), std::move(gradient));
+    DoNotOptimize(delta);
+    DoNotOptimize(gradient);
+  });
+}
+
+typedef Convolution<Im2ColConvolution<ValidConvolution>,
+                    Im2ColConvolution<FullConvolution>,
+                    Im2ColConvolution<ValidConvolution>> Im2ColConvolutionLayer;
+
+MLPACK_BENCHMARK("ffn/convolution/naive/batch=32", [](BenchmarkState& state)
+{
+  ConvolutionBenchmark<Convolution<>>(state, 32);
+});
+
+MLPACK_BENCHMARK("ffn/convolution/im2col/batch=32", [](BenchmarkState& state)
+{
+  ConvolutionBenchmark<Im2ColConvolutionLayer>(state, 32);
+});
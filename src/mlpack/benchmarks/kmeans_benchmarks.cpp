@@ -0,0 +1,137 @@
+/**
+ * @file kmeans_benchmarks.cpp
+ *
+ * End-to-end benchmarks of the k-means variants.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+#include "datasets.hpp"
+
+#include <mlpack/methods/kmeans/kmeans.hpp>
+#include <mlpack/methods/kmeans/elkan_kmeans.hpp>
+#include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
+#include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
+#include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include <mlpack/methods/kmeans/mini_batch_kmeans.hpp>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+using namespace mlpack::kmeans;
+using namespace mlpack::metric;
+
+/**
+ * Run a fixed number of Lloyd iterations of the given k-means variant, always
+ * starting from the same centroids, so that every variant does the same work.
+ */
+template<template<class, class> class LloydStepType>
+static void KMeansBenchmark(BenchmarkState& state,
+                            const size_t dimensionality,
+                            const size_t points,
+                            const size_t clusters)
+{
+  const arma::mat dataset = GaussianBlobsDataset(dimensionality,
+      state.Scaled(points), clusters);
+
+  // Take random points as the initial centroids.
+  arma::mat initialCentroids(dimensionality, clusters);
+  for (size_t i = 0; i < clusters; ++i)
+    initialCentroids.col(i) = dataset.col(math::RandInt(dataset.n_cols));
+
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      LloydStepType> kmeans(10);
+
+  state.SetItems(dataset.n_cols);
+  state.Run([&]()
+  {
+    arma::mat centroids = initialCentroids;
+    kmeans.Cluster(dataset, clusters, centroids, true);
+    DoNotOptimize(centroids);
+  });
+}
+
+/**
+ * Run mini-batch k-means with the given batch size, from the same random
+ * centroids as KMeansBenchmark(), with enough mini-batches to see as many
+ * points as ten Lloyd iterations do.
+ */
+static void MiniBatchKMeansBenchmark(BenchmarkState& state,
+                                     const size_t dimensionality,
+                                     const size_t points,
+                                     const size_t clusters,
+                                     const size_t batchSize)
+{
+  const arma::mat dataset = GaussianBlobsDataset(dimensionality,
+      state.Scaled(points), clusters);
+
+  arma::mat initialCentroids(dimensionality, clusters);
+  for (size_t i = 0; i < clusters; ++i)
+    initialCentroids.col(i) = dataset.col(math::RandInt(dataset.n_cols));
+
+  MiniBatchKMeans<> kmeans(batchSize,
+      std::max(10 * dataset.n_cols / batchSize, (size_t) 1));
+
+  state.SetItems(dataset.n_cols);
+  state.Run([&]()
+  {
+    arma::mat centroids = initialCentroids;
+    kmeans.Cluster(dataset, clusters, centroids, true);
+    DoNotOptimize(centroids);
+  });
+}
+
+MLPACK_BENCHMARK("kmeans/naive/blobs/d=10/k=20", [](BenchmarkState& state)
+{
+  KMeansBenchmark<NaiveKMeans>(state, 10, 100000, 20);
+});
+
+MLPACK_BENCHMARK("kmeans/naive/blobs/d=256/k=1000", [](BenchmarkState& state)
+{
+  KMeansBenchmark<NaiveKMeans>(state, 256, 20000, 1000);
+});
+
+MLPACK_BENCHMARK("kmeans/elkan/blobs/d=10/k=20", [](BenchmarkState& state)
+{
+  KMeansBenchmark<ElkanKMeans>(state, 10, 100000, 20);
+});
+
+MLPACK_BENCHMARK("kmeans/hamerly/blobs/d=10/k=20", [](BenchmarkState& state)
+{
+  KMeansBenchmark<HamerlyKMeans>(state, 10, 100000, 20);
+});
+
+MLPACK_BENCHMARK("kmeans/pelleg_moore/blobs/d=3/k=20",
+    [](BenchmarkState& state)
+{
+  KMeansBenchmark<PellegMooreKMeans>(state, 3, 100000, 20);
+});
+
+MLPACK_BENCHMARK("kmeans/dual_tree/blobs/d=3/k=20", [](BenchmarkState& state)
+{
+  KMeansBenchmark<DefaultDualTreeKMeans>(state, 3, 100000, 20);
+});
+
+MLPACK_BENCHMARK("kmeans/naive/blobs/d=64/k=200", [](BenchmarkState& state)
+{
+  KMeansBenchmark<NaiveKMeans>(state, 64, 50000, 200);
+});
+
+MLPACK_BENCHMARK("kmeans/hamerly/blobs/d=64/k=200", [](BenchmarkState& state)
+{
+  KMeansBenchmark<HamerlyKMeans>(state, 64, 50000, 200);
+});
+
+MLPACK_BENCHMARK("kmeans/mini_batch/blobs/d=10/k=20/b=1000",
+    [](BenchmarkState& state)
+{
+  MiniBatchKMeansBenchmark(state, 10, 100000, 20, 1000);
+});
+
+MLPACK_BENCHMARK("kmeans/mini_batch/blobs/d=64/k=200/b=1000",
+    [](BenchmarkState& state)
+{
+  MiniBatchKMeansBenchmark(state, 64, 50000, 200, 1000);
+});
@@ -0,0 +1,126 @@
+/**
+ * @file knn_benchmarks.cpp
+ *
+ * End-to-end benchmarks of k-nearest-neighbor search.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+#include "datasets.hpp"
+
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/core/tree/cover_tree.hpp>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+using namespace mlpack::metric;
+using namespace mlpack::neighbor;
+using namespace mlpack::tree;
+
+/**
+ * Build the reference tree and find the k nearest neighbors of every point of
+ * the dataset (monochromatic search), as mlpack_knn does without a query set.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+static void KNNBenchmark(BenchmarkState& state,
+                         const arma::mat& dataset,
+                         const NeighborSearchMode mode)
+{
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      TreeType> KNNType;
+
+  state.SetItems(dataset.n_cols);
+  state.Run([&]()
+  {
+    KNNType knn(dataset, mode);
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    knn.Search(5, neighbors, distances);
+    DoNotOptimize(neighbors);
+  });
+}
+
+MLPACK_BENCHMARK("knn/naive/uniform/d=3", [](BenchmarkState& state)
+{
+  KNNBenchmark<KDTree>(state, UniformDataset(3, state.Scaled(5000)),
+      NAIVE_MODE);
+});
+
+MLPACK_BENCHMARK("knn/kd/single/uniform/d=3", [](BenchmarkState& state)
+{
+  KNNBenchmark<KDTree>(state, UniformDataset(3, state.Scaled(50000)),
+      SINGLE_TREE_MODE);
+});
+
+MLPACK_BENCHMARK("knn/kd/dual/uniform/d=3", [](BenchmarkState& state)
+{
+  KNNBenchmark<KDTree>(state, UniformDataset(3, state.Scaled(50000)),
+      DUAL_TREE_MODE);
+});
+
+MLPACK_BENCHMARK("knn/kd/dual/blobs/d=10", [](BenchmarkState& state)
+{
+  KNNBenchmark<KDTree>(state, GaussianBlobsDataset(10, state.Scaled(50000),
+      20), DUAL_TREE_MODE);
+});
+
+MLPACK_BENCHMARK("knn/ball/dual/blobs/d=10", [](BenchmarkState& state)
+{
+  KNNBenchmark<BallTree>(state, GaussianBlobsDataset(10, state.Scaled(50000),
+      20), DUAL_TREE_MODE);
+});
+
+MLPACK_BENCHMARK("knn/cover/dual/blobs/d=10", [](BenchmarkState& state)
+{
+  KNNBenchmark<StandardCoverTree>(state, GaussianBlobsDataset(10,
+      state.Scaled(20000), 20), DUAL_TREE_MODE);
+});
+
+MLPACK_BENCHMARK("knn/r/dual/uniform/d=3", [](BenchmarkState& state)
+{
+  KNNBenchmark<RTree>(state, UniformDataset(3, state.Scaled(20000)),
+      DUAL_TREE_MODE);
+});
+
+/**
+ * Search for the neighbors of query points one query point at a time, as a
+ * server would, with best-first search limited to the given number of visited
+ * nodes per query point (0 means no limit).  The tree is built only once.
+ */
+static void BestFirstBenchmark(BenchmarkState& state, const size_t maxVisits)
+{
+  const arma::mat dataset = GaussianBlobsDataset(10, state.Scaled(50000), 20);
+  const arma::mat queries = GaussianBlobsDataset(10, 1000, 20);
+
+  KNN knn(dataset, BEST_FIRST_SINGLE_TREE_MODE);
+  knn.MaxVisits() = maxVisits;
+
+  state.SetItems(queries.n_cols);
+  state.Run([&]()
+  {
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    for (size_t i = 0; i < queries.n_cols; ++i)
+    {
+      knn.Search(queries.col(i), 5, neighbors, distances);
+      DoNotOptimize(neighbors);
+    }
+  });
+}
+
+MLPACK_BENCHMARK("knn/kd/best_first/blobs/d=10", [](BenchmarkState& state)
+{
+  BestFirstBenchmark(state, 0);
+});
+
+MLPACK_BENCHMARK("knn/kd/best_first/blobs/d=10/visits=50",
+    [](BenchmarkState& state)
+{
+  BestFirstBenchmark(state, 50);
+});
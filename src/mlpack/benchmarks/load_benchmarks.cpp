@@ -0,0 +1,111 @@
+/**
+ * @file load_benchmarks.cpp
+ *
+ * Benchmarks of loading datasets from disk.  The files are written to the
+ * current directory before each benchmark and removed afterwards.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+#include "datasets.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+
+/**
+ * Write a CSV file with the given number of points of uniform numeric data;
+ * if categorical is true, the last dimension holds one of 100 strings instead.
+ */
+static void WriteCSV(const std::string& filename,
+                     const size_t dimensionality,
+                     const size_t points,
+                     const bool categorical)
+{
+  const arma::mat dataset = UniformDataset(dimensionality, points);
+
+  std::ofstream stream(filename.c_str());
+  stream.precision(12);
+  for (size_t i = 0; i < points; ++i)
+  {
+    for (size_t d = 0; d < dimensionality; ++d)
+    {
+      if (d > 0)
+        stream << ",";
+
+      if (categorical && d == dimensionality - 1)
+        stream << "category" << (size_t) (100 * dataset(d, i));
+      else
+        stream << dataset(d, i);
+    }
+    stream << std::endl;
+  }
+}
+
+/**
+ * Load a CSV file with data::Load(); with a DatasetInfo, this uses mlpack's
+ * own CSV parser, and otherwise Armadillo's.
+ */
+static void LoadCSVBenchmark(BenchmarkState& state,
+                             const bool withInfo,
+                             const bool categorical)
+{
+  const std::string filename = "mlpack_benchmark_load.csv";
+  const size_t points = state.Scaled(200000);
+  WriteCSV(filename, 10, points, categorical);
+
+  state.SetItems(points);
+  state.Run([&]()
+  {
+    arma::mat dataset;
+    if (withInfo)
+    {
+      data::DatasetInfo info;
+      data::Load(filename, dataset, info, true);
+    }
+    else
+    {
+      data::Load(filename, dataset, true);
+    }
+    DoNotOptimize(dataset);
+  });
+
+  std::remove(filename.c_str());
+}
+
+MLPACK_BENCHMARK("load/csv/armadillo/numeric", [](BenchmarkState& state)
+{
+  LoadCSVBenchmark(state, false, false);
+});
+
+MLPACK_BENCHMARK("load/csv/dataset_info/numeric", [](BenchmarkState& state)
+{
+  LoadCSVBenchmark(state, true, false);
+});
+
+MLPACK_BENCHMARK("load/csv/dataset_info/categorical", [](BenchmarkState& state)
+{
+  LoadCSVBenchmark(state, true, true);
+});
+
+MLPACK_BENCHMARK("load/mmat/map", [](BenchmarkState& state)
+{
+  const std::string filename = "mlpack_benchmark_load.mmat";
+  const size_t points = state.Scaled(200000);
+  data::Save(filename, UniformDataset(10, points), true);
+
+  state.SetItems(points);
+  state.Run([&]()
+  {
+    // Touch every element, so the whole file is actually read.
+    data::MappedMatrix<double> dataset(filename, true);
+    DoNotOptimize(arma::accu(dataset.Matrix()));
+  });
+
+  std::remove(filename.c_str());
+});
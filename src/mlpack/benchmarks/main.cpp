@@ -0,0 +1,166 @@
+/**
+ * @file main.cpp
+ *
+ * The mlpack_benchmarks program: run the registered benchmarks and write the
+ * results as JSON or CSV.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <fstream>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+
+static const char* usage =
+"Usage: mlpack_benchmarks [options]\n"
+"\n"
+"Run the mlpack benchmarks and write the results as JSON (or CSV).  Times are\n"
+"in seconds; the median of the timed runs is the most robust statistic for\n"
+"comparing two builds.  Each benchmark is run with the same random seed, so\n"
+"the same data is used no matter which benchmarks are selected.\n"
+"\n"
+"Options:\n"
+"  --list                 List the names of the benchmarks and exit.\n"
+"  --filter=STRING        Only run benchmarks whose name contains STRING.\n"
+"  --repetitions=N        Minimum number of timed runs (default 5).\n"
+"  --min_time=SECONDS     Minimum total time of the timed runs (default 1).\n"
+"  --scale=FACTOR         Multiply all dataset sizes by FACTOR (default 1).\n"
+"  --seed=N               Random seed (default 42).\n"
+"  --format=json|csv      Output format (default json).\n"
+"  --output=FILE          Write the results to FILE instead of stdout.\n"
+"  --help                 Print this message.\n";
+
+//! If arg is "--name=value", store value and return true.
+static bool ParseOption(const std::string& arg,
+                        const std::string& name,
+                        std::string& value)
+{
+  const std::string prefix = "--" + name + "=";
+  if (arg.compare(0, prefix.size(), prefix) != 0)
+    return false;
+
+  value = arg.substr(prefix.size());
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  std::string filter, format = "json", output;
+  size_t repetitions = 5;
+  double minTime = 1.0, scale = 1.0;
+  size_t seed = 42;
+  bool list = false;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    std::string value;
+    try
+    {
+      if (arg == "--help" || arg == "-h")
+      {
+        std::cout << usage;
+        return 0;
+      }
+      else if (arg == "--list")
+        list = true;
+      else if (ParseOption(arg, "filter", value))
+        filter = value;
+      else if (ParseOption(arg, "repetitions", value))
+        repetitions = std::stoul(value);
+      else if (ParseOption(arg, "min_time", value))
+        minTime = std::stod(value);
+      else if (ParseOption(arg, "scale", value))
+        scale = std::stod(value);
+      else if (ParseOption(arg, "seed", value))
+        seed = std::stoul(value);
+      else if (ParseOption(arg, "format", value))
+        format = value;
+      else if (ParseOption(arg, "output", value))
+        output = value;
+      else
+      {
+        std::cerr << "Unknown option '" << arg << "'." << std::endl << std::endl
+            << usage;
+        return 1;
+      }
+    }
+    catch (std::exception& e)
+    {
+      std::cerr << "Invalid value in option '" << arg << "'." << std::endl;
+      return 1;
+    }
+  }
+
+  if (format != "json" && format != "csv")
+  {
+    std::cerr << "Unknown format '" << format << "'; must be 'json' or 'csv'."
+        << std::endl;
+    return 1;
+  }
+
+  if (scale <= 0.0)
+  {
+    std::cerr << "The scale must be positive." << std::endl;
+    return 1;
+  }
+
+  std::vector<Benchmark> selected;
+  for (const Benchmark& benchmark : Benchmarks())
+    if (benchmark.name.find(filter) != std::string::npos)
+      selected.push_back(benchmark);
+
+  if (list)
+  {
+    for (const Benchmark& benchmark : selected)
+      std::cout << benchmark.name << std::endl;
+    return 0;
+  }
+
+  std::vector<BenchmarkResult> results;
+  for (const Benchmark& benchmark : selected)
+  {
+    std::cerr << benchmark.name << "... " << std::flush;
+
+    math::RandomSeed(seed);
+    BenchmarkState state(repetitions, minTime, scale);
+    benchmark.function(state);
+    results.push_back(Summarize(benchmark.name, state));
+
+    std::cerr << results.back().median << "s" << std::endl;
+  }
+
+  std::ofstream file;
+  if (!output.empty())
+  {
+    file.open(output.c_str());
+    if (!file.is_open())
+    {
+      std::cerr << "Cannot open '" << output << "' for writing." << std::endl;
+      return 1;
+    }
+  }
+  std::ostream& stream = output.empty() ? std::cout : file;
+
+  if (format == "json")
+  {
+    std::vector<std::pair<std::string, std::string>> settings;
+    settings.push_back(std::make_pair("repetitions",
+        std::to_string(repetitions)));
+    settings.push_back(std::make_pair("min_time", std::to_string(minTime)));
+    settings.push_back(std::make_pair("scale", std::to_string(scale)));
+    settings.push_back(std::make_pair("seed", std::to_string(seed)));
+    WriteJSON(stream, settings, results);
+  }
+  else
+  {
+    WriteCSV(stream, results);
+  }
+
+  return 0;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file rnn_benchmarks.cpp
+ *
+ * Benchmarks of the forward and backward passes through time of recurrent
+ * networks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
+#include <mlpack/methods/ann/rnn.hpp>
+
+using namespace mlpack;
+using namespace mlpack::ann;
+using namespace mlpack::benchmark;
+
+/**
+ * Compute the gradient of a recurrent network with the given recurrent layer
+ * for one batch of sequences of the given length.
+ */
+template<typename RecurrentLayerType>
+static void BPTTBenchmark(BenchmarkState& state,
+                          const size_t rho,
+                          const size_t batchSize)
+{
+  RNN<MeanSquaredError<> > model(rho);
+  model.Predictors() = arma::randu<arma::cube>(16, batchSize, rho);
+  model.Responses() = arma::randu<arma::cube>(8, batchSize, rho);
+
+  model.Add<IdentityLayer<> >();
+  model.Add<Linear<> >(16, 64);
+  model.Add<RecurrentLayerType>(64, 64, rho);
+  model.Add<Linear<> >(64, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Reset();
+
+  state.SetItems(rho * batchSize);
+  state.Run([&]()
+  {
+    arma::mat gradient;
+    model.Gradient(model.Parameters(), 0, gradient, batchSize);
+    DoNotOptimize(gradient);
+  });
+}
+
+MLPACK_BENCHMARK("rnn/bptt/gru/rho=100/batch=32", [](BenchmarkState& state)
+{
+  BPTTBenchmark<GRU<> >(state, 100, 32);
+});
+
+MLPACK_BENCHMARK("rnn/bptt/fast_gru/rho=100/batch=32",
+    [](BenchmarkState& state)
+{
+  BPTTBenchmark<FastGRU<> >(state, 100, 32);
+});
+
+MLPACK_BENCHMARK("rnn/bptt/fast_lstm/rho=100/batch=32",
+    [](BenchmarkState& state)
+{
+  BPTTBenchmark<FastLSTM<> >(state, 100, 32);
+});
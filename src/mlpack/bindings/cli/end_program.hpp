@@ -3,7 +3,8 @@
  * @author Ryan Curtin
  * @author Matthew Amidon
  *
- * Terminate the program; handle --verbose option; print output parameters.
+ * Terminate the program; handle --verbose, --profile_file, and --trace_file
+ * options; print output parameters.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -14,6 +15,7 @@
 #define MLPACK_BINDINGS_CLI_END_PROGRAM_HPP
 
 #include <mlpack/core/util/cli.hpp>
+#include <fstream>
 
 namespace mlpack {
 namespace bindings {
@@ -71,6 +73,31 @@ inline void EndProgram()
       Log::Info << "  " << it2.first << ": ";
       CLI::GetSingleton().timer.PrintTimer(it2.first);
     }
+
+    Log::Info << "Program profile:" << std::endl;
+    CLI::GetSingleton().timer.PrintProfile();
+  }
+
+  // Write the profile and trace of the timers, if requested.  Failing to do so
+  // isn't worth losing the results of the program over.
+  if (CLI::HasParam("profile_file"))
+  {
+    const std::string& filename = CLI::GetParam<std::string>("profile_file");
+    std::ofstream stream(filename.c_str());
+    CLI::GetSingleton().timer.WriteProfile(stream);
+    if (!stream.good())
+      Log::Warn << "Could not write profile to '" << filename << "'."
+          << std::endl;
+  }
+
+  if (CLI::HasParam("trace_file"))
+  {
+    const std::string& filename = CLI::GetParam<std::string>("trace_file");
+    std::ofstream stream(filename.c_str());
+    CLI::GetSingleton().timer.WriteTrace(stream);
+    if (!stream.good())
+      Log::Warn << "Could not write trace to '" << filename << "'."
+          << std::endl;
   }
 
   // Lastly clean up any memory.  If we are holding any pointers, then we "own"
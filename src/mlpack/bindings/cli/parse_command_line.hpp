@@ -27,6 +27,13 @@ PARAM_STRING_IN("info", "Get help on a specific module or option.", "", "");
 PARAM_FLAG("verbose", "Display informational messages and the full list of "
     "parameters and timers at the end of execution.", "v");
 PARAM_FLAG("version", "Display the version of mlpack.", "V");
+PARAM_STRING_IN("profile_file", "If specified, a JSON profile of the program's "
+    "timers (with the number of calls and the total, average, minimum, and "
+    "maximum time of each nested timer) is written to this file at the end of "
+    "execution.", "", "");
+PARAM_STRING_IN("trace_file", "If specified, every run of every timer is "
+    "recorded and written to this file at the end of execution, in the Chrome "
+    "trace event format (viewable with chrome://tracing or Perfetto).", "", "");
 
 /**
  * Parse the command line, setting all of the options inside of the CLI object
@@ -174,6 +181,10 @@ void ParseCommandLine(int argc, char** argv)
     Log::Info.ignoreInput = false;
   }
 
+  // Record every run of every timer if a trace was requested.
+  if (CLI::HasParam("trace_file"))
+    Timer::EnableTracing();
+
   // Now, issue an error if we forgot any required options.
   for (std::map<std::string, util::ParamData>::const_iterator iter =
        parameters.begin(); iter != parameters.end(); ++iter)
@@ -0,0 +1,241 @@
+/**
+ * @file chunk_reader.cpp
+ *
+ * Implementation of the ChunkReader class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "chunk_reader.hpp"
+#include "extension.hpp"
+
+#include <cstdlib>
+
+namespace mlpack {
+namespace data {
+
+//! Return true if c separates two values in a text file.
+static bool IsSeparator(const char c)
+{
+  return (c == ',' || c == ' ' || c == '\t' || c == '\r' || c == '\v' ||
+      c == '\f');
+}
+
+/**
+ * Parse the values of one line of a text file into the given memory, which
+ * must be able to hold maxValues values.  Returns the number of values on the
+ * line, or size_t(-1) if the line could not be parsed.
+ */
+static size_t ParseLine(const std::string& line,
+                        double* values,
+                        const size_t maxValues)
+{
+  size_t count = 0;
+  const char* p = line.c_str();
+  while (true)
+  {
+    while (IsSeparator(*p))
+      ++p;
+    if (*p == '\0')
+      return count;
+
+    char* end;
+    const double value = std::strtod(p, &end);
+    if (end == p || (*end != '\0' && !IsSeparator(*end)))
+      return size_t(-1);
+
+    if (count < maxValues)
+      values[count] = value;
+    ++count;
+    p = end;
+  }
+}
+
+//! Return true if the line holds nothing but separators.
+static bool IsBlank(const std::string& line)
+{
+  for (size_t i = 0; i < line.size(); ++i)
+    if (!IsSeparator(line[i]))
+      return false;
+
+  return true;
+}
+
+ChunkReader::ChunkReader(const std::string& filename, const size_t chunkSize) :
+    filename(filename),
+    chunkSize(chunkSize),
+    dimensionality(0),
+    binary(false),
+    pointsRead(0),
+    linesRead(0)
+{
+  if (chunkSize == 0)
+    throw std::invalid_argument("ChunkReader: chunk size must be positive");
+
+  const std::string extension = Extension(filename);
+  if (extension == "mmat")
+    binary = true;
+  else if (extension != "csv" && extension != "tsv" && extension != "txt")
+  {
+    std::ostringstream oss;
+    oss << "ChunkReader: cannot read '" << filename << "' in chunks; only "
+        << "csv, tsv, txt and mmat files are supported.";
+    throw std::runtime_error(oss.str());
+  }
+
+  stream.open(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+  {
+    std::ostringstream oss;
+    oss << "Cannot open file '" << filename << "'. " << std::endl;
+    throw std::runtime_error(oss.str());
+  }
+
+  std::string error;
+  if (binary)
+  {
+    // Read the header.
+    if (!stream.read((char*) &header, sizeof(MappedMatrixHeader)))
+      error = "file is too small to be a memory-mappable matrix";
+    else if (CheckMappedMatrixHeader(header, error) && header.elemKind != 0)
+      error = "only float and double elements can be read in chunks";
+
+    dimensionality = header.nRows;
+  }
+  else
+  {
+    // The dimensionality is the number of values on the first line that isn't
+    // blank.
+    std::string line;
+    while (std::getline(stream, line) && IsBlank(line)) { }
+
+    dimensionality = ParseLine(line, NULL, 0);
+    if (dimensionality == size_t(-1))
+      error = "parsing error on first line";
+
+    stream.clear();
+    stream.seekg(0, std::ios::beg);
+  }
+
+  if (!error.empty())
+  {
+    std::ostringstream oss;
+    oss << "ChunkReader: cannot read '" << filename << "': " << error << ".";
+    throw std::runtime_error(oss.str());
+  }
+
+  StartRead();
+}
+
+ChunkReader::~ChunkReader()
+{
+  if (pending.valid())
+    pending.wait();
+}
+
+bool ChunkReader::NextChunk(arma::mat& chunk)
+{
+  // If no read is running, we've already reached the end of the file.
+  if (!pending.valid())
+  {
+    chunk.set_size(dimensionality, 0);
+    return false;
+  }
+
+  // This rethrows any exception thrown while reading.
+  chunk = pending.get();
+  pointsRead += chunk.n_cols;
+
+  // A full chunk means there may be more to read.
+  if (chunk.n_cols == chunkSize)
+    StartRead();
+
+  return (chunk.n_cols > 0);
+}
+
+void ChunkReader::StartRead()
+{
+  pending = std::async(std::launch::async, [this]()
+  {
+    arma::mat chunk;
+    if (binary)
+      ReadBinaryChunk(chunk);
+    else
+      ReadTextChunk(chunk);
+    return chunk;
+  });
+}
+
+void ChunkReader::ReadTextChunk(arma::mat& chunk)
+{
+  chunk.set_size(dimensionality, chunkSize);
+
+  size_t points = 0;
+  std::string line;
+  while (points < chunkSize && std::getline(stream, line))
+  {
+    ++linesRead;
+    if (IsBlank(line))
+      continue;
+
+    const size_t values = ParseLine(line, chunk.colptr(points),
+        dimensionality);
+    if (values != dimensionality)
+    {
+      std::ostringstream oss;
+      if (values == size_t(-1))
+      {
+        oss << "ChunkReader: parsing error on line " << linesRead << " of '"
+            << filename << "'!";
+      }
+      else
+      {
+        oss << "ChunkReader: wrong number of dimensions (" << values << ") on "
+            << "line " << linesRead << " of '" << filename << "'; should be "
+            << dimensionality << " dimensions.";
+      }
+      throw std::runtime_error(oss.str());
+    }
+
+    ++points;
+  }
+
+  if (points < chunkSize)
+    chunk.resize(dimensionality, points);
+}
+
+void ChunkReader::ReadBinaryChunk(arma::mat& chunk)
+{
+  // Only one chunk is read at a time, so pointsRead counts everything before
+  // this chunk.
+  const size_t pointsLeft = (size_t) header.nCols - pointsRead;
+  const size_t points = std::min(chunkSize, pointsLeft);
+  const size_t elements = points * dimensionality;
+
+  bool success;
+  if (header.elemSize == sizeof(double))
+  {
+    chunk.set_size(dimensionality, points);
+    success = (bool) stream.read((char*) chunk.memptr(),
+        std::streamsize(elements * sizeof(double)));
+  }
+  else
+  {
+    arma::fmat floatChunk(dimensionality, points);
+    success = (bool) stream.read((char*) floatChunk.memptr(),
+        std::streamsize(elements * sizeof(float)));
+    chunk = arma::conv_to<arma::mat>::from(floatChunk);
+  }
+
+  if (!success)
+  {
+    std::ostringstream oss;
+    oss << "ChunkReader: '" << filename << "' is truncated.";
+    throw std::runtime_error(oss.str());
+  }
+}
+
+} // namespace data
+} // namespace mlpack
@@ -0,0 +1,122 @@
+/**
+ * @file chunk_reader.hpp
+ *
+ * Read a numeric dataset from disk a fixed number of points at a time, so that
+ * datasets larger than memory can be streamed through an algorithm.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_CHUNK_READER_HPP
+#define MLPACK_CORE_DATA_CHUNK_READER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <fstream>
+#include <future>
+
+#include "mapped_matrix.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The ChunkReader reads a numeric dataset from a file in chunks of a fixed
+ * number of points, instead of loading the whole dataset into memory like
+ * data::Load() does.  While the caller works on one chunk, the next chunk is
+ * read on a background thread, so that I/O and computation overlap.  At most
+ * two chunks are held in memory at any time.
+ *
+ * Two kinds of files are supported:
+ *
+ *  - Text files (.csv, .tsv, .txt) with one point per line, whose values are
+ *    separated by commas, tabs, or spaces.  All values must be numeric; blank
+ *    lines are skipped.
+ *  - Memory-mappable binary matrices (.mmat, see MappedMatrixHeader) with
+ *    float or double elements.
+ *
+ * As with data::Load(), each chunk holds one point per column.
+ *
+ * @code
+ * data::ChunkReader reader("huge_dataset.csv", 100000);
+ * arma::mat chunk;
+ * while (reader.NextChunk(chunk))
+ * {
+ *   // Do something with the points in chunk...
+ * }
+ * @endcode
+ */
+class ChunkReader
+{
+ public:
+  /**
+   * Open the given file for reading in chunks of the given number of points.
+   * Reading of the first chunk starts immediately.  A std::runtime_error is
+   * thrown if the file cannot be opened or its type is not supported.
+   *
+   * @param filename Name of file to read.
+   * @param chunkSize Maximum number of points in each chunk.
+   */
+  ChunkReader(const std::string& filename, const size_t chunkSize);
+
+  //! Wait for any background read to finish.
+  ~ChunkReader();
+
+  /**
+   * Get the next chunk of points, and start reading the chunk after it in the
+   * background.  The last chunk may hold fewer than ChunkSize() points.  A
+   * std::runtime_error is thrown if the file cannot be parsed.
+   *
+   * @param chunk Matrix to store the next chunk of points in.
+   * @return false if there are no points left.
+   */
+  bool NextChunk(arma::mat& chunk);
+
+  //! Get the dimensionality of the points in the file.
+  size_t Dimensionality() const { return dimensionality; }
+  //! Get the maximum number of points in each chunk.
+  size_t ChunkSize() const { return chunkSize; }
+
+ private:
+  // The background thread refers to this object, so it can't be copied.
+  ChunkReader(const ChunkReader&);
+  ChunkReader& operator=(const ChunkReader&);
+
+  //! Read the next chunk from a text file into the given matrix.
+  void ReadTextChunk(arma::mat& chunk);
+
+  //! Read the next chunk from a binary file into the given matrix.
+  void ReadBinaryChunk(arma::mat& chunk);
+
+  //! Start reading the next chunk in the background.
+  void StartRead();
+
+  //! Name of file.
+  std::string filename;
+  //! Maximum number of points in each chunk.
+  size_t chunkSize;
+  //! Dimensionality of the points.
+  size_t dimensionality;
+
+  //! The file being read.
+  std::ifstream stream;
+  //! Whether the file is a binary (.mmat) file.
+  bool binary;
+  //! Header of the file, if it is a binary file.
+  MappedMatrixHeader header;
+  //! The number of points that have been read so far.
+  size_t pointsRead;
+  //! The number of lines that have been read so far (for text files).
+  size_t linesRead;
+
+  //! The chunk being read in the background.  This is declared last, so that
+  //! it is destroyed (and waited for) before the stream it reads from.
+  std::future<arma::mat> pending;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
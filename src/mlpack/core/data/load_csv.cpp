@@ -2,7 +2,7 @@
  * @file load_csv.cpp
  * @author Tham Ngap Wei
  *
- * A CSV reader that uses boost::spirit.
+ * A CSV reader that parses a memory-mapped file in parallel.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -11,62 +11,228 @@
  */
 #include "load_csv.hpp"
 
-using namespace boost::spirit;
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 
 namespace mlpack {
 namespace data {
 
 LoadCSV::LoadCSV(const std::string& file) :
-  extension(Extension(file)),
-  filename(file),
-  inFile(file)
+    extension(Extension(file)),
+    filename(file),
+    numLines(0)
 {
+  // Map the whole file into memory; it is read front to back.
+  mappedFile.Open(file, true);
+  fileData = mappedFile.Data();
+  fileSize = mappedFile.Size();
+
   // Attempt to open stream.
   CheckOpen();
 
-  // Set rules.
+  // Set the delimiter rules.
   if (extension == "csv" || extension == "txt")
   {
-    // Match all characters that are not ',', '\r', or '\n'.
-    stringRule = qi::raw[*~qi::char_(" ,\r\n")];
+    // Tokens are all characters that are not ' ', ',', '\r', or '\n'.
+    tokenEndChar = ',';
   }
   else
   {
-    // Match all characters that are not '\t', '\r', or '\n'.
-    stringRule = qi::raw[*~qi::char_(" \t\r\n")];
+    // Tokens are all characters that are not ' ', '\t', '\r', or '\n'.
+    tokenEndChar = '\t';
   }
 
   if (extension == "csv")
   {
-    // Extract a single comma as the delimiter, catching whitespace on either
-    // side.
-    delimiterRule = qi::raw[(*qi::char_(" ") >> qi::char_(",") >>
-        *qi::char_(" "))];
+    // A single comma is the delimiter, with whitespace allowed on either side.
+    delimiter = ',';
   }
   else if (extension == "txt")
   {
-    // This one is a little more difficult, we need to catch any number of
-    // spaces more than one.
-    delimiterRule = qi::raw[+qi::char_(" ")];
+    // Any number of spaces (at least one).
+    delimiter = ' ';
   }
   else // TSV.
   {
-    // Catch a tab character, possibly with whitespace on either side.
-    delimiterRule = qi::raw[(*qi::char_(" ") >> qi::char_("\t") >>
-        *qi::char_(" "))];
+    // A tab character, possibly with whitespace on either side.
+    delimiter = '\t';
   }
+
+  FindChunks();
 }
 
 void LoadCSV::CheckOpen()
 {
-  if (!inFile.is_open())
+  if (!mappedFile.IsOpen())
   {
     std::ostringstream oss;
     oss << "Cannot open file '" << filename << "'. " << std::endl;
     throw std::runtime_error(oss.str());
   }
+}
+
+void LoadCSV::FindChunks()
+{
+  chunkBegin.clear();
+  chunkLines.clear();
+  chunkFirstLine.clear();
+  numLines = 0;
+
+  if (fileSize == 0)
+    return;
+
+  // Use a few chunks per thread so that the work is balanced, but don't bother
+  // splitting small files.
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = (size_t) omp_get_max_threads();
+  #endif
+  const size_t minChunkSize = 1024 * 1024;
+  const size_t numChunks = std::max((size_t) 1,
+      std::min(4 * numThreads, fileSize / minChunkSize));
+  const size_t chunkSize = fileSize / numChunks;
+
+  // Each chunk starts right after a newline.
+  chunkBegin.push_back(0);
+  for (size_t c = 1; c < numChunks; ++c)
+  {
+    const size_t start = std::max(chunkBegin.back(), c * chunkSize);
+    const char* newline = (const char*) std::memchr(fileData + start, '\n',
+        fileSize - start);
+    if (newline == NULL)
+      break;
+
+    const size_t next = (newline - fileData) + 1;
+    if (next >= fileSize)
+      break;
+    if (next > chunkBegin.back())
+      chunkBegin.push_back(next);
+  }
+  chunkBegin.push_back(fileSize);
+
+  // Count the lines in each chunk.
+  const size_t chunks = chunkBegin.size() - 1;
+  chunkLines.resize(chunks);
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) chunks; ++c)
+  {
+    chunkLines[c] = std::count(fileData + chunkBegin[c],
+        fileData + chunkBegin[c + 1], '\n');
+  }
+
+  // The last line may not end with a newline.
+  if (fileData[fileSize - 1] != '\n')
+    ++chunkLines[chunks - 1];
+
+  chunkFirstLine.resize(chunks);
+  for (size_t c = 0; c < chunks; ++c)
+  {
+    chunkFirstLine[c] = numLines;
+    numLines += chunkLines[c];
+  }
+}
+
+size_t LoadCSV::CountFirstLineTokens() const
+{
+  const char* end = (const char*) std::memchr(fileData, '\n', fileSize);
+  if (end == NULL)
+    end = fileData + fileSize;
+
+  // Remove whitespace from either side.
+  const char* begin = fileData;
+  while (begin < end && IsSpace(*begin))
+    ++begin;
+  while (end > begin && IsSpace(*(end - 1)))
+    --end;
+
+  size_t tokens = 0;
+  Tokenize(begin, end, [&tokens](const char*, const char*) { ++tokens; });
+  return tokens;
+}
+
+/**
+ * Check that the given characters form a plain decimal number that can be
+ * parsed with strtod(), and copy them into the given buffer.  Returns false if
+ * they don't.
+ */
+static bool CheckNumber(const char* begin,
+                        const char* end,
+                        char* buffer,
+                        const size_t bufferSize)
+{
+  if ((size_t) (end - begin) >= bufferSize)
+    return false;
+
+  const char* p = begin;
+  if (p < end && (*p == '+' || *p == '-'))
+    ++p;
+
+  size_t digits = 0;
+  while (p < end && *p >= '0' && *p <= '9')
+  {
+    ++p;
+    ++digits;
+  }
+
+  if (p < end && *p == '.')
+  {
+    ++p;
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+      ++p;
+      ++digits;
+    }
+  }
+
+  if (digits == 0)
+    return false;
+
+  if (p < end && (*p == 'e' || *p == 'E'))
+  {
+    ++p;
+    if (p < end && (*p == '+' || *p == '-'))
+      ++p;
+
+    size_t expDigits = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+      ++p;
+      ++expDigits;
+    }
+
+    if (expDigits == 0)
+      return false;
+  }
+
+  if (p != end)
+    return false;
+
+  std::memcpy(buffer, begin, end - begin);
+  buffer[end - begin] = '\0';
+  return true;
+}
+
+bool LoadCSV::ParseNumber(const char* begin, const char* end, double& value)
+{
+  char buffer[64];
+  if (!CheckNumber(begin, end, buffer, sizeof(buffer)))
+    return false;
+
+  // Out-of-range values can't be read by a stringstream either, so let the
+  // DatasetMapper decide what to do with them.
+  value = std::strtod(buffer, NULL);
+  return (value != HUGE_VAL && value != -HUGE_VAL);
+}
+
+bool LoadCSV::ParseNumber(const char* begin, const char* end, float& value)
+{
+  char buffer[64];
+  if (!CheckNumber(begin, end, buffer, sizeof(buffer)))
+    return false;
 
-  inFile.unsetf(std::ios::skipws);
+  value = std::strtof(buffer, NULL);
+  return (value != HUGE_VALF && value != -HUGE_VALF);
 }
 
 } // namespace data
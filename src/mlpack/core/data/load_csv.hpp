@@ -12,33 +12,40 @@
 #ifndef MLPACK_CORE_DATA_LOAD_CSV_HPP
 #define MLPACK_CORE_DATA_LOAD_CSV_HPP
 
-#include <boost/spirit/include/qi.hpp>
-#include <boost/algorithm/string/trim.hpp>
-
 #include <mlpack/core.hpp>
 #include <mlpack/core/util/log.hpp>
 
+#include <cstring>
 #include <set>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "extension.hpp"
 #include "format.hpp"
 #include "dataset_mapper.hpp"
+#include "mapped_file.hpp"
 
 namespace mlpack {
 namespace data {
 
 /**
- *Load the csv file.This class use boost::spirit
- *to implement the parser, please refer to following link
- *http://theboostcpplibraries.com/boost.spirit for quick review.
+ * Load a CSV, TSV or space-separated text file into an Armadillo matrix,
+ * passing tokens through a DatasetMapper.
+ *
+ * The whole file is mapped into memory (or read at once, where memory mapping
+ * is not available) and split into chunks that start at line boundaries.  When
+ * possible, numeric tokens are parsed directly into the matrix by several
+ * threads without creating any std::string objects; only tokens that the
+ * DatasetMapper has to map (i.e. categorical values) are converted to strings
+ * and passed to the mapper, in the order in which they appear in the file.
  */
 class LoadCSV
 {
  public:
   /**
-   * Construct the LoadCSV object on the given file.  This will construct the
-   * rules necessary for loading and attempt to open the file.
+   * Construct the LoadCSV object on the given file.  This will attempt to open
+   * the file and map it into memory.
    */
   LoadCSV(const std::string& file);
 
@@ -77,64 +84,12 @@ class LoadCSV
   template<typename T, typename MapPolicy>
   void GetMatrixSize(size_t& rows, size_t& cols, DatasetMapper<MapPolicy>& info)
   {
-    using namespace boost::spirit;
-
-    // Take a pass through the file.  If the DatasetMapper policy requires it,
-    // we will pass everything string through MapString().  This might be useful
-    // if, e.g., the MapPolicy needs to find which dimensions are numeric or
-    // categorical.
-
-    // Reset to the start of the file.
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-    rows = 0;
-    cols = 0;
-
-    // First, count the number of rows in the file (this is the dimensionality).
-    std::string line;
-    while (std::getline(inFile, line))
-    {
-      ++rows;
-    }
-    info = DatasetMapper<MapPolicy>(rows);
-
-    // Now, jump back to the beginning of the file.
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-    rows = 0;
+    // Each line is a dimension.
+    rows = numLines;
+    cols = (numLines == 0) ? 0 : CountFirstLineTokens();
+    info = DatasetMapper<MapPolicy>(info.Policy(), rows);
 
-    while (std::getline(inFile, line))
-    {
-      ++rows;
-      // Remove whitespace from either side.
-      boost::trim(line);
-
-      if (rows == 1)
-      {
-        // Extract the number of columns.
-        auto findColSize = [&cols](iter_type) { ++cols; };
-        qi::parse(line.begin(), line.end(),
-            stringRule[findColSize] % delimiterRule);
-      }
-
-      // I guess this is technically a second pass, but that's ok... still the
-      // same idea...
-      if (MapPolicy::NeedsFirstPass)
-      {
-        // In this case we must pass everything we parse to the MapPolicy.
-        auto firstPassMap = [&](const iter_type& iter)
-        {
-          std::string str(iter.begin(), iter.end());
-          boost::trim(str);
-
-          info.template MapFirstPass<T>(std::move(str), rows - 1);
-        };
-
-        // Now parse the line.
-        qi::parse(line.begin(), line.end(),
-            stringRule[firstPassMap] % delimiterRule);
-      }
-    }
+    FirstPass<T>(info, false);
   }
 
   /**
@@ -152,222 +107,393 @@ class LoadCSV
                               size_t& cols,
                               DatasetMapper<MapPolicy>& info)
   {
-    using namespace boost::spirit;
+    // Each line is a point.
+    cols = numLines;
+    rows = (numLines == 0) ? 0 : CountFirstLineTokens();
+    info = DatasetMapper<MapPolicy>(info.Policy(), rows);
 
-    // Take a pass through the file.  If the DatasetMapper policy requires it,
-    // we will pass everything string through MapString().  This might be useful
-    // if, e.g., the MapPolicy needs to find which dimensions are numeric or
-    // categorical.
+    FirstPass<T>(info, true);
+  }
 
-    // Reset to the start of the file.
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-    rows = 0;
-    cols = 0;
+ private:
+  /**
+   * Check whether or not the file has successfully opened; throw an exception
+   * if not.
+   */
+  void CheckOpen();
 
-    std::string line;
-    while (std::getline(inFile, line))
+  /**
+   * Split the file into chunks that start at line boundaries, and count the
+   * lines in each chunk.
+   */
+  void FindChunks();
+
+  //! Return true if c is whitespace (as for std::isspace() in the C locale).
+  static bool IsSpace(const char c)
+  {
+    return (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' ||
+        c == '\f');
+  }
+
+  //! Return true if c ends a token.
+  bool IsTokenEnd(const char c) const
+  {
+    return (c == ' ' || c == '\r' || c == '\n' || c == tokenEndChar);
+  }
+
+  /**
+   * Call f(begin, end) for each (trimmed) line of the given chunk.
+   */
+  template<typename FunctionType>
+  void ForEachLine(const size_t chunk, FunctionType&& f) const
+  {
+    const char* p = fileData + chunkBegin[chunk];
+    const char* chunkEnd = fileData + chunkBegin[chunk + 1];
+    while (p < chunkEnd)
     {
-      ++cols;
+      const char* lineEnd = (const char*) std::memchr(p, '\n', chunkEnd - p);
+      if (lineEnd == NULL)
+        lineEnd = chunkEnd;
+
       // Remove whitespace from either side.
-      boost::trim(line);
+      const char* begin = p;
+      const char* end = lineEnd;
+      while (begin < end && IsSpace(*begin))
+        ++begin;
+      while (end > begin && IsSpace(*(end - 1)))
+        --end;
+
+      f(begin, end);
+      p = lineEnd + 1;
+    }
+  }
 
-      if (cols == 1)
+  /**
+   * Split the given line into tokens, calling f(begin, end) for each
+   * (trimmed) token.  Returns false if the line could not be parsed completely.
+   */
+  template<typename FunctionType>
+  bool Tokenize(const char* begin, const char* end, FunctionType&& f) const
+  {
+    const char* p = begin;
+    while (true)
+    {
+      const char* tokenBegin = p;
+      while (p < end && !IsTokenEnd(*p))
+        ++p;
+
+      const char* tokenEnd = p;
+      while (tokenBegin < tokenEnd && IsSpace(*tokenBegin))
+        ++tokenBegin;
+      while (tokenEnd > tokenBegin && IsSpace(*(tokenEnd - 1)))
+        --tokenEnd;
+      f(tokenBegin, tokenEnd);
+
+      if (p == end)
+        return true;
+
+      // Now consume the delimiter.
+      if (delimiter == ' ')
       {
-        // Extract the number of dimensions.
-        auto findRowSize = [&rows](iter_type) { ++rows; };
-        qi::parse(line.begin(), line.end(),
-            stringRule[findRowSize] % delimiterRule);
-
-        // Now that we know the dimensionality, initialize the DatasetMapper.
-        info = DatasetMapper<MapPolicy>(rows);
+        // Any number of spaces.
+        if (*p != ' ')
+          return false;
+        while (p < end && *p == ' ')
+          ++p;
       }
-
-      // If we need to do a first pass for the DatasetMapper, do it.
-      if (MapPolicy::NeedsFirstPass)
+      else
       {
-        size_t dim = 0;
-
-        // In this case we must pass everything we parse to the MapPolicy.
-        auto firstPassMap = [&](const iter_type& iter)
-        {
-          std::string str(iter.begin(), iter.end());
-          boost::trim(str);
-
-          info.template MapFirstPass<T>(std::move(str), dim++);
-        };
-
-        // Now parse the line.
-        qi::parse(line.begin(), line.end(),
-            stringRule[firstPassMap] % delimiterRule);
+        // A single delimiter, possibly with spaces on either side.
+        while (p < end && *p == ' ')
+          ++p;
+        if (p == end || *p != delimiter)
+          return false;
+        ++p;
+        while (p < end && *p == ' ')
+          ++p;
       }
     }
   }
 
- private:
-  using iter_type = boost::iterator_range<std::string::iterator>;
-
   /**
-   * Check whether or not the file has successfully opened; throw an exception
-   * if not.
+   * Count the number of tokens on the first line of the file.
    */
-  void CheckOpen();
+  size_t CountFirstLineTokens() const;
 
   /**
-   * Parse a non-transposed matrix.
-   *
-   * @param inout Matrix to load into.
-   * @param infoSet DatasetMapper object to load with.
+   * Parse a number directly from the given characters.  Only plain decimal
+   * numbers (e.g. "-1.5e3") are accepted; anything else returns false, and must
+   * be given to the DatasetMapper instead.
    */
-  template<typename T, typename PolicyType>
-  void NonTransposeParse(arma::Mat<T>& inout,
-                         DatasetMapper<PolicyType>& infoSet)
+  static bool ParseNumber(const char* begin, const char* end, double& value);
+  static bool ParseNumber(const char* begin, const char* end, float& value);
+
+  //! Integer types are always given to the DatasetMapper.
+  template<typename T>
+  static bool ParseNumber(const char* /* begin */,
+                          const char* /* end */,
+                          T& /* value */)
   {
-    using namespace boost::spirit;
-
-    // Get the size of the matrix.
-    size_t rows, cols;
-    GetMatrixSize<T>(rows, cols, infoSet);
+    return false;
+  }
 
-    // Set up output matrix.
-    inout.set_size(rows, cols);
-    size_t row = 0;
-    size_t col = 0;
+  /**
+   * Return whether numeric tokens in numeric dimensions can be parsed directly,
+   * giving exactly the result that the MapPolicy would give.  This is true for
+   * floating-point matrices loaded with the IncrementPolicy, which only maps
+   * tokens that cannot be read as numbers.
+   */
+  template<typename T, typename MapPolicy>
+  static constexpr bool UseFastPath()
+  {
+    return std::is_floating_point<T>::value &&
+        std::is_same<MapPolicy, IncrementPolicy>::value;
+  }
 
-    // Reset file position.
-    std::string line;
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
+  /**
+   * Take a first pass over the data for the DatasetMapper, if the MapPolicy
+   * needs it.
+   *
+   * @param info DatasetMapper object to use for the first pass.
+   * @param transpose Whether each line is a point (true) or a dimension.
+   */
+  template<typename T, typename MapPolicy>
+  void FirstPass(DatasetMapper<MapPolicy>& info, const bool transpose)
+  {
+    if (!MapPolicy::NeedsFirstPass)
+      return;
 
-    auto setCharClass = [&](iter_type const &iter)
+    if (!UseFastPath<T, MapPolicy>())
     {
-      std::string str(iter.begin(), iter.end());
-      if (str == "\t")
+      // Pass every token to the MapPolicy.
+      size_t line = 0;
+      for (size_t c = 0; c < chunkLines.size(); ++c)
       {
-        str.clear();
+        ForEachLine(c, [&](const char* begin, const char* end)
+        {
+          size_t token = 0;
+          Tokenize(begin, end, [&](const char* tokenBegin,
+                                   const char* tokenEnd)
+          {
+            info.template MapFirstPass<T>(std::string(tokenBegin, tokenEnd),
+                transpose ? token : line);
+            ++token;
+          });
+          ++line;
+        });
       }
-      boost::trim(str);
 
-      inout(row, col++) = infoSet.template MapString<T>(std::move(str), row);
-    };
-
-    while (std::getline(inFile, line))
-    {
-      // Remove whitespace from either side.
-      boost::trim(line);
-
-      // Parse the numbers from a line (ex: 1,2,3,4); if the parser finds a
-      // number it will execute the setNum function.
-      const bool canParse = qi::parse(line.begin(), line.end(),
-          stringRule[setCharClass] % delimiterRule);
+      return;
+    }
 
-      // Make sure we got the right number of rows.
-      if (col != cols)
-      {
-        std::ostringstream oss;
-        oss << "LoadCSV::NonTransposeParse(): wrong number of dimensions ("
-            << col << ") on line " << row << "; should be " << cols
-            << " dimensions.";
-        throw std::runtime_error(oss.str());
-      }
+    // Tokens that are numbers do not affect the IncrementPolicy, unless it is
+    // forcing all mappings; so we only give the policy the first token of each
+    // dimension (which is enough to make the dimension categorical), and the
+    // tokens that are not numbers.  Those are collected in parallel.
+    std::vector<std::vector<std::pair<size_t, std::string>>> unparsed(
+        chunkLines.size());
 
-      if (!canParse)
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t c = 0; c < (omp_size_t) chunkLines.size(); ++c)
+    {
+      size_t line = chunkFirstLine[c];
+      ForEachLine(c, [&](const char* begin, const char* end)
       {
-        std::ostringstream oss;
-        oss << "LoadCSV::NonTransposeParse(): parsing error on line " << col
-            << "!";
-        throw std::runtime_error(oss.str());
-      }
-
-      ++row; col = 0;
+        size_t token = 0;
+        Tokenize(begin, end, [&](const char* tokenBegin, const char* tokenEnd)
+        {
+          const bool firstInDimension = transpose ? (line == 0) : (token == 0);
+          T value;
+          if (firstInDimension || !ParseNumber(tokenBegin, tokenEnd, value))
+          {
+            unparsed[c].push_back(std::make_pair(transpose ? token : line,
+                std::string(tokenBegin, tokenEnd)));
+          }
+          ++token;
+        });
+        ++line;
+      });
     }
+
+    for (size_t c = 0; c < unparsed.size(); ++c)
+      for (size_t i = 0; i < unparsed[c].size(); ++i)
+        info.template MapFirstPass<T>(unparsed[c][i].second,
+            unparsed[c][i].first);
   }
 
   /**
-   * Parse a transposed matrix.
+   * Parse the file into the given matrix.
    *
    * @param inout Matrix to load into.
-   * @param infoSet DatasetMapper to load with.
+   * @param infoSet DatasetMapper object to load with.
+   * @param transpose Whether each line is a point (true) or a dimension.
    */
   template<typename T, typename PolicyType>
-  void TransposeParse(arma::Mat<T>& inout, DatasetMapper<PolicyType>& infoSet)
+  void Parse(arma::Mat<T>& inout,
+             DatasetMapper<PolicyType>& infoSet,
+             const bool transpose)
   {
-    using namespace boost::spirit;
-
-    // Get matrix size.  This also initializes infoSet correctly.
+    // Get the size of the matrix.  This also initializes infoSet correctly.
     size_t rows, cols;
-    GetTransposeMatrixSize<T>(rows, cols, infoSet);
+    if (transpose)
+      GetTransposeMatrixSize<T>(rows, cols, infoSet);
+    else
+      GetMatrixSize<T>(rows, cols, infoSet);
 
-    // Set the matrix size.
     inout.set_size(rows, cols);
-
-    // Initialize auxiliary variables.
-    size_t row = 0;
-    size_t col = 0;
-    std::string line;
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-
-    /**
-     * This is the parse rule for strings.  When we get a string we have to pass
-     * it to the DatasetMapper.
-     */
-    auto parseString = [&](iter_type const &iter)
+    const size_t numTokens = transpose ? rows : cols;
+    const bool fastPath = UseFastPath<T, PolicyType>();
+
+    // Lines holding tokens that must be mapped by the DatasetMapper, and the
+    // first malformed line of each chunk (if any).
+    std::vector<std::vector<size_t>> mapLines(chunkLines.size());
+    std::vector<size_t> errorLine(chunkLines.size(), size_t(-1));
+    std::vector<size_t> errorTokens(chunkLines.size(), 0);
+
+    // Parse all the numbers we can directly into the matrix, in parallel.
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t c = 0; c < (omp_size_t) chunkLines.size(); ++c)
     {
-      // All parsed values must be mapped.
-      std::string str(iter.begin(), iter.end());
-      boost::trim(str);
+      size_t line = chunkFirstLine[c];
+      ForEachLine(c, [&](const char* begin, const char* end)
+      {
+        if (errorLine[c] != size_t(-1))
+          return;
 
-      inout(row, col) = infoSet.template MapString<T>(std::move(str), row);
-      ++row;
-    };
+        size_t token = 0;
+        bool needsMapping = false;
+        const bool canParse = Tokenize(begin, end,
+            [&](const char* tokenBegin, const char* tokenEnd)
+        {
+          if (token < numTokens)
+          {
+            const size_t dim = transpose ? token : line;
+            T& value = transpose ? inout.at(token, line) :
+                inout.at(line, token);
+            if (!fastPath || infoSet.Type(dim) != Datatype::numeric ||
+                !ParseNumber(tokenBegin, tokenEnd, value))
+              needsMapping = true;
+          }
+          ++token;
+        });
+
+        if (!canParse || token != numTokens)
+        {
+          errorLine[c] = line;
+          errorTokens[c] = canParse ? token : size_t(-1);
+          return;
+        }
+
+        if (needsMapping)
+          mapLines[c].push_back(line);
+        ++line;
+      });
+    }
 
-    while (std::getline(inFile, line))
+    // Report the first malformed line in the file.
+    const char* caller = transpose ? "LoadCSV::TransposeParse()" :
+        "LoadCSV::NonTransposeParse()";
+    for (size_t c = 0; c < errorLine.size(); ++c)
     {
-      // Remove whitespace from either side.
-      boost::trim(line);
-
-      // Reset the row we are looking at.  (Remember this is transposed.)
-      row = 0;
+      if (errorLine[c] == size_t(-1))
+        continue;
 
-      // Now use boost::spirit to parse the characters of the line;
-      // parseString() will be called when a token is detected.
-      const bool canParse = qi::parse(line.begin(), line.end(),
-          stringRule[parseString] % delimiterRule);
-
-      // Make sure we got the right number of rows.
-      if (row != rows)
+      std::ostringstream oss;
+      if (errorTokens[c] == size_t(-1))
       {
-        std::ostringstream oss;
-        oss << "LoadCSV::TransposeParse(): wrong number of dimensions (" << row
-            << ") on line " << col << "; should be " << rows << " dimensions.";
-        throw std::runtime_error(oss.str());
+        oss << caller << ": parsing error on line " << errorLine[c] << "!";
       }
-
-      if (!canParse)
+      else
       {
-        std::ostringstream oss;
-        oss << "LoadCSV::TransposeParse(): parsing error on line " << col
-            << "!";
-        throw std::runtime_error(oss.str());
+        oss << caller << ": wrong number of dimensions (" << errorTokens[c]
+            << ") on line " << errorLine[c] << "; should be " << numTokens
+            << " dimensions.";
       }
+      throw std::runtime_error(oss.str());
+    }
 
-      // Increment the column index.
-      ++col;
+    // Now map the remaining tokens.  This is done in the order of the file, so
+    // that the mappings are the same as if the file was parsed sequentially.
+    for (size_t c = 0; c < mapLines.size(); ++c)
+    {
+      size_t i = 0;
+      size_t line = chunkFirstLine[c];
+      ForEachLine(c, [&](const char* begin, const char* end)
+      {
+        if (i < mapLines[c].size() && mapLines[c][i] == line)
+        {
+          size_t token = 0;
+          Tokenize(begin, end, [&](const char* tokenBegin,
+                                   const char* tokenEnd)
+          {
+            const size_t dim = transpose ? token : line;
+            T& value = transpose ? inout.at(token, line) :
+                inout.at(line, token);
+            if (!fastPath || infoSet.Type(dim) != Datatype::numeric ||
+                !ParseNumber(tokenBegin, tokenEnd, value))
+            {
+              value = infoSet.template MapString<T>(
+                  std::string(tokenBegin, tokenEnd), dim);
+            }
+            ++token;
+          });
+          ++i;
+        }
+        ++line;
+      });
     }
   }
 
-  //! Spirit rule for parsing.
-  boost::spirit::qi::rule<std::string::iterator, iter_type()> stringRule;
-  //! Spirit rule for delimiters (i.e. ',' for CSVs).
-  boost::spirit::qi::rule<std::string::iterator, iter_type()> delimiterRule;
+  /**
+   * Parse a non-transposed matrix.
+   *
+   * @param inout Matrix to load into.
+   * @param infoSet DatasetMapper object to load with.
+   */
+  template<typename T, typename PolicyType>
+  void NonTransposeParse(arma::Mat<T>& inout,
+                         DatasetMapper<PolicyType>& infoSet)
+  {
+    Parse(inout, infoSet, false);
+  }
+
+  /**
+   * Parse a transposed matrix.
+   *
+   * @param inout Matrix to load into.
+   * @param infoSet DatasetMapper to load with.
+   */
+  template<typename T, typename PolicyType>
+  void TransposeParse(arma::Mat<T>& inout, DatasetMapper<PolicyType>& infoSet)
+  {
+    Parse(inout, infoSet, true);
+  }
 
   //! Extension (type) of file.
   std::string extension;
   //! Name of file.
   std::string filename;
-  //! Opened stream for reading.
-  std::ifstream inFile;
+
+  //! The delimiter between tokens (' ' means any number of spaces).
+  char delimiter;
+  //! The character (besides whitespace) that ends a token.
+  char tokenEndChar;
+
+  //! The file, mapped into memory.
+  MappedFile mappedFile;
+  //! Contents of the file.
+  const char* fileData;
+  //! Size of the file in bytes.
+  size_t fileSize;
+
+  //! Byte offset of the beginning of each chunk, plus the end of the file.
+  std::vector<size_t> chunkBegin;
+  //! The number of lines in each chunk.
+  std::vector<size_t> chunkLines;
+  //! The index of the first line of each chunk.
+  std::vector<size_t> chunkFirstLine;
+  //! The total number of lines in the file.
+  size_t numLines;
 };
 
 } // namespace data
@@ -21,6 +21,7 @@
 #include "load_csv.hpp"
 #include "load.hpp"
 #include "extension.hpp"
+#include "mapped_matrix.hpp"
 
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/tokenizer.hpp>
@@ -107,6 +108,43 @@ bool Load(const std::string& filename,
     return false;
   }
 
+  // Our own memory-mappable format is not handled by Armadillo.  It already
+  // holds the matrix the way mlpack uses it, so only transpose if we were asked
+  // not to.
+  if (extension == "mmat")
+  {
+    stream.close();
+    Log::Info << "Loading '" << filename << "' as memory-mappable binary "
+        << "data.  " << std::flush;
+
+    MappedFile file;
+    MappedMatrixHeader header;
+    std::string error = "cannot open file";
+    if (!file.Open(filename) || !ReadMappedMatrixHeader(file, header, error))
+    {
+      Log::Info << std::endl;
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << "Loading from '" << filename << "' failed: " << error
+            << "." << std::endl;
+      else
+        Log::Warn << "Loading from '" << filename << "' failed: " << error
+            << "." << std::endl;
+
+      return false;
+    }
+
+    CopyMappedMatrix(file, header, matrix);
+    Log::Info << "Size is " << (transpose ? matrix.n_rows : matrix.n_cols)
+        << " x " << (transpose ? matrix.n_cols : matrix.n_rows) << ".\n";
+
+    if (!transpose)
+      inplace_transpose(matrix);
+
+    Timer::Stop("loading_data");
+    return true;
+  }
+
   bool unknownType = false;
   arma::file_type loadType;
   std::string stringType;
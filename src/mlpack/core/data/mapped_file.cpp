@@ -0,0 +1,141 @@
+/**
+ * @file mapped_file.cpp
+ *
+ * Implementation of the MappedFile class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "mapped_file.hpp"
+
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+MappedFile::MappedFile() :
+    data(NULL),
+    size(0),
+    isOpen(false),
+    isMapped(false)
+{
+  // Nothing to do.
+}
+
+MappedFile::~MappedFile()
+{
+  Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) :
+    data(other.data),
+    size(other.size),
+    isOpen(other.isOpen),
+    isMapped(other.isMapped),
+    buffer(std::move(other.buffer))
+{
+  other.data = NULL;
+  other.size = 0;
+  other.isOpen = false;
+  other.isMapped = false;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other)
+{
+  if (this != &other)
+  {
+    Close();
+
+    data = other.data;
+    size = other.size;
+    isOpen = other.isOpen;
+    isMapped = other.isMapped;
+    buffer = std::move(other.buffer);
+
+    other.data = NULL;
+    other.size = 0;
+    other.isOpen = false;
+    other.isMapped = false;
+  }
+
+  return *this;
+}
+
+bool MappedFile::Open(const std::string& filename, const bool sequential)
+{
+  Close();
+
+#ifndef _WIN32
+  // Attempt to map the file into memory.  The mapping is shared, so that other
+  // processes mapping the same file use the same pages.
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd != -1)
+  {
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode))
+    {
+      isOpen = true;
+      size = (size_t) fileStat.st_size;
+      if (size > 0)
+      {
+        void* mapped = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped != MAP_FAILED)
+        {
+          if (sequential)
+            madvise(mapped, size, MADV_SEQUENTIAL);
+          data = (const char*) mapped;
+          isMapped = true;
+        }
+      }
+    }
+    close(fd);
+
+    if (isMapped || (isOpen && size == 0))
+      return true;
+  }
+#endif
+
+  // If the file could not be mapped, read the whole thing at once instead.
+  std::ifstream stream(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+  {
+    isOpen = false;
+    size = 0;
+    return false;
+  }
+
+  buffer.assign(std::istreambuf_iterator<char>(stream),
+      std::istreambuf_iterator<char>());
+  data = buffer.data();
+  size = buffer.size();
+  isOpen = true;
+  return true;
+}
+
+void MappedFile::Close()
+{
+#ifndef _WIN32
+  if (isMapped)
+    munmap((void*) data, size);
+#endif
+
+  buffer.clear();
+  buffer.shrink_to_fit();
+  data = NULL;
+  size = 0;
+  isOpen = false;
+  isMapped = false;
+}
+
+} // namespace data
+} // namespace mlpack
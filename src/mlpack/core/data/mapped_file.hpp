@@ -0,0 +1,88 @@
+/**
+ * @file mapped_file.hpp
+ *
+ * A read-only view of a whole file, which is memory-mapped where the platform
+ * allows it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_FILE_HPP
+#define MLPACK_CORE_DATA_MAPPED_FILE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A MappedFile gives read-only access to the contents of a file.  On POSIX
+ * systems the file is mapped into memory with mmap(), so opening it is nearly
+ * free, pages are only read from disk when they are touched, and several
+ * processes mapping the same file share the same physical memory.  Where
+ * memory mapping is not available, the file is read into a buffer instead.
+ *
+ * The data stays valid until the MappedFile is closed or destroyed.  Mapped
+ * data is aligned to a page boundary.
+ */
+class MappedFile
+{
+ public:
+  //! Create an empty MappedFile.
+  MappedFile();
+
+  //! Unmap the file, if it is open.
+  ~MappedFile();
+
+  //! Take ownership of the mapping held by another MappedFile.
+  MappedFile(MappedFile&& other);
+
+  //! Take ownership of the mapping held by another MappedFile.
+  MappedFile& operator=(MappedFile&& other);
+
+  /**
+   * Open the given file and map it into memory (or read it, if it can't be
+   * mapped).  Any file that is already open is closed first.
+   *
+   * @param filename Name of file to open.
+   * @param sequential If true, hint that the file will be read sequentially,
+   *     so that the operating system reads ahead more aggressively.
+   * @return false if the file could not be opened.
+   */
+  bool Open(const std::string& filename, const bool sequential = false);
+
+  //! Unmap the file and release any memory held.
+  void Close();
+
+  //! Get the contents of the file.
+  const char* Data() const { return data; }
+  //! Get the size of the file in bytes.
+  size_t Size() const { return size; }
+  //! Return whether or not a file is open.
+  bool IsOpen() const { return isOpen; }
+  //! Return whether or not the file is actually memory-mapped.
+  bool IsMapped() const { return isMapped; }
+
+ private:
+  // Copying would unmap the file twice.
+  MappedFile(const MappedFile&);
+  MappedFile& operator=(const MappedFile&);
+
+  //! The contents of the file.
+  const char* data;
+  //! The size of the file in bytes.
+  size_t size;
+  //! Whether or not a file is open.
+  bool isOpen;
+  //! Whether data is memory-mapped (otherwise it points into buffer).
+  bool isMapped;
+  //! Buffer holding the file, if it could not be memory-mapped.
+  std::vector<char> buffer;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,76 @@
+/**
+ * @file mapped_matrix.cpp
+ *
+ * Validation of the header of memory-mappable matrix files.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "mapped_matrix.hpp"
+
+namespace mlpack {
+namespace data {
+
+bool CheckMappedMatrixHeader(const MappedMatrixHeader& header,
+                             std::string& error)
+{
+  if (std::memcmp(header.magic, "MLPKMMAT", 8) != 0)
+  {
+    error = "file is not a memory-mappable matrix";
+    return false;
+  }
+
+  if (header.version != 1)
+  {
+    error = "unsupported version of the memory-mappable matrix format";
+    return false;
+  }
+
+  if (header.byteOrder != 0x01020304)
+  {
+    error = "file was written on a machine with a different byte order";
+    return false;
+  }
+
+  if (header.elemKind > 2 || (header.elemSize != 4 && header.elemSize != 8))
+  {
+    error = "unsupported element type";
+    return false;
+  }
+
+  return true;
+}
+
+bool ReadMappedMatrixHeader(const MappedFile& file,
+                            MappedMatrixHeader& header,
+                            std::string& error)
+{
+  static_assert(sizeof(MappedMatrixHeader) == 64,
+      "MappedMatrixHeader must be 64 bytes long");
+
+  if (file.Size() < sizeof(MappedMatrixHeader))
+  {
+    error = "file is too small to be a memory-mappable matrix";
+    return false;
+  }
+
+  std::memcpy(&header, file.Data(), sizeof(MappedMatrixHeader));
+  if (!CheckMappedMatrixHeader(header, error))
+    return false;
+
+  // Make sure the elements are all there (and that the size doesn't overflow).
+  const uint64_t available = (file.Size() - sizeof(MappedMatrixHeader)) /
+      header.elemSize;
+  if (header.nCols != 0 && header.nRows > available / header.nCols)
+  {
+    error = "file is truncated";
+    return false;
+  }
+
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
@@ -0,0 +1,199 @@
+/**
+ * @file mapped_matrix.hpp
+ *
+ * A binary matrix format that can be memory-mapped and used directly as an
+ * Armadillo matrix, without reading it into memory first.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/log.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+#include "mapped_file.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The header of a memory-mappable matrix file (extension .mmat).  The file
+ * consists of this 64-byte header, followed directly by the elements of the
+ * matrix in column-major order, in native byte order.  Because the header is 64
+ * bytes long and mappings are page-aligned, the elements are aligned to 64
+ * bytes in memory.
+ *
+ * The matrix stored is the matrix as mlpack uses it: each column is one point.
+ * Seen as a dataset file with one point per row (like a CSV), the data is
+ * therefore stored row-major, and data::Load() and data::Save() with their
+ * default transpose = true do not need to transpose anything.
+ */
+struct MappedMatrixHeader
+{
+  //! The string "MLPKMMAT".
+  char magic[8];
+  //! The version of the format (currently 1).
+  uint32_t version;
+  //! Set to 0x01020304, to detect files written with a different byte order.
+  uint32_t byteOrder;
+  //! The kind of element: 0 for floating point, 1 for signed integers, and 2
+  //! for unsigned integers.
+  uint32_t elemKind;
+  //! The size of each element in bytes.
+  uint32_t elemSize;
+  //! The number of rows of the matrix (the dimensionality of the data).
+  uint64_t nRows;
+  //! The number of columns of the matrix (the number of points).
+  uint64_t nCols;
+  //! Unused; pads the header to 64 bytes.
+  char padding[24];
+};
+
+//! The kind of element stored in a MappedMatrixHeader, for a given type.
+template<typename eT>
+struct MappedElemKind
+{
+  static const uint32_t value = std::is_floating_point<eT>::value ? 0 :
+      (std::is_signed<eT>::value ? 1 : 2);
+};
+
+/**
+ * Fill a header for a matrix of the given size and element type.
+ */
+template<typename eT>
+MappedMatrixHeader MakeMappedMatrixHeader(const size_t nRows,
+                                          const size_t nCols);
+
+/**
+ * Check that the given header is valid and describes a matrix with a supported
+ * element type.  If it is not valid, an explanation is stored in error.
+ *
+ * @param header Header to check.
+ * @param error Reason why the header is not valid.
+ * @return Whether or not the header is valid.
+ */
+bool CheckMappedMatrixHeader(const MappedMatrixHeader& header,
+                             std::string& error);
+
+/**
+ * Check that the given file starts with a valid header, and that it is large
+ * enough to hold the matrix that the header describes.  If it is not valid, an
+ * explanation is stored in error.
+ *
+ * @param file File to check.
+ * @param header Header of the file, if it is valid.
+ * @param error Reason why the file is not valid.
+ * @return Whether or not the file is a valid memory-mappable matrix file.
+ */
+bool ReadMappedMatrixHeader(const MappedFile& file,
+                            MappedMatrixHeader& header,
+                            std::string& error);
+
+/**
+ * Copy the matrix held in a valid memory-mappable matrix file into the given
+ * matrix, converting the elements to eT if necessary.
+ *
+ * @param file File holding the matrix.
+ * @param header Header of the file, as given by ReadMappedMatrixHeader().
+ * @param matrix Matrix to copy into.
+ */
+template<typename eT>
+void CopyMappedMatrix(const MappedFile& file,
+                      const MappedMatrixHeader& header,
+                      arma::Mat<eT>& matrix);
+
+/**
+ * Write the given matrix to the given stream in the memory-mappable binary
+ * format.  The stream should be opened in binary mode.
+ *
+ * @param stream Stream to write to.
+ * @param matrix Matrix to write.
+ * @return Whether or not the write succeeded.
+ */
+template<typename eT>
+bool SaveMappedMatrix(std::ostream& stream, const arma::Mat<eT>& matrix);
+
+/**
+ * A MappedMatrix holds a matrix stored in the memory-mappable binary format
+ * (.mmat; see MappedMatrixHeader) and exposes it as a read-only Armadillo
+ * matrix, using Armadillo's auxiliary memory constructor.  "Loading" a matrix
+ * this way takes constant time, and no memory is used for the matrix except
+ * for the pages of the file that are actually touched, which are shared with
+ * any other process that maps the same file.  This is useful for large
+ * reference sets that several processes on one host use at the same time,
+ * e.g., for nearest neighbor search or k-means.
+ *
+ * The element type of the file must be exactly eT; use data::Load() to convert
+ * a file to another type.  Files can be written with data::Save(), using the
+ * extension .mmat.
+ *
+ * @code
+ * data::Save("reference.mmat", dataset);
+ *
+ * // Later, perhaps in another process...
+ * data::MappedMatrix<double> reference("reference.mmat", true);
+ * arma::vec centroid = arma::mean(reference.Matrix(), 1);
+ * @endcode
+ *
+ * The matrix returned by Matrix() is only valid for the lifetime of the
+ * MappedMatrix object, and must not be modified (the mapping is read-only).
+ * Where memory mapping is not available, the file is read into memory instead.
+ *
+ * @tparam eT Type of element held in the matrix.
+ */
+template<typename eT>
+class MappedMatrix
+{
+ public:
+  //! Create an empty MappedMatrix.
+  MappedMatrix() : matrix(new arma::Mat<eT>()) { }
+
+  /**
+   * Map the given file.  On failure, a warning is issued (or an exception is
+   * thrown, if fatal is true), and the matrix is left empty.
+   *
+   * @param filename Name of .mmat file to map.
+   * @param fatal If an error should be reported as fatal (default false).
+   */
+  MappedMatrix(const std::string& filename, const bool fatal = false);
+
+  /**
+   * Map the given file, unmapping any file that was previously mapped.  On
+   * failure, a warning is issued (or an exception is thrown, if fatal is true),
+   * and the matrix is left empty.
+   *
+   * @param filename Name of .mmat file to map.
+   * @param fatal If an error should be reported as fatal (default false).
+   * @return Boolean value indicating success or failure of mapping.
+   */
+  bool Load(const std::string& filename, const bool fatal = false);
+
+  //! Get the matrix.  This refers to the mapped memory of the file.
+  const arma::Mat<eT>& Matrix() const { return *matrix; }
+
+  //! Return whether or not the file is actually memory-mapped.
+  bool IsMapped() const { return file.IsMapped(); }
+
+ private:
+  //! The mapped file.
+  MappedFile file;
+  //! An alias of the elements in the mapped file.  This is held by pointer,
+  //! since an alias can't be re-pointed at new memory by assignment.
+  std::unique_ptr<arma::Mat<eT>> matrix;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "mapped_matrix_impl.hpp"
+
+#endif
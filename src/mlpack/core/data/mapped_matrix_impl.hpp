@@ -0,0 +1,145 @@
+/**
+ * @file mapped_matrix_impl.hpp
+ *
+ * Implementation of the memory-mappable binary matrix format.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mapped_matrix.hpp"
+
+#include <cstring>
+
+namespace mlpack {
+namespace data {
+
+template<typename eT>
+MappedMatrixHeader MakeMappedMatrixHeader(const size_t nRows,
+                                          const size_t nCols)
+{
+  MappedMatrixHeader header;
+  std::memset(&header, 0, sizeof(MappedMatrixHeader));
+  std::memcpy(header.magic, "MLPKMMAT", 8);
+  header.version = 1;
+  header.byteOrder = 0x01020304;
+  header.elemKind = MappedElemKind<eT>::value;
+  header.elemSize = sizeof(eT);
+  header.nRows = nRows;
+  header.nCols = nCols;
+
+  return header;
+}
+
+namespace details {
+
+/**
+ * Copy the elements of the file, which have type FileType, into the given
+ * matrix.
+ */
+template<typename FileType, typename eT>
+void CopyMappedElements(const MappedFile& file,
+                        const MappedMatrixHeader& header,
+                        arma::Mat<eT>& matrix)
+{
+  const FileType* elements = (const FileType*) (file.Data() +
+      sizeof(MappedMatrixHeader));
+  const arma::Mat<FileType> alias(const_cast<FileType*>(elements),
+      header.nRows, header.nCols, false, true);
+  matrix = arma::conv_to<arma::Mat<eT>>::from(alias);
+}
+
+} // namespace details
+
+template<typename eT>
+void CopyMappedMatrix(const MappedFile& file,
+                      const MappedMatrixHeader& header,
+                      arma::Mat<eT>& matrix)
+{
+  if (header.elemKind == 0 && header.elemSize == 4)
+    details::CopyMappedElements<float>(file, header, matrix);
+  else if (header.elemKind == 0 && header.elemSize == 8)
+    details::CopyMappedElements<double>(file, header, matrix);
+  else if (header.elemKind == 1 && header.elemSize == 4)
+    details::CopyMappedElements<int32_t>(file, header, matrix);
+  else if (header.elemKind == 1 && header.elemSize == 8)
+    details::CopyMappedElements<int64_t>(file, header, matrix);
+  else if (header.elemKind == 2 && header.elemSize == 4)
+    details::CopyMappedElements<uint32_t>(file, header, matrix);
+  else if (header.elemKind == 2 && header.elemSize == 8)
+    details::CopyMappedElements<uint64_t>(file, header, matrix);
+  else
+    throw std::invalid_argument("CopyMappedMatrix(): unsupported element "
+        "type");
+}
+
+template<typename eT>
+bool SaveMappedMatrix(std::ostream& stream, const arma::Mat<eT>& matrix)
+{
+  const MappedMatrixHeader header = MakeMappedMatrixHeader<eT>(matrix.n_rows,
+      matrix.n_cols);
+  stream.write((const char*) &header, sizeof(MappedMatrixHeader));
+  stream.write((const char*) matrix.memptr(),
+      std::streamsize(sizeof(eT) * matrix.n_elem));
+
+  return stream.good();
+}
+
+template<typename eT>
+MappedMatrix<eT>::MappedMatrix(const std::string& filename, const bool fatal) :
+    matrix(new arma::Mat<eT>())
+{
+  Load(filename, fatal);
+}
+
+template<typename eT>
+bool MappedMatrix<eT>::Load(const std::string& filename, const bool fatal)
+{
+  // Drop the alias before the memory it points to goes away.
+  matrix.reset(new arma::Mat<eT>());
+  file.Close();
+
+  std::string error;
+  MappedMatrixHeader header;
+  if (!file.Open(filename))
+  {
+    error = "cannot open file";
+  }
+  else if (ReadMappedMatrixHeader(file, header, error))
+  {
+    if (header.elemKind != MappedElemKind<eT>::value ||
+        header.elemSize != sizeof(eT))
+      error = "element type of file does not match element type of matrix";
+  }
+
+  if (!error.empty())
+  {
+    file.Close();
+    if (fatal)
+      Log::Fatal << "Cannot map '" << filename << "': " << error << "."
+          << std::endl;
+    else
+      Log::Warn << "Cannot map '" << filename << "': " << error << "; load "
+          << "failed." << std::endl;
+
+    return false;
+  }
+
+  // The mapping is read-only, but Armadillo's auxiliary memory constructor
+  // wants a non-const pointer; only const access is given out, though.
+  eT* elements = (eT*) (file.Data() + sizeof(MappedMatrixHeader));
+  matrix.reset(new arma::Mat<eT>(elements, header.nRows, header.nCols, false,
+      true));
+
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -15,6 +15,7 @@
 // In case it hasn't already been included.
 #include "save.hpp"
 #include "extension.hpp"
+#include "mapped_matrix.hpp"
 
 #include <boost/serialization/serialization.hpp>
 #include <boost/archive/xml_oarchive.hpp>
@@ -64,6 +65,26 @@ bool Save(const std::string& filename,
     return false;
   }
 
+  // Only some element types can be stored in the memory-mappable format; check
+  // the header the same way Load() will, before creating the file.
+  if (extension == "mmat")
+  {
+    std::string error;
+    if (!CheckMappedMatrixHeader(MakeMappedMatrixHeader<eT>(matrix.n_rows,
+        matrix.n_cols), error))
+    {
+      Timer::Stop("saving_data");
+      if (fatal)
+        Log::Fatal << "Cannot save '" << filename << "': " << error << "."
+            << std::endl;
+      else
+        Log::Warn << "Cannot save '" << filename << "': " << error << "; save "
+            << "failed." << std::endl;
+
+      return false;
+    }
+  }
+
   // Catch errors opening the file.
   std::fstream stream;
 #ifdef  _WIN32 // Always open in binary mode on Windows.
@@ -84,6 +105,29 @@ bool Save(const std::string& filename,
     return false;
   }
 
+  // Our own memory-mappable format stores the matrix the way mlpack uses it, so
+  // it only needs to be transposed if we were asked not to transpose.
+  if (extension == "mmat")
+  {
+    Log::Info << "Saving memory-mappable binary data to '" << filename << "'."
+        << std::endl;
+
+    const bool success = transpose ? SaveMappedMatrix(stream, matrix) :
+        SaveMappedMatrix(stream, arma::Mat<eT>(trans(matrix)));
+    Timer::Stop("saving_data");
+    if (!success)
+    {
+      if (fatal)
+        Log::Fatal << "Save to '" << filename << "' failed." << std::endl;
+      else
+        Log::Warn << "Save to '" << filename << "' failed." << std::endl;
+
+      return false;
+    }
+
+    return true;
+  }
+
   bool unknownType = false;
   arma::file_type saveType;
   std::string stringType;
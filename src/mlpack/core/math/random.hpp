@@ -30,6 +30,75 @@ extern MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist;
 // Global normal distribution.
 extern MLPACK_EXPORT std::normal_distribution<> randNormalDist;
 
+/**
+ * Get the per-thread generator override.  If it is not NULL, Random(),
+ * RandInt(), RandIndex() and RandNormal() called from this thread draw from it
+ * instead of the global randGen.  This should generally be managed through a
+ * ScopedRandomGenerator object.
+ */
+inline std::mt19937*& ThreadRandGenOverride()
+{
+  static thread_local std::mt19937* generator = NULL;
+  return generator;
+}
+
+/**
+ * Get the random number generator used by the random functions in the calling
+ * thread.  This is randGen, unless the thread has installed its own generator
+ * with a ScopedRandomGenerator.
+ */
+inline std::mt19937& RandGen()
+{
+  std::mt19937* generator = ThreadRandGenOverride();
+  return (generator == NULL) ? randGen : *generator;
+}
+
+/**
+ * Get the normal distribution used by RandNormal() with a per-thread generator.
+ * std::normal_distribution caches a second value between calls, so the global
+ * randNormalDist can't be shared with other threads' generators.
+ */
+inline std::normal_distribution<>& ThreadRandNormalDist()
+{
+  static thread_local std::normal_distribution<> distribution;
+  return distribution;
+}
+
+/**
+ * While in scope, make Random(), RandInt(), RandIndex() and RandNormal() in the
+ * calling thread draw from the given generator instead of the global randGen.  This allows parallel code
+ * to give each task its own deterministically-seeded random stream, so that
+ * results do not depend on the number of threads or on scheduling order.  The
+ * previous generator (if any) is restored on destruction.
+ */
+class ScopedRandomGenerator
+{
+ public:
+  //! Install the given generator for the calling thread.
+  ScopedRandomGenerator(std::mt19937& generator) :
+      previous(ThreadRandGenOverride())
+  {
+    ThreadRandGenOverride() = &generator;
+    // Don't return a normal value cached from another generator.
+    ThreadRandNormalDist().reset();
+  }
+
+  //! Restore the previous generator.
+  ~ScopedRandomGenerator()
+  {
+    ThreadRandGenOverride() = previous;
+    ThreadRandNormalDist().reset();
+  }
+
+ private:
+  // Non-copyable.
+  ScopedRandomGenerator(const ScopedRandomGenerator&);
+  ScopedRandomGenerator& operator=(const ScopedRandomGenerator&);
+
+  //! The generator that was installed before this one.
+  std::mt19937* previous;
+};
+
 /**
  * Set the random seed used by the random functions (Random() and RandInt()).
  * The seed is casted to a 32-bit integer before being given to the random
@@ -70,7 +139,7 @@ inline void FixedRandomSeed()
  */
 inline double Random()
 {
-  return randUniformDist(randGen);
+  return randUniformDist(RandGen());
 }
 
 /**
@@ -78,7 +147,7 @@ inline double Random()
  */
 inline double Random(const double lo, const double hi)
 {
-  return lo + (hi - lo) * randUniformDist(randGen);
+  return lo + (hi - lo) * randUniformDist(RandGen());
 }
 
 /**
@@ -97,7 +166,7 @@ inline double RandBernoulli(const double input)
  */
 inline int RandInt(const int hiExclusive)
 {
-  return (int) std::floor((double) hiExclusive * randUniformDist(randGen));
+  return (int) std::floor((double) hiExclusive * randUniformDist(RandGen()));
 }
 
 /**
@@ -106,7 +175,19 @@ inline int RandInt(const int hiExclusive)
 inline int RandInt(const int lo, const int hiExclusive)
 {
   return lo + (int) std::floor((double) (hiExclusive - lo)
-                               * randUniformDist(randGen));
+                               * randUniformDist(RandGen()));
+}
+
+/**
+ * Generates a uniform random index in [0, hiExclusive).  Unlike RandInt(), this
+ * works when hiExclusive is larger than INT_MAX.
+ */
+inline size_t RandIndex(const size_t hiExclusive)
+{
+  const size_t index = (size_t) std::floor((double) hiExclusive *
+      randUniformDist(RandGen()));
+  // Rounding could give hiExclusive for very large ranges.
+  return std::min(index, hiExclusive - 1);
 }
 
 /**
@@ -114,7 +195,9 @@ inline int RandInt(const int lo, const int hiExclusive)
  */
 inline double RandNormal()
 {
-  return randNormalDist(randGen);
+  std::mt19937* generator = ThreadRandGenOverride();
+  return (generator == NULL) ? randNormalDist(randGen) :
+      ThreadRandNormalDist()(*generator);
 }
 
 /**
@@ -126,7 +209,7 @@ inline double RandNormal()
  */
 inline double RandNormal(const double mean, const double variance)
 {
-  return variance * randNormalDist(randGen) + mean;
+  return variance * RandNormal() + mean;
 }
 
 /**
@@ -57,6 +57,15 @@ class RangeType
    */
   inline RangeType(const T lo, const T hi);
 
+  /**
+   * Convert a range holding another type of element (such as the distances
+   * between the nodes of a tree built on float data) to this type.
+   *
+   * @param other Range to convert.
+   */
+  template<typename U>
+  inline RangeType(const RangeType<U>& other);
+
   //! Get the lower bound.
   inline T Lo() const { return lo; }
   //! Modify the lower bound.
@@ -18,6 +18,172 @@
 namespace mlpack {
 namespace metric {
 
+/**
+ * The element type in which the distance between a VecTypeA and a VecTypeB is
+ * accumulated: float for two float vectors, and double if either is double.
+ */
+template<typename VecTypeA, typename VecTypeB>
+using LMetricSumType = decltype(typename VecTypeA::elem_type() -
+    typename VecTypeB::elem_type());
+
+/**
+ * Whether the raw-memory kernels below can be used for a VecTypeA and a
+ * VecTypeB: both must be dense contiguous vectors of floating-point elements.
+ */
+template<typename VecTypeA, typename VecTypeB>
+struct UseLMetricKernel
+{
+  static const bool value = IsContiguousVector<VecTypeA>::value &&
+      IsContiguousVector<VecTypeB>::value &&
+      std::is_floating_point<typename VecTypeA::elem_type>::value &&
+      std::is_floating_point<typename VecTypeB::elem_type>::value;
+};
+
+/**
+ * Check that two vectors given to a raw-memory kernel have the same size, as
+ * Armadillo would do for an expression.
+ */
+template<typename VecTypeA, typename VecTypeB>
+inline void CheckSameSize(const VecTypeA& a, const VecTypeB& b)
+{
+  if (a.n_elem != b.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "LMetric::Evaluate(): vectors have different sizes (" << a.n_elem
+        << " and " << b.n_elem << ")";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+// The kernels below are used when both vectors are dense and contiguous (which
+// is the case for the columns of a dataset) and hold floating-point values.
+// They read both vectors directly and keep four independent sums, so that the
+// additions do not all wait on each other and the compiler can vectorize the
+// loop; Armadillo expressions go through its generic element accessors
+// instead.  Other vector types (sparse vectors, rows of a matrix, expressions,
+// integers) use Armadillo.
+
+//! Sum of the absolute differences of the elements of a and b.
+template<typename VecTypeA, typename VecTypeB>
+inline LMetricSumType<VecTypeA, VecTypeB> AbsoluteDifferenceSum(
+    const VecTypeA& a,
+    const VecTypeB& b,
+    const typename std::enable_if_t<
+        UseLMetricKernel<VecTypeA, VecTypeB>::value>* = 0)
+{
+  CheckSameSize(a, b);
+  const typename VecTypeA::elem_type* aMem = a.colptr(0);
+  const typename VecTypeB::elem_type* bMem = b.colptr(0);
+  const size_t n = a.n_elem;
+
+  LMetricSumType<VecTypeA, VecTypeB> s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    s0 += std::abs(aMem[i] - bMem[i]);
+    s1 += std::abs(aMem[i + 1] - bMem[i + 1]);
+    s2 += std::abs(aMem[i + 2] - bMem[i + 2]);
+    s3 += std::abs(aMem[i + 3] - bMem[i + 3]);
+  }
+  for (; i < n; ++i)
+    s0 += std::abs(aMem[i] - bMem[i]);
+
+  return (s0 + s1) + (s2 + s3);
+}
+
+template<typename VecTypeA, typename VecTypeB>
+inline typename VecTypeA::elem_type AbsoluteDifferenceSum(
+    const VecTypeA& a,
+    const VecTypeB& b,
+    const typename std::enable_if_t<
+        !UseLMetricKernel<VecTypeA, VecTypeB>::value>* = 0)
+{
+  return arma::accu(abs(a - b));
+}
+
+//! Sum of the squared differences of the elements of a and b.
+template<typename VecTypeA, typename VecTypeB>
+inline LMetricSumType<VecTypeA, VecTypeB> SquaredDifferenceSum(
+    const VecTypeA& a,
+    const VecTypeB& b,
+    const typename std::enable_if_t<
+        UseLMetricKernel<VecTypeA, VecTypeB>::value>* = 0)
+{
+  CheckSameSize(a, b);
+  const typename VecTypeA::elem_type* aMem = a.colptr(0);
+  const typename VecTypeB::elem_type* bMem = b.colptr(0);
+  const size_t n = a.n_elem;
+
+  LMetricSumType<VecTypeA, VecTypeB> s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const LMetricSumType<VecTypeA, VecTypeB> d0 = aMem[i] - bMem[i];
+    const LMetricSumType<VecTypeA, VecTypeB> d1 = aMem[i + 1] - bMem[i + 1];
+    const LMetricSumType<VecTypeA, VecTypeB> d2 = aMem[i + 2] - bMem[i + 2];
+    const LMetricSumType<VecTypeA, VecTypeB> d3 = aMem[i + 3] - bMem[i + 3];
+    s0 += d0 * d0;
+    s1 += d1 * d1;
+    s2 += d2 * d2;
+    s3 += d3 * d3;
+  }
+  for (; i < n; ++i)
+  {
+    const LMetricSumType<VecTypeA, VecTypeB> d = aMem[i] - bMem[i];
+    s0 += d * d;
+  }
+
+  return (s0 + s1) + (s2 + s3);
+}
+
+template<typename VecTypeA, typename VecTypeB>
+inline typename VecTypeA::elem_type SquaredDifferenceSum(
+    const VecTypeA& a,
+    const VecTypeB& b,
+    const typename std::enable_if_t<
+        !UseLMetricKernel<VecTypeA, VecTypeB>::value>* = 0)
+{
+  return arma::accu(arma::square(a - b));
+}
+
+//! Largest absolute difference of the elements of a and b.
+template<typename VecTypeA, typename VecTypeB>
+inline LMetricSumType<VecTypeA, VecTypeB> MaxAbsoluteDifference(
+    const VecTypeA& a,
+    const VecTypeB& b,
+    const typename std::enable_if_t<
+        UseLMetricKernel<VecTypeA, VecTypeB>::value>* = 0)
+{
+  CheckSameSize(a, b);
+  const typename VecTypeA::elem_type* aMem = a.colptr(0);
+  const typename VecTypeB::elem_type* bMem = b.colptr(0);
+  const size_t n = a.n_elem;
+
+  LMetricSumType<VecTypeA, VecTypeB> m0 = 0, m1 = 0, m2 = 0, m3 = 0;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    m0 = std::max(m0, std::abs(aMem[i] - bMem[i]));
+    m1 = std::max(m1, std::abs(aMem[i + 1] - bMem[i + 1]));
+    m2 = std::max(m2, std::abs(aMem[i + 2] - bMem[i + 2]));
+    m3 = std::max(m3, std::abs(aMem[i + 3] - bMem[i + 3]));
+  }
+  for (; i < n; ++i)
+    m0 = std::max(m0, std::abs(aMem[i] - bMem[i]));
+
+  return std::max(std::max(m0, m1), std::max(m2, m3));
+}
+
+template<typename VecTypeA, typename VecTypeB>
+inline typename VecTypeA::elem_type MaxAbsoluteDifference(
+    const VecTypeA& a,
+    const VecTypeB& b,
+    const typename std::enable_if_t<
+        !UseLMetricKernel<VecTypeA, VecTypeB>::value>* = 0)
+{
+  return arma::as_scalar(arma::max(arma::abs(a - b)));
+}
+
 // Unspecialized implementation.  This should almost never be used...
 template<int Power, bool TakeRoot>
 template<typename VecTypeA, typename VecTypeB>
@@ -42,7 +208,7 @@ typename VecTypeA::elem_type LMetric<1, true>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return arma::accu(abs(a - b));
+  return AbsoluteDifferenceSum(a, b);
 }
 
 template<>
@@ -51,7 +217,7 @@ typename VecTypeA::elem_type LMetric<1, false>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return arma::accu(abs(a - b));
+  return AbsoluteDifferenceSum(a, b);
 }
 
 // L2-metric specializations.
@@ -61,7 +227,7 @@ typename VecTypeA::elem_type LMetric<2, true>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return sqrt(arma::accu(square(a - b)));
+  return std::sqrt(SquaredDifferenceSum(a, b));
 }
 
 template<>
@@ -70,7 +236,7 @@ typename VecTypeA::elem_type LMetric<2, false>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return accu(arma::square(a - b));
+  return SquaredDifferenceSum(a, b);
 }
 
 // L3-metric specialization (not very likely to be used, but just in case).
@@ -103,7 +269,7 @@ typename VecTypeA::elem_type LMetric<INT_MAX, false>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return arma::as_scalar(arma::max(arma::abs(a - b)));
+  return MaxAbsoluteDifference(a, b);
 }
 
 } // namespace metric
@@ -40,6 +40,8 @@ HAS_EXACT_METHOD_FORM(GradientConstraint, HasGradientConstraint);
 HAS_EXACT_METHOD_FORM(NumFeatures, HasNumFeatures);
 //! Detect a PartialGradient() method.
 HAS_EXACT_METHOD_FORM(PartialGradient, HasPartialGradient);
+//! Detect a Parameters() method.
+HAS_EXACT_METHOD_FORM(Parameters, HasParameters);
 
 //! This is the form of a non-const Evaluate() method.
 template<typename FunctionType>
@@ -234,6 +236,11 @@ template<typename FunctionType>
 using PartialGradientStaticForm = void(*)(
     const arma::mat&, const size_t, arma::sp_mat&);
 
+//! This is the form of a non-const Parameters() method, which gives access to
+//! the parameters the function is evaluated with.
+template<typename FunctionType>
+using ParametersForm = arma::mat&(FunctionType::*)();
+
 //! This is a utility struct that will match any non-const form.
 template<typename FunctionType, typename... Ts>
 using OtherForm = double(FunctionType::*)(Ts...);
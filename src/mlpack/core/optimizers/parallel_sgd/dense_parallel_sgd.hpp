@@ -0,0 +1,261 @@
+/**
+ * @file dense_parallel_sgd.hpp
+ *
+ * Parallel mini-batch stochastic gradient descent for functions with dense
+ * gradients.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_DENSE_PARALLEL_SGD_HPP
+#define MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_DENSE_PARALLEL_SGD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+#include <mlpack/core/optimizers/function.hpp>
+#include "decay_policies/constant_step.hpp"
+
+namespace mlpack {
+namespace optimization {
+namespace traits {
+
+/**
+ * Check whether the decomposable Evaluate(), Gradient() and
+ * EvaluateWithGradient() methods of a function are all const or static, so
+ * that one function object can be used by all threads at once.
+ */
+template<typename FunctionType>
+struct IsConstDecomposableFunction
+{
+  const static bool value =
+      (HasEvaluate<FunctionType, DecomposableEvaluateConstForm>::value ||
+       HasEvaluate<FunctionType, DecomposableEvaluateStaticForm>::value) &&
+      (HasGradient<FunctionType, DecomposableGradientConstForm>::value ||
+       HasGradient<FunctionType, DecomposableGradientStaticForm>::value) &&
+      !HasEvaluateWithGradient<FunctionType,
+          DecomposableEvaluateWithGradientForm>::value;
+};
+
+} // namespace traits
+
+/**
+ * Parallel mini-batch stochastic gradient descent for decomposable functions
+ * with dense gradients, such as FFN, LogisticRegressionFunction and
+ * SoftmaxRegressionFunction.  ParallelSGD, by contrast, needs functions that
+ * give sparse gradients of single points.
+ *
+ * Each epoch visits the mini-batches of the dataset (in a shuffled order if
+ * Shuffle() is true), and one of two modes is used to spread the work over the
+ * threads made available by the OpenMP runtime.
+ *
+ *  - In the lock-free (HOGWILD!) mode, each thread takes whole mini-batches,
+ *    computes their gradient with the shared parameters as they are, and
+ *    subtracts it from the shared parameters with atomic updates and without
+ *    any lock.
+ *
+ *  - In the synchronous mode, each mini-batch is split among the threads,
+ *    each thread computes the gradient of its share into its own buffer, and
+ *    the buffers are summed with a tree reduction before a single update.  If
+ *    the objective and gradient of a mini-batch are the sums of those of its
+ *    points, as the DecomposableFunctionType API assumes (and as for
+ *    LogisticRegressionFunction, SoftmaxRegressionFunction, or an FFN with a
+ *    NegativeLogLikelihood output layer), this gives the same steps and the
+ *    same epoch objective as mini-batch SGD with the same batch size, whatever
+ *    the number of threads.  If the function averages over the mini-batch
+ *    instead (such as an FFN with a MeanSquaredError output layer), the shares
+ *    are averaged separately and then summed, so the step, the epoch objective
+ *    and therefore the tolerance test scale with the number of shares; scale
+ *    the step size and tolerance accordingly.
+ *
+ * For more information on the lock-free mode, see the following.
+ *
+ * @code
+ * @misc{1106.5730,
+ *   Author = {Feng Niu and Benjamin Recht and Christopher Re and Stephen J.
+ *             Wright},
+ *   Title = {HOGWILD!: A Lock-Free Approach to Parallelizing Stochastic
+ *            Gradient Descent},
+ *   Year = {2011},
+ *   Eprint = {arXiv:1106.5730},
+ * }
+ * @endcode
+ *
+ * The function must implement the DecomposableFunctionType API, as for SGD:
+ *
+ *   size_t NumFunctions();
+ *   double Evaluate(const arma::mat& coordinates,
+ *                   const size_t begin,
+ *                   const size_t batchSize);
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t begin,
+ *                 arma::mat& gradient,
+ *                 const size_t batchSize);
+ *   void Shuffle();
+ *
+ * If those methods are const (or static), all threads use the given function
+ * object.  Otherwise the function is assumed to keep state between calls (as
+ * FFN does with the activations of its layers), and each thread uses its own
+ * copy, made with the copy constructor when Optimize() starts; the first
+ * thread uses the given function itself.  If the function has a Parameters()
+ * method, as FFN does, the function of a thread gets the current parameters
+ * before each mini-batch; otherwise the functions are expected to use the
+ * coordinates they are given.  The copies hold copies of the data, and any
+ * state of the function besides its parameters (such as the statistics of a
+ * BatchNorm layer) is only updated with the mini-batches of the first thread
+ * in the given function.
+ *
+ * The data is shuffled once with Shuffle() before the copies are made; after
+ * that, only the order of the mini-batches changes from one epoch to the next.
+ *
+ * @tparam DecayPolicyType Step size update policy, called with the number of
+ *     the epoch.
+ */
+template<typename DecayPolicyType = ConstantStep>
+class DenseParallelSGD
+{
+ public:
+  /**
+   * Construct the dense parallel SGD optimizer with the given parameters.  The
+   * step size is given by the decay policy.
+   *
+   * The defaults here are not necessarily good for the given problem, so it is
+   * suggested that the values used be tailored to the task at hand.
+   *
+   * @param batchSize Number of points in each mini-batch.
+   * @param maxIterations Maximum number of points to process, as for SGD (0
+   *     means no limit); the last mini-batch is cut short if needed.
+   * @param tolerance Maximum absolute tolerance to terminate the algorithm.
+   * @param shuffle If true, the data and the order of the mini-batches are
+   *     shuffled; otherwise, the mini-batches are visited in linear order.
+   * @param synchronous If true, each mini-batch is split among the threads and
+   *     gives one update; otherwise, each thread updates the shared parameters
+   *     without locks after each of its own mini-batches.
+   * @param decayPolicy The step size update policy to use.
+   */
+  DenseParallelSGD(const size_t batchSize = 32,
+                   const size_t maxIterations = 100000,
+                   const double tolerance = 1e-5,
+                   const bool shuffle = true,
+                   const bool synchronous = false,
+                   const DecayPolicyType& decayPolicy = DecayPolicyType());
+
+  /**
+   * Optimize the given function using dense parallel SGD.  The given starting
+   * point will be modified to store the finishing point of the algorithm, and
+   * the value of the loss function at the final point is returned.
+   *
+   * @tparam DecomposableFunctionType Type of the function to be optimized.
+   * @param function Function to be optimized (minimized).
+   * @param iterate Starting point (will be modified).
+   * @return Objective value at the final point.
+   */
+  template<typename DecomposableFunctionType>
+  double Optimize(DecomposableFunctionType& function, arma::mat& iterate);
+
+  //! Get the number of points in each mini-batch.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each mini-batch.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the maximum number of points to process (0 indicates no limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of points to process (0 indicates no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether or not the mini-batches are shuffled.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether or not the mini-batches are shuffled.
+  bool& Shuffle() { return shuffle; }
+
+  //! Get whether or not the threads share each mini-batch and update together.
+  bool Synchronous() const { return synchronous; }
+  //! Modify whether or not the threads share each mini-batch and update
+  //! together.
+  bool& Synchronous() { return synchronous; }
+
+  //! Get the step size decay policy.
+  const DecayPolicyType& DecayPolicy() const { return decayPolicy; }
+  //! Modify the step size decay policy.
+  DecayPolicyType& DecayPolicy() { return decayPolicy; }
+
+ private:
+  //! Make one copy of the function per thread besides the first, if the
+  //! function needs them.
+  template<typename FunctionType>
+  typename std::enable_if<
+      traits::IsConstDecomposableFunction<FunctionType>::value, void>::type
+  MakeCopies(FunctionType& function,
+             const size_t numThreads,
+             std::vector<FunctionType>& copies) const;
+
+  template<typename FunctionType>
+  typename std::enable_if<
+      !traits::IsConstDecomposableFunction<FunctionType>::value, void>::type
+  MakeCopies(FunctionType& function,
+             const size_t numThreads,
+             std::vector<FunctionType>& copies) const;
+
+  //! Get the function the given thread uses, set to the given parameters if
+  //! it is a copy with a Parameters() method.
+  template<typename FunctionType>
+  typename std::enable_if<
+      traits::IsConstDecomposableFunction<FunctionType>::value,
+      FunctionType&>::type
+  ThreadFunction(FunctionType& function,
+                 std::vector<FunctionType>& copies,
+                 const size_t thread,
+                 const arma::mat& iterate) const;
+
+  template<typename FunctionType>
+  typename std::enable_if<
+      !traits::IsConstDecomposableFunction<FunctionType>::value &&
+      traits::HasParameters<FunctionType, traits::ParametersForm>::value,
+      FunctionType&>::type
+  ThreadFunction(FunctionType& function,
+                 std::vector<FunctionType>& copies,
+                 const size_t thread,
+                 const arma::mat& iterate) const;
+
+  template<typename FunctionType>
+  typename std::enable_if<
+      !traits::IsConstDecomposableFunction<FunctionType>::value &&
+      !traits::HasParameters<FunctionType, traits::ParametersForm>::value,
+      FunctionType&>::type
+  ThreadFunction(FunctionType& function,
+                 std::vector<FunctionType>& copies,
+                 const size_t thread,
+                 const arma::mat& iterate) const;
+
+  //! The number of points in each mini-batch.
+  size_t batchSize;
+
+  //! The maximum number of points to process.
+  size_t maxIterations;
+
+  //! The tolerance for termination.
+  double tolerance;
+
+  //! Controls whether or not the mini-batches are shuffled.
+  bool shuffle;
+
+  //! Controls whether the threads share each mini-batch and update together.
+  bool synchronous;
+
+  //! The step size decay policy.
+  DecayPolicyType decayPolicy;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation.
+#include "dense_parallel_sgd_impl.hpp"
+
+#endif
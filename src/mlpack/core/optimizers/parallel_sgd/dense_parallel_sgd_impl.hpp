@@ -0,0 +1,304 @@
+/**
+ * @file dense_parallel_sgd_impl.hpp
+ *
+ * Implementation of parallel mini-batch stochastic gradient descent for
+ * functions with dense gradients.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_DENSE_PARALLEL_SGD_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_DENSE_PARALLEL_SGD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "dense_parallel_sgd.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+template<typename DecayPolicyType>
+DenseParallelSGD<DecayPolicyType>::DenseParallelSGD(
+    const size_t batchSize,
+    const size_t maxIterations,
+    const double tolerance,
+    const bool shuffle,
+    const bool synchronous,
+    const DecayPolicyType& decayPolicy) :
+    batchSize(batchSize),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    shuffle(shuffle),
+    synchronous(synchronous),
+    decayPolicy(decayPolicy)
+{ /* Nothing to do. */ }
+
+template<typename DecayPolicyType>
+template<typename DecomposableFunctionType>
+double DenseParallelSGD<DecayPolicyType>::Optimize(
+    DecomposableFunctionType& function,
+    arma::mat& iterate)
+{
+  typedef Function<DecomposableFunctionType> FullFunctionType;
+
+  // Make sure we have all the methods that we need.
+  traits::CheckDecomposableFunctionTypeAPI<FullFunctionType>();
+
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("DenseParallelSGD::Optimize(): the batch size "
+        "must be positive");
+  }
+
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  // Shuffle the points once, before the copies of the function are made, so
+  // that all copies hold the points in the same order.
+  if (shuffle)
+    static_cast<FullFunctionType&>(function).Shuffle();
+
+  std::vector<DecomposableFunctionType> copies;
+  MakeCopies(function, numThreads, copies);
+
+  // The order in which the mini-batches will be visited.
+  const size_t numFunctions = function.NumFunctions();
+  const size_t numBatches = (numFunctions + batchSize - 1) / batchSize;
+  arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
+      numBatches - 1, numBatches);
+
+  // Each thread computes its gradients into its own buffer.
+  std::vector<arma::mat> gradients(numThreads);
+
+  double overallObjective = DBL_MAX;
+  double lastObjective;
+
+  const size_t actualMaxIterations = (maxIterations == 0) ?
+      std::numeric_limits<size_t>::max() : maxIterations;
+  for (size_t i = 0, epoch = 1; i < actualMaxIterations; ++epoch)
+  {
+    // Get the step size for this epoch.
+    const double stepSize = decayPolicy.StepSize(epoch);
+
+    if (shuffle)
+    {
+      std::shuffle(visitationOrder.begin(), visitationOrder.end(),
+          mlpack::math::randGen);
+    }
+
+    // Find how many mini-batches of this epoch can be visited before
+    // actualMaxIterations points are reached; only the last of them may have
+    // to be cut short.
+    size_t epochBatches = 0;
+    size_t epochPoints = 0;
+    size_t lastBatchSize = 0;
+    while (epochBatches < numBatches && i + epochPoints < actualMaxIterations)
+    {
+      const size_t begin = visitationOrder[epochBatches] * batchSize;
+      lastBatchSize = std::min(std::min(batchSize, numFunctions - begin),
+          actualMaxIterations - i - epochPoints);
+      epochPoints += lastBatchSize;
+      ++epochBatches;
+    }
+
+    double epochObjective = 0.0;
+
+    if (synchronous)
+    {
+      for (size_t b = 0; b < epochBatches; ++b)
+      {
+        const size_t begin = visitationOrder[b] * batchSize;
+        const size_t effectiveBatchSize = (b == epochBatches - 1) ?
+            lastBatchSize : std::min(batchSize, numFunctions - begin);
+
+        // Split the mini-batch among the threads.  The objectives and
+        // gradients of the shares are summed, which is only the objective and
+        // gradient of the whole mini-batch if the function sums over points.
+        const size_t shares = std::min(numThreads, effectiveBatchSize);
+
+        #pragma omp parallel for reduction(+:epochObjective)
+        for (omp_size_t t = 0; t < (omp_size_t) shares; ++t)
+        {
+          const size_t shareBegin = begin + t * effectiveBatchSize / shares;
+          const size_t shareEnd = begin + (t + 1) * effectiveBatchSize / shares;
+
+          FullFunctionType& threadFunction =
+              static_cast<FullFunctionType&>(ThreadFunction(function, copies,
+              t, iterate));
+          epochObjective += threadFunction.EvaluateWithGradient(iterate,
+              shareBegin, gradients[t], shareEnd - shareBegin);
+        }
+
+        // Sum the gradients of the shares in a binary tree.
+        for (size_t stride = 1; stride < shares; stride *= 2)
+        {
+          #pragma omp parallel for
+          for (omp_size_t t = 0; t < (omp_size_t) (shares - stride);
+              t += 2 * stride)
+          {
+            gradients[t] += gradients[t + stride];
+          }
+        }
+
+        iterate -= stepSize * gradients[0];
+      }
+    }
+    else
+    {
+      #pragma omp parallel for schedule(dynamic) reduction(+:epochObjective)
+      for (omp_size_t b = 0; b < (omp_size_t) epochBatches; ++b)
+      {
+        size_t threadId = 0;
+        #ifdef HAS_OPENMP
+          threadId = omp_get_thread_num();
+        #endif
+
+        const size_t begin = visitationOrder[b] * batchSize;
+        const size_t effectiveBatchSize = ((size_t) b == epochBatches - 1) ?
+            lastBatchSize : std::min(batchSize, numFunctions - begin);
+
+        FullFunctionType& threadFunction =
+            static_cast<FullFunctionType&>(ThreadFunction(function, copies,
+            threadId, iterate));
+        arma::mat& gradient = gradients[threadId];
+        epochObjective += threadFunction.EvaluateWithGradient(iterate, begin,
+            gradient, effectiveBatchSize);
+
+        // Update the shared parameters without locking them.
+        for (size_t j = 0; j < gradient.n_elem; ++j)
+        {
+          #pragma omp atomic
+          iterate[j] -= stepSize * gradient[j];
+        }
+      }
+    }
+
+    i += epochPoints;
+    if (i >= actualMaxIterations)
+      break;
+
+    lastObjective = overallObjective;
+    overallObjective = epochObjective;
+
+    // Output current objective function.
+    Log::Info << "Dense parallel SGD: epoch " << epoch << ", objective "
+        << overallObjective << "." << std::endl;
+
+    if (std::isnan(overallObjective) || std::isinf(overallObjective))
+    {
+      Log::Warn << "Dense parallel SGD: converged to " << overallObjective
+          << "; terminating with failure.  Try a smaller step size?"
+          << std::endl;
+      return overallObjective;
+    }
+
+    if (std::abs(lastObjective - overallObjective) < tolerance)
+    {
+      Log::Info << "Dense parallel SGD: minimized within tolerance "
+          << tolerance << "; terminating optimization." << std::endl;
+      return overallObjective;
+    }
+  }
+
+  Log::Info << "Dense parallel SGD: maximum iterations (" << maxIterations
+      << ") reached; terminating optimization." << std::endl;
+
+  // Calculate the final objective.
+  overallObjective = 0;
+  for (size_t i = 0; i < numFunctions; i += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - i);
+    overallObjective += static_cast<FullFunctionType&>(function).Evaluate(
+        iterate, i, effectiveBatchSize);
+  }
+  return overallObjective;
+}
+
+template<typename DecayPolicyType>
+template<typename FunctionType>
+typename std::enable_if<
+    traits::IsConstDecomposableFunction<FunctionType>::value, void>::type
+DenseParallelSGD<DecayPolicyType>::MakeCopies(
+    FunctionType& /* function */,
+    const size_t /* numThreads */,
+    std::vector<FunctionType>& /* copies */) const
+{
+  // All threads can use the given function.
+}
+
+template<typename DecayPolicyType>
+template<typename FunctionType>
+typename std::enable_if<
+    !traits::IsConstDecomposableFunction<FunctionType>::value, void>::type
+DenseParallelSGD<DecayPolicyType>::MakeCopies(
+    FunctionType& function,
+    const size_t numThreads,
+    std::vector<FunctionType>& copies) const
+{
+  // The first thread uses the given function, so that its state (such as the
+  // statistics of a BatchNorm layer) is updated by the training too.
+  copies.clear();
+  copies.reserve(numThreads - 1);
+  for (size_t i = 1; i < numThreads; ++i)
+    copies.push_back(function);
+}
+
+template<typename DecayPolicyType>
+template<typename FunctionType>
+typename std::enable_if<
+    traits::IsConstDecomposableFunction<FunctionType>::value,
+    FunctionType&>::type
+DenseParallelSGD<DecayPolicyType>::ThreadFunction(
+    FunctionType& function,
+    std::vector<FunctionType>& /* copies */,
+    const size_t /* thread */,
+    const arma::mat& /* iterate */) const
+{
+  return function;
+}
+
+template<typename DecayPolicyType>
+template<typename FunctionType>
+typename std::enable_if<
+    !traits::IsConstDecomposableFunction<FunctionType>::value &&
+    traits::HasParameters<FunctionType, traits::ParametersForm>::value,
+    FunctionType&>::type
+DenseParallelSGD<DecayPolicyType>::ThreadFunction(
+    FunctionType& function,
+    std::vector<FunctionType>& copies,
+    const size_t thread,
+    const arma::mat& iterate) const
+{
+  // The function evaluates with its own parameters, so give it the current
+  // ones, unless they are the iterate already (as when FFN::Train() optimizes
+  // the parameters of the network).
+  FunctionType& threadFunction = (thread == 0) ? function :
+      copies[thread - 1];
+  if (threadFunction.Parameters().memptr() != iterate.memptr())
+    threadFunction.Parameters() = iterate;
+
+  return threadFunction;
+}
+
+template<typename DecayPolicyType>
+template<typename FunctionType>
+typename std::enable_if<
+    !traits::IsConstDecomposableFunction<FunctionType>::value &&
+    !traits::HasParameters<FunctionType, traits::ParametersForm>::value,
+    FunctionType&>::type
+DenseParallelSGD<DecayPolicyType>::ThreadFunction(
+    FunctionType& function,
+    std::vector<FunctionType>& copies,
+    const size_t thread,
+    const arma::mat& /* iterate */) const
+{
+  return (thread == 0) ? function : copies[thread - 1];
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,122 @@
+/**
+ * @file best_first_single_tree_traverser.hpp
+ *
+ * A single-tree traverser for any tree type which visits the reference nodes
+ * best-first (in the order of their scores) and may be stopped after a given
+ * number of nodes or a given amount of time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <queue>
+
+#include "tree_traits.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A single-tree traverser that keeps the reference nodes that were scored but
+ * not yet visited in a priority queue, and always visits the node with the
+ * best (lowest) score next.  Without a budget, this gives the same results as
+ * any other single-tree traversal.
+ *
+ * With a budget (MaxVisits() or TimeLimit()), the traversal stops once the
+ * budget is used up, so the results are the best ones found so far.  Since
+ * every node that was not visited has a score at least as large as
+ * UnvisitedScore(), the rules can turn it into a bound on the error of those
+ * results; for neighbor search, no unvisited reference point can be closer
+ * than the distance given by that score.
+ *
+ * Each reference point must belong to only one node, so trees with overlapping
+ * nodes (spill trees with a positive tau) would give duplicate results;
+ * NeighborSearch refuses to search them in best-first mode.
+ */
+template<typename TreeType, typename RuleType>
+class BestFirstSingleTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the best-first single tree traverser with the given rule set.
+   */
+  BestFirstSingleTreeTraverser(RuleType& rule);
+
+  /**
+   * Traverse the tree with the given point, until the tree is exhausted or the
+   * budget is used up.
+   *
+   * @param queryIndex The index of the point in the query set which is being
+   *     used as the query point.
+   * @param referenceNode The tree node to be traversed.
+   */
+  void Traverse(const size_t queryIndex, TreeType& referenceNode);
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+
+  //! Get the number of nodes visited during the last traversal.
+  size_t NumVisited() const { return numVisited; }
+
+  //! Get the maximum number of nodes to visit per traversal (0 means no limit).
+  size_t MaxVisits() const { return maxVisits; }
+  //! Modify the maximum number of nodes to visit per traversal.
+  size_t& MaxVisits() { return maxVisits; }
+
+  //! Get the maximum time of a traversal in seconds (0 means no limit).
+  double TimeLimit() const { return timeLimit; }
+  //! Modify the maximum time of a traversal in seconds.
+  double& TimeLimit() { return timeLimit; }
+
+  /**
+   * Get the best score of the nodes that were not visited in the last
+   * traversal because the budget was used up, or DBL_MAX if the traversal
+   * finished.
+   */
+  double UnvisitedScore() const { return unvisitedScore; }
+
+ private:
+  //! A node waiting to be visited, with its score.
+  struct NodeAndScore
+  {
+    TreeType* node;
+    double score;
+
+    //! Order the priority queue so that the best score is on top.
+    bool operator<(const NodeAndScore& other) const
+    {
+      return score > other.score;
+    }
+  };
+
+  //! Reference to the rules with which the tree will be traversed.
+  RuleType& rule;
+
+  //! The number of nodes which have been pruned during traversal.
+  size_t numPrunes;
+
+  //! The number of nodes visited during the last traversal.
+  size_t numVisited;
+
+  //! The maximum number of nodes to visit per traversal.
+  size_t maxVisits;
+
+  //! The maximum time of a traversal in seconds.
+  double timeLimit;
+
+  //! The best score of the nodes that were not visited.
+  double unvisitedScore;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "best_first_single_tree_traverser_impl.hpp"
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * @file best_first_single_tree_traverser_impl.hpp
+ *
+ * Implementation of the best-first single-tree traverser, which visits the
+ * reference nodes in the order of their scores until a budget is used up.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "best_first_single_tree_traverser.hpp"
+
+#include <chrono>
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType, typename RuleType>
+BestFirstSingleTreeTraverser<TreeType, RuleType>::BestFirstSingleTreeTraverser(
+    RuleType& rule) :
+    rule(rule),
+    numPrunes(0),
+    numVisited(0),
+    maxVisits(0),
+    timeLimit(0.0),
+    unvisitedScore(DBL_MAX)
+{ /* Nothing to do. */ }
+
+template<typename TreeType, typename RuleType>
+void BestFirstSingleTreeTraverser<TreeType, RuleType>::Traverse(
+    const size_t queryIndex,
+    TreeType& referenceNode)
+{
+  typedef std::chrono::steady_clock Clock;
+  const Clock::time_point start = Clock::now();
+
+  numVisited = 0;
+  unvisitedScore = DBL_MAX;
+
+  std::priority_queue<NodeAndScore> queue;
+
+  const double rootScore = rule.Score(queryIndex, referenceNode);
+  if (rootScore == DBL_MAX)
+  {
+    ++numPrunes;
+    return;
+  }
+
+  NodeAndScore root = { &referenceNode, rootScore };
+  queue.push(root);
+
+  while (!queue.empty())
+  {
+    // Stop if the budget is used up; the best node left gives the bound.
+    const bool outOfVisits = (maxVisits > 0 && numVisited >= maxVisits);
+    const bool outOfTime = (timeLimit > 0.0 &&
+        std::chrono::duration<double>(Clock::now() - start).count() >=
+        timeLimit);
+    if (outOfVisits || outOfTime)
+    {
+      unvisitedScore = queue.top().score;
+      return;
+    }
+
+    const NodeAndScore current = queue.top();
+    queue.pop();
+
+    // The bound may have improved since the node was scored.
+    if (rule.Rescore(queryIndex, *current.node, current.score) == DBL_MAX)
+    {
+      ++numPrunes;
+      continue;
+    }
+
+    TreeType& node = *current.node;
+    ++numVisited;
+
+    // Trees whose first point is the centroid of a node and which have self
+    // children evaluate that point when the node is scored, so it must not be
+    // evaluated again here.
+    const size_t firstPoint = (TreeTraits<TreeType>::FirstPointIsCentroid &&
+        TreeTraits<TreeType>::HasSelfChildren) ? 1 : 0;
+    for (size_t i = firstPoint; i < node.NumPoints(); ++i)
+      rule.BaseCase(queryIndex, node.Point(i));
+
+    for (size_t i = 0; i < node.NumChildren(); ++i)
+    {
+      const double score = rule.Score(queryIndex, node.Child(i));
+      if (score == DBL_MAX)
+      {
+        ++numPrunes;
+        continue;
+      }
+
+      NodeAndScore child = { &node.Child(i), score };
+      queue.push(child);
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
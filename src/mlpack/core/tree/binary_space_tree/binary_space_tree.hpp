@@ -88,6 +88,11 @@ class BinarySpaceTree
   //! The dataset.  If we are the root of the tree, we own the dataset and must
   //! delete it.
   MatType* dataset;
+  //! If this is the root of a compacted tree, the block holding all of its
+  //! descendants (see Compact()); otherwise NULL.
+  BinarySpaceTree* nodes;
+  //! The number of nodes in the block pointed to by nodes.
+  size_t numNodes;
 
  public:
   //! A single-tree traverser for binary space trees; see
@@ -492,7 +497,37 @@ class BinarySpaceTree
   //! Store the center of the bounding region in the given vector.
   void Center(arma::vec& center) const { bound.Center(center); }
 
+  /**
+   * Move every descendant of this node into a single contiguous block of
+   * memory, in breadth-first order, so that the two children of each node are
+   * adjacent and the top levels of the tree share a few cache lines.
+   * Traversals of a compacted tree follow the same pointers as before, but
+   * miss the cache much less often than they do when each node is allocated
+   * separately on the heap.  Only the node objects themselves are moved: memory
+   * that a node refers to stays where it was, so, e.g., the per-dimension
+   * ranges of an HRectBound are still reached through a separate pointer on
+   * every bound check.  This can only be called on the root of the tree,
+   * and it should be called before any statistic that holds pointers to other
+   * nodes is computed, since all nodes but the root are moved.
+   *
+   * After this call, the shape of the tree must not change: no descendant may
+   * be deleted, or replaced by another node.  Copies of a compacted tree and
+   * trees loaded from an archive are not compacted.  Calling Compact() on a
+   * tree that is already compacted does nothing.
+   */
+  void Compact();
+
+  //! Return whether or not the descendants of this node are stored in one
+  //! contiguous block (see Compact()).
+  bool IsCompact() const { return nodes != NULL; }
+
  private:
+  /**
+   * Delete the children of this node and their descendants, whether they are
+   * held in a compacted block or were allocated individually.
+   */
+  void DeleteChildren();
+
   /**
    * Splits the current node, assigning its left and right children recursively.
    *
@@ -514,6 +549,23 @@ class BinarySpaceTree
                  const size_t maxLeafSize,
                  SplitType<BoundType<MetricType>, MatType>& splitter);
 
+  /**
+   * Split the root node, like SplitNode(), but on all available OpenMP threads
+   * if the splitter allows it (see IsParallelSplit) and the tree is large
+   * enough.  The top levels of the tree are split one level at a time, with
+   * the nodes of each level split in parallel; then the subtrees below them
+   * are built in parallel.  The tree and the mapping are the same as the ones
+   * SplitNode() gives.
+   *
+   * @param oldFromNew Vector holding permuted indices, or NULL if the mapping
+   *     is not needed.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   */
+  void SplitRoot(std::vector<size_t>* oldFromNew,
+                 const size_t maxLeafSize,
+                 SplitType<BoundType<MetricType>, MatType>& splitter);
+
   /**
    * Update the bound of the current node. This method does not take into
    * account bound-specific properties.
@@ -13,6 +13,7 @@
 
 // In case it wasn't included already for some reason.
 #include "binary_space_tree.hpp"
+#include "is_parallel_split.hpp"
 
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/log.hpp>
@@ -40,11 +41,13 @@ BinarySpaceTree(
     count(data.n_cols), /* and spans all of the dataset. */
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    nodes(NULL),
+    numNodes(0)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(maxLeafSize, splitter);
+  SplitRoot(NULL, maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -68,7 +71,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    nodes(NULL),
+    numNodes(0)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(data.n_cols);
@@ -77,7 +82,7 @@ BinarySpaceTree(
 
   // Now do the actual splitting.
   SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  SplitRoot(&oldFromNew, maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -102,7 +107,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    nodes(NULL),
+    numNodes(0)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(data.n_cols);
@@ -111,7 +118,7 @@ BinarySpaceTree(
 
   // Now do the actual splitting.
   SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  SplitRoot(&oldFromNew, maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -137,11 +144,13 @@ BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    nodes(NULL),
+    numNodes(0)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(maxLeafSize, splitter);
+  SplitRoot(NULL, maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -165,7 +174,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    nodes(NULL),
+    numNodes(0)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -174,7 +185,7 @@ BinarySpaceTree(
 
   // Now do the actual splitting.
   SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  SplitRoot(&oldFromNew, maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -199,7 +210,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    nodes(NULL),
+    numNodes(0)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -208,7 +221,7 @@ BinarySpaceTree(
 
   // Now do the actual splitting.
   SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  SplitRoot(&oldFromNew, maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -238,7 +251,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset()) // Point to the parent's dataset.
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    nodes(NULL),
+    numNodes(0)
 {
   // Perform the actual splitting.
   SplitNode(maxLeafSize, splitter);
@@ -267,7 +282,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    nodes(NULL),
+    numNodes(0)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -301,7 +318,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset()->n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    nodes(NULL),
+    numNodes(0)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -342,7 +361,9 @@ BinarySpaceTree(
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     // Copy matrix, but only if we are the root.
-    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL)
+    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL),
+    nodes(NULL),
+    numNodes(0)
 {
   // Create left and right children (if any).
   if (other.Left())
@@ -400,12 +421,16 @@ BinarySpaceTree(BinarySpaceTree&& other) :
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
-    dataset(other.dataset)
+    dataset(other.dataset),
+    nodes(other.nodes),
+    numNodes(other.numNodes)
 {
   // Now we are a clone of the other tree.  But we must also clear the other
   // tree's contents, so it doesn't delete anything when it is destructed.
   other.left = NULL;
   other.right = NULL;
+  other.nodes = NULL;
+  other.numNodes = 0;
   other.begin = 0;
   other.count = 0;
   other.parentDistance = 0.0;
@@ -455,8 +480,7 @@ template<typename MetricType,
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     ~BinarySpaceTree()
 {
-  delete left;
-  delete right;
+  DeleteChildren();
 
   // If we're the root, delete the matrix.
   if (!parent)
@@ -869,6 +893,120 @@ SplitNode(std::vector<size_t>& oldFromNew,
   right->ParentDistance() = rightParentDistance;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+SplitRoot(std::vector<size_t>* oldFromNew,
+          const size_t maxLeafSize,
+          SplitType<BoundType<MetricType>, MatType>& splitter)
+{
+  // Subtrees with fewer points than this are always built on one thread.
+  const size_t minParallelCount = 10000;
+
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  if (!IsParallelSplit<Split>::value || numThreads == 1 ||
+      count < minParallelCount)
+  {
+    if (oldFromNew)
+      SplitNode(*oldFromNew, maxLeafSize, splitter);
+    else
+      SplitNode(maxLeafSize, splitter);
+    return;
+  }
+
+  UpdateBound(bound);
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  // Each node of a level is split, and its children are built either as
+  // leaves, to be split with the next level, or, once the level has enough
+  // nodes to keep every thread busy (or the node is small), as whole subtrees.
+  // Nodes of a level hold disjoint parts of the dataset, so they can be split
+  // at the same time.
+  std::vector<BinarySpaceTree*> level(1, this);
+  std::vector<BinarySpaceTree*> splitNodes;
+  while (!level.empty())
+  {
+    const bool lastLevel = (level.size() >= 4 * numThreads);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) level.size(); ++i)
+    {
+      BinarySpaceTree& node = *level[i];
+      if (node.count <= maxLeafSize)
+        continue;
+
+      typename Split::SplitInfo splitInfo;
+      if (!splitter.SplitNode(node.bound, *dataset, node.begin, node.count,
+          splitInfo))
+        continue;
+
+      const size_t splitCol = (oldFromNew == NULL) ?
+          splitter.PerformSplit(*dataset, node.begin, node.count, splitInfo) :
+          splitter.PerformSplit(*dataset, node.begin, node.count, splitInfo,
+              *oldFromNew);
+
+      // A leaf size no node can reach keeps the children from being split.
+      const size_t childLeafSize = (lastLevel || node.count < minParallelCount)
+          ? maxLeafSize : std::numeric_limits<size_t>::max();
+      const size_t leftCount = splitCol - node.begin;
+      const size_t rightCount = node.begin + node.count - splitCol;
+      if (oldFromNew == NULL)
+      {
+        node.left = new BinarySpaceTree(&node, node.begin, leftCount,
+            splitter, childLeafSize);
+        node.right = new BinarySpaceTree(&node, splitCol, rightCount,
+            splitter, childLeafSize);
+      }
+      else
+      {
+        node.left = new BinarySpaceTree(&node, node.begin, leftCount,
+            *oldFromNew, splitter, childLeafSize);
+        node.right = new BinarySpaceTree(&node, splitCol, rightCount,
+            *oldFromNew, splitter, childLeafSize);
+      }
+
+      // Calculate parent distances for those two nodes.
+      arma::vec center, leftCenter, rightCenter;
+      node.Center(center);
+      node.left->Center(leftCenter);
+      node.right->Center(rightCenter);
+
+      node.left->ParentDistance() = MetricType::Evaluate(center, leftCenter);
+      node.right->ParentDistance() = MetricType::Evaluate(center,
+          rightCenter);
+    }
+
+    std::vector<BinarySpaceTree*> nextLevel;
+    for (size_t i = 0; i < level.size(); ++i)
+    {
+      if (level[i]->left == NULL)
+        continue;
+
+      splitNodes.push_back(level[i]);
+      if (!lastLevel && level[i]->count >= minParallelCount)
+      {
+        nextLevel.push_back(level[i]->left);
+        nextLevel.push_back(level[i]->right);
+      }
+    }
+    level.swap(nextLevel);
+  }
+
+  // The statistics of the nodes that were split were built when the nodes were
+  // still leaves; build them again, children first.  The statistic of the root
+  // is built by the constructor.
+  for (size_t i = splitNodes.size(); i > 1; --i)
+    splitNodes[i - 1]->stat = StatisticType(*splitNodes[i - 1]);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -909,6 +1047,102 @@ UpdateBound(bound::HollowBallBound<MetricType>& boundToUpdate)
     boundToUpdate |= dataset->cols(begin, begin + count - 1);
 }
 
+/**
+ * Move all descendants of the root into one contiguous block, in breadth-first
+ * order.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Compact()
+{
+  if (parent != NULL)
+  {
+    throw std::invalid_argument("BinarySpaceTree::Compact(): only the root of "
+        "a tree can be compacted");
+  }
+
+  if (nodes != NULL || left == NULL)
+    return;
+
+  // List the descendants in breadth-first order.
+  std::vector<BinarySpaceTree*> order;
+  order.push_back(left);
+  order.push_back(right);
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    if (order[i]->left)
+    {
+      order.push_back(order[i]->left);
+      order.push_back(order[i]->right);
+    }
+  }
+
+  BinarySpaceTree* block = static_cast<BinarySpaceTree*>(
+      ::operator new(order.size() * sizeof(BinarySpaceTree)));
+
+  // Since a parent is always moved before its children, when a node is moved
+  // its parent is already in the block, and still points to the old location
+  // of the node.  The move constructor points the children of the node to the
+  // new location.
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    BinarySpaceTree* node = new (block + i) BinarySpaceTree(
+        std::move(*order[i]));
+    if (node->parent->left == order[i])
+      node->parent->left = node;
+    else
+      node->parent->right = node;
+
+    // The old node has no children anymore, so this deletes only the node.
+    delete order[i];
+  }
+
+  nodes = block;
+  numNodes = order.size();
+}
+
+/**
+ * Delete the children of this node, and all their descendants.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    DeleteChildren()
+{
+  if (nodes != NULL)
+  {
+    // Every descendant is in the block, so destroy them in place without
+    // letting them delete their own children.
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      nodes[i].left = NULL;
+      nodes[i].right = NULL;
+      nodes[i].~BinarySpaceTree();
+    }
+    ::operator delete(nodes);
+
+    nodes = NULL;
+    numNodes = 0;
+  }
+  else
+  {
+    delete left;
+    delete right;
+  }
+
+  left = NULL;
+  right = NULL;
+}
+
 // Default constructor (private), for boost::serialization.
 template<typename MetricType,
          typename StatisticType,
@@ -926,7 +1160,9 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     stat(*this),
     parentDistance(0),
     furthestDescendantDistance(0),
-    dataset(NULL)
+    dataset(NULL),
+    nodes(NULL),
+    numNodes(0)
 {
   // Nothing to do.
 }
@@ -947,10 +1183,7 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   // If we're loading, and we have children, they need to be deleted.
   if (Archive::is_loading::value)
   {
-    if (left)
-      delete left;
-    if (right)
-      delete right;
+    DeleteChildren();
     if (!parent)
       delete dataset;
 
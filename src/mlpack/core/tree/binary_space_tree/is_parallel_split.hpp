@@ -0,0 +1,50 @@
+/**
+ * @file is_parallel_split.hpp
+ *
+ * Definition of IsParallelSplit.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_IS_PARALLEL_SPLIT_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_IS_PARALLEL_SPLIT_HPP
+
+#include "midpoint_split.hpp"
+#include "mean_split.hpp"
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+/**
+ * Whether several threads may split different nodes of a BinarySpaceTree with
+ * the same splitter at once, and get the same tree as a single thread would.
+ * This is not true of splits that draw random numbers (such as RPTreeMaxSplit
+ * and VantagePointSplit) or that keep state (such as UBTreeSplit); trees that
+ * use those splits are always built on one thread.
+ */
+template<typename SplitType>
+struct IsParallelSplit
+{
+  static const bool value = false;
+};
+
+// Specialization for MidpointSplit.
+template<typename BoundType, typename MatType>
+struct IsParallelSplit<MidpointSplit<BoundType, MatType>>
+{
+  static const bool value = true;
+};
+
+// Specialization for MeanSplit.
+template<typename BoundType, typename MatType>
+struct IsParallelSplit<MeanSplit<BoundType, MatType>>
+{
+  static const bool value = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,45 @@
+/**
+ * @file compact_tree.hpp
+ *
+ * CompactTree() stores the nodes of a tree contiguously, for tree types that
+ * support it, and does nothing for the others.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_COMPACT_TREE_HPP
+#define MLPACK_CORE_TREE_COMPACT_TREE_HPP
+
+#include "binary_space_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Trees without a compact layout are left as they are.
+ */
+template<typename TreeType>
+void CompactTree(TreeType& /* tree */) { }
+
+/**
+ * Store the descendants of the root of a BinarySpaceTree in one contiguous
+ * block; see BinarySpaceTree::Compact().
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void CompactTree(BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+                                 SplitType>& tree)
+{
+  tree.Compact();
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
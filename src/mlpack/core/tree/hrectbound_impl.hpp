@@ -512,8 +512,15 @@ HRectBound<MetricType, ElemType>::operator|=(const MatType& data)
 {
   Log::Assert(data.n_rows == dim);
 
-  arma::Col<ElemType> mins(min(data, 1));
-  arma::Col<ElemType> maxs(max(data, 1));
+  // The data may hold another type of element than the bound (for instance,
+  // float data in a tree whose bounds hold doubles).
+  typedef typename MatType::elem_type DataElemType;
+  const arma::Col<DataElemType> dataMins(min(data, 1));
+  const arma::Col<DataElemType> dataMaxs(max(data, 1));
+  arma::Col<ElemType> mins(
+      arma::conv_to<arma::Col<ElemType>>::from(dataMins));
+  arma::Col<ElemType> maxs(
+      arma::conv_to<arma::Col<ElemType>>::from(dataMaxs));
 
   minWidth = std::numeric_limits<ElemType>::max();
   for (size_t i = 0; i < dim; i++)
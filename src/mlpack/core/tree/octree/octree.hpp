@@ -425,6 +425,52 @@ class Octree
                  std::vector<size_t>& oldFromNew,
                  const size_t maxLeafSize);
 
+  /**
+   * Split the root node, like SplitNode(), but on all available OpenMP threads
+   * if the tree is large enough.  The top levels of the tree are split one
+   * level at a time, with the nodes of each level split in parallel; then the
+   * subtrees below them are built in parallel.  The tree and the mapping are
+   * the same as the ones SplitNode() gives.
+   *
+   * @param center Center of the node.
+   * @param width Width of the current node.
+   * @param oldFromNew Mappings from old to new, or NULL if the mapping is not
+   *     needed.
+   * @param maxLeafSize Maximum number of points allowed in a leaf.
+   */
+  void SplitRoot(const arma::vec& center,
+                 const double width,
+                 std::vector<size_t>* oldFromNew,
+                 const size_t maxLeafSize);
+
+  /**
+   * Reorder the points of this node so that the points that belong to each
+   * child are contiguous, and fill the index of the first point of each child
+   * (followed by the index one past the last point of the node).
+   *
+   * @param center Center of the node.
+   * @param oldFromNew Mappings from old to new, or NULL if the mapping is not
+   *     needed.
+   * @param childBegins Vector to store the first index of each child in.
+   */
+  void PartitionNode(const arma::vec& center,
+                     std::vector<size_t>* oldFromNew,
+                     arma::Col<size_t>& childBegins);
+
+  /**
+   * Compute the center of the child with the given index.
+   *
+   * @param center Center of the node.
+   * @param childWidth Width of the children of the node.
+   * @param child Index of the child.
+   * @param childCenter Vector to store the center of the child in; it must
+   *     already have the right size.
+   */
+  static void ChildCenter(const arma::vec& center,
+                          const double childWidth,
+                          const size_t child,
+                          arma::vec& childCenter);
+
   /**
    * This is used for sorting points while splitting.
    */
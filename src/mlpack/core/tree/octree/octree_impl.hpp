@@ -42,7 +42,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(const MatType& dataset,
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, maxLeafSize);
+    SplitRoot(center, maxWidth, NULL, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -84,7 +84,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
+    SplitRoot(center, maxWidth, &oldFromNew, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -127,7 +127,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
+    SplitRoot(center, maxWidth, &oldFromNew, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -168,7 +168,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(MatType&& dataset,
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, maxLeafSize);
+    SplitRoot(center, maxWidth, NULL, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -210,7 +210,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
+    SplitRoot(center, maxWidth, &oldFromNew, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -253,7 +253,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
+    SplitRoot(center, maxWidth, &oldFromNew, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -677,68 +677,8 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
     return;
 
   // This will hold the index of the first point in each child.
-  arma::Col<size_t> childBegins(((size_t) 1 << dataset->n_rows) + 1);
-  childBegins[0] = begin;
-  childBegins[childBegins.n_elem - 1] = begin + count;
-
-  // We will make log2(dim) passes, splitting along the last down to the first
-  // dimension.  The tuple holds { dim, begin, count, leftChildIndex }.
-  std::stack<std::tuple<size_t, size_t, size_t, size_t>> stack;
-  stack.push(std::tuple<size_t, size_t, size_t, size_t>(dataset->n_rows - 1,
-      begin, count, 0));
-
-  while (!stack.empty())
-  {
-    std::tuple<size_t, size_t, size_t, size_t> t = stack.top();
-    stack.pop();
-
-    const size_t d = std::get<0>(t);
-    const size_t childBegin = std::get<1>(t);
-    const size_t childCount = std::get<2>(t);
-    const size_t leftChildIndex = std::get<3>(t);
-
-    // Perform a "half-split": after this split, all points belonging to
-    // children of index 2^(d - 1) - 1 and less will be on the left side, and
-    // all points belonging to children of index 2^(d - 1) and above will be on
-    // the right side.
-    typename SplitType::SplitInfo s(d, center);
-    const size_t firstRight = split::PerformSplit<MatType, SplitType>(*dataset,
-        childBegin, childCount, s);
-
-    // We can set the first index of the right child.  The first index of the
-    // left child is already set.
-    const size_t rightChildIndex = leftChildIndex + ((size_t) 1 << d);
-    childBegins[rightChildIndex] = firstRight;
-
-    // Now we have to recurse, if this was not the last dimension.
-    if (d != 0)
-    {
-      if (firstRight > childBegin)
-      {
-        stack.push(std::tuple<size_t, size_t, size_t, size_t>(d - 1, childBegin,
-            firstRight - childBegin, leftChildIndex));
-      }
-      else
-      {
-        // Set beginning indices correctly for all children below this level.
-        for (size_t c = leftChildIndex + 1; c < rightChildIndex; ++c)
-          childBegins[c] = childBegins[leftChildIndex];
-      }
-
-      if (firstRight < childBegin + childCount)
-      {
-        stack.push(std::tuple<size_t, size_t, size_t, size_t>(d - 1, firstRight,
-            childCount - (firstRight - childBegin), rightChildIndex));
-      }
-      else
-      {
-        // Set beginning indices correctly for all children below this level.
-        for (size_t c = rightChildIndex + 1;
-             c < rightChildIndex + (rightChildIndex - leftChildIndex); ++c)
-          childBegins[c] = childBegins[rightChildIndex];
-      }
-    }
-  }
+  arma::Col<size_t> childBegins;
+  PartitionNode(center, NULL, childBegins);
 
   // Now that the dataset is reordered, we can create the children.
   arma::vec childCenter(center.n_elem);
@@ -750,14 +690,7 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
       continue;
 
     // Create the correct center.
-    for (size_t d = 0; d < center.n_elem; ++d)
-    {
-      // Is the dimension "right" (1) or "left" (0)?
-      if (((i >> d) & 1) == 0)
-        childCenter[d] = center[d] - childWidth;
-      else
-        childCenter[d] = center[d] + childWidth;
-    }
+    ChildCenter(center, childWidth, i, childCenter);
 
     children.push_back(new Octree(this, childBegins[i],
         childBegins[i + 1] - childBegins[i], childCenter, childWidth,
@@ -779,7 +712,145 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
     return;
 
   // This will hold the index of the first point in each child.
-  arma::Col<size_t> childBegins(((size_t) 1 << dataset->n_rows) + 1);
+  arma::Col<size_t> childBegins;
+  PartitionNode(center, &oldFromNew, childBegins);
+
+  // Now that the dataset is reordered, we can create the children.
+  arma::vec childCenter(center.n_elem);
+  const double childWidth = width / 2.0;
+  for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
+  {
+    // If the child has no points, don't create it.
+    if (childBegins[i + 1] - childBegins[i] == 0)
+      continue;
+
+    // Create the correct center.
+    ChildCenter(center, childWidth, i, childCenter);
+
+    children.push_back(new Octree(this, childBegins[i],
+        childBegins[i + 1] - childBegins[i], oldFromNew, childCenter,
+        childWidth, maxLeafSize));
+  }
+}
+
+//! Split the root node, on all threads if the tree is large enough.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::SplitRoot(
+    const arma::vec& center,
+    const double width,
+    std::vector<size_t>* oldFromNew,
+    const size_t maxLeafSize)
+{
+  // Subtrees with fewer points than this are always built on one thread.
+  const size_t minParallelCount = 10000;
+
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  if (numThreads == 1 || count < minParallelCount)
+  {
+    if (oldFromNew)
+      SplitNode(center, width, *oldFromNew, maxLeafSize);
+    else
+      SplitNode(center, width, maxLeafSize);
+    return;
+  }
+
+  // Each node of a level is split, and its children are built either as
+  // leaves, to be split with the next level, or, once the level has enough
+  // nodes to keep every thread busy (or the node is small), as whole subtrees.
+  // Nodes of a level hold disjoint parts of the dataset, so they can be split
+  // at the same time.  The centers and widths of the nodes of a level are
+  // kept, since the nodes themselves don't store them.
+  std::vector<Octree*> level(1, this);
+  std::vector<arma::vec> centers(1, center);
+  std::vector<double> widths(1, width);
+  std::vector<Octree*> splitNodes;
+  while (!level.empty())
+  {
+    const bool lastLevel = (level.size() >= 4 * numThreads);
+    std::vector<std::vector<arma::vec>> childCenters(level.size());
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) level.size(); ++i)
+    {
+      Octree& node = *level[i];
+      if (node.count <= maxLeafSize)
+        continue;
+
+      arma::Col<size_t> childBegins;
+      node.PartitionNode(centers[i], oldFromNew, childBegins);
+
+      // A leaf size no node can reach keeps the children from being split.
+      const size_t childLeafSize = (lastLevel || node.count < minParallelCount)
+          ? maxLeafSize : std::numeric_limits<size_t>::max();
+      arma::vec childCenter(centers[i].n_elem);
+      const double childWidth = widths[i] / 2.0;
+      for (size_t c = 0; c < childBegins.n_elem - 1; ++c)
+      {
+        // If the child has no points, don't create it.
+        if (childBegins[c + 1] - childBegins[c] == 0)
+          continue;
+
+        ChildCenter(centers[i], childWidth, c, childCenter);
+        if (oldFromNew == NULL)
+        {
+          node.children.push_back(new Octree(&node, childBegins[c],
+              childBegins[c + 1] - childBegins[c], childCenter, childWidth,
+              childLeafSize));
+        }
+        else
+        {
+          node.children.push_back(new Octree(&node, childBegins[c],
+              childBegins[c + 1] - childBegins[c], *oldFromNew, childCenter,
+              childWidth, childLeafSize));
+        }
+        childCenters[i].push_back(childCenter);
+      }
+    }
+
+    std::vector<Octree*> nextLevel;
+    std::vector<arma::vec> nextCenters;
+    std::vector<double> nextWidths;
+    for (size_t i = 0; i < level.size(); ++i)
+    {
+      if (level[i]->children.empty())
+        continue;
+
+      splitNodes.push_back(level[i]);
+      if (!lastLevel && level[i]->count >= minParallelCount)
+      {
+        for (size_t c = 0; c < level[i]->children.size(); ++c)
+        {
+          nextLevel.push_back(level[i]->children[c]);
+          nextCenters.push_back(childCenters[i][c]);
+          nextWidths.push_back(widths[i] / 2.0);
+        }
+      }
+    }
+    level.swap(nextLevel);
+    centers.swap(nextCenters);
+    widths.swap(nextWidths);
+  }
+
+  // The statistics of the nodes that were split were built when the nodes were
+  // still leaves; build them again, children first.  The statistic of the root
+  // is built by the constructor.
+  for (size_t i = splitNodes.size(); i > 1; --i)
+    splitNodes[i - 1]->stat = StatisticType(*splitNodes[i - 1]);
+}
+
+//! Reorder the points of the node so that the points of each child are
+//! contiguous.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::PartitionNode(
+    const arma::vec& center,
+    std::vector<size_t>* oldFromNew,
+    arma::Col<size_t>& childBegins)
+{
+  childBegins.set_size(((size_t) 1 << dataset->n_rows) + 1);
   childBegins[0] = begin;
   childBegins[childBegins.n_elem - 1] = begin + count;
 
@@ -804,8 +875,11 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
     // all points belonging to children of index 2^(d - 1) and above will be on
     // the right side.
     typename SplitType::SplitInfo s(d, center);
-    const size_t firstRight = split::PerformSplit<MatType, SplitType>(*dataset,
-        childBegin, childCount, s, oldFromNew);
+    const size_t firstRight = (oldFromNew == NULL) ?
+        split::PerformSplit<MatType, SplitType>(*dataset, childBegin,
+            childCount, s) :
+        split::PerformSplit<MatType, SplitType>(*dataset, childBegin,
+            childCount, s, *oldFromNew);
 
     // We can set the first index of the right child.  The first index of the
     // left child is already set.
@@ -841,29 +915,23 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
       }
     }
   }
+}
 
-  // Now that the dataset is reordered, we can create the children.
-  arma::vec childCenter(center.n_elem);
-  const double childWidth = width / 2.0;
-  for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
+//! Compute the center of the given child of a node.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::ChildCenter(
+    const arma::vec& center,
+    const double childWidth,
+    const size_t child,
+    arma::vec& childCenter)
+{
+  for (size_t d = 0; d < center.n_elem; ++d)
   {
-    // If the child has no points, don't create it.
-    if (childBegins[i + 1] - childBegins[i] == 0)
-      continue;
-
-    // Create the correct center.
-    for (size_t d = 0; d < center.n_elem; ++d)
-    {
-      // Is the dimension "right" (1) or "left" (0)?
-      if (((i >> d) & 1) == 0)
-        childCenter[d] = center[d] - childWidth;
-      else
-        childCenter[d] = center[d] + childWidth;
-    }
-
-    children.push_back(new Octree(this, childBegins[i],
-        childBegins[i + 1] - childBegins[i], oldFromNew, childCenter,
-        childWidth, maxLeafSize));
+    // Is the dimension "right" (1) or "left" (0)?
+    if (((child >> d) & 1) == 0)
+      childCenter[d] = center[d] - childWidth;
+    else
+      childCenter[d] = center[d] + childWidth;
   }
 }
 
@@ -0,0 +1,69 @@
+/**
+ * @file can_pack_nodes.hpp
+ *
+ * Definition of CanPackNodes, which tells whether a bulk-loaded RectangleTree
+ * may be built by packing its nodes directly.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_CAN_PACK_NODES_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_CAN_PACK_NODES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "no_auxiliary_information.hpp"
+#include "x_tree_auxiliary_information.hpp"
+
+namespace mlpack {
+namespace tree {
+
+// Forward declaration, so that the R+ tree split does not need to be included.
+template<typename SplitPolicyType,
+         template<typename> class SweepType>
+class RPlusTreeSplit;
+
+/**
+ * Whether a RectangleTree with the given split and auxiliary information may
+ * be bulk loaded by packing its leaves and nodes directly.  This is only true
+ * if neither the split nor the auxiliary information holds an invariant about
+ * the way the points are distributed between nodes (as the non-overlapping
+ * nodes of the R+ and R++ trees or the Hilbert R tree ordering do); other
+ * trees are bulk loaded by inserting the points one by one in the packed
+ * order.
+ */
+template<typename SplitType,
+         template<typename> class AuxiliaryInformationType>
+struct CanPackNodes
+{
+  static const bool value = false;
+};
+
+// Specialization for the R tree and the R* tree.
+template<typename SplitType>
+struct CanPackNodes<SplitType, NoAuxiliaryInformation>
+{
+  static const bool value = true;
+};
+
+// Specialization for the X tree.
+template<typename SplitType>
+struct CanPackNodes<SplitType, XTreeAuxiliaryInformation>
+{
+  static const bool value = true;
+};
+
+// Specialization for the R+ tree, whose sibling nodes must not overlap.
+template<typename SplitPolicyType,
+         template<typename> class SweepType>
+struct CanPackNodes<RPlusTreeSplit<SplitPolicyType, SweepType>,
+                    NoAuxiliaryInformation>
+{
+  static const bool value = false;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
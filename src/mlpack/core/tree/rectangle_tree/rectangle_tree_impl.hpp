@@ -14,6 +14,8 @@
 
 // In case it wasn't included already for some reason.
 #include "rectangle_tree.hpp"
+#include "can_pack_nodes.hpp"
+#include "discrete_hilbert_value.hpp"
 
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/log.hpp>
@@ -101,6 +103,80 @@ RectangleTree(MatType&& data,
     root->InsertPoint(i);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(const MatType& data,
+              const BulkLoadType bulkLoad,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(data)),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad(bulkLoad);
+
+  // Build the statistic once all the points are in the tree.
+  stat = StatisticType(*this);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(MatType&& data,
+              const BulkLoadType bulkLoad,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(std::move(data))),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad(bulkLoad);
+
+  // Build the statistic once all the points are in the tree.
+  stat = StatisticType(*this);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -893,6 +969,220 @@ void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
   }
 }
 
+/**
+ * Bulk load the dataset.  The points are ordered and cut into groups that
+ * become the leaves; then the leaves are ordered (by the centers of their
+ * bounds) and cut into groups that become the nodes of the next level, and so
+ * on, until the nodes fit into the root.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    BulkLoad(const BulkLoadType bulkLoad)
+{
+  const size_t numPoints = dataset->n_cols;
+  const size_t numLeaves = (numPoints + maxLeafSize - 1) / maxLeafSize;
+
+  std::vector<size_t> order(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+    order[i] = i;
+
+  std::vector<size_t> groupEnds;
+  if (bulkLoad == STR_BULK_LOAD)
+  {
+    TileItems(*dataset, order, 0, numPoints, 0, numLeaves, groupEnds);
+  }
+  else
+  {
+    typedef DiscreteHilbertValue<ElemType> HilbertValueType;
+    typedef typename HilbertValueType::HilbertElemType HilbertElemType;
+
+    std::vector<arma::Col<HilbertElemType>> values(numPoints);
+    for (size_t i = 0; i < numPoints; ++i)
+      values[i] = HilbertValueType::CalculateValue(dataset->col(i));
+
+    std::stable_sort(order.begin(), order.end(),
+        [&values](const size_t a, const size_t b)
+        {
+          return HilbertValueType::CompareValues(values[a], values[b]) < 0;
+        });
+
+    ChunkItems(0, numPoints, numLeaves, groupEnds);
+  }
+
+  // If the split or the auxiliary information holds some invariant about the
+  // nodes, the nodes can't simply be packed.  The points are inserted one by
+  // one then, but in the packed order, so that nearby points still end up
+  // together.
+  if (!CanPackNodes<SplitType, AuxiliaryInformationType>::value ||
+      numPoints <= maxLeafSize)
+  {
+    for (size_t i = 0; i < numPoints; ++i)
+      InsertPoint(order[i]);
+
+    return;
+  }
+
+  // Pack the points into the leaves.
+  std::vector<RectangleTree*> nodes;
+  size_t groupBegin = 0;
+  for (size_t g = 0; g < groupEnds.size(); ++g)
+  {
+    RectangleTree* leaf = new RectangleTree(this);
+    for (size_t i = groupBegin; i < groupEnds[g]; ++i)
+    {
+      leaf->points[leaf->count++] = order[i];
+      leaf->bound |= dataset->col(order[i]);
+    }
+    leaf->numDescendants = leaf->count;
+    leaf->stat = StatisticType(*leaf);
+
+    nodes.push_back(leaf);
+    groupBegin = groupEnds[g];
+  }
+
+  // Pack the nodes into the nodes of the next level, until they fit into the
+  // root.
+  while (nodes.size() > maxNumChildren)
+  {
+    std::vector<size_t> nodeOrder(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+      nodeOrder[i] = i;
+
+    const size_t numNodes = (nodes.size() + maxNumChildren - 1) /
+        maxNumChildren;
+    groupEnds.clear();
+    if (bulkLoad == STR_BULK_LOAD)
+    {
+      arma::Mat<ElemType> centers(bound.Dim(), nodes.size());
+      arma::Col<ElemType> center;
+      for (size_t i = 0; i < nodes.size(); ++i)
+      {
+        nodes[i]->bound.Center(center);
+        centers.col(i) = center;
+      }
+
+      TileItems(centers, nodeOrder, 0, nodes.size(), 0, numNodes, groupEnds);
+    }
+    else
+    {
+      // The nodes were built from consecutive runs of the Hilbert order, so
+      // they are already in Hilbert order too.
+      ChunkItems(0, nodes.size(), numNodes, groupEnds);
+    }
+
+    std::vector<RectangleTree*> parents;
+    groupBegin = 0;
+    for (size_t g = 0; g < groupEnds.size(); ++g)
+    {
+      RectangleTree* node = new RectangleTree(this);
+      for (size_t i = groupBegin; i < groupEnds[g]; ++i)
+      {
+        RectangleTree* child = nodes[nodeOrder[i]];
+        child->parent = node;
+        node->children[node->numChildren++] = child;
+        node->bound |= child->bound;
+        node->numDescendants += child->numDescendants;
+      }
+      node->stat = StatisticType(*node);
+
+      parents.push_back(node);
+      groupBegin = groupEnds[g];
+    }
+
+    nodes.swap(parents);
+  }
+
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    nodes[i]->parent = this;
+    children[numChildren++] = nodes[i];
+    bound |= nodes[i]->bound;
+    numDescendants += nodes[i]->numDescendants;
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+template<typename CoordinatesType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    TileItems(const CoordinatesType& coordinates,
+              std::vector<size_t>& order,
+              const size_t begin,
+              const size_t end,
+              const size_t dim,
+              const size_t numGroups,
+              std::vector<size_t>& groupEnds)
+{
+  if (numGroups <= 1)
+  {
+    groupEnds.push_back(end);
+    return;
+  }
+
+  std::sort(order.begin() + begin, order.begin() + end,
+      [&coordinates, dim](const size_t a, const size_t b)
+      {
+        return coordinates(dim, a) < coordinates(dim, b);
+      });
+
+  // In the last dimension, the sorted items are cut into the groups.
+  if (dim + 1 >= coordinates.n_rows)
+  {
+    ChunkItems(begin, end, numGroups, groupEnds);
+    return;
+  }
+
+  // Otherwise, cut them into S slabs, with S the smallest number such that
+  // S^d is at least the number of groups, where d is the number of dimensions
+  // that are left.  Each slab gets a whole number of groups and the matching
+  // share of the items, so that all groups are nearly full, and is tiled in
+  // the next dimension.
+  const size_t numItems = end - begin;
+  const double dimsLeft = (double) (coordinates.n_rows - dim);
+  size_t numSlabs = std::max((size_t) 1,
+      (size_t) std::pow((double) numGroups, 1.0 / dimsLeft));
+  while (std::pow((double) numSlabs, dimsLeft) < (double) numGroups)
+    ++numSlabs;
+
+  for (size_t s = 0; s < numSlabs; ++s)
+  {
+    const size_t groupBegin = s * numGroups / numSlabs;
+    const size_t groupEnd = (s + 1) * numGroups / numSlabs;
+    TileItems(coordinates, order, begin + groupBegin * numItems / numGroups,
+        begin + groupEnd * numItems / numGroups, dim + 1,
+        groupEnd - groupBegin, groupEnds);
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    ChunkItems(const size_t begin,
+               const size_t end,
+               const size_t numGroups,
+               std::vector<size_t>& groupEnds)
+{
+  const size_t numItems = end - begin;
+  for (size_t g = 1; g <= numGroups; ++g)
+    groupEnds.push_back(begin + g * numItems / numGroups);
+}
+
 //! Default constructor for boost::serialization.
 template<typename MetricType,
          typename StatisticType,
@@ -91,4 +91,36 @@ struct IsVector<arma::SpSubview<eT> >
   const static bool value = true;
 };
 
+/**
+ * If value == true, then VecType is a dense Armadillo vector whose elements are
+ * stored contiguously in memory (a Col, a Row, or a column of a matrix), so
+ * that the elements can be read directly through a pointer to the first one.
+ */
+template<typename VecType>
+struct IsContiguousVector
+{
+  const static bool value = false;
+};
+
+// template<>
+template<typename eT>
+struct IsContiguousVector<arma::Col<eT> >
+{
+  const static bool value = true;
+};
+
+// template<>
+template<typename eT>
+struct IsContiguousVector<arma::Row<eT> >
+{
+  const static bool value = true;
+};
+
+// template<>
+template<typename eT>
+struct IsContiguousVector<arma::subview_col<eT> >
+{
+  const static bool value = true;
+};
+
 #endif
@@ -0,0 +1,150 @@
+/**
+ * @file shared_mutex.hpp
+ *
+ * A mutex that many readers or one writer can hold, for C++11.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_SHARED_MUTEX_HPP
+#define MLPACK_CORE_UTIL_SHARED_MUTEX_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+namespace mlpack {
+namespace util {
+
+/**
+ * A mutex that can be held either by any number of threads at once with
+ * lock_shared(), or by a single thread with lock(), like the
+ * std::shared_timed_mutex of C++14.  The member functions have the names of
+ * the standard ones, so std::lock_guard and std::unique_lock can be used for
+ * exclusive ownership, and SharedLock for shared ownership.
+ *
+ * Writers are preferred: once a thread waits in lock(), new shared owners
+ * wait until it has released the mutex, so that a steady stream of readers
+ * can't starve a writer.
+ */
+class SharedMutex
+{
+ public:
+  //! Create the mutex, unlocked.
+  SharedMutex() : readers(0), writer(false), waitingWriters(0) { }
+
+  //! Block until the calling thread is the only owner of the mutex.
+  void lock()
+  {
+    std::unique_lock<std::mutex> stateLock(stateMutex);
+    ++waitingWriters;
+    writerCondition.wait(stateLock,
+        [this]() { return !writer && readers == 0; });
+    --waitingWriters;
+    writer = true;
+  }
+
+  //! Release exclusive ownership of the mutex.
+  void unlock()
+  {
+    {
+      std::lock_guard<std::mutex> stateLock(stateMutex);
+      writer = false;
+    }
+
+    // Waiting writers go first; readers only proceed once none is waiting.
+    writerCondition.notify_one();
+    readerCondition.notify_all();
+  }
+
+  //! Block until the calling thread shares ownership of the mutex.
+  void lock_shared()
+  {
+    std::unique_lock<std::mutex> stateLock(stateMutex);
+    readerCondition.wait(stateLock,
+        [this]() { return !writer && waitingWriters == 0; });
+    ++readers;
+  }
+
+  //! Release shared ownership of the mutex.
+  void unlock_shared()
+  {
+    bool last;
+    {
+      std::lock_guard<std::mutex> stateLock(stateMutex);
+      last = (--readers == 0);
+    }
+
+    if (last)
+      writerCondition.notify_one();
+  }
+
+ private:
+  // Copying a mutex makes no sense.
+  SharedMutex(const SharedMutex& other);
+  SharedMutex& operator=(const SharedMutex& other);
+
+  //! Protects the state below.
+  std::mutex stateMutex;
+  //! Signalled when a writer may be able to take the mutex.
+  std::condition_variable writerCondition;
+  //! Signalled when readers may be able to take the mutex.
+  std::condition_variable readerCondition;
+  //! Number of threads that share ownership of the mutex.
+  size_t readers;
+  //! Whether a thread owns the mutex exclusively.
+  bool writer;
+  //! Number of threads waiting for exclusive ownership.
+  size_t waitingWriters;
+};
+
+/**
+ * Hold a SharedMutex for the lifetime of this object: shared by default, or
+ * exclusively if requested (for code that only knows at runtime whether it
+ * will modify the protected state).
+ */
+class SharedLock
+{
+ public:
+  /**
+   * Lock the given mutex.
+   *
+   * @param mutex Mutex to lock.
+   * @param exclusive If true, take exclusive instead of shared ownership.
+   */
+  explicit SharedLock(SharedMutex& mutex, const bool exclusive = false) :
+      mutex(mutex),
+      exclusive(exclusive)
+  {
+    if (exclusive)
+      mutex.lock();
+    else
+      mutex.lock_shared();
+  }
+
+  //! Unlock the mutex.
+  ~SharedLock()
+  {
+    if (exclusive)
+      mutex.unlock();
+    else
+      mutex.unlock_shared();
+  }
+
+ private:
+  // The lock can't be copied, or the mutex would be unlocked twice.
+  SharedLock(const SharedLock& other);
+  SharedLock& operator=(const SharedLock& other);
+
+  //! The locked mutex.
+  SharedMutex& mutex;
+  //! Whether the mutex is held exclusively.
+  bool exclusive;
+};
+
+} // namespace util
+} // namespace mlpack
+
+#endif
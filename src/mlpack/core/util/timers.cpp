@@ -15,6 +15,7 @@
 #include "cli.hpp"
 #include "log.hpp"
 
+#include <algorithm>
 #include <map>
 #include <string>
 
@@ -64,12 +65,41 @@ void Timer::ResetAll()
   CLI::GetSingleton().timer.Reset();
 }
 
+// Enable tracing.
+void Timer::EnableTracing()
+{
+  CLI::GetSingleton().timer.Tracing() = true;
+}
+
+// Disable tracing.
+void Timer::DisableTracing()
+{
+  CLI::GetSingleton().timer.Tracing() = false;
+}
+
+size_t TimerProfile::Depth() const
+{
+  return std::count(path.begin(), path.end(), '/');
+}
+
+Timers::Timers() :
+    traceStart(high_resolution_clock::now()),
+    enabled(false),
+    tracing(false)
+{
+  // Nothing to do.
+}
+
 // Reset a Timers object.
 void Timers::Reset()
 {
   lock_guard<mutex> lock(timersMutex);
   timers.clear();
-  timerStartTime.clear();
+  profiles.clear();
+  runningTimers.clear();
+  threadNumbers.clear();
+  traceEvents.clear();
+  traceStart = high_resolution_clock::now();
 }
 
 map<string, microseconds> Timers::GetAllTimers()
@@ -92,9 +122,14 @@ bool Timers::GetState(const string& timerName,
                       const thread::id& threadId)
 {
   lock_guard<mutex> lock(timersMutex);
-  if (timerStartTime.count(threadId) == 0)
-    return 0;
-  return (timerStartTime[threadId].count(timerName) > 0);
+  if (runningTimers.count(threadId) == 0)
+    return false;
+
+  for (const RunningTimer& timer : runningTimers[threadId])
+    if (timer.name == timerName)
+      return true;
+
+  return false;
 }
 
 void Timers::PrintTimer(const string& timerName)
@@ -164,12 +199,12 @@ void Timers::StopAllTimers()
   lock_guard<mutex> lock(timersMutex);
 
   high_resolution_clock::time_point currTime = high_resolution_clock::now();
-  for (auto it : timerStartTime)
-    for (auto it2 : it.second)
-      timers[it2.first] += duration_cast<microseconds>(currTime - it2.second);
+  for (auto& it : runningTimers)
+    for (const RunningTimer& timer : it.second)
+      Record(timer, it.first, currTime);
 
-  // If all timers are stopped, we can clear the maps.
-  timerStartTime.clear();
+  // If all timers are stopped, we can clear the map.
+  runningTimers.clear();
 }
 
 void Timers::StartTimer(const string& timerName,
@@ -181,16 +216,23 @@ void Timers::StartTimer(const string& timerName,
 
   lock_guard<mutex> lock(timersMutex);
 
-  if ((timerStartTime.count(threadId) > 0) &&
-      (timerStartTime[threadId].count(timerName)))
+  vector<RunningTimer>& running = runningTimers[threadId];
+  for (const RunningTimer& timer : running)
   {
-    ostringstream error;
-    error << "Timer::Start(): timer '" << timerName
-        << "' has already been started";
-    throw runtime_error(error.str());
+    if (timer.name == timerName)
+    {
+      ostringstream error;
+      error << "Timer::Start(): timer '" << timerName
+          << "' has already been started";
+      throw runtime_error(error.str());
+    }
   }
 
-  high_resolution_clock::time_point currTime = high_resolution_clock::now();
+  // The new timer is nested in the timer that was started last on this thread.
+  RunningTimer timer;
+  timer.name = timerName;
+  timer.path = running.empty() ? timerName :
+      running.back().path + "/" + timerName;
 
   // If the timer is added for the first time.
   if (timers.count(timerName) == 0)
@@ -198,7 +240,8 @@ void Timers::StartTimer(const string& timerName,
     timers[timerName] = (microseconds) 0;
   }
 
-  timerStartTime[threadId][timerName] = currTime;
+  timer.start = high_resolution_clock::now();
+  running.push_back(timer);
 }
 
 void Timers::StopTimer(const string& timerName,
@@ -208,10 +251,21 @@ void Timers::StopTimer(const string& timerName,
   if (!enabled)
     return;
 
+  high_resolution_clock::time_point currTime = high_resolution_clock::now();
+
   lock_guard<mutex> lock(timersMutex);
 
-  if ((timerStartTime.count(threadId) == 0) ||
-      (timerStartTime[threadId].count(timerName) == 0))
+  // Timers are usually stopped in the opposite order to which they were
+  // started, so search from the back.
+  vector<RunningTimer>* running = NULL;
+  if (runningTimers.count(threadId) > 0)
+    running = &runningTimers[threadId];
+
+  size_t index = (running == NULL) ? 0 : running->size();
+  while (index > 0 && (*running)[index - 1].name != timerName)
+    --index;
+
+  if (index == 0)
   {
     ostringstream error;
     error << "Timer::Stop(): no timer with name '" << timerName
@@ -219,14 +273,176 @@ void Timers::StopTimer(const string& timerName,
     throw runtime_error(error.str());
   }
 
-  high_resolution_clock::time_point currTime = high_resolution_clock::now();
+  Record((*running)[index - 1], threadId, currTime);
 
+  // Remove the entries.
+  running->erase(running->begin() + (index - 1));
+  if (running->empty())
+    runningTimers.erase(threadId);
+}
+
+void Timers::Record(const RunningTimer& timer,
+                    const thread::id& threadId,
+                    const high_resolution_clock::time_point& stopTime)
+{
   // Calculate the delta time.
-  timers[timerName] += duration_cast<microseconds>(currTime -
-      timerStartTime[threadId][timerName]);
+  const microseconds duration = duration_cast<microseconds>(stopTime -
+      timer.start);
+  timers[timer.name] += duration;
 
-  // Remove the entries.
-  timerStartTime[threadId].erase(timerName);
-  if (timerStartTime[threadId].empty())
-    timerStartTime.erase(threadId);
+  if (threadNumbers.count(threadId) == 0)
+  {
+    const size_t number = threadNumbers.size();
+    threadNumbers[threadId] = number;
+  }
+  const size_t thread = threadNumbers[threadId];
+
+  TimerProfile& profile = profiles[timer.path];
+  if (profile.calls == 0)
+  {
+    profile.path = timer.path;
+    profile.name = timer.name;
+    profile.min = duration;
+    profile.max = duration;
+  }
+  else
+  {
+    profile.min = std::min(profile.min, duration);
+    profile.max = std::max(profile.max, duration);
+  }
+  ++profile.calls;
+  profile.total += duration;
+  profile.threadTotals[thread] += duration;
+
+  if (tracing)
+  {
+    TraceEvent event;
+    event.path = timer.path;
+    event.thread = thread;
+    event.start = duration_cast<microseconds>(timer.start - traceStart);
+    event.duration = duration;
+    traceEvents.push_back(event);
+  }
+}
+
+vector<TimerProfile> Timers::GetProfile()
+{
+  vector<TimerProfile> result;
+  {
+    lock_guard<mutex> lock(timersMutex);
+    for (auto& it : profiles)
+      result.push_back(it.second);
+  }
+
+  // Sort by path, but with '/' before any other character, so that each timer
+  // comes directly after the timer it is nested in.
+  std::sort(result.begin(), result.end(),
+      [](const TimerProfile& a, const TimerProfile& b)
+      {
+        return std::lexicographical_compare(a.path.begin(), a.path.end(),
+            b.path.begin(), b.path.end(), [](const char x, const char y)
+            {
+              return (x == '/' ? '\0' : x) < (y == '/' ? '\0' : y);
+            });
+      });
+
+  return result;
+}
+
+//! Print a time in seconds, with microsecond precision.
+static void PrintSeconds(const microseconds time)
+{
+  Log::Info << duration_cast<seconds>(time).count() << "." << setw(6)
+      << setfill('0') << (time % seconds(1)).count() << "s";
+}
+
+void Timers::PrintProfile()
+{
+  for (const TimerProfile& profile : GetProfile())
+  {
+    Log::Info << string(2 * (profile.Depth() + 1), ' ') << profile.name
+        << ": " << profile.calls << ((profile.calls == 1) ? " call, " :
+        " calls, ");
+    PrintSeconds(profile.total);
+    Log::Info << " total (avg ";
+    PrintSeconds(profile.Average());
+    Log::Info << ", min ";
+    PrintSeconds(profile.min);
+    Log::Info << ", max ";
+    PrintSeconds(profile.max);
+    Log::Info << ")";
+
+    if (profile.threadTotals.size() > 1)
+      Log::Info << " on " << profile.threadTotals.size() << " threads";
+
+    Log::Info << endl;
+  }
+}
+
+//! Write a string to the stream as a JSON string.
+static void WriteJSONString(ostream& stream, const string& str)
+{
+  stream << '"';
+  for (const char c : str)
+  {
+    if (c == '"' || c == '\\')
+      stream << '\\' << c;
+    else if ((unsigned char) c < 0x20)
+      stream << "\\u" << hex << setw(4) << setfill('0') << (int) c << dec;
+    else
+      stream << c;
+  }
+  stream << '"';
+}
+
+void Timers::WriteProfile(ostream& stream)
+{
+  const vector<TimerProfile> profile = GetProfile();
+
+  stream << "{" << endl << "  \"timers\": [";
+  for (size_t i = 0; i < profile.size(); ++i)
+  {
+    const TimerProfile& p = profile[i];
+    stream << ((i == 0) ? "" : ",") << endl << "    { \"path\": ";
+    WriteJSONString(stream, p.path);
+    stream << ", \"name\": ";
+    WriteJSONString(stream, p.name);
+    stream << ", \"calls\": " << p.calls
+        << ", \"total\": " << p.total.count()
+        << ", \"average\": " << p.Average().count()
+        << ", \"min\": " << p.min.count()
+        << ", \"max\": " << p.max.count()
+        << ", \"threads\": {";
+
+    for (auto it = p.threadTotals.begin(); it != p.threadTotals.end(); ++it)
+    {
+      stream << ((it == p.threadTotals.begin()) ? " " : ", ") << "\""
+          << it->first << "\": " << it->second.count();
+    }
+    stream << " } }";
+  }
+  stream << endl << "  ]" << endl << "}" << endl;
+}
+
+void Timers::WriteTrace(ostream& stream)
+{
+  lock_guard<mutex> lock(timersMutex);
+
+  // Each run is a "complete" event; all times are in microseconds.
+  stream << "{ \"traceEvents\": [";
+  for (size_t i = 0; i < traceEvents.size(); ++i)
+  {
+    const TraceEvent& event = traceEvents[i];
+    const size_t nameStart = event.path.rfind('/');
+    stream << ((i == 0) ? "" : ",") << endl << "  { \"name\": ";
+    WriteJSONString(stream, (nameStart == string::npos) ? event.path :
+        event.path.substr(nameStart + 1));
+    stream << ", \"cat\": \"mlpack\", \"ph\": \"X\", \"ts\": "
+        << event.start.count() << ", \"dur\": " << event.duration.count()
+        << ", \"pid\": 0, \"tid\": " << event.thread << ", \"args\": { "
+        << "\"path\": ";
+    WriteJSONString(stream, event.path);
+    stream << " } }";
+  }
+  stream << endl << "], \"displayTimeUnit\": \"ms\" }" << endl;
 }
@@ -21,6 +21,8 @@
 #include <mutex>
 #include <list>
 #include <atomic>
+#include <vector>
+#include <ostream>
 
 #if defined(_WIN32)
   // uint64_t isn't defined on every windows.
@@ -35,6 +37,46 @@
 
 namespace mlpack {
 
+/**
+ * The statistics of all runs of one timer at one position in the hierarchy of
+ * timers.  A timer that is started while other timers are running on the same
+ * thread is nested inside the timer that was started most recently, so the
+ * same timer can appear at several positions (for instance "total_time/knn"
+ * and "total_time/clustering/knn").
+ */
+struct TimerProfile
+{
+  //! Create an empty profile.
+  TimerProfile() : calls(0), total(0), min(0), max(0) { }
+
+  //! The names of the enclosing timers and of the timer itself, separated by
+  //! '/'.
+  std::string path;
+  //! The name of the timer.
+  std::string name;
+  //! The number of times the timer was run at this position.
+  size_t calls;
+  //! The total time of all runs, summed over all threads.
+  std::chrono::microseconds total;
+  //! The length of the shortest run.
+  std::chrono::microseconds min;
+  //! The length of the longest run.
+  std::chrono::microseconds max;
+  //! The total time of all runs on each thread; threads are numbered in the
+  //! order in which they first used a timer.
+  std::map<size_t, std::chrono::microseconds> threadTotals;
+
+  //! Get the average length of a run.
+  std::chrono::microseconds Average() const
+  {
+    return (calls == 0) ? std::chrono::microseconds(0) :
+        std::chrono::microseconds(total.count() / calls);
+  }
+
+  //! Get the depth of the timer in the hierarchy (0 for a top-level timer).
+  size_t Depth() const;
+};
+
 /**
  * The timer class provides a way for mlpack methods to be timed.  The three
  * methods contained in this class allow a named timer to be started and
@@ -92,13 +134,34 @@ class Timer
    * existing timers.
    */
   static void ResetAll();
+
+  /**
+   * Record every run of every timer, so that a trace can be written with
+   * Timers::WriteTrace().  This uses memory for each run, so it is off by
+   * default.
+   */
+  static void EnableTracing();
+
+  //! Stop recording every run of every timer.
+  static void DisableTracing();
 };
 
+/**
+ * The Timers class holds all of the timers of a program.  For each timer it
+ * keeps the total time over all threads, and a profile of the timer at each
+ * position in the hierarchy of timers (see TimerProfile).  The profile can be
+ * printed, or written as JSON with WriteProfile(); if tracing is enabled, each
+ * run of each timer is also recorded and can be written with WriteTrace() in
+ * the Chrome trace event format, to be viewed in chrome://tracing or Perfetto.
+ *
+ * All functions are thread-safe.  Timers are meant for coarse-grained work;
+ * each call takes a lock, so don't start and stop them in tight loops.
+ */
 class Timers
 {
  public:
   //! Default to disabled.
-  Timers() : enabled(false) { }
+  Timers();
 
   /**
    * Returns a copy of all the timers used via this interface.
@@ -162,22 +225,100 @@ class Timers
    */
   void StopAllTimers();
 
+  /**
+   * Returns the profile of every timer at every position in the hierarchy of
+   * timers.  Each timer comes directly after the timer it is nested in, and
+   * timers nested in the same timer are sorted by name.  Running timers are not
+   * included.
+   */
+  std::vector<TimerProfile> GetProfile();
+
+  /**
+   * Print the profile of all timers as a tree, with the number of calls and
+   * the total, average, minimum, and maximum time of each timer.
+   */
+  void PrintProfile();
+
+  /**
+   * Write the profile of all timers as JSON to the given stream.  The result
+   * is an object with a "timers" array, holding one object for each element
+   * of GetProfile(); all times are in microseconds.
+   *
+   * @param stream Stream to write to.
+   */
+  void WriteProfile(std::ostream& stream);
+
+  /**
+   * Write every recorded run of every timer to the given stream, in the Chrome
+   * trace event format.  Runs are only recorded while tracing is enabled.
+   *
+   * @param stream Stream to write to.
+   */
+  void WriteTrace(std::ostream& stream);
+
   //! Modify whether or not timing is enabled.
   std::atomic<bool>& Enabled() { return enabled; }
   //! Get whether or not timing is enabled.
   bool Enabled() const { return enabled; }
 
+  //! Modify whether or not every run of every timer is recorded.
+  std::atomic<bool>& Tracing() { return tracing; }
+  //! Get whether or not every run of every timer is recorded.
+  bool Tracing() const { return tracing; }
+
  private:
+  //! A timer that is running on some thread.
+  struct RunningTimer
+  {
+    //! The name of the timer.
+    std::string name;
+    //! The position of the timer in the hierarchy of timers.
+    std::string path;
+    //! When the timer was started.
+    std::chrono::high_resolution_clock::time_point start;
+  };
+
+  //! One recorded run of a timer.
+  struct TraceEvent
+  {
+    //! The position of the timer in the hierarchy of timers.
+    std::string path;
+    //! The number of the thread the timer ran on.
+    size_t thread;
+    //! When the timer was started, relative to traceStart.
+    std::chrono::microseconds start;
+    //! How long the timer ran.
+    std::chrono::microseconds duration;
+  };
+
+  /**
+   * Record that the given timer stopped at the given time on the given thread.
+   * The timers mutex must be held.
+   */
+  void Record(const RunningTimer& timer,
+              const std::thread::id& threadId,
+              const std::chrono::high_resolution_clock::time_point& stopTime);
+
   //! A map of all the timers that are being tracked.
   std::map<std::string, std::chrono::microseconds> timers;
+  //! The profile of each timer, indexed by path.
+  std::map<std::string, TimerProfile> profiles;
   //! A mutex for modifying the timers.
   std::mutex timersMutex;
-  //! A map for the starting values of the timers.
-  std::map<std::thread::id, std::map<std::string,
-      std::chrono::high_resolution_clock::time_point>> timerStartTime;
+  //! The timers running on each thread, in the order they were started.
+  std::map<std::thread::id, std::vector<RunningTimer>> runningTimers;
+  //! The number given to each thread that has used a timer.
+  std::map<std::thread::id, size_t> threadNumbers;
+
+  //! The recorded runs of all timers, if tracing is enabled.
+  std::vector<TraceEvent> traceEvents;
+  //! The time that trace events are relative to.
+  std::chrono::high_resolution_clock::time_point traceStart;
 
   //! Whether or not timing is enabled.
   std::atomic<bool> enabled;
+  //! Whether or not every run of every timer is recorded.
+  std::atomic<bool> tracing;
 };
 
 } // namespace mlpack
@@ -0,0 +1,569 @@
+/**
+ * @file im2col_convolution.hpp
+ *
+ * Implementation of the convolution through im2col lowering and matrix
+ * products.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution by lowering every patch of the input
+ * that the filter is applied to into a column of a matrix (im2col), so that the
+ * convolution becomes a matrix product.  Like NaiveConvolution, this class can
+ * be used with the valid or the full border type for single two-dimensional
+ * slices.
+ *
+ * More importantly, when it is given as a convolution rule to the Convolution,
+ * AtrousConvolution or TransposedConvolution layers, these layers lower all the
+ * input maps of the whole batch at once, so that each of the forward, backward
+ * and gradient passes is a single large matrix product (BLAS GEMM) instead of
+ * one small convolution per pair of input and output maps:
+ *
+ *  - BatchConvolution() computes the valid convolution of every point with
+ *    every filter, as filters^T * im2col(input);
+ *  - BatchTransposedConvolution() computes its adjoint with respect to the
+ *    input, as col2im(filters * error), which is the gradient with respect to
+ *    the input for any stride and dilation;
+ *  - BatchFilterGradient() computes its adjoint with respect to the filters, as
+ *    im2col(input) * error^T.
+ *
+ * For these three functions, each point of the batch is a group of consecutive
+ * slices of a cube, one slice per map, and the filters are the columns of a
+ * matrix, one column per output map, each holding the (kW x kH) filters of all
+ * input maps one after another.  This is the memory layout of the weights of
+ * the Convolution layer, so its weights can be used without a copy.
+ *
+ * The memory needed for the lowered input is kW * kH times the memory of the
+ * input of the layer (ignoring the stride).
+ *
+ * @code
+ * Convolution<Im2ColConvolution<ValidConvolution>,
+ *             Im2ColConvolution<FullConvolution>,
+ *             Im2ColConvolution<ValidConvolution>> layer(3, 16, 5, 5);
+ * @endcode
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution
+{
+ public:
+  /*
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    const arma::Cube<eT> inputCube(const_cast<eT*>(input.memptr()),
+        input.n_rows, input.n_cols, 1, false, true);
+
+    arma::Mat<eT> columns;
+    Im2Col(inputCube, 1, filter.n_rows, filter.n_cols, dW, dH, dilationW,
+        dilationH, columns);
+
+    output.set_size(
+        OutputSize(input.n_rows, filter.n_rows, dW, dilationW),
+        OutputSize(input.n_cols, filter.n_cols, dH, dilationH));
+    arma::Col<eT>(output.memptr(), output.n_elem, false, true) =
+        columns.t() * arma::vectorise(filter);
+  }
+
+  /*
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    // Pad the input to the working output shape, as NaiveConvolution does.
+    size_t outputRows = (input.n_rows - 1) * dW + 2 * (filter.n_rows - 1)
+        * dilationW + 1;
+    size_t outputCols = (input.n_cols - 1) * dH + 2 * (filter.n_cols - 1)
+        * dilationH + 1;
+
+    for (size_t i = 0; i < dW; i++)
+    {
+      if (((((i + outputRows - 2 * (filter.n_rows - 1) * dilationW - 1) % dW)
+          + dW) % dW) == i)
+      {
+        outputRows += i;
+        break;
+      }
+    }
+    for (size_t i = 0; i < dH; i++)
+    {
+      if (((((i + outputCols - 2 * (filter.n_cols - 1) * dilationH - 1) % dH)
+          + dH) % dH) == i)
+      {
+        outputCols += i;
+        break;
+      }
+    }
+
+    arma::Mat<eT> inputPadded = arma::zeros<arma::Mat<eT> >(outputRows,
+        outputCols);
+    inputPadded.submat((filter.n_rows - 1) * dilationW, (filter.n_cols - 1)
+        * dilationH, (filter.n_rows - 1) * dilationW + input.n_rows - 1,
+        (filter.n_cols - 1) * dilationH + input.n_cols - 1) = input;
+
+    Im2ColConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output, 1, 1, dilationW, dilationH);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        filter.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Compute the valid convolution of each point of the batch with each filter,
+   * summed over the input maps, with one matrix product.
+   *
+   * @param input Input maps, channels consecutive slices per point.
+   * @param filters Filters, one column per output map (see the class
+   *     documentation).
+   * @param kW Width of the filters.
+   * @param kH Height of the filters.
+   * @param output Output maps, filters.n_cols consecutive slices per point; it
+   *     must have the size of the valid convolution and is overwritten.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void BatchConvolution(const arma::Cube<eT>& input,
+                               const arma::Mat<eT>& filters,
+                               const size_t kW,
+                               const size_t kH,
+                               arma::Cube<eT>& output,
+                               const size_t dW = 1,
+                               const size_t dH = 1,
+                               const size_t dilationW = 1,
+                               const size_t dilationH = 1)
+  {
+    const size_t channels = filters.n_rows / (kW * kH);
+
+    arma::Mat<eT> columns;
+    Im2Col(input, channels, kW, kH, dW, dH, dilationW, dilationH, columns);
+
+    const size_t points = output.n_rows * output.n_cols;
+    if (columns.n_cols != points * (output.n_slices / filters.n_cols))
+    {
+      throw std::invalid_argument("Im2ColConvolution::BatchConvolution(): "
+          "the output does not have the size of the convolution");
+    }
+
+    const arma::Mat<eT> products = filters.t() * columns;
+
+    // Each point of the output holds one map after the other.
+    for (size_t b = 0; b < output.n_slices / filters.n_cols; ++b)
+    {
+      arma::Mat<eT>(output.slice_memptr(b * filters.n_cols), points,
+          filters.n_cols, false, true) =
+          products.cols(b * points, (b + 1) * points - 1).t();
+    }
+  }
+
+  /*
+   * Compute the adjoint of BatchConvolution() with respect to its input: the
+   * given error of each output map is spread back over the input maps, and
+   * added to the given output.
+   *
+   * @param error Error of the output maps, filters.n_cols consecutive slices
+   *     per point.
+   * @param filters Filters, one column per output map (see the class
+   *     documentation).
+   * @param kW Width of the filters.
+   * @param kH Height of the filters.
+   * @param output Error of the input maps, filters.n_rows / (kW * kH)
+   *     consecutive slices per point; it must be large enough to hold the
+   *     input of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void BatchTransposedConvolution(const arma::Cube<eT>& error,
+                                         const arma::Mat<eT>& filters,
+                                         const size_t kW,
+                                         const size_t kH,
+                                         arma::Cube<eT>& output,
+                                         const size_t dW = 1,
+                                         const size_t dH = 1,
+                                         const size_t dilationW = 1,
+                                         const size_t dilationH = 1)
+  {
+    arma::Mat<eT> errors;
+    ErrorMatrix(error, filters.n_cols, errors);
+
+    const arma::Mat<eT> columns = filters * errors.t();
+    Col2Im(columns, filters.n_rows / (kW * kH), kW, kH, dW, dH, dilationW,
+        dilationH, error.n_rows, error.n_cols, output);
+  }
+
+  /*
+   * Compute the adjoint of BatchConvolution() with respect to its filters: the
+   * gradient of the filters given the input maps and the error of the output
+   * maps, summed over the batch.
+   *
+   * @param input Input maps, filterGradient.n_rows / (kW * kH) consecutive
+   *     slices per point.
+   * @param error Error of the output maps, filterGradient.n_cols consecutive
+   *     slices per point.
+   * @param kW Width of the filters.
+   * @param kH Height of the filters.
+   * @param filterGradient Gradient of the filters, in the layout of the
+   *     filters; it must already have its size, and is overwritten.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void BatchFilterGradient(const arma::Cube<eT>& input,
+                                  const arma::Cube<eT>& error,
+                                  const size_t kW,
+                                  const size_t kH,
+                                  arma::Mat<eT>& filterGradient,
+                                  const size_t dW = 1,
+                                  const size_t dH = 1,
+                                  const size_t dilationW = 1,
+                                  const size_t dilationH = 1)
+  {
+    arma::Mat<eT> columns;
+    Im2Col(input, filterGradient.n_rows / (kW * kH), kW, kH, dW, dH,
+        dilationW, dilationH, columns);
+
+    arma::Mat<eT> errors;
+    ErrorMatrix(error, filterGradient.n_cols, errors);
+
+    if (columns.n_cols != errors.n_rows)
+    {
+      throw std::invalid_argument("Im2ColConvolution::BatchFilterGradient(): "
+          "the error does not have the size of the convolution");
+    }
+
+    filterGradient = columns * errors;
+  }
+
+  /*
+   * Lower the input into a matrix with one column for each position of the
+   * filter on each point, holding the values of the patch under the filter for
+   * all input maps.
+   *
+   * @param input Input maps, channels consecutive slices per point.
+   * @param channels Number of input maps of each point.
+   * @param kW Width of the filters.
+   * @param kH Height of the filters.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param columns Matrix to store the patches in.
+   */
+  template<typename eT>
+  static void Im2Col(const arma::Cube<eT>& input,
+                     const size_t channels,
+                     const size_t kW,
+                     const size_t kH,
+                     const size_t dW,
+                     const size_t dH,
+                     const size_t dilationW,
+                     const size_t dilationH,
+                     arma::Mat<eT>& columns)
+  {
+    const size_t outputRows = OutputSize(input.n_rows, kW, dW, dilationW);
+    const size_t outputCols = OutputSize(input.n_cols, kH, dH, dilationH);
+    const size_t points = outputRows * outputCols;
+    const size_t batchSize = input.n_slices / channels;
+
+    columns.set_size(kW * kH * channels, points * batchSize);
+
+    #pragma omp parallel for
+    for (omp_size_t n = 0; n < (omp_size_t) columns.n_cols; ++n)
+    {
+      const size_t b = n / points;
+      const size_t i = (n % points) % outputRows;
+      const size_t j = (n % points) / outputRows;
+
+      eT* columnPtr = columns.colptr(n);
+      for (size_t c = 0; c < channels; ++c)
+      {
+        const eT* slicePtr = input.slice_memptr(b * channels + c);
+        for (size_t kj = 0; kj < kH; ++kj)
+        {
+          const eT* inputPtr = slicePtr + (j * dH + kj * dilationH) *
+              input.n_rows + i * dW;
+          for (size_t ki = 0; ki < kW; ++ki, inputPtr += dilationW)
+            *(columnPtr++) = *inputPtr;
+        }
+      }
+    }
+  }
+
+  /*
+   * Add the columns of a matrix of patches, as given by Im2Col(), back into the
+   * maps they were taken from.
+   *
+   * @param columns Matrix of patches.
+   * @param channels Number of maps of each point.
+   * @param kW Width of the filters.
+   * @param kH Height of the filters.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param outputRows Number of positions of the filter in the x direction.
+   * @param outputCols Number of positions of the filter in the y direction.
+   * @param output Maps to add the patches to, channels consecutive slices per
+   *     point.
+   */
+  template<typename eT>
+  static void Col2Im(const arma::Mat<eT>& columns,
+                     const size_t channels,
+                     const size_t kW,
+                     const size_t kH,
+                     const size_t dW,
+                     const size_t dH,
+                     const size_t dilationW,
+                     const size_t dilationH,
+                     const size_t outputRows,
+                     const size_t outputCols,
+                     arma::Cube<eT>& output)
+  {
+    if (output.n_rows < (outputRows - 1) * dW + (kW - 1) * dilationW + 1 ||
+        output.n_cols < (outputCols - 1) * dH + (kH - 1) * dilationH + 1 ||
+        columns.n_cols != outputRows * outputCols *
+        (output.n_slices / channels))
+    {
+      throw std::invalid_argument("Im2ColConvolution::Col2Im(): the output "
+          "is too small for the given patches");
+    }
+
+    const size_t points = outputRows * outputCols;
+
+    // Each slice only receives its own rows of the columns, so the slices can
+    // be filled in parallel.
+    #pragma omp parallel for
+    for (omp_size_t s = 0; s < (omp_size_t) output.n_slices; ++s)
+    {
+      const size_t b = s / channels;
+      const size_t c = s % channels;
+
+      eT* slicePtr = output.slice_memptr(s);
+      for (size_t j = 0; j < outputCols; ++j)
+      {
+        for (size_t i = 0; i < outputRows; ++i)
+        {
+          const eT* columnPtr = columns.colptr(b * points + j * outputRows + i)
+              + c * kW * kH;
+          for (size_t kj = 0; kj < kH; ++kj)
+          {
+            eT* outputPtr = slicePtr + (j * dH + kj * dilationH) *
+                output.n_rows + i * dW;
+            for (size_t ki = 0; ki < kW; ++ki, outputPtr += dilationW)
+              *outputPtr += *(columnPtr++);
+          }
+        }
+      }
+    }
+  }
+
+ private:
+  //! Return the number of positions of a filter along one dimension.
+  static size_t OutputSize(const size_t size,
+                           const size_t k,
+                           const size_t s,
+                           const size_t d)
+  {
+    return (size - (k - 1) * d - 1) / s + 1;
+  }
+
+  //! Arrange the error of each point as rows of a matrix, one column per map.
+  template<typename eT>
+  static void ErrorMatrix(const arma::Cube<eT>& error,
+                          const size_t channels,
+                          arma::Mat<eT>& errors)
+  {
+    const size_t points = error.n_rows * error.n_cols;
+    const size_t batchSize = error.n_slices / channels;
+
+    errors.set_size(points * batchSize, channels);
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      errors.rows(b * points, (b + 1) * points - 1) = arma::Mat<eT>(
+          const_cast<eT*>(error.slice_memptr(b * channels)), points, channels,
+          false, true);
+    }
+  }
+};  // class Im2ColConvolution
+
+/**
+ * Whether the given convolution rule is Im2ColConvolution, in which case the
+ * convolution layers lower the whole batch into one matrix product.
+ */
+template<typename ConvolutionRuleType>
+struct IsIm2ColConvolution
+{
+  static const bool value = false;
+};
+
+// Specialization for Im2ColConvolution.
+template<typename BorderMode>
+struct IsIm2ColConvolution<Im2ColConvolution<BorderMode>>
+{
+  static const bool value = true;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -37,6 +37,10 @@ namespace ann /** Artificial Neural Network. */ {
 /**
  * Implementation of a standard feed forward network.
  *
+ * The network, its parameters and its layers use double precision
+ * (arma::mat); layers instantiated with single precision data types can only
+ * be used on their own.
+ *
  * @tparam OutputLayerType The output layer type used to evaluate the network.
  * @tparam InitializationRuleType Rule used to initialize the weight matrix.
  * @tparam CustomLayers Any set of custom layers that could be a part of the
@@ -129,10 +133,22 @@ class FFN
    * If you want to pass in a parameter and discard the original parameter
    * object, be sure to use std::move to avoid unnecessary copy.
    *
+   * The predictors are passed through the network in batches of batchSize
+   * columns, so that every layer processes a whole batch at once (i.e. one
+   * matrix-matrix product per layer and batch instead of one matrix-vector
+   * product per point).  Larger batches give higher throughput at the cost of
+   * more temporary memory in each layer.  The output of each layer is written
+   * to the output parameter of the layer, whose memory is reused by the next
+   * batch of the same size.  Before batchSize was added, points were
+   * predicted one at a time; pass batchSize = 1 to do that.
+   *
    * @param predictors Input predictors.
    * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of points to predict at once.
    */
-  void Predict(arma::mat predictors, arma::mat& results);
+  void Predict(arma::mat predictors,
+               arma::mat& results,
+               const size_t batchSize = 128);
 
   /**
    * Evaluate the feedforward network with the given ppredictors and responses.
@@ -235,7 +251,9 @@ class FFN
 
   /**
    * Shuffle the order of function visitation. This may be called by the
-   * optimizer.
+   * optimizer.  Only the order of the points is shuffled; the predictors and
+   * responses stay where they are, and the points of each mini-batch are
+   * gathered into reusable buffers.
    */
   void Shuffle();
 
@@ -371,6 +389,36 @@ class FFN
    */
   void Swap(FFN& network);
 
+  /**
+   * Get the predictors of the mini-batch of the given size that starts at the
+   * given position in the visitation order.  If the points have not been
+   * shuffled, the result is an alias of the predictors; otherwise it is an
+   * alias of a buffer the points are gathered into, reused from one mini-batch
+   * to the next.  Either way the result is only valid until the next call.
+   *
+   * @param begin Position of the first point of the mini-batch.
+   * @param batchSize Number of points in the mini-batch.
+   */
+  arma::mat BatchPredictors(const size_t begin, const size_t batchSize);
+
+  /**
+   * Get the responses of the mini-batch of the given size that starts at the
+   * given position in the visitation order, as BatchPredictors() does.
+   *
+   * @param begin Position of the first point of the mini-batch.
+   * @param batchSize Number of points in the mini-batch.
+   */
+  arma::mat BatchResponses(const size_t begin, const size_t batchSize);
+
+  /**
+   * Get an alias of the given columns of the data, in the visitation order,
+   * gathering them into the given buffer if the points have been shuffled.
+   */
+  arma::mat BatchColumns(arma::mat& data,
+                         arma::mat& buffer,
+                         const size_t begin,
+                         const size_t batchSize);
+
   //! Instantiated outputlayer used to evaluate the network.
   OutputLayerType outputLayer;
 
@@ -396,6 +444,16 @@ class FFN
   //! The matrix of responses to the input data points.
   arma::mat responses;
 
+  //! The order in which the points are visited; empty if they have not been
+  //! shuffled.
+  arma::uvec visitationOrder;
+
+  //! The buffer the predictors of a shuffled mini-batch are gathered into.
+  arma::mat batchPredictors;
+
+  //! The buffer the responses of a shuffled mini-batch are gathered into.
+  arma::mat batchResponses;
+
   //! Matrix of (trained) parameters.
   arma::mat parameter;
 
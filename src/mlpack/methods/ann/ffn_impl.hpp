@@ -23,6 +23,8 @@
 #include "visitor/set_input_height_visitor.hpp"
 #include "visitor/set_input_width_visitor.hpp"
 
+#include "layer/batch_norm.hpp"
+
 #include <boost/serialization/variant.hpp>
 
 namespace mlpack {
@@ -60,6 +62,7 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::ResetData(
   numFunctions = responses.n_cols;
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
+  visitationOrder.reset();
   this->deterministic = true;
   ResetDeterministic();
 
@@ -172,7 +175,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward(
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
-    arma::mat predictors, arma::mat& results)
+    arma::mat predictors, arma::mat& results, const size_t batchSize)
 {
   if (parameter.is_empty())
     ResetParameters();
@@ -183,23 +186,35 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
     ResetDeterministic();
   }
 
-  arma::mat resultsTemp;
-  Forward(std::move(arma::mat(predictors.colptr(0),
-      predictors.n_rows, 1, false, true)));
-  resultsTemp = boost::apply_visitor(outputParameterVisitor,
-      network.back()).col(0);
+  if (batchSize == 0)
+  {
+    Log::Fatal << "FFN::Predict(): batchSize must be greater than 0!"
+        << std::endl;
+  }
 
-  results = arma::mat(resultsTemp.n_elem, predictors.n_cols);
-  results.col(0) = resultsTemp.col(0);
+  if (predictors.n_cols == 0)
+  {
+    results.reset();
+    return;
+  }
 
-  for (size_t i = 1; i < predictors.n_cols; i++)
+  for (size_t i = 0; i < predictors.n_cols; i += batchSize)
   {
-    Forward(std::move(arma::mat(predictors.colptr(i),
-        predictors.n_rows, 1, false, true)));
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols - i));
+
+    // Forward the batch as an alias of the predictors, so no copy is made.
+    Forward(std::move(arma::mat(predictors.colptr(i), predictors.n_rows,
+        effectiveBatchSize, false, true)));
 
-    resultsTemp = boost::apply_visitor(outputParameterVisitor,
+    const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
         network.back());
-    results.col(i) = resultsTemp.col(0);
+
+    // Now that we know the output size, allocate the results once.
+    if (i == 0)
+      results.set_size(output.n_rows, predictors.n_cols);
+
+    results.cols(i, i + effectiveBatchSize - 1) = output;
   }
 }
 
@@ -259,10 +274,10 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     ResetDeterministic();
   }
 
-  Forward(std::move(predictors.cols(begin, begin + batchSize - 1)));
+  Forward(BatchPredictors(begin, batchSize));
   double res = outputLayer.Forward(
       std::move(boost::apply_visitor(outputParameterVisitor, network.back())),
-      std::move(responses.cols(begin, begin + batchSize - 1)));
+      BatchResponses(begin, batchSize));
 
   for (size_t i = 0; i < network.size(); ++i)
   {
@@ -320,10 +335,14 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     ResetDeterministic();
   }
 
-  Forward(std::move(predictors.cols(begin, begin + batchSize - 1)));
+  // The mini-batch is not copied unless the points have been shuffled.
+  arma::mat input = BatchPredictors(begin, batchSize);
+  arma::mat target = BatchResponses(begin, batchSize);
+
+  Forward(std::move(input));
   double res = outputLayer.Forward(
       std::move(boost::apply_visitor(outputParameterVisitor, network.back())),
-      std::move(responses.cols(begin, begin + batchSize - 1)));
+      std::move(target));
 
   for (size_t i = 0; i < network.size(); ++i)
   {
@@ -332,12 +351,11 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
   outputLayer.Backward(
       std::move(boost::apply_visitor(outputParameterVisitor, network.back())),
-      std::move(responses.cols(begin, begin + batchSize - 1)),
-      std::move(error));
+      std::move(target), std::move(error));
 
   Backward();
   ResetGradients(gradient);
-  Gradient(std::move(predictors.cols(begin, begin + batchSize - 1)));
+  Gradient(std::move(input));
 
   return res;
 }
@@ -357,7 +375,60 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
 {
-  math::ShuffleData(predictors, responses, predictors, responses);
+  if (visitationOrder.n_elem != predictors.n_cols)
+  {
+    visitationOrder = arma::linspace<arma::uvec>(0, predictors.n_cols - 1,
+        predictors.n_cols);
+  }
+
+  std::shuffle(visitationOrder.begin(), visitationOrder.end(),
+      math::randGen);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+arma::mat FFN<OutputLayerType, InitializationRuleType,
+              CustomLayers...>::BatchPredictors(const size_t begin,
+                                                const size_t batchSize)
+{
+  return BatchColumns(predictors, batchPredictors, begin, batchSize);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+arma::mat FFN<OutputLayerType, InitializationRuleType,
+              CustomLayers...>::BatchResponses(const size_t begin,
+                                               const size_t batchSize)
+{
+  return BatchColumns(responses, batchResponses, begin, batchSize);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+arma::mat FFN<OutputLayerType, InitializationRuleType,
+              CustomLayers...>::BatchColumns(arma::mat& data,
+                                             arma::mat& buffer,
+                                             const size_t begin,
+                                             const size_t batchSize)
+{
+  // Unshuffled points are consecutive, so the data can be used in place.
+  if (visitationOrder.n_elem != data.n_cols)
+  {
+    return arma::mat(data.colptr(begin), data.n_rows, batchSize, false,
+        true);
+  }
+
+  // The buffer only allocates memory when the batch size grows.
+  if (buffer.n_rows != data.n_rows || buffer.n_cols < batchSize)
+    buffer.set_size(data.n_rows, batchSize);
+
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    std::memcpy(buffer.colptr(i), data.colptr(visitationOrder[begin + i]),
+        sizeof(double) * data.n_rows);
+  }
+
+  return arma::mat(buffer.memptr(), data.n_rows, batchSize, false, true);
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -544,6 +615,7 @@ void FFN<OutputLayerType, InitializationRuleType,
   std::swap(this->network, network.network);
   std::swap(predictors, network.predictors);
   std::swap(responses, network.responses);
+  std::swap(visitationOrder, network.visitationOrder);
   std::swap(parameter, network.parameter);
   std::swap(numFunctions, network.numFunctions);
   std::swap(error, network.error);
@@ -566,6 +638,7 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     reset(network.reset),
     predictors(network.predictors),
     responses(network.responses),
+    visitationOrder(network.visitationOrder),
     parameter(network.parameter),
     numFunctions(network.numFunctions),
     error(network.error),
@@ -582,6 +655,37 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     this->network.push_back(boost::apply_visitor(copyVisitor,
         network.network[i]));
   }
+
+  // The copied layers hold copies of the weights; make them use the copied
+  // parameters instead, so that training the copy changes its predictions.
+  // Resetting a layer may overwrite its weights, so restore them afterwards.
+  if (!parameter.is_empty())
+  {
+    size_t offset = 0;
+    for (size_t i = 0; i < this->network.size(); ++i)
+    {
+      offset += boost::apply_visitor(WeightSetVisitor(std::move(parameter),
+          offset), this->network[i]);
+
+      // Resetting a BatchNorm layer also clears the running statistics of the
+      // training data, which the copy must keep.
+      BatchNorm<>** batchNorm = boost::get<BatchNorm<>*>(&this->network[i]);
+      if (batchNorm)
+      {
+        const arma::running_stat_vec<arma::colvec> stats =
+            (*batchNorm)->Stats();
+        boost::apply_visitor(resetVisitor, this->network[i]);
+        (*batchNorm)->Stats() = stats;
+      }
+      else
+      {
+        boost::apply_visitor(resetVisitor, this->network[i]);
+      }
+    }
+
+    parameter = network.parameter;
+    ResetDeterministic();
+  }
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -595,6 +699,7 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     reset(network.reset),
     predictors(std::move(network.predictors)),
     responses(std::move(network.responses)),
+    visitationOrder(std::move(network.visitationOrder)),
     parameter(std::move(network.parameter)),
     numFunctions(network.numFunctions),
     error(std::move(network.error)),
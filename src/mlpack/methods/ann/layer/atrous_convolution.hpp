@@ -19,6 +19,7 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 
 #include "layer_types.hpp"
 
@@ -32,6 +33,10 @@ namespace ann /** Artificial Neural Network. */ {
  * spaces included between the kernel cells, in order to capture a larger
  * field of reception, without having to increase dicrete kernel sizes.
  *
+ * As for the Convolution layer, any of the convolution rules may be
+ * Im2ColConvolution, to lower the whole batch into one matrix product in the
+ * corresponding pass.
+ *
  * @tparam ForwardConvolutionRule Atrous Convolution to perform forward process.
  * @tparam BackwardConvolutionRule Atrous Convolution to perform backward process.
  * @tparam GradientConvolutionRule Atrous Convolution to calculate gradient.
@@ -135,36 +135,51 @@ void AtrousConvolution<
       outSize * batchSize, false, false);
   outputTemp.zeros();
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
+  if (IsIm2ColConvolution<ForwardConvolutionRule>::value)
   {
-    if (outMap != 0 && outMap % outSize == 0)
-    {
-      batchCount++;
-      outMapIdx = 0;
-    }
-
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
+    // Convolve all input maps of the whole batch with one matrix product.
+    const arma::mat filters(weight.memptr(), kW * kH * inSize, outSize, false,
+        true);
+    Im2ColConvolution<>::BatchConvolution((padW != 0 || padH != 0) ?
+        inputPaddedTemp : inputTemp, filters, kW, kH, outputTemp, dW, dH,
+        dilationW, dilationH);
+
+    for (size_t outMap = 0; outMap < outSize * batchSize; outMap++)
+      outputTemp.slice(outMap) += bias(outMap % outSize);
+  }
+  else
+  {
+    for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
+        outSize * batchSize; outMap++)
     {
-      arma::Mat<eT> convOutput;
-
-      if (padW != 0 || padH != 0)
+      if (outMap != 0 && outMap % outSize == 0)
       {
-        ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput, dW, dH,
-            dilationW, dilationH);
+        batchCount++;
+        outMapIdx = 0;
       }
-      else
+
+      for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
       {
-        ForwardConvolutionRule::Convolution(inputTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput, dW, dH,
-            dilationW, dilationH);
+        arma::Mat<eT> convOutput;
+
+        if (padW != 0 || padH != 0)
+        {
+          ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap +
+              batchCount * inSize), weight.slice(outMapIdx), convOutput, dW, dH,
+              dilationW, dilationH);
+        }
+        else
+        {
+          ForwardConvolutionRule::Convolution(inputTemp.slice(inMap +
+              batchCount * inSize), weight.slice(outMapIdx), convOutput, dW, dH,
+              dilationW, dilationH);
+        }
+
+        outputTemp.slice(outMap) += convOutput;
       }
 
-      outputTemp.slice(outMap) += convOutput;
+      outputTemp.slice(outMap) += bias(outMap % outSize);
     }
-
-    outputTemp.slice(outMap) += bias(outMap % outSize);
   }
 
   outputWidth = outputTemp.n_rows;
@@ -196,6 +211,35 @@ void AtrousConvolution<
       inputTemp.n_cols, inputTemp.n_slices, false, false);
   gTemp.zeros();
 
+  if (IsIm2ColConvolution<BackwardConvolutionRule>::value)
+  {
+    // Spread the error of all output maps of the whole batch back over the
+    // (padded) input maps, through the dilated filters, with one matrix
+    // product.
+    const arma::mat filters(weight.memptr(), kW * kH * inSize, outSize, false,
+        true);
+    if (padW != 0 || padH != 0)
+    {
+      arma::cube gPadded(inputPaddedTemp.n_rows, inputPaddedTemp.n_cols,
+          inputPaddedTemp.n_slices, arma::fill::zeros);
+      Im2ColConvolution<>::BatchTransposedConvolution(mappedError, filters, kW,
+          kH, gPadded, dW, dH, dilationW, dilationH);
+
+      for (size_t i = 0; i < gTemp.n_slices; i++)
+      {
+        gTemp.slice(i) = gPadded.slice(i).submat(padW, padH,
+            padW + gTemp.n_rows - 1, padH + gTemp.n_cols - 1);
+      }
+    }
+    else
+    {
+      Im2ColConvolution<>::BatchTransposedConvolution(mappedError, filters, kW,
+          kH, gTemp, dW, dH, dilationW, dilationH);
+    }
+
+    return;
+  }
+
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
@@ -246,6 +290,30 @@ void AtrousConvolution<
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
+  if (IsIm2ColConvolution<GradientConvolutionRule>::value)
+  {
+    const arma::cube mappedError(error.memptr(), outputWidth, outputHeight,
+        outSize * batchSize, false, false);
+
+    // Correlate the input maps with the error of the output maps at the
+    // dilated positions of the filters, for the whole batch at once.
+    gradient.set_size(weights.n_elem, 1);
+    arma::mat filterGradient(gradient.memptr(), kW * kH * inSize, outSize,
+        false, true);
+    Im2ColConvolution<>::BatchFilterGradient((padW != 0 || padH != 0) ?
+        inputPaddedTemp : inputTemp, mappedError, kW, kH, filterGradient, dW,
+        dH, dilationW, dilationH);
+
+    gradient.rows(weight.n_elem, weights.n_elem - 1).zeros();
+    for (size_t outMap = 0; outMap < outSize * batchSize; outMap++)
+    {
+      gradient(weight.n_elem + (outMap % outSize)) +=
+          arma::accu(mappedError.slice(outMap));
+    }
+
+    return;
+  }
+
   arma::cube mappedError;
   if (padW != 0 && padH != 0)
   {
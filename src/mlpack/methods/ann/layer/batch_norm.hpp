@@ -132,11 +132,22 @@ class BatchNorm
   //! Modify the value of deterministic parameter.
   bool& Deterministic() { return deterministic; }
 
+  //! Get the running statistics of the training data.
+  arma::running_stat_vec<arma::colvec> const& Stats() const { return stats; }
+  //! Modify the running statistics of the training data.
+  arma::running_stat_vec<arma::colvec>& Stats() { return stats; }
+
   //! Get the mean over the training data.
-  OutputDataType TrainingMean() { return stats.mean(); }
+  OutputDataType TrainingMean()
+  {
+    return arma::conv_to<OutputDataType>::from(stats.mean());
+  }
 
   //! Get the variance over the training data.
-  OutputDataType TrainingVariance() { return stats.var(1); }
+  OutputDataType TrainingVariance()
+  {
+    return arma::conv_to<OutputDataType>::from(stats.var(1));
+  }
 
   /**
    * Serialize the layer
@@ -145,6 +156,14 @@ class BatchNorm
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  //! Add the columns of the given input to the running statistics.
+  void UpdateStats(const arma::mat& input);
+
+  //! Add the columns of the given single precision input to the running
+  //! statistics, which are kept in double precision.
+  template<typename eT>
+  void UpdateStats(const arma::Mat<eT>& input);
+
   //! Locally-stored number of input units.
   size_t size;
 
@@ -172,7 +191,8 @@ class BatchNorm
   //! Locally-stored variance object.
   OutputDataType variance;
 
-  //! Locally-stored running statistics object.
+  //! Locally-stored running statistics object, in double precision whatever
+  //! the type of the data.
   arma::running_stat_vec<arma::colvec> stats;
 
   //! Locally-stored gradient object.
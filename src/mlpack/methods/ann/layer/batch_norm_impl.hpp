@@ -42,8 +42,9 @@ BatchNorm<InputDataType, OutputDataType>::BatchNorm(
 template<typename InputDataType, typename OutputDataType>
 void BatchNorm<InputDataType, OutputDataType>::Reset()
 {
-  gamma = arma::mat(weights.memptr(), size, 1, false, false);
-  beta = arma::mat(weights.memptr() + gamma.n_elem, size, 1, false, false);
+  gamma = OutputDataType(weights.memptr(), size, 1, false, false);
+  beta = OutputDataType(weights.memptr() + gamma.n_elem, size, 1, false,
+      false);
   deterministic = false;
   gamma.fill(1.0);
   beta.fill(0.0);
@@ -60,10 +61,10 @@ void BatchNorm<InputDataType, OutputDataType>::Forward(
   if (deterministic)
   {
     // Mini--batch mean using the stats object.
-    mean = stats.mean();
+    mean = arma::conv_to<OutputDataType>::from(stats.mean());
 
     // Mini--batch variance using the stats object.
-    variance = stats.var(1);
+    variance = arma::conv_to<OutputDataType>::from(stats.var(1));
 
     // Normalize the input and scale and shift the output.
     output = input.each_col() - mean;
@@ -75,8 +76,7 @@ void BatchNorm<InputDataType, OutputDataType>::Forward(
     mean = arma::mean(input, 1);
     variance = arma::var(input, 1, 1);
 
-    for (size_t i = 0; i < input.n_cols; i++)
-      stats(input.col(i));
+    UpdateStats(input);
 
     // Normalize the input.
     output = input.each_col() - mean;
@@ -96,14 +96,14 @@ template<typename eT>
 void BatchNorm<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>&& input, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  const arma::mat inputMean = input.each_col() - mean;
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
+  const arma::Mat<eT> inputMean = input.each_col() - mean;
+  const arma::Mat<eT> stdInv = 1.0 / arma::sqrt(variance + eps);
 
   // Step 1: dl / dxhat
-  const arma::mat norm = gy.each_col() % gamma;
+  const arma::Mat<eT> norm = gy.each_col() % gamma;
 
   // Step 2: sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  const arma::mat var = arma::sum(norm % inputMean, 1) %
+  const arma::Mat<eT> var = arma::sum(norm % inputMean, 1) %
       arma::pow(stdInv, 3.0) * -0.5;
 
   // Step 4: dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
@@ -134,6 +134,22 @@ void BatchNorm<InputDataType, OutputDataType>::Gradient(
       arma::sum(error, 1);
 }
 
+template<typename InputDataType, typename OutputDataType>
+void BatchNorm<InputDataType, OutputDataType>::UpdateStats(
+    const arma::mat& input)
+{
+  for (size_t i = 0; i < input.n_cols; i++)
+    stats(input.col(i));
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void BatchNorm<InputDataType, OutputDataType>::UpdateStats(
+    const arma::Mat<eT>& input)
+{
+  UpdateStats(arma::conv_to<arma::mat>::from(input));
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void BatchNorm<InputDataType, OutputDataType>::serialize(
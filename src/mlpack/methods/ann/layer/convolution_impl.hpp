@@ -91,9 +91,9 @@ void Convolution<
     OutputDataType
 >::Reset()
 {
-    weight = arma::cube(weights.memptr(), kW, kH,
-        outSize * inSize, false, false);
-    bias = arma::mat(weights.memptr() + weight.n_elem,
+    weight = arma::Cube<typename OutputDataType::elem_type>(weights.memptr(),
+        kW, kH, outSize * inSize, false, false);
+    bias = OutputDataType(weights.memptr() + weight.n_elem,
         outSize, 1, false, false);
 }
 
@@ -114,7 +114,7 @@ void Convolution<
 >::Forward(const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
   batchSize = input.n_cols;
-  inputTemp = arma::cube(const_cast<arma::Mat<eT>&&>(input).memptr(),
+  inputTemp = arma::Cube<eT>(const_cast<arma::Mat<eT>&&>(input).memptr(),
       inputWidth, inputHeight, inSize * batchSize, false, false);
 
   if (padW != 0 || padH != 0)
@@ -130,34 +130,50 @@ void Convolution<
       outSize * batchSize, false, false);
   outputTemp.zeros();
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
+  if (IsIm2ColConvolution<ForwardConvolutionRule>::value)
   {
-    if (outMap != 0 && outMap % outSize == 0)
-    {
-      batchCount++;
-      outMapIdx = 0;
-    }
-
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
+    // Convolve all input maps of the whole batch with one matrix product.
+    const arma::Mat<eT> filters(weight.memptr(), kW * kH * inSize, outSize,
+        false, true);
+    Im2ColConvolution<>::BatchConvolution((padW != 0 || padH != 0) ?
+        inputPaddedTemp : inputTemp, filters, kW, kH, outputTemp, dW, dH);
+
+    for (size_t outMap = 0; outMap < outSize * batchSize; outMap++)
+      outputTemp.slice(outMap) += bias(outMap % outSize);
+  }
+  else
+  {
+    for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
+        outSize * batchSize; outMap++)
     {
-      arma::Mat<eT> convOutput;
-
-      if (padW != 0 || padH != 0)
+      if (outMap != 0 && outMap % outSize == 0)
       {
-        ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput, dW, dH);
+        batchCount++;
+        outMapIdx = 0;
       }
-      else
+
+      for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
       {
-        ForwardConvolutionRule::Convolution(inputTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput, dW, dH);
+        arma::Mat<eT> convOutput;
+
+        if (padW != 0 || padH != 0)
+        {
+          ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap +
+              batchCount * inSize), weight.slice(outMapIdx), convOutput, dW,
+              dH);
+        }
+        else
+        {
+          ForwardConvolutionRule::Convolution(inputTemp.slice(inMap +
+              batchCount * inSize), weight.slice(outMapIdx), convOutput, dW,
+              dH);
+        }
+
+        outputTemp.slice(outMap) += convOutput;
       }
 
-      outputTemp.slice(outMap) += convOutput;
+      outputTemp.slice(outMap) += bias(outMap % outSize);
     }
-
-    outputTemp.slice(outMap) += bias(outMap % outSize);
   }
 
   outputWidth = outputTemp.n_rows;
@@ -181,7 +197,7 @@ void Convolution<
 >::Backward(
     const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  arma::cube mappedError(gy.memptr(), outputWidth, outputHeight,
+  arma::Cube<eT> mappedError(gy.memptr(), outputWidth, outputHeight,
       outSize * batchSize, false, false);
 
   g.set_size(inputTemp.n_rows * inputTemp.n_cols * inSize, batchSize);
@@ -189,6 +205,34 @@ void Convolution<
       inputTemp.n_cols, inputTemp.n_slices, false, false);
   gTemp.zeros();
 
+  if (IsIm2ColConvolution<BackwardConvolutionRule>::value)
+  {
+    // Spread the error of all output maps of the whole batch back over the
+    // (padded) input maps with one matrix product.
+    const arma::Mat<eT> filters(weight.memptr(), kW * kH * inSize, outSize,
+        false, true);
+    if (padW != 0 || padH != 0)
+    {
+      arma::Cube<eT> gPadded(inputPaddedTemp.n_rows, inputPaddedTemp.n_cols,
+          inputPaddedTemp.n_slices, arma::fill::zeros);
+      Im2ColConvolution<>::BatchTransposedConvolution(mappedError, filters, kW,
+          kH, gPadded, dW, dH);
+
+      for (size_t i = 0; i < gTemp.n_slices; i++)
+      {
+        gTemp.slice(i) = gPadded.slice(i).submat(padW, padH,
+            padW + gTemp.n_rows - 1, padH + gTemp.n_cols - 1);
+      }
+    }
+    else
+    {
+      Im2ColConvolution<>::BatchTransposedConvolution(mappedError, filters, kW,
+          kH, gTemp, dW, dH);
+    }
+
+    return;
+  }
+
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
@@ -239,15 +283,41 @@ void Convolution<
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
-  arma::cube mappedError;
+  if (IsIm2ColConvolution<GradientConvolutionRule>::value)
+  {
+    const arma::Cube<eT> mappedError(error.memptr(), outputWidth, outputHeight,
+        outSize * batchSize, false, false);
+
+    // Correlate all input maps of the whole batch with the error of all output
+    // maps with one matrix product.
+    gradient.set_size(weights.n_elem, 1);
+    arma::Mat<eT> filterGradient(gradient.memptr(), kW * kH * inSize, outSize,
+        false, true);
+    Im2ColConvolution<>::BatchFilterGradient((padW != 0 || padH != 0) ?
+        inputPaddedTemp : inputTemp, mappedError, kW, kH, filterGradient, dW,
+        dH);
+
+    // The gradient of the bias sums the error of each output map over the
+    // batch.
+    gradient.rows(weight.n_elem, weights.n_elem - 1).zeros();
+    for (size_t outMap = 0; outMap < outSize * batchSize; outMap++)
+    {
+      gradient(weight.n_elem + (outMap % outSize)) +=
+          arma::accu(mappedError.slice(outMap));
+    }
+
+    return;
+  }
+
+  arma::Cube<eT> mappedError;
   if (padW != 0 && padH != 0)
   {
-    mappedError = arma::cube(error.memptr(), outputWidth / padW,
+    mappedError = arma::Cube<eT>(error.memptr(), outputWidth / padW,
         outputHeight / padH, outSize * batchSize, false, false);
   }
   else
   {
-    mappedError = arma::cube(error.memptr(), outputWidth,
+    mappedError = arma::Cube<eT>(error.memptr(), outputWidth,
         outputHeight, outSize * batchSize, false, false);
   }
 
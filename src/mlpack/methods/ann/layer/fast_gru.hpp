@@ -0,0 +1,266 @@
+/**
+ * @file fast_gru.hpp
+ *
+ * Definition of the FastGRU class, which implements a GRU network layer with
+ * fused gates and a preallocated workspace.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FAST_GRU_HPP
+#define MLPACK_METHODS_ANN_LAYER_FAST_GRU_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <limits>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * An implementation of a faster version of the GRU network layer.  The update
+ * gate, the reset gate and the candidate state are computed with one matrix
+ * product for the input and one for each recurrent weight matrix, and the
+ * activations are applied in fused elementwise passes:
+ *
+ * @f{eqnarray}{
+ * z &=& sigmoid(W_z \cdot x + U_z \cdot h + b_z) \\
+ * r &=& sigmoid(W_r \cdot x + U_r \cdot h + b_r) \\
+ * o &=& tanh(W_o \cdot x + U_o \cdot (r \cdot h) + b_o) \\
+ * h &=& z \cdot h + (1 - z) \cdot o
+ * @f}
+ *
+ * The layer computes the same function as GRU, and its parameters have the
+ * same layout, so the parameters of one can be used by the other.
+ *
+ * The activations of each time step are kept in a workspace which is only
+ * allocated when the sequence length or the batch size changes, and which is
+ * used as a ring buffer if more steps are given than it holds (as
+ * RNN::Predict() does for several batches).  The gradient of the weights is
+ * not computed step by step: the errors of the gates are kept in the
+ * workspace, and the gradient of a whole BPTT window is computed with one
+ * matrix product per weight matrix when the backward pass reaches the first
+ * step of the window.
+ *
+ * \see GRU for the implementation of the GRU layer with separate layers.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class FastGRU
+{
+ public:
+  // Convenience typedefs.
+  typedef typename OutputDataType::elem_type ElemType;
+
+  //! Create the FastGRU object.
+  FastGRU();
+
+  /**
+   * Create the FastGRU layer object using the specified parameters.
+   *
+   * @param inSize The number of input units.
+   * @param outSize The number of output units.
+   * @param rho Maximum number of steps to backpropagate through time (BPTT).
+   */
+  FastGRU(const size_t inSize,
+          const size_t outSize,
+          const size_t rho = std::numeric_limits<size_t>::max());
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename InputType, typename OutputType>
+  void Forward(InputType&& input, OutputType&& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f. Using the results from the feed
+   * forward pass.
+   *
+   * @param input The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename InputType, typename ErrorType, typename GradientType>
+  void Backward(const InputType&& input,
+                ErrorType&& gy,
+                GradientType&& g);
+
+  /*
+   * Reset the layer parameter.
+   */
+  void Reset();
+
+  /*
+   * Resets the cell to accept a new input. This breaks the BPTT chain starts a
+   * new one.
+   *
+   * @param size The current maximum number of steps through time.
+   */
+  void ResetCell(const size_t size);
+
+  /*
+   * Calculate the gradient using the output delta and the input activation.
+   * The gradient of a BPTT window is given at its first step; the gradient is
+   * zero for the other steps.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  template<typename InputType, typename ErrorType, typename GradientType>
+  void Gradient(InputType&& input,
+                ErrorType&& error,
+                GradientType&& gradient);
+
+  //! Get the maximum number of steps to backpropagate through time (BPTT).
+  size_t Rho() const { return rho; }
+  //! Modify the maximum number of steps to backpropagate through time (BPTT).
+  size_t& Rho() { return rho; }
+
+  //! Get the parameters.
+  OutputDataType const& Parameters() const { return weights; }
+  //! Modify the parameters.
+  OutputDataType& Parameters() { return weights; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the gradient.
+  OutputDataType const& Gradient() const { return grad; }
+  //! Modify the gradient.
+  OutputDataType& Gradient() { return grad; }
+
+  /**
+   * Serialize the layer
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Get the output of the step before the given step of the workspace.
+  OutputDataType PreviousOutput(const size_t step);
+
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of output units.
+  size_t outSize;
+
+  //! Number of steps to backpropagate through time (BPTT).
+  size_t rho;
+
+  //! Locally-stored current rho size.
+  size_t rhoSize;
+
+  //! Current backpropagate through time steps.
+  size_t bpttSteps;
+
+  //! Number of steps the workspace holds, a multiple of bpttSteps.
+  size_t workspaceSteps;
+
+  //! Locally-stored batch size.
+  size_t batchSize;
+
+  //! Step of the workspace the next forward pass writes.
+  size_t forwardStep;
+
+  //! Step of the workspace the next backward pass reads.
+  size_t backwardStep;
+
+  //! Step of the workspace the next gradient pass reads.
+  size_t gradientStep;
+
+  //! Number of steps whose gradient has not been computed yet.
+  size_t pendingSteps;
+
+  //! Whether the error of the last backward step goes to the step before.
+  bool carryError;
+
+  //! Locally-stored weight object.
+  OutputDataType weights;
+
+  //! Weights between the input and the gates.
+  OutputDataType input2GateWeight;
+
+  //! Bias of the gates.
+  OutputDataType input2GateBias;
+
+  //! Weights between the previous output and the update and reset gates.
+  OutputDataType output2GateWeight;
+
+  //! Weights between the reset previous output and the candidate state.
+  OutputDataType outputHidden2GateWeight;
+
+  //! Activations of the update gate, the reset gate and the candidate state of
+  //! each step.
+  OutputDataType gate;
+
+  //! Errors of the gates of each step, before the activations.
+  OutputDataType gateError;
+
+  //! Previous output multiplied by the reset gate, for each step.
+  OutputDataType resetOutput;
+
+  //! Input of each step.
+  OutputDataType inputs;
+
+  //! Output of each step.
+  OutputDataType outParameter;
+
+  //! Output before the first step of a BPTT window.
+  OutputDataType allZeros;
+
+  //! Recurrent part of the update and reset gates in the forward pass, and
+  //! their errors in the backward pass.
+  OutputDataType recurrentGate;
+
+  //! Recurrent part of the candidate state in the forward pass, and its error
+  //! in the backward pass.
+  OutputDataType recurrentHidden;
+
+  //! Error of the previous output multiplied by the reset gate.
+  OutputDataType resetError;
+
+  //! Error of the previous output through the update and reset gates.
+  OutputDataType hiddenError;
+
+  //! Error of the previous output, given to the step before.
+  OutputDataType outputError;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored gradient object.
+  OutputDataType grad;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class FastGRU
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "fast_gru_impl.hpp"
+
+#endif
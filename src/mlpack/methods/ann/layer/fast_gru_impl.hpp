@@ -0,0 +1,345 @@
+/**
+ * @file fast_gru_impl.hpp
+ *
+ * Implementation of the FastGRU class, which implements a GRU network layer
+ * with fused gates and a preallocated workspace.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FAST_GRU_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_FAST_GRU_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "fast_gru.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+FastGRU<InputDataType, OutputDataType>::FastGRU()
+{
+  // Nothing to do here.
+}
+
+template <typename InputDataType, typename OutputDataType>
+FastGRU<InputDataType, OutputDataType>::FastGRU(
+    const size_t inSize, const size_t outSize, const size_t rho) :
+    inSize(inSize),
+    outSize(outSize),
+    rho(rho),
+    rhoSize(rho),
+    bpttSteps(0),
+    workspaceSteps(0),
+    batchSize(0),
+    forwardStep(0),
+    backwardStep(0),
+    gradientStep(0),
+    pendingSteps(0),
+    carryError(false)
+{
+  // Weights for: input to gate layer (3 * outSize * inSize + 3 * outSize),
+  // output to update and reset gate (2 * outSize * outSize) and reset output
+  // to candidate state (outSize * outSize); the same layout as GRU.
+  weights.set_size(3 * outSize * inSize + 3 * outSize +
+      3 * outSize * outSize, 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void FastGRU<InputDataType, OutputDataType>::Reset()
+{
+  input2GateWeight = OutputDataType(weights.memptr(),
+      3 * outSize, inSize, false, false);
+  input2GateBias = OutputDataType(weights.memptr() + input2GateWeight.n_elem,
+      3 * outSize, 1, false, false);
+
+  output2GateWeight = OutputDataType(weights.memptr() +
+      input2GateWeight.n_elem + input2GateBias.n_elem, 2 * outSize, outSize,
+      false, false);
+  outputHidden2GateWeight = OutputDataType(weights.memptr() +
+      input2GateWeight.n_elem + input2GateBias.n_elem +
+      output2GateWeight.n_elem, outSize, outSize, false, false);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void FastGRU<InputDataType, OutputDataType>::ResetCell(const size_t size)
+{
+  if (size == std::numeric_limits<size_t>::max())
+    return;
+
+  rhoSize = size;
+
+  if (batchSize == 0)
+    return;
+
+  // The workspace holds whole BPTT windows, so that a window never wraps
+  // around its end.  set_size() keeps the memory if the size is the same.
+  bpttSteps = std::min(rho, rhoSize);
+  workspaceSteps = ((rhoSize + bpttSteps - 1) / bpttSteps) * bpttSteps;
+
+  const size_t workspaceCols = workspaceSteps * batchSize;
+  gate.set_size(3 * outSize, workspaceCols);
+  gateError.set_size(3 * outSize, workspaceCols);
+  resetOutput.set_size(outSize, workspaceCols);
+  inputs.set_size(inSize, workspaceCols);
+  outParameter.set_size(outSize, workspaceCols);
+
+  allZeros.zeros(outSize, batchSize);
+  recurrentGate.set_size(2 * outSize, batchSize);
+  recurrentHidden.set_size(outSize, batchSize);
+  resetError.set_size(outSize, batchSize);
+  hiddenError.set_size(outSize, batchSize);
+  outputError.set_size(outSize, batchSize);
+
+  forwardStep = 0;
+  pendingSteps = 0;
+  carryError = false;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename OutputType>
+void FastGRU<InputDataType, OutputDataType>::Forward(
+    InputType&& input, OutputType&& output)
+{
+  // Check if the batch size changed, the number of cols is defines the input
+  // batch size.
+  if (input.n_cols != batchSize)
+  {
+    batchSize = input.n_cols;
+    ResetCell(rhoSize);
+  }
+
+  const size_t begin = forwardStep * batchSize;
+  const OutputDataType prevOutput = PreviousOutput(forwardStep);
+
+  // Input part of all the gates, and recurrent part of the update and reset
+  // gates.
+  OutputDataType gateStep(gate.colptr(begin), 3 * outSize, batchSize, false,
+      true);
+  gateStep = input2GateWeight * input;
+  recurrentGate = output2GateWeight * prevOutput;
+
+  // Update and reset gates, and the previous output multiplied by the reset
+  // gate, in one pass.
+  const ElemType* bias = input2GateBias.memptr();
+  for (size_t j = 0; j < batchSize; ++j)
+  {
+    ElemType* g = gateStep.colptr(j);
+    const ElemType* recurrent = recurrentGate.colptr(j);
+    const ElemType* h = prevOutput.colptr(j);
+    ElemType* rh = resetOutput.colptr(begin + j);
+
+    for (size_t i = 0; i < 2 * outSize; ++i)
+      g[i] = 1.0 / (1.0 + std::exp(-(g[i] + bias[i] + recurrent[i])));
+
+    for (size_t i = 0; i < outSize; ++i)
+      rh[i] = g[outSize + i] * h[i];
+  }
+
+  const OutputDataType resetStep(resetOutput.colptr(begin), outSize, batchSize,
+      false, true);
+  recurrentHidden = outputHidden2GateWeight * resetStep;
+
+  // Candidate state and output in one pass.
+  for (size_t j = 0; j < batchSize; ++j)
+  {
+    ElemType* g = gateStep.colptr(j);
+    const ElemType* recurrent = recurrentHidden.colptr(j);
+    const ElemType* h = prevOutput.colptr(j);
+    ElemType* out = outParameter.colptr(begin + j);
+
+    for (size_t i = 0; i < outSize; ++i)
+    {
+      const ElemType o = std::tanh(g[2 * outSize + i] + bias[2 * outSize + i] +
+          recurrent[i]);
+      g[2 * outSize + i] = o;
+      out[i] = g[i] * (h[i] - o) + o;
+    }
+  }
+
+  output = OutputType(outParameter.colptr(begin), outSize, batchSize, false,
+      false);
+
+  // The backward pass starts at the last step.
+  carryError = false;
+  backwardStep = forwardStep;
+
+  if (++forwardStep == workspaceSteps)
+    forwardStep = 0;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename ErrorType, typename GradientType>
+void FastGRU<InputDataType, OutputDataType>::Backward(
+  const InputType&& /* input */, ErrorType&& gy, GradientType&& g)
+{
+  const size_t step = backwardStep;
+  const size_t begin = step * batchSize;
+  const OutputDataType prevOutput = PreviousOutput(step);
+
+  // Errors of the update gate and the candidate state, and the error of the
+  // previous output through the update gate, in one pass.
+  for (size_t j = 0; j < batchSize; ++j)
+  {
+    const ElemType* g = gate.colptr(begin + j);
+    ElemType* e = gateError.colptr(begin + j);
+    const ElemType* dy = gy.colptr(j);
+    const ElemType* carried = outputError.colptr(j);
+    const ElemType* h = prevOutput.colptr(j);
+    ElemType* gateE = recurrentGate.colptr(j);
+    ElemType* hiddenE = recurrentHidden.colptr(j);
+    ElemType* outputE = hiddenError.colptr(j);
+
+    for (size_t i = 0; i < outSize; ++i)
+    {
+      const ElemType dh = carryError ? dy[i] + carried[i] : dy[i];
+      const ElemType z = g[i];
+      const ElemType o = g[2 * outSize + i];
+
+      e[i] = dh * (h[i] - o) * z * (1.0 - z);
+      e[2 * outSize + i] = dh * (1.0 - z) * (1.0 - o * o);
+      gateE[i] = e[i];
+      hiddenE[i] = e[2 * outSize + i];
+      outputE[i] = dh * z;
+    }
+  }
+
+  // Error of the reset gate, and of the previous output through it.
+  resetError = outputHidden2GateWeight.t() * recurrentHidden;
+  for (size_t j = 0; j < batchSize; ++j)
+  {
+    const ElemType* g = gate.colptr(begin + j);
+    ElemType* e = gateError.colptr(begin + j);
+    const ElemType* resetE = resetError.colptr(j);
+    const ElemType* h = prevOutput.colptr(j);
+    ElemType* gateE = recurrentGate.colptr(j);
+    ElemType* outputE = hiddenError.colptr(j);
+
+    for (size_t i = 0; i < outSize; ++i)
+    {
+      const ElemType r = g[outSize + i];
+      e[outSize + i] = resetE[i] * h[i] * r * (1.0 - r);
+      gateE[outSize + i] = e[outSize + i];
+      outputE[i] += resetE[i] * r;
+    }
+  }
+
+  // The error of the previous output only goes back inside the BPTT window.
+  carryError = (step % bpttSteps != 0);
+  if (carryError)
+  {
+    outputError = output2GateWeight.t() * recurrentGate;
+    outputError += hiddenError;
+  }
+
+  const OutputDataType errorStep(gateError.colptr(begin), 3 * outSize,
+      batchSize, false, true);
+  g = input2GateWeight.t() * errorStep;
+
+  gradientStep = step;
+  backwardStep = (step == 0) ? workspaceSteps - 1 : step - 1;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename ErrorType, typename GradientType>
+void FastGRU<InputDataType, OutputDataType>::Gradient(
+    InputType&& input, ErrorType&& /* error */, GradientType&& gradient)
+{
+  const size_t step = gradientStep;
+  const size_t begin = step * batchSize;
+
+  inputs.cols(begin, begin + batchSize - 1) = input;
+  ++pendingSteps;
+
+  // The gradient of the whole window is computed at its first step.
+  if (step % bpttSteps != 0)
+  {
+    gradient.zeros();
+    return;
+  }
+
+  const size_t windowCols = pendingSteps * batchSize;
+  const OutputDataType windowErrors(gateError.colptr(begin), 3 * outSize,
+      windowCols, false, true);
+  const OutputDataType windowInputs(inputs.colptr(begin), inSize, windowCols,
+      false, true);
+
+  OutputDataType weightGradient(gradient.memptr(), 3 * outSize, inSize, false,
+      true);
+  OutputDataType biasGradient(gradient.memptr() + weightGradient.n_elem,
+      3 * outSize, 1, false, true);
+  OutputDataType outputGradient(gradient.memptr() + weightGradient.n_elem +
+      biasGradient.n_elem, 2 * outSize, outSize, false, true);
+  OutputDataType hiddenGradient(gradient.memptr() + weightGradient.n_elem +
+      biasGradient.n_elem + outputGradient.n_elem, outSize, outSize, false,
+      true);
+
+  weightGradient = windowErrors * windowInputs.t();
+  biasGradient = arma::sum(windowErrors, 1);
+
+  // The previous output of the first step of the window is zero, so only the
+  // other steps contribute to the gradient of the recurrent weights.
+  if (pendingSteps > 1)
+  {
+    const size_t recurrentCols = windowCols - batchSize;
+    const OutputDataType prevOutputs(outParameter.colptr(begin), outSize,
+        recurrentCols, false, true);
+    const OutputDataType resetOutputs(resetOutput.colptr(begin + batchSize),
+        outSize, recurrentCols, false, true);
+
+    outputGradient = windowErrors.submat(0, batchSize, 2 * outSize - 1,
+        windowCols - 1) * prevOutputs.t();
+    hiddenGradient = windowErrors.submat(2 * outSize, batchSize,
+        3 * outSize - 1, windowCols - 1) * resetOutputs.t();
+  }
+  else
+  {
+    outputGradient.zeros();
+    hiddenGradient.zeros();
+  }
+
+  pendingSteps = 0;
+}
+
+template<typename InputDataType, typename OutputDataType>
+OutputDataType FastGRU<InputDataType, OutputDataType>::PreviousOutput(
+    const size_t step)
+{
+  // The state starts from zero at the beginning of each BPTT window.
+  if (step % bpttSteps == 0)
+  {
+    return OutputDataType(allZeros.memptr(), outSize, batchSize, false,
+        true);
+  }
+
+  return OutputDataType(outParameter.colptr((step - 1) * batchSize), outSize,
+      batchSize, false, true);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void FastGRU<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(weights);
+  ar & BOOST_SERIALIZATION_NVP(inSize);
+  ar & BOOST_SERIALIZATION_NVP(outSize);
+  ar & BOOST_SERIALIZATION_NVP(rho);
+
+  // The workspace is allocated again by the next forward pass.
+  if (Archive::is_loading::value)
+  {
+    rhoSize = rho;
+    batchSize = 0;
+    forwardStep = 0;
+    pendingSteps = 0;
+    carryError = false;
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -27,6 +27,7 @@
 #include "multiply_merge.hpp"
 #include "gru.hpp"
 #include "fast_lstm.hpp"
+#include "fast_gru.hpp"
 #include "recurrent.hpp"
 #include "recurrent_attention.hpp"
 #include "reparametrization.hpp"
@@ -39,8 +39,9 @@ LayerNorm<InputDataType, OutputDataType>::LayerNorm(
 template<typename InputDataType, typename OutputDataType>
 void LayerNorm<InputDataType, OutputDataType>::Reset()
 {
-  gamma = arma::mat(weights.memptr(), 1, size, false, false);
-  beta = arma::mat(weights.memptr() + gamma.n_elem, 1, size, false, false);
+  gamma = OutputDataType(weights.memptr(), 1, size, false, false);
+  beta = OutputDataType(weights.memptr() + gamma.n_elem, 1, size, false,
+      false);
   gamma.fill(1.0);
   beta.fill(0.0);
 }
@@ -70,14 +71,14 @@ template<typename eT>
 void LayerNorm<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>&& input, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  const arma::mat inputMean = input.each_row() - mean;
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
+  const arma::Mat<eT> inputMean = input.each_row() - mean;
+  const arma::Mat<eT> stdInv = 1.0 / arma::sqrt(variance + eps);
 
   // dl / dxhat
-  const arma::mat norm = gy.each_row() % gamma;
+  const arma::Mat<eT> norm = gy.each_row() % gamma;
 
   // sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  const arma::mat var = arma::sum(norm % inputMean, 0) %
+  const arma::Mat<eT> var = arma::sum(norm % inputMean, 0) %
       arma::pow(stdInv, 3.0) * -0.5;
 
   // dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
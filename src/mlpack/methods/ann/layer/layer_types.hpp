@@ -59,6 +59,7 @@ template<typename InputDataType, typename OutputDataType> class LinearNoBias;
 template<typename InputDataType, typename OutputDataType> class LSTM;
 template<typename InputDataType, typename OutputDataType> class GRU;
 template<typename InputDataType, typename OutputDataType> class FastLSTM;
+template<typename InputDataType, typename OutputDataType> class FastGRU;
 template<typename InputDataType, typename OutputDataType> class VRClassReward;
 
 template<typename InputDataType,
@@ -178,6 +179,7 @@ using LayerTypes = boost::variant<
     LSTM<arma::mat, arma::mat>*,
     GRU<arma::mat, arma::mat>*,
     FastLSTM<arma::mat, arma::mat>*,
+    FastGRU<arma::mat, arma::mat>*,
     MaxPooling<arma::mat, arma::mat>*,
     MeanPooling<arma::mat, arma::mat>*,
     MultiplyConstant<arma::mat, arma::mat>*,
@@ -152,7 +152,8 @@ class MaxPooling
     {
       for (size_t i = 0, rowidx = 0; i < output.n_rows; ++i, rowidx += dH)
       {
-        arma::mat subInput = input(arma::span(rowidx, rowidx + kW - 1 - offset),
+        arma::Mat<eT> subInput = input(
+            arma::span(rowidx, rowidx + kW - 1 - offset),
             arma::span(colidx, colidx + kH - 1 - offset));
 
         const size_t idx = pooling.Pooling(subInput);
@@ -234,13 +235,13 @@ class MaxPooling
   size_t batchSize;
 
   //! Locally-stored output parameter.
-  arma::cube outputTemp;
+  arma::Cube<typename OutputDataType::elem_type> outputTemp;
 
   //! Locally-stored transformed input parameter.
-  arma::cube inputTemp;
+  arma::Cube<typename OutputDataType::elem_type> inputTemp;
 
   //! Locally-stored transformed output parameter.
-  arma::cube gTemp;
+  arma::Cube<typename OutputDataType::elem_type> gTemp;
 
   //! Locally-stored pooling strategy.
   MaxPoolingRule pooling;
@@ -261,7 +262,7 @@ class MaxPooling
   arma::Col<size_t> indicesCol;
 
   //! Locally-stored pooling indicies.
-  std::vector<arma::cube> poolingIndices;
+  std::vector<arma::Cube<typename OutputDataType::elem_type>> poolingIndices;
 }; // class MaxPooling
 
 } // namespace ann
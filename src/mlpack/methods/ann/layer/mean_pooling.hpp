@@ -132,7 +132,7 @@ class MeanPooling
     {
       for (size_t i = 0, rowidx = 0; i < output.n_rows; ++i, rowidx += dW)
       {
-        arma::mat subInput = input(
+        arma::Mat<eT> subInput = input(
             arma::span(rowidx, rowidx + rStep - 1 - offset),
             arma::span(colidx, colidx + cStep - 1 - offset));
 
@@ -218,13 +218,13 @@ class MeanPooling
   size_t batchSize;
 
   //! Locally-stored output parameter.
-  arma::cube outputTemp;
+  arma::Cube<typename OutputDataType::elem_type> outputTemp;
 
   //! Locally-stored transformed input parameter.
-  arma::cube inputTemp;
+  arma::Cube<typename OutputDataType::elem_type> inputTemp;
 
   //! Locally-stored transformed output parameter.
-  arma::cube gTemp;
+  arma::Cube<typename OutputDataType::elem_type> gTemp;
 
   //! Locally-stored delta object.
   OutputDataType delta;
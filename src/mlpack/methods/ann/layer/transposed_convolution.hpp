@@ -19,6 +19,7 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 
 #include "layer_types.hpp"
 
@@ -29,6 +30,10 @@ namespace ann /** Artificial Neural Network. */ {
  * Implementation of the Transposed Convolution class. The Transposed 
  * Convolution class represents a single layer of a neural network.
  *
+ * Note that the forward pass of this layer uses the backward convolution rule,
+ * and the backward pass the forward rule.  If a rule is Im2ColConvolution, its
+ * pass handles the whole batch with one matrix product.
+ *
  * @tparam ForwardConvolutionRule Convolution to perform forward process.
  * @tparam BackwardConvolutionRule Convolution to perform backward process.
  * @tparam GradientConvolutionRule Convolution to calculate gradient.
@@ -216,6 +221,26 @@ class TransposedConvolution
     output = arma::fliplr(arma::flipud(input));
   }
 
+  /*
+   * Arrange the filters for Im2ColConvolution, as the filters of the valid
+   * convolution whose adjoint this layer computes: one column per input map of
+   * this layer, holding the filters of all output maps one after another.
+   *
+   * @param filters Matrix to store the filters in.
+   */
+  void Im2ColFilters(arma::mat& filters)
+  {
+    filters.set_size(kW * kH * outSize, inSize);
+    for (size_t outMap = 0; outMap < outSize; outMap++)
+    {
+      for (size_t inMap = 0; inMap < inSize; inMap++)
+      {
+        filters.submat(outMap * kW * kH, inMap, (outMap + 1) * kW * kH - 1,
+            inMap) = arma::vectorise(weight.slice(outMap * inSize + inMap));
+      }
+    }
+  }
+
   /*
    * Pad the given input data.
    *
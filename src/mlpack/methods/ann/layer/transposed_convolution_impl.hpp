@@ -126,27 +126,43 @@ void TransposedConvolution<
       outSize * batchSize, false, false);
   outputTemp.zeros();
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
+  if (IsIm2ColConvolution<BackwardConvolutionRule>::value)
   {
-    if (outMap != 0 && outMap % outSize == 0)
-    {
-      batchCount++;
-      outMapIdx = 0;
-    }
+    // The full convolution of the input maps is the adjoint of the valid
+    // convolution of the output maps, which spreads all input maps of the
+    // whole batch over the output maps with one matrix product.
+    arma::mat filters;
+    Im2ColFilters(filters);
+    Im2ColConvolution<>::BatchTransposedConvolution(inputTemp, filters, kW, kH,
+        outputTemp);
 
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
+    for (size_t outMap = 0; outMap < outSize * batchSize; outMap++)
+      outputTemp.slice(outMap) += bias(outMap % outSize);
+  }
+  else
+  {
+    for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
+        outSize * batchSize; outMap++)
     {
-      arma::Mat<eT> convOutput, rotatedFilter;
-      Rotate180(weight.slice(outMapIdx), rotatedFilter);
+      if (outMap != 0 && outMap % outSize == 0)
+      {
+        batchCount++;
+        outMapIdx = 0;
+      }
 
-      BackwardConvolutionRule::Convolution(inputTemp.slice(inMap +
-          batchCount * inSize), rotatedFilter, convOutput, 1, 1);
+      for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
+      {
+        arma::Mat<eT> convOutput, rotatedFilter;
+        Rotate180(weight.slice(outMapIdx), rotatedFilter);
 
-      outputTemp.slice(outMap) += convOutput;
-    }
+        BackwardConvolutionRule::Convolution(inputTemp.slice(inMap +
+            batchCount * inSize), rotatedFilter, convOutput, 1, 1);
 
-    outputTemp.slice(outMap) += bias(outMap % outSize);
+        outputTemp.slice(outMap) += convOutput;
+      }
+
+      outputTemp.slice(outMap) += bias(outMap % outSize);
+    }
   }
 }
 
@@ -175,6 +191,16 @@ void TransposedConvolution<
 
   gTemp.zeros();
 
+  if (IsIm2ColConvolution<ForwardConvolutionRule>::value)
+  {
+    // Convolve the error of all output maps of the whole batch with one matrix
+    // product.
+    arma::mat filters;
+    Im2ColFilters(filters);
+    Im2ColConvolution<>::BatchConvolution(mappedError, filters, kW, kH, gTemp);
+    return;
+  }
+
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
@@ -219,6 +245,37 @@ void TransposedConvolution<
       outputHeight, outSize * batchSize, false, false);
 
   gradient.set_size(weights.n_elem, 1);
+
+  if (IsIm2ColConvolution<GradientConvolutionRule>::value)
+  {
+    // Correlate the error of the output maps with all input maps of the whole
+    // batch with one matrix product; the result has the layout of the filters
+    // given by Im2ColFilters().
+    arma::mat filterGradient(kW * kH * outSize, inSize);
+    Im2ColConvolution<>::BatchFilterGradient(mappedError, inputTemp, kW, kH,
+        filterGradient);
+
+    for (size_t outMap = 0; outMap < outSize; outMap++)
+    {
+      for (size_t inMap = 0; inMap < inSize; inMap++)
+      {
+        gradient.rows((outMap * inSize + inMap) * kW * kH,
+            (outMap * inSize + inMap + 1) * kW * kH - 1) =
+            filterGradient.submat(outMap * kW * kH, inMap,
+            (outMap + 1) * kW * kH - 1, inMap);
+      }
+    }
+
+    gradient.rows(weight.n_elem, weights.n_elem - 1).zeros();
+    for (size_t outMap = 0; outMap < outSize * batchSize; outMap++)
+    {
+      gradient(weight.n_elem + (outMap % outSize)) +=
+          arma::accu(mappedError.slice(outMap));
+    }
+
+    return;
+  }
+
   gradientTemp = arma::Cube<eT>(gradient.memptr(), weight.n_rows,
       weight.n_cols, weight.n_slices, false, false);
   gradientTemp.zeros();
@@ -30,8 +30,15 @@ template<typename InputType, typename TargetType>
 double CrossEntropyError<InputDataType, OutputDataType>::Forward(
     const InputType&& input, const TargetType&& target)
 {
-  return -arma::accu(target % arma::log(input + eps) +
-      (1. - target) % arma::log(1. - input + eps));
+  // The sum is taken in double precision also for single precision data.
+  double loss = 0;
+  for (size_t i = 0; i < input.n_elem; ++i)
+  {
+    loss += target[i] * std::log(input[i] + eps) +
+        (1. - target[i]) * std::log(1. - input[i] + eps);
+  }
+
+  return -loss;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -29,7 +29,16 @@ template<typename InputType, typename TargetType>
 double MeanSquaredError<InputDataType, OutputDataType>::Forward(
     const InputType&& input, const TargetType&& target)
 {
-  return arma::accu(arma::square(input - target)) / target.n_cols;
+  // Accumulate in double precision, so that the loss of single precision data
+  // does not lose accuracy over large batches.
+  double loss = 0;
+  for (size_t i = 0; i < input.n_elem; ++i)
+  {
+    const double error = (double) input[i] - (double) target[i];
+    loss += error * error;
+  }
+
+  return loss / target.n_cols;
 }
 
 template<typename InputDataType, typename OutputDataType>
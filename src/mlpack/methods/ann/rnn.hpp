@@ -31,6 +31,9 @@ namespace ann /** Artificial Neural Network. */ {
 /**
  * Implementation of a standard recurrent neural network container.
  *
+ * As for FFN, the network, its parameters and its layers use double precision
+ * (arma::mat).
+ *
  * @tparam OutputLayerType The output layer type used to evaluate the network.
  * @tparam InitializationRuleType Rule used to initialize the weight matrix.
  */
@@ -15,7 +15,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
-#include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 #include "random_point_selection.hpp"
 #include <boost/dynamic_bitset.hpp>
 
@@ -43,6 +43,10 @@ namespace dbscan {
  * range search technique used and the point selection strategy by means of
  * template parameters.
  *
+ * In batch mode, the range searches use all available OpenMP threads (if the
+ * RangeSearchType does), and the components are merged by all threads at once
+ * with a lock-free union-find structure.
+ *
  * @tparam RangeSearchType Class to use for range searching.
  * @tparam PointSelectionPolicy Strategy for selecting next point to cluster
  *      with.
@@ -53,11 +57,13 @@ class DBSCAN
 {
  public:
   /**
-   * Construct the DBSCAN object with the given parameters.  The batchMode
-   * parameter should be set to false in the case where RAM issues will be
-   * encountered (i.e. if the dataset is very large or if epsilon is large).
-   * When batchMode is false, each point will be searched iteratively, which
-   * could be slower but will use less memory.
+   * Construct the DBSCAN object with the given parameters.  When batchMode is
+   * true, the points are range searched in blocks, and the size of each block
+   * is chosen from the neighborhood sizes of the previous block, aiming to
+   * hold only about as many neighbors as there are points in memory at once.
+   * This is not a bound: if a dense region follows a sparse one, a block can
+   * still return up to a quadratic number of neighbors.  When batchMode is
+   * false, each point will be searched iteratively, which could be slower.
    *
    * @param epsilon Size of range query.
    * @param minPoints Minimum number of points for each cluster.
@@ -136,11 +142,11 @@ class DBSCAN
    *
    * @param data Dataset to cluster.
    * @param assignments Assignments for each point.
-   * @param uf UnionFind structure that will be modified.
+   * @param uf Union-find structure that will be modified.
    */
   template<typename MatType>
   void PointwiseCluster(const MatType& data,
-                        emst::UnionFind& uf);
+                        emst::ConcurrentUnionFind& uf);
 
   /**
    * Performs DBSCAN clustering on the data, returning number of clusters
@@ -149,11 +155,11 @@ class DBSCAN
    *
    * @param data Dataset to cluster.
    * @param assignments Assignments for each point.
-   * @param uf UnionFind structure that will be modified.
+   * @param uf Union-find structure that will be modified.
    */
   template<typename MatType>
   void BatchCluster(const MatType& data,
-                    emst::UnionFind& uf);
+                    emst::ConcurrentUnionFind& uf);
 };
 
 } // namespace dbscan
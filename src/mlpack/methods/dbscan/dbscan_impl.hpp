@@ -100,8 +100,8 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
     const MatType& data,
     arma::Row<size_t>& assignments)
 {
-  // Initialize the UnionFind object.
-  emst::UnionFind uf(data.n_cols);
+  // Initialize the union-find object.
+  emst::ConcurrentUnionFind uf(data.n_cols);
   rangeSearch.Train(data);
 
   if (batchMode)
@@ -150,7 +150,7 @@ template<typename RangeSearchType, typename PointSelectionPolicy>
 template<typename MatType>
 void DBSCAN<RangeSearchType, PointSelectionPolicy>::PointwiseCluster(
     const MatType& data,
-    emst::UnionFind& uf)
+    emst::ConcurrentUnionFind& uf)
 {
   std::vector<std::vector<size_t>> neighbors;
   std::vector<std::vector<double>> distances;
@@ -173,29 +173,60 @@ void DBSCAN<RangeSearchType, PointSelectionPolicy>::PointwiseCluster(
 /**
  * Performs DBSCAN clustering on the data, returning number of clusters
  * and also the list of cluster assignments.  This can perform search in batch,
- * naive search).
+ * so it is well suited for dual-tree or naive search.  The query points are
+ * searched in blocks, so that the neighborhoods of only one block are held in
+ * memory at a time.
  */
 template<typename RangeSearchType, typename PointSelectionPolicy>
 template<typename MatType>
 void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
     const MatType& data,
-    emst::UnionFind& uf)
+    emst::ConcurrentUnionFind& uf)
 {
-  // For each point, find the points in epsilon-nighborhood and their distances.
+  // Searching every point at once would store all of the epsilon-neighborhoods
+  // (and their distances), which is quadratic in the number of points for dense
+  // data.  Instead, the size of each block is chosen from the average
+  // neighborhood size of the previous block, aiming for about as many
+  // neighbors as there are points.  The block size grows by at most a factor
+  // of four each time.  This is only a guess, though: a block of b points can
+  // return up to b * n neighbors, and after a sparse region b can be close to
+  // n, so a dense region right after it can still return a quadratic number of
+  // neighbors.
+  const size_t maxNeighbors = data.n_cols;
+  size_t blockSize = 1;
+
+  Log::Info << "Performing range search." << std::endl;
   std::vector<std::vector<size_t>> neighbors;
   std::vector<std::vector<double>> distances;
-  Log::Info << "Performing range search." << std::endl;
-  rangeSearch.Train(data);
-  rangeSearch.Search(data, math::Range(0.0, epsilon), neighbors, distances);
-  Log::Info << "Range search complete." << std::endl;
-
-  // Now loop over all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
+  size_t begin = 0;
+  while (begin < data.n_cols)
   {
-    // Union to all neighbors.
-    for (size_t j = 0; j < neighbors[i].size(); ++j)
-      uf.Union(i, neighbors[i][j]);
+    blockSize = std::min(blockSize, data.n_cols - begin);
+    const MatType block = data.cols(begin, begin + blockSize - 1);
+    rangeSearch.Search(block, math::Range(0.0, epsilon), neighbors,
+        distances);
+
+    // The distances are not needed; release them before taking the unions.
+    std::vector<std::vector<double>>().swap(distances);
+
+    // Union each point in the block to all of its neighbors.
+    size_t numNeighbors = 0;
+    #pragma omp parallel for schedule(dynamic, 64) reduction(+:numNeighbors)
+    for (omp_size_t i = 0; i < (omp_size_t) neighbors.size(); ++i)
+    {
+      for (size_t j = 0; j < neighbors[i].size(); ++j)
+        uf.Union(begin + (size_t) i, neighbors[i][j]);
+      numNeighbors += neighbors[i].size();
+    }
+    std::vector<std::vector<size_t>>().swap(neighbors);
+
+    begin += blockSize;
+    const size_t averageNeighbors = std::max(numNeighbors / blockSize,
+        (size_t) 1);
+    blockSize = std::max(std::min(maxNeighbors / averageNeighbors,
+        4 * blockSize), (size_t) 1);
   }
+  Log::Info << "Range search complete." << std::endl;
 }
 
 } // namespace dbscan
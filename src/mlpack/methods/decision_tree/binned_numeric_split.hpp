@@ -0,0 +1,114 @@
+/**
+ * @file binned_numeric_split.hpp
+ *
+ * A tree splitter that finds a binary numeric split by scanning a histogram of
+ * the data instead of sorting it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_BINNED_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_DECISION_TREE_BINNED_NUMERIC_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The BinnedNumericSplit is a splitting function for decision trees that
+ * quantizes a numeric dimension into at most MaxBins equal-width bins, builds a
+ * histogram of the (possibly weighted) class counts in each bin, and then finds
+ * the best binary split between two bins with a single scan over the histogram.
+ *
+ * Unlike BestBinaryNumericSplit, no sorting is necessary, so finding a split
+ * takes O(n + MaxBins * numClasses) time instead of O(n log n) time.  The split
+ * found may be slightly worse than the best split, since only bin boundaries
+ * are considered as split points.
+ *
+ * The bins are computed from the range of the points of each node, since a
+ * split strategy only sees the points of the node it splits.  So the data is
+ * binned again at every node (in O(n) time), and the histogram of a child is
+ * not obtained from that of its parent and its sibling.
+ *
+ * The FitnessFunction must provide an EvaluatePtr() function that evaluates the
+ * fitness from class counts (both GiniGain and InformationGain do).
+ *
+ * @tparam FitnessFunction Fitness function to use to calculate gain.
+ */
+template<typename FitnessFunction>
+class BinnedNumericSplit
+{
+ public:
+  //! The maximum number of bins a dimension is quantized into.
+  static const size_t MaxBins = 256;
+
+  // No extra info needed for split.
+  template<typename ElemType>
+  class AuxiliarySplitInfo { };
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then classProbabilities
+   * and aux may be modified.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights associated with labels.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum improvement in gain required to split.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::Col<typename VecType::elem_type>& classProbabilities,
+      AuxiliarySplitInfo<typename VecType::elem_type>& aux);
+
+  /**
+   * Returns 2, since the binary split always has two children.
+   */
+  template<typename ElemType>
+  static size_t NumChildren(const arma::Col<ElemType>& /* classProbabilities */,
+                            const AuxiliarySplitInfo<ElemType>& /* aux */)
+  {
+    return 2;
+  }
+
+  /**
+   * Given a point, calculate which child it should go to (left or right).
+   *
+   * @param point Point to calculate direction of.
+   * @param classProbabilities Auxiliary information for the split.
+   * @param aux (Unused) auxiliary information for the split.
+   */
+  template<typename ElemType>
+  static size_t CalculateDirection(
+      const ElemType& point,
+      const arma::Col<ElemType>& classProbabilities,
+      const AuxiliarySplitInfo<ElemType>& /* aux */);
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "binned_numeric_split_impl.hpp"
+
+#endif
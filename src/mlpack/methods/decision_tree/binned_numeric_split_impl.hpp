@@ -0,0 +1,175 @@
+/**
+ * @file binned_numeric_split_impl.hpp
+ *
+ * Implementation of strategy that finds a binary numeric split by scanning a
+ * histogram of the data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_BINNED_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_BINNED_NUMERIC_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "binned_numeric_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double BinnedNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<typename VecType::elem_type>& classProbabilities,
+    AuxiliarySplitInfo<typename VecType::elem_type>& /* aux */)
+{
+  typedef typename VecType::elem_type ElemType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2) || data.n_elem < 2)
+    return bestGain;
+
+  // Find the range of the data.
+  ElemType minValue = data[0];
+  ElemType maxValue = data[0];
+  for (size_t i = 1; i < data.n_elem; ++i)
+  {
+    if (data[i] < minValue)
+      minValue = data[i];
+    else if (data[i] > maxValue)
+      maxValue = data[i];
+  }
+
+  // If all values are the same, there is nothing to split.
+  if (minValue == maxValue)
+    return bestGain;
+
+  const size_t numBins = std::min((size_t) MaxBins, (size_t) data.n_elem);
+  const double binScale = double(numBins) / (double(maxValue) -
+      double(minValue));
+
+  // Build the histogram: the (weighted) count of each class in each bin, the
+  // number of points in each bin, and the smallest and largest value in each
+  // bin (so that we can place split points halfway between two points, like
+  // BestBinaryNumericSplit does).
+  arma::mat binCounts(numClasses, numBins, arma::fill::zeros);
+  arma::Col<size_t> binPoints(numBins, arma::fill::zeros);
+  arma::Col<ElemType> binMin(numBins);
+  arma::Col<ElemType> binMax(numBins);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const size_t bin = std::min(numBins - 1,
+        (size_t) ((double(data[i]) - double(minValue)) * binScale));
+
+    binCounts(labels[i], bin) += UseWeights ? (double) weights[i] : 1.0;
+    if (binPoints[bin] == 0)
+    {
+      binMin[bin] = data[i];
+      binMax[bin] = data[i];
+    }
+    else if (data[i] < binMin[bin])
+    {
+      binMin[bin] = data[i];
+    }
+    else if (data[i] > binMax[bin])
+    {
+      binMax[bin] = data[i];
+    }
+    ++binPoints[bin];
+  }
+
+  // Total class counts of the node; for each candidate split, the counts on
+  // the right are these minus the counts on the left.
+  const arma::vec totalCounts = arma::sum(binCounts, 1);
+  const double totalWeight = arma::accu(totalCounts);
+  if (totalWeight == 0.0)
+    return bestGain;
+
+  arma::vec leftCounts(numClasses, arma::fill::zeros);
+  arma::vec rightCounts(numClasses);
+  double leftWeight = 0.0;
+  size_t leftPoints = 0;
+
+  // Scan through the bins, considering a split after each non-empty bin.  Also,
+  // force a minimum leaf size of 1 (empty children don't make sense).
+  double bestFoundGain = bestGain;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+  for (size_t bin = 0; bin < numBins - 1; ++bin)
+  {
+    if (binPoints[bin] == 0)
+      continue;
+
+    leftCounts += binCounts.col(bin);
+    leftWeight += arma::accu(binCounts.col(bin));
+    leftPoints += binPoints[bin];
+
+    // Make sure both children are large enough.
+    if (leftPoints < minimum)
+      continue;
+    if (data.n_elem - leftPoints < minimum)
+      break;
+
+    // Find the next non-empty bin; its smallest value bounds the split.
+    size_t nextBin = bin + 1;
+    while (nextBin < numBins && binPoints[nextBin] == 0)
+      ++nextBin;
+    if (nextBin == numBins)
+      break;
+
+    // Calculate the gain for the left and right child.
+    rightCounts = totalCounts - leftCounts;
+    const double rightWeight = totalWeight - leftWeight;
+    const double leftGain = FitnessFunction::EvaluatePtr(leftCounts.memptr(),
+        numClasses, leftWeight);
+    const double rightGain = FitnessFunction::EvaluatePtr(
+        rightCounts.memptr(), numClasses, rightWeight);
+
+    const double gain = (leftWeight / totalWeight) * leftGain +
+        (rightWeight / totalWeight) * rightGain;
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      // We can take a shortcut: no split will be better than this, so just take
+      // this one.
+      classProbabilities.set_size(1);
+      classProbabilities[0] = (binMax[bin] + binMin[nextBin]) / 2.0;
+      return gain;
+    }
+    else if (gain > bestFoundGain + minimumGainSplit)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      classProbabilities.set_size(1);
+      classProbabilities[0] = (binMax[bin] + binMin[nextBin]) / 2.0;
+    }
+  }
+
+  return bestFoundGain;
+}
+
+template<typename FitnessFunction>
+template<typename ElemType>
+size_t BinnedNumericSplit<FitnessFunction>::CalculateDirection(
+    const ElemType& point,
+    const arma::Col<ElemType>& classProbabilities,
+    const AuxiliarySplitInfo<ElemType>& /* aux */)
+{
+  if (point <= classProbabilities[0])
+    return 0; // Go left.
+  else
+    return 1; // Go right.
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
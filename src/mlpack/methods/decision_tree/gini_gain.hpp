@@ -175,6 +175,34 @@ class GiniGain
     return -impurity;
   }
 
+  /**
+   * Evaluate the Gini impurity given the (possibly weighted) number of points
+   * of each class, instead of the labels themselves.  This is useful for
+   * splitting strategies that accumulate class counts incrementally.
+   *
+   * @param counts Pointer to the count of each class.
+   * @param numClasses Number of classes in the dataset.
+   * @param totalCount Sum of all the counts.
+   */
+  template<typename CountType>
+  static double EvaluatePtr(const CountType* counts,
+                            const size_t numClasses,
+                            const CountType totalCount)
+  {
+    // Corner case: if there are no elements, the impurity is zero.
+    if (totalCount == 0)
+      return 0.0;
+
+    double impurity = 0.0;
+    for (size_t i = 0; i < numClasses; ++i)
+    {
+      const double f = ((double) counts[i] / (double) totalCount);
+      impurity += f * (1.0 - f);
+    }
+
+    return -impurity;
+  }
+
   /**
    * Return the range of the Gini impurity for the given number of classes.
    * (That is, the difference between the maximum possible value and the minimum
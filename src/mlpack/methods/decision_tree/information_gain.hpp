@@ -172,6 +172,35 @@ class InformationGain
     return gain;
   }
 
+  /**
+   * Evaluate the information gain given the (possibly weighted) number of
+   * points of each class, instead of the labels themselves.  This is useful for
+   * splitting strategies that accumulate class counts incrementally.
+   *
+   * @param counts Pointer to the count of each class.
+   * @param numClasses Number of classes in the dataset.
+   * @param totalCount Sum of all the counts.
+   */
+  template<typename CountType>
+  static double EvaluatePtr(const CountType* counts,
+                            const size_t numClasses,
+                            const CountType totalCount)
+  {
+    // Corner case: if there are no elements, the gain is zero.
+    if (totalCount == 0)
+      return 0.0;
+
+    double gain = 0.0;
+    for (size_t i = 0; i < numClasses; ++i)
+    {
+      const double f = ((double) counts[i] / (double) totalCount);
+      if (f > 0.0)
+        gain += f * std::log2(f);
+    }
+
+    return gain;
+  }
+
   /**
    * Return the range of the information gain for the given number of classes.
    * (That is, the difference between the maximum possible value and the minimum
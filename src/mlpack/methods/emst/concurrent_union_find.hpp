@@ -0,0 +1,105 @@
+/**
+ * @file concurrent_union_find.hpp
+ *
+ * A union-find data structure that may be used by many threads at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+#define MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <atomic>
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * A lock-free Union-Find data structure, which has the same interface as
+ * UnionFind, but whose Union() and Find() may be called by any number of
+ * threads at once.
+ *
+ * The root of a component is always the smallest index in it: Union() links
+ * the root with the larger index below the other root with a compare-and-swap,
+ * and retries if another thread changed either root in the meantime.  Since
+ * the parent of a point never has a larger index than the point itself, no
+ * thread can ever create a cycle.  Find() halves the path it follows, again
+ * with a compare-and-swap, so that later calls are faster.
+ *
+ * Because the root is the smallest index, the result of Find() after all the
+ * unions are done does not depend on the order in which the unions were done.
+ */
+class ConcurrentUnionFind
+{
+ private:
+  std::vector<std::atomic<size_t>> parent;
+
+ public:
+  //! Construct the object with the given size.
+  ConcurrentUnionFind(const size_t size) : parent(size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      parent[i].store(i, std::memory_order_relaxed);
+  }
+
+  /**
+   * Returns the component containing an element.
+   *
+   * @param x the component to be found
+   * @return The index of the component containing x
+   */
+  size_t Find(size_t x)
+  {
+    while (true)
+    {
+      size_t p = parent[x].load();
+      if (p == x)
+        return x;
+
+      // Point x to its grandparent.  If another thread changed the parent of x
+      // in the meantime, it only moved it closer to the root, so a failure can
+      // be ignored.
+      const size_t grandparent = parent[p].load();
+      if (grandparent != p)
+        parent[x].compare_exchange_weak(p, grandparent);
+
+      x = grandparent;
+    }
+  }
+
+  /**
+   * Union the components containing x and y.
+   *
+   * @param x one component
+   * @param y the other component
+   */
+  void Union(size_t x, size_t y)
+  {
+    while (true)
+    {
+      x = Find(x);
+      y = Find(y);
+
+      if (x == y)
+        return;
+
+      // Link the larger root below the smaller one.
+      if (x < y)
+        std::swap(x, y);
+
+      // This fails only if x stopped being a root; then find the roots again.
+      size_t expected = x;
+      if (parent[x].compare_exchange_strong(expected, y))
+        return;
+    }
+  }
+}; // class ConcurrentUnionFind
+
+} // namespace emst
+} // namespace mlpack
+
+#endif // MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
@@ -234,6 +234,12 @@ class HoeffdingTree
   //! Modify the number of samples before a split check is performed.
   void CheckInterval(const size_t checkInterval);
 
+  //! Get the number of classes this node is trained on.
+  size_t NumClasses() const { return numClasses; }
+
+  //! Get the dimensionality of the points this node is trained on.
+  size_t Dimensionality() const { return datasetInfo->Dimensionality(); }
+
   /**
    * Given a point and that this node is not a leaf, calculate the index of the
    * child node this point would go towards.  This method is primarily used by
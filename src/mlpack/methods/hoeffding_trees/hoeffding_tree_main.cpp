@@ -17,6 +17,7 @@
 #include <mlpack/methods/hoeffding_trees/binary_numeric_split.hpp>
 #include <mlpack/methods/hoeffding_trees/information_gain.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree_model.hpp>
+#include <memory>
 #include <queue>
 
 using namespace std;
@@ -39,6 +40,18 @@ PROGRAM_INFO("Hoeffding trees",
     PRINT_PARAM_STRING("labels") + " is not specified, the labels are assumed "
     "to be the last dimension of the training dataset."
     "\n\n"
+    "Datasets too large to fit in memory may instead be streamed from disk "
+    "with the " + PRINT_PARAM_STRING("training_file") + " parameter, which "
+    "names a numeric CSV, TSV, TXT or memory-mappable binary (.mmat) file "
+    "whose last dimension holds the labels.  The file is read in chunks of " +
+    PRINT_PARAM_STRING("chunk_size") + " points on a background thread while "
+    "the tree trains on the previous chunk.  In this case the number of "
+    "classes must be given with " + PRINT_PARAM_STRING("num_classes") + " "
+    "(unless an input model is given), and the tree may be saved to the file "
+    "given by " + PRINT_PARAM_STRING("checkpoint_file") + " every " +
+    PRINT_PARAM_STRING("checkpoint_interval") + " points, so that training "
+    "can be resumed later by passing the checkpoint as an input model."
+    "\n\n"
     "The training may be performed in batch mode "
     "(like a typical decision tree algorithm) by specifying the " +
     PRINT_PARAM_STRING("batch_mode") + " option, but this may not be the best "
@@ -76,6 +89,18 @@ PARAM_MATRIX_AND_INFO_IN("training", "Training dataset (may be categorical).",
     "t");
 PARAM_UROW_IN("labels", "Labels for training dataset.", "l");
 
+PARAM_STRING_IN("training_file", "File containing a numeric training dataset, "
+    "with labels in the last dimension, to stream from disk in chunks instead "
+    "of loading it into memory.", "f", "");
+PARAM_INT_IN("chunk_size", "Number of points read from the training file at a "
+    "time, when streaming.", "C", 100000);
+PARAM_INT_IN("num_classes", "Number of classes in the training file, when "
+    "streaming.", "k", 0);
+PARAM_STRING_IN("checkpoint_file", "File to periodically save the model to "
+    "while streaming the training file.", "K", "");
+PARAM_INT_IN("checkpoint_interval", "Number of points between checkpoints when "
+    "streaming.", "", 1000000);
+
 PARAM_DOUBLE_IN("confidence", "Confidence before splitting (between 0 and 1).",
     "c", 0.95);
 PARAM_INT_IN("max_samples", "Maximum number of samples before splitting.", "n",
@@ -119,7 +144,13 @@ static void mlpackMain()
   const string numericSplitStrategy =
       CLI::GetParam<string>("numeric_split_strategy");
 
-  RequireAtLeastOnePassed({ "training", "input_model" }, true);
+  RequireAtLeastOnePassed({ "training", "training_file", "input_model" },
+      true);
+  if (CLI::HasParam("training") && CLI::HasParam("training_file"))
+  {
+    Log::Fatal << "Cannot specify both " << PRINT_PARAM_STRING("training")
+        << " and " << PRINT_PARAM_STRING("training_file") << "!" << endl;
+  }
 
   RequireAtLeastOnePassed({ "output_model", "predictions", "probabilities",
       "test_labels" }, false, "no output will be given");
@@ -128,7 +159,26 @@ static void mlpackMain()
   ReportIgnoredParam({{ "test", false }}, "predictions");
 
   ReportIgnoredParam({{ "training", false }}, "batch_mode");
-  ReportIgnoredParam({{ "training", false }}, "passes");
+  ReportIgnoredParam({{ "training", false }, { "training_file", false }},
+      "passes");
+  ReportIgnoredParam({{ "training_file", false }}, "chunk_size");
+  ReportIgnoredParam({{ "training_file", false }}, "num_classes");
+  ReportIgnoredParam({{ "training_file", false }}, "checkpoint_file");
+  ReportIgnoredParam({{ "training_file", false }}, "checkpoint_interval");
+
+  if (CLI::HasParam("training_file"))
+  {
+    RequireParamValue<int>("chunk_size", [](int x) { return x > 0; }, true,
+        "chunk size must be positive");
+    RequireParamValue<int>("checkpoint_interval", [](int x) { return x > 0; },
+        true, "checkpoint interval must be positive");
+    if (!CLI::HasParam("input_model"))
+    {
+      RequireParamValue<int>("num_classes", [](int x) { return x > 0; }, true,
+          "number of classes must be given when streaming without an input "
+          "model");
+    }
+  }
 
   if (CLI::HasParam("test"))
   {
@@ -229,6 +279,71 @@ static void mlpackMain()
 
     Timer::Stop("tree_training");
   }
+  else if (CLI::HasParam("training_file"))
+  {
+    // Load necessary parameters for training.
+    const string trainingFile = CLI::GetParam<string>("training_file");
+    const size_t chunkSize = (size_t) CLI::GetParam<int>("chunk_size");
+    const string checkpointFile = CLI::GetParam<string>("checkpoint_file");
+    const size_t checkpointInterval = (size_t)
+        CLI::GetParam<int>("checkpoint_interval");
+    const size_t passes = (size_t) CLI::GetParam<int>("passes");
+
+    Timer::Start("tree_training");
+    for (size_t p = 0; p < passes; ++p)
+    {
+      std::unique_ptr<ChunkReader> reader;
+      try
+      {
+        reader.reset(new ChunkReader(trainingFile, chunkSize));
+      }
+      catch (std::exception& e)
+      {
+        Log::Fatal << e.what() << endl;
+      }
+
+      if (reader->Dimensionality() < 2)
+      {
+        Log::Fatal << "Training file '" << trainingFile << "' must have at "
+            << "least one dimension besides the labels!" << endl;
+      }
+
+      // The tree must know the dimensionality and the number of classes before
+      // it sees any points, so build it without any.  A loaded tree keeps its
+      // own dataset information.
+      if (p == 0 && !CLI::HasParam("input_model"))
+      {
+        // Streamed data is numeric.
+        datasetInfo = DatasetInfo(reader->Dimensionality() - 1);
+
+        const double confidence = CLI::GetParam<double>("confidence");
+        const size_t maxSamples = (size_t) CLI::GetParam<int>("max_samples");
+        const size_t minSamples = (size_t) CLI::GetParam<int>("min_samples");
+        const size_t bins = (size_t) CLI::GetParam<int>("bins");
+        const size_t observationsBeforeBinning = (size_t)
+            CLI::GetParam<int>("observations_before_binning");
+        const size_t numClasses = (size_t) CLI::GetParam<int>("num_classes");
+
+        model->BuildModel(arma::mat(datasetInfo.Dimensionality(), 0),
+            datasetInfo, arma::Row<size_t>(), numClasses, false, confidence,
+            maxSamples, 100, minSamples, bins, observationsBeforeBinning);
+      }
+
+      size_t numPoints = 0;
+      try
+      {
+        numPoints = model->Train(*reader, checkpointFile, checkpointInterval);
+      }
+      catch (std::exception& e)
+      {
+        Log::Fatal << e.what() << endl;
+      }
+
+      Log::Info << "Pass " << (p + 1) << " took " << numPoints << " points "
+          << "from '" << trainingFile << "'." << endl;
+    }
+    Timer::Stop("tree_training");
+  }
 
   // Do we need to evaluate the training set error?
   if (CLI::HasParam("training"))
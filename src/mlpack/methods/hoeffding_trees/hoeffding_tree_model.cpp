@@ -11,6 +11,9 @@
  */
 #include "hoeffding_tree_model.hpp"
 
+#include <mlpack/core/data/save.hpp>
+
+#include <cstdio>
 #include <queue>
 
 using namespace mlpack;
@@ -204,6 +207,90 @@ void HoeffdingTreeModel::Train(const arma::mat& dataset,
   }
 }
 
+// Save the model to the given file, without ever leaving a partially written
+// file behind.
+void HoeffdingTreeModel::SaveCheckpoint(const std::string& checkpointFile)
+{
+  // Write to a temporary file with the same extension (so that the format is
+  // the same), and then move it over the old checkpoint.
+  const std::string tmpFile = checkpointFile + ".tmp." +
+      data::Extension(checkpointFile);
+  if (!data::Save(tmpFile, "model", *this, false) ||
+      std::rename(tmpFile.c_str(), checkpointFile.c_str()) != 0)
+  {
+    std::remove(tmpFile.c_str());
+    std::ostringstream oss;
+    oss << "HoeffdingTreeModel::Train(): could not save checkpoint to '"
+        << checkpointFile << "'.";
+    throw std::runtime_error(oss.str());
+  }
+
+  Log::Info << "Saved checkpoint to '" << checkpointFile << "'." << std::endl;
+}
+
+// Train the model on one pass of the data given by the chunk reader.
+size_t HoeffdingTreeModel::Train(data::ChunkReader& reader,
+                                 const std::string& checkpointFile,
+                                 const size_t checkpointInterval)
+{
+  if (reader.Dimensionality() == 0)
+    return 0;
+
+  const size_t numClasses = NumClasses();
+  const size_t dimensionality = Dimensionality();
+  size_t numPoints = 0;
+  size_t lastCheckpoint = 0;
+  arma::mat chunk;
+  while (reader.NextChunk(chunk))
+  {
+    // Points of the wrong size would be read out of bounds by the tree.
+    if (chunk.n_rows - 1 != dimensionality)
+    {
+      std::ostringstream oss;
+      oss << "HoeffdingTreeModel::Train(): the data has " << (chunk.n_rows - 1)
+          << " dimensions besides the labels, but the tree was built for "
+          << dimensionality << " dimensions!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    // The labels are in the last dimension.  The statistics of the tree only
+    // have room for the classes it was built with, so any other label is an
+    // error.
+    for (size_t i = 0; i < chunk.n_cols; ++i)
+    {
+      const double label = chunk(chunk.n_rows - 1, i);
+      if (label < 0 || label >= numClasses || label != std::floor(label))
+      {
+        std::ostringstream oss;
+        oss << "HoeffdingTreeModel::Train(): label " << label << " of point "
+            << (numPoints + i) << " is not a class index less than the number "
+            << "of classes (" << numClasses << ")!";
+        throw std::invalid_argument(oss.str());
+      }
+    }
+
+    const arma::Row<size_t> labels = arma::conv_to<arma::Row<size_t>>::from(
+        chunk.row(chunk.n_rows - 1));
+    chunk.shed_row(chunk.n_rows - 1);
+
+    Train(chunk, labels, false);
+    numPoints += chunk.n_cols;
+    Log::Info << "Trained on " << numPoints << " points." << std::endl;
+
+    if (!checkpointFile.empty() && checkpointInterval > 0 &&
+        numPoints - lastCheckpoint >= checkpointInterval)
+    {
+      SaveCheckpoint(checkpointFile);
+      lastCheckpoint = numPoints;
+    }
+  }
+
+  if (!checkpointFile.empty() && numPoints != lastCheckpoint)
+    SaveCheckpoint(checkpointFile);
+
+  return numPoints;
+}
+
 // Classify the given points.
 void HoeffdingTreeModel::Classify(const arma::mat& dataset,
                                   arma::Row<size_t>& predictions) const
@@ -293,3 +380,37 @@ size_t HoeffdingTreeModel::NumNodes() const
 
   return 0; // This should never happen!
 }
+
+size_t HoeffdingTreeModel::NumClasses() const
+{
+  switch (type)
+  {
+    case GINI_HOEFFDING:
+      return giniHoeffdingTree->NumClasses();
+    case GINI_BINARY:
+      return giniBinaryTree->NumClasses();
+    case INFO_HOEFFDING:
+      return infoHoeffdingTree->NumClasses();
+    case INFO_BINARY:
+      return infoBinaryTree->NumClasses();
+  }
+
+  return 0; // This should never happen!
+}
+
+size_t HoeffdingTreeModel::Dimensionality() const
+{
+  switch (type)
+  {
+    case GINI_HOEFFDING:
+      return giniHoeffdingTree->Dimensionality();
+    case GINI_BINARY:
+      return giniBinaryTree->Dimensionality();
+    case INFO_HOEFFDING:
+      return infoHoeffdingTree->Dimensionality();
+    case INFO_BINARY:
+      return infoBinaryTree->Dimensionality();
+  }
+
+  return 0; // This should never happen!
+}
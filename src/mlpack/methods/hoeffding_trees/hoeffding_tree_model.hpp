@@ -12,6 +12,8 @@
 #ifndef MLPACK_METHODS_HOEFFDING_TREE_HOEFFDING_TREE_MODEL_HPP
 #define MLPACK_METHODS_HOEFFDING_TREE_HOEFFDING_TREE_MODEL_HPP
 
+#include <mlpack/core/data/chunk_reader.hpp>
+
 #include "hoeffding_tree.hpp"
 #include "binary_numeric_split.hpp"
 #include "information_gain.hpp"
@@ -135,6 +137,31 @@ class HoeffdingTreeModel
              const arma::Row<size_t>& labels,
              const bool batchTraining);
 
+  /**
+   * Train in streaming mode on the points given by the chunk reader, whose last
+   * dimension holds the labels.  This takes one pass over the file, and never
+   * holds more than two chunks in memory: the next chunk is read in the
+   * background while the tree is trained on the current one.  Be sure that
+   * BuildModel() has been called first (with a dataset of the right
+   * dimensionality, which may be empty)!
+   *
+   * If a checkpoint file is given, the model is saved to it every time at least
+   * checkpointInterval points have been seen since the last checkpoint, and
+   * once more after the last chunk.  Checkpoints are only taken between chunks.
+   * A checkpoint can be loaded like any other saved model (with the name
+   * "model"), to resume training or to make predictions.  A
+   * std::runtime_error is thrown if the file can't be read or a checkpoint
+   * can't be saved.
+   *
+   * @param reader Chunk reader to take points from.
+   * @param checkpointFile File to save checkpoints to (none if empty).
+   * @param checkpointInterval Number of points between checkpoints.
+   * @return Number of points trained on.
+   */
+  size_t Train(data::ChunkReader& reader,
+               const std::string& checkpointFile = "",
+               const size_t checkpointInterval = 0);
+
   /**
    * Using the model, classify the given test points.  Be sure that BuildModel()
    * has been called first!
@@ -162,6 +189,16 @@ class HoeffdingTreeModel
    */
   size_t NumNodes() const;
 
+  /**
+   * Get the number of classes the tree is trained on.
+   */
+  size_t NumClasses() const;
+
+  /**
+   * Get the dimensionality of the points the tree is trained on.
+   */
+  size_t Dimensionality() const;
+
   /**
    * Serialize the model.
    */
@@ -217,6 +254,9 @@ class HoeffdingTreeModel
   }
 
  private:
+  //! Save the model to the given checkpoint file.
+  void SaveCheckpoint(const std::string& checkpointFile);
+
   //! The type of tree we are using.
   TreeType type;
 
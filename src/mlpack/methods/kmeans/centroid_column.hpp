@@ -0,0 +1,83 @@
+/**
+ * @file centroid_column.hpp
+ *
+ * Helpers to use the columns of a dataset of any element type in arithmetic
+ * with the centroids, which are always held as doubles.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_CENTROID_COLUMN_HPP
+#define MLPACK_METHODS_KMEANS_CENTROID_COLUMN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * Return a column of a dataset of doubles (dense or sparse) as it is; it can
+ * be used directly with the centroids.
+ *
+ * @param column Column of the dataset.
+ */
+template<typename VecType>
+inline const VecType& CentroidColumn(
+    const VecType& column,
+    const typename std::enable_if_t<
+        std::is_same<typename VecType::elem_type, double>::value>* = 0)
+{
+  return column;
+}
+
+/**
+ * Convert a column of a dense dataset of another element type (such as float)
+ * to a column of doubles, so that it can be used with the centroids.
+ *
+ * @param column Column of the dataset.
+ */
+template<typename VecType>
+inline arma::vec CentroidColumn(
+    const VecType& column,
+    const typename std::enable_if_t<
+        !std::is_same<typename VecType::elem_type, double>::value>* = 0)
+{
+  return arma::conv_to<arma::vec>::from(column);
+}
+
+/**
+ * Return a block of columns of a dense dataset of doubles as it is; it can be
+ * used directly in products with the centroids.
+ *
+ * @param columns Columns of the dataset.
+ */
+template<typename MatType>
+inline const MatType& CentroidColumns(
+    const MatType& columns,
+    const typename std::enable_if_t<
+        std::is_same<typename MatType::elem_type, double>::value>* = 0)
+{
+  return columns;
+}
+
+/**
+ * Convert a block of columns of a dense dataset of another element type to a
+ * matrix of doubles, so that it can be used in products with the centroids.
+ *
+ * @param columns Columns of the dataset.
+ */
+template<typename MatType>
+inline arma::mat CentroidColumns(
+    const MatType& columns,
+    const typename std::enable_if_t<
+        !std::is_same<typename MatType::elem_type, double>::value>* = 0)
+{
+  return arma::conv_to<arma::mat>::from(columns);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -192,7 +192,7 @@ Cluster(const MatType& data,
       centroids.zeros(data.n_rows, clusters);
       for (size_t i = 0; i < data.n_cols; ++i)
       {
-        centroids.col(assignments[i]) += arma::vec(data.col(i));
+        centroids.col(assignments[i]) += arma::vec(CentroidColumn(data.col(i)));
         counts[assignments[i]]++;
       }
 
@@ -299,7 +299,7 @@ Cluster(const MatType& data,
     centroids.zeros(data.n_rows, clusters);
     for (size_t i = 0; i < data.n_cols; ++i)
     {
-      centroids.col(assignments[i]) += arma::vec(data.col(i));
+      centroids.col(assignments[i]) += arma::vec(CentroidColumn(data.col(i)));
       counts[assignments[i]]++;
     }
 
@@ -12,6 +12,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/data/chunk_reader.hpp>
 
 #include "kmeans.hpp"
 #include "allow_empty_clusters.hpp"
@@ -21,6 +22,9 @@
 #include "hamerly_kmeans.hpp"
 #include "pelleg_moore_kmeans.hpp"
 #include "dual_tree_kmeans.hpp"
+#include "mini_batch_kmeans.hpp"
+
+#include <memory>
 
 using namespace mlpack;
 using namespace mlpack::kmeans;
@@ -52,6 +56,22 @@ PROGRAM_INFO("K-Means Clustering", "This program performs K-Means clustering "
     "algorithm ('dualtree'), and the dual-tree k-means algorithm using the "
     "cover tree ('dualtree-covertree')."
     "\n\n"
+    "Sculley's mini-batch k-means ('minibatch') may be used instead of Lloyd "
+    "iterations for datasets too large to cluster in full.  It runs " +
+    PRINT_PARAM_STRING("max_iterations") + " iterations (which must be "
+    "positive) on mini-batches of " + PRINT_PARAM_STRING("batch_size") +
+    " points sampled from the input, and "
+    "each centroid has its own learning rate, so empty clusters are allowed.  "
+    "Points may also be streamed from disk with the " +
+    PRINT_PARAM_STRING("input_file") + " parameter, which names a numeric CSV, "
+    "TSV, TXT or memory-mappable binary (.mmat) file that is read in chunks of "
+    + PRINT_PARAM_STRING("chunk_size") + " points.  The centroids are then "
+    "updated online with every chunk, in mini-batches of consecutive points; "
+    "if no " + PRINT_PARAM_STRING("input") + " is given, the first chunk is "
+    "clustered first, unless " + PRINT_PARAM_STRING("initial_centroids") +
+    " are given, in which case every chunk updates them.  Only the centroids "
+    "may be saved when streaming without an input dataset."
+    "\n\n"
     "The behavior for when an empty cluster is encountered can be modified with"
     " the " + PRINT_PARAM_STRING("allow_empty_clusters") + " option.  When "
     "this option is specified and there is a cluster owning no points at the "
@@ -88,7 +108,7 @@ PROGRAM_INFO("K-Means Clustering", "This program performs K-Means clustering "
         "clusters", 10, "max_iterations", 500, "centroid", "final"));
 
 // Required options.
-PARAM_MATRIX_IN_REQ("input", "Input dataset to perform clustering on.", "i");
+PARAM_MATRIX_IN("input", "Input dataset to perform clustering on.", "i");
 PARAM_INT_IN_REQ("clusters", "Number of clusters to find (0 autodetects from "
     "initial centroids).", "c");
 
@@ -121,8 +141,17 @@ PARAM_DOUBLE_IN("percentage", "Percentage of dataset to use for each refined "
     "start sampling (use when --refined_start is specified).", "p", 0.02);
 
 PARAM_STRING_IN("algorithm", "Algorithm to use for the Lloyd iteration "
-    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', or "
-    "'dualtree-covertree').", "a", "naive");
+    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', "
+    "'dualtree-covertree', or 'minibatch').", "a", "naive");
+
+// Parameters for mini-batch k-means.
+PARAM_INT_IN("batch_size", "Number of points in each mini-batch (use when "
+    "--algorithm is 'minibatch').", "b", 1000);
+PARAM_STRING_IN("input_file", "File containing a numeric dataset to stream "
+    "from disk in chunks, updating the centroids online (use when --algorithm "
+    "is 'minibatch').", "f", "");
+PARAM_INT_IN("chunk_size", "Number of points read from the input file at a "
+    "time.", "", 100000);
 
 // Given the type of initial partition policy, figure out the empty cluster
 // policy and run k-means.
@@ -140,6 +169,18 @@ template<typename InitialPartitionPolicy,
          template<class, class> class LloydStepType>
 void RunKMeans(const InitialPartitionPolicy& ipp);
 
+// Given the initial partition policy, sanitize/load input and run mini-batch
+// k-means.
+template<typename InitialPartitionPolicy>
+void RunMiniBatchKMeans(const InitialPartitionPolicy& ipp);
+
+// Validate the number of clusters and return it.
+static int GetClusters();
+
+// Save the assignments of the points of the dataset to the output.
+static void SaveAssignments(arma::mat& dataset,
+                            const arma::Row<size_t>& assignments);
+
 static void mlpackMain()
 {
   // Initialize random seed.
@@ -174,6 +215,25 @@ static void mlpackMain()
 template<typename InitialPartitionPolicy>
 void FindEmptyClusterPolicy(const InitialPartitionPolicy& ipp)
 {
+  RequireParamInSet<string>("algorithm", { "elkan", "hamerly", "pelleg-moore",
+      "dualtree", "dualtree-covertree", "naive", "minibatch" }, true, "unknown "
+      "k-means algorithm");
+
+  // Mini-batch k-means has no empty cluster policy.
+  if (CLI::GetParam<string>("algorithm") == "minibatch")
+  {
+    if (CLI::HasParam("allow_empty_clusters") ||
+        CLI::HasParam("kill_empty_clusters"))
+    {
+      Log::Warn << PRINT_PARAM_STRING("allow_empty_clusters") << " and "
+          << PRINT_PARAM_STRING("kill_empty_clusters") << " ignored because "
+          << PRINT_PARAM_STRING("algorithm") << " is 'minibatch'; centroids "
+          << "without points do not move." << endl;
+    }
+    RunMiniBatchKMeans<InitialPartitionPolicy>(ipp);
+    return;
+  }
+
   if (CLI::HasParam("allow_empty_clusters") ||
       CLI::HasParam("kill_empty_clusters"))
     RequireOnlyOnePassed({ "allow_empty_clusters", "kill_empty_clusters" },
@@ -192,10 +252,6 @@ void FindEmptyClusterPolicy(const InitialPartitionPolicy& ipp)
 template<typename InitialPartitionPolicy, typename EmptyClusterPolicy>
 void FindLloydStepType(const InitialPartitionPolicy& ipp)
 {
-  RequireParamInSet<string>("algorithm", { "elkan", "hamerly", "pelleg-moore",
-      "dualtree", "dualtree-covertree", "naive" }, true, "unknown k-means "
-      "algorithm");
-
   const string algorithm = CLI::GetParam<string>("algorithm");
   if (algorithm == "elkan")
     RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, ElkanKMeans>(ipp);
@@ -221,23 +277,23 @@ template<typename InitialPartitionPolicy,
 void RunKMeans(const InitialPartitionPolicy& ipp)
 {
   // Now, do validation of input options.
-  if (!CLI::HasParam("initial_centroids"))
+  RequireAtLeastOnePassed({ "input" }, true);
+  if (CLI::HasParam("input_file"))
   {
-    RequireParamValue<int>("clusters", [](int x) { return x > 0; }, true,
-        "number of clusters must be positive");
-  }
-  else
-  {
-    ReportIgnoredParam({{ "initial_centroids", true }}, "clusters");
+    Log::Fatal << "Only mini-batch k-means can stream points from "
+        << PRINT_PARAM_STRING("input_file") << "; use "
+        << PRINT_PARAM_STRING("input") << " or set "
+        << PRINT_PARAM_STRING("algorithm") << " to 'minibatch'!" << endl;
   }
 
-  int clusters = CLI::GetParam<int>("clusters");
-  if (clusters == 0 && CLI::HasParam("initial_centroids"))
+  if (CLI::HasParam("batch_size"))
   {
-    Log::Info << "Detecting number of clusters automatically from input "
-        << "centroids." << endl;
+    Log::Warn << PRINT_PARAM_STRING("batch_size") << " ignored because "
+        << PRINT_PARAM_STRING("algorithm") << " is not 'minibatch'." << endl;
   }
 
+  int clusters = GetClusters();
+
   RequireParamValue<int>("max_iterations", [](int x) { return x >= 0; }, true,
     "maximum iterations must be positive or 0 (for no limit)");
   const int maxIterations = CLI::GetParam<int>("max_iterations");
@@ -278,53 +334,220 @@ void RunKMeans(const InitialPartitionPolicy& ipp)
     Timer::Stop("clustering");
 
     // Now figure out what to do with our results.
-    if (CLI::HasParam("in_place"))
-    {
-      // Add the column of assignments to the dataset; but we have to convert
-      // them to type double first.
-      arma::rowvec converted(assignments.n_elem);
-      for (size_t i = 0; i < assignments.n_elem; i++)
-        converted(i) = (double) assignments(i);
+    SaveAssignments(dataset, assignments);
+  }
+  else
+  {
+    // Just save the centroids.
+    kmeans.Cluster(dataset, clusters, centroids, initialCentroidGuess);
+    Timer::Stop("clustering");
+  }
 
-      dataset.insert_rows(dataset.n_rows, converted);
+  // Should we write the centroids to a file?
+  if (CLI::HasParam("centroid"))
+    CLI::GetParam<arma::mat>("centroid") = std::move(centroids);
+}
 
-      // Save the dataset.  We have to do a little trickery to get it to save
-      // the input file correctly.
-      CLI::GetPrintableParam<arma::mat>("output") =
-          CLI::GetPrintableParam<arma::mat>("input");
-      CLI::GetParam<arma::mat>("output") = std::move(dataset);
+// Given the initial partition policy, sanitize/load input and run mini-batch
+// k-means.
+template<typename InitialPartitionPolicy>
+void RunMiniBatchKMeans(const InitialPartitionPolicy& ipp)
+{
+  RequireAtLeastOnePassed({ "input", "input_file" }, true);
+
+  // The points that were streamed are not kept, so they can't be labeled.
+  if (!CLI::HasParam("input") &&
+      (CLI::HasParam("output") || CLI::HasParam("in_place")))
+  {
+    Log::Fatal << "Cannot save the assignments of the points of "
+        << PRINT_PARAM_STRING("input_file") << "; specify "
+        << PRINT_PARAM_STRING("input") << " or only save the centroids with "
+        << PRINT_PARAM_STRING("centroid") << "!" << endl;
+  }
+
+  ReportIgnoredParam({{ "input_file", false }}, "chunk_size");
+
+  int clusters = GetClusters();
+
+  // Mini-batch k-means has no convergence check, so there must be a limit.
+  RequireParamValue<int>("max_iterations", [](int x) { return x > 0; }, true,
+      "number of mini-batches must be positive");
+  const size_t maxIterations = (size_t) CLI::GetParam<int>("max_iterations");
+
+  RequireParamValue<int>("batch_size", [](int x) { return x > 0; }, true,
+      "batch size must be positive");
+  const size_t batchSize = (size_t) CLI::GetParam<int>("batch_size");
+
+  // Make sure we have an output file if we're not doing the work in-place.
+  RequireAtLeastOnePassed({ "in_place", "output", "centroid" }, false,
+      "no results will be saved");
+
+  arma::mat centroids;
+  const bool initialCentroidGuess = CLI::HasParam("initial_centroids");
+  if (initialCentroidGuess)
+  {
+    centroids = std::move(CLI::GetParam<arma::mat>("initial_centroids"));
+    if (clusters == 0)
+      clusters = centroids.n_cols;
+
+    ReportIgnoredParam({{ "refined_start", true }}, "initial_centroids");
+
+    if (!CLI::HasParam("refined_start"))
+      Log::Info << "Using initial centroid guesses." << endl;
+  }
+
+  std::unique_ptr<data::ChunkReader> reader;
+  if (CLI::HasParam("input_file"))
+  {
+    RequireParamValue<int>("chunk_size", [](int x) { return x > 0; }, true,
+        "chunk size must be positive");
+    const size_t chunkSize = (size_t) CLI::GetParam<int>("chunk_size");
+
+    try
+    {
+      reader.reset(new data::ChunkReader(CLI::GetParam<string>("input_file"),
+          chunkSize));
+    }
+    catch (std::exception& e)
+    {
+      Log::Fatal << e.what() << endl;
     }
+  }
+
+  Timer::Start("clustering");
+  MiniBatchKMeans<metric::EuclideanDistance, InitialPartitionPolicy> kmeans(
+      batchSize, maxIterations, metric::EuclideanDistance(), ipp);
+
+  // Without an input dataset, the first chunk is clustered, or only used to
+  // update the initial centroids if there are any.
+  arma::mat dataset;
+  if (CLI::HasParam("input"))
+    dataset = std::move(CLI::GetParam<arma::mat>("input"));
+
+  bool hasPoints = true;
+  try
+  {
+    if (!CLI::HasParam("input"))
+      hasPoints = reader->NextChunk(dataset);
+  }
+  catch (std::exception& e)
+  {
+    Log::Fatal << e.what() << endl;
+  }
+
+  if (!hasPoints)
+  {
+    Log::Fatal << "Input file '" << CLI::GetParam<string>("input_file")
+        << "' holds no points!" << endl;
+  }
+
+  try
+  {
+    if (CLI::HasParam("input") || !initialCentroidGuess)
+      kmeans.Cluster(dataset, clusters, centroids, initialCentroidGuess);
     else
+      kmeans.Update(dataset, centroids);
+
+    // Now keep updating the centroids with the rest of the stream.
+    if (reader)
     {
-      if (CLI::HasParam("labels_only"))
+      size_t numPoints = CLI::HasParam("input") ? 0 : dataset.n_cols;
+      arma::mat chunk;
+      while (reader->NextChunk(chunk))
       {
-        // Save only the labels.  TODO: figure out how to get this to output an
-        // arma::Mat<size_t> instead of an arma::mat.
-        CLI::GetParam<arma::mat>("output") =
-            arma::conv_to<arma::mat>::from(assignments);
+        kmeans.Update(chunk, centroids);
+        numPoints += chunk.n_cols;
       }
-      else
-      {
-        // Convert the assignments to doubles.
-        arma::rowvec converted(assignments.n_elem);
-        for (size_t i = 0; i < assignments.n_elem; i++)
-          converted(i) = (double) assignments(i);
-
-        dataset.insert_rows(dataset.n_rows, converted);
 
-        // Now save, in the different file.
-        CLI::GetParam<arma::mat>("output") = std::move(dataset);
-      }
+      Log::Info << "Updated centroids with " << numPoints << " points from '"
+          << CLI::GetParam<string>("input_file") << "'." << endl;
     }
   }
+  catch (std::exception& e)
+  {
+    Log::Fatal << e.what() << endl;
+  }
+
+  if (CLI::HasParam("output") || CLI::HasParam("in_place"))
+  {
+    arma::Row<size_t> assignments;
+    kmeans.Assign(dataset, centroids, assignments);
+    Timer::Stop("clustering");
+
+    SaveAssignments(dataset, assignments);
+  }
   else
   {
-    // Just save the centroids.
-    kmeans.Cluster(dataset, clusters, centroids, initialCentroidGuess);
     Timer::Stop("clustering");
   }
 
-  // Should we write the centroids to a file?
   if (CLI::HasParam("centroid"))
     CLI::GetParam<arma::mat>("centroid") = std::move(centroids);
 }
+
+// Validate the number of clusters and return it.
+static int GetClusters()
+{
+  if (!CLI::HasParam("initial_centroids"))
+  {
+    RequireParamValue<int>("clusters", [](int x) { return x > 0; }, true,
+        "number of clusters must be positive");
+  }
+  else
+  {
+    ReportIgnoredParam({{ "initial_centroids", true }}, "clusters");
+  }
+
+  const int clusters = CLI::GetParam<int>("clusters");
+  if (clusters == 0 && CLI::HasParam("initial_centroids"))
+  {
+    Log::Info << "Detecting number of clusters automatically from input "
+        << "centroids." << endl;
+  }
+
+  return clusters;
+}
+
+// Save the assignments of the points of the dataset to the output.
+static void SaveAssignments(arma::mat& dataset,
+                            const arma::Row<size_t>& assignments)
+{
+  if (CLI::HasParam("in_place"))
+  {
+    // Add the column of assignments to the dataset; but we have to convert
+    // them to type double first.
+    arma::rowvec converted(assignments.n_elem);
+    for (size_t i = 0; i < assignments.n_elem; i++)
+      converted(i) = (double) assignments(i);
+
+    dataset.insert_rows(dataset.n_rows, converted);
+
+    // Save the dataset.  We have to do a little trickery to get it to save
+    // the input file correctly.
+    CLI::GetPrintableParam<arma::mat>("output") =
+        CLI::GetPrintableParam<arma::mat>("input");
+    CLI::GetParam<arma::mat>("output") = std::move(dataset);
+  }
+  else
+  {
+    if (CLI::HasParam("labels_only"))
+    {
+      // Save only the labels.  TODO: figure out how to get this to output an
+      // arma::Mat<size_t> instead of an arma::mat.
+      CLI::GetParam<arma::mat>("output") =
+          arma::conv_to<arma::mat>::from(assignments);
+    }
+    else
+    {
+      // Convert the assignments to doubles.
+      arma::rowvec converted(assignments.n_elem);
+      for (size_t i = 0; i < assignments.n_elem; i++)
+        converted(i) = (double) assignments(i);
+
+      dataset.insert_rows(dataset.n_rows, converted);
+
+      // Now save, in the different file.
+      CLI::GetParam<arma::mat>("output") = std::move(dataset);
+    }
+  }
+}
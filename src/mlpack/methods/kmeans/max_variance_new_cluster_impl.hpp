@@ -14,6 +14,7 @@
 
 // Just in case it has not been included.
 #include "max_variance_new_cluster.hpp"
+#include "centroid_column.hpp"
 
 namespace mlpack {
 namespace kmeans {
@@ -66,10 +67,11 @@ void MaxVarianceNewCluster::EmptyCluster(const MatType& data,
   newCentroids.col(maxVarCluster) *= (double(clusterCounts[maxVarCluster]) /
       double(clusterCounts[maxVarCluster] - 1));
   newCentroids.col(maxVarCluster) -= (1.0 / (clusterCounts[maxVarCluster] -
-      1.0)) * arma::vec(data.col(furthestPoint));
+      1.0)) * arma::vec(CentroidColumn(data.col(furthestPoint)));
   clusterCounts[maxVarCluster]--;
   clusterCounts[emptyCluster]++;
-  newCentroids.col(emptyCluster) = arma::vec(data.col(furthestPoint));
+  newCentroids.col(emptyCluster) =
+      arma::vec(CentroidColumn(data.col(furthestPoint)));
   assignments[furthestPoint] = emptyCluster;
 
   // Modify the variances, as necessary.
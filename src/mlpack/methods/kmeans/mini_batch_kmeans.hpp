@@ -0,0 +1,210 @@
+/**
+ * @file mini_batch_kmeans.hpp
+ *
+ * Mini-batch k-means clustering, which updates the centroids with small random
+ * samples of the data instead of the whole dataset, and can keep updating them
+ * as new data arrives.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * An implementation of mini-batch k-means, as described in the paper below.
+ * Each iteration samples a mini-batch of points from the dataset, finds the
+ * closest centroid of each point of the batch, and then moves each of those
+ * centroids towards its points.  Each centroid has its own learning rate: it
+ * moves by 1 / n of the distance to a point, where n is the number of points
+ * it has been given so far.  The number of points assigned to each centroid is
+ * therefore the only state kept between iterations, so the dataset is never
+ * traversed as a whole.
+ *
+ * @code
+ * @inproceedings{sculley2010web,
+ *   title={Web-scale k-means clustering},
+ *   author={Sculley, D.},
+ *   booktitle={Proceedings of the 19th International Conference on World Wide
+ *       Web (WWW '10)},
+ *   pages={1177--1178},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * Cluster() samples the mini-batches at random from the given dataset, which
+ * may be the Matrix() of a data::MappedMatrix, so that only the sampled points
+ * are read from disk.  Update() runs mini-batch iterations on new points, in
+ * order, and continues from the state left by Cluster() or the last call to
+ * Update(); this can be used to keep the centroids up to date as data arrives,
+ * for instance chunk by chunk from a data::ChunkReader.
+ *
+ * @code
+ * extern arma::mat sample; // A sample of the data.
+ * arma::mat centroids;
+ *
+ * MiniBatchKMeans<> k(1000); // Mini-batches of 1000 points.
+ * k.Cluster(sample, 10, centroids);
+ *
+ * data::ChunkReader reader("huge_dataset.csv", 100000);
+ * arma::mat chunk;
+ * while (reader.NextChunk(chunk))
+ *   k.Update(chunk, centroids);
+ * @endcode
+ *
+ * A centroid that gets no points simply stays where it is.
+ *
+ * @tparam MetricType The distance metric used to find the closest centroid.
+ * @tparam InitialPartitionPolicy Initial partitioning policy; see KMeans.
+ * @tparam MatType Type of data (arma::mat or arma::fmat).
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename InitialPartitionPolicy = SampleInitialization,
+         typename MatType = arma::mat>
+class MiniBatchKMeans
+{
+ public:
+  /**
+   * Create the MiniBatchKMeans object and set the parameters with which it
+   * will be run.
+   *
+   * @param batchSize Number of points in each mini-batch.
+   * @param maxIterations Number of mini-batches Cluster() uses.
+   * @param metric Optional MetricType object; for when the metric has state.
+   * @param partitioner Optional InitialPartitionPolicy object.
+   */
+  MiniBatchKMeans(const size_t batchSize = 1000,
+                  const size_t maxIterations = 100,
+                  const MetricType metric = MetricType(),
+                  const InitialPartitionPolicy partitioner =
+                      InitialPartitionPolicy());
+
+  /**
+   * Cluster the data with maxIterations mini-batches of random points, storing
+   * the centroids of each cluster in the centroids matrix.  If initialGuess is
+   * true, the given centroids are used as the starting point; otherwise the
+   * initial partition policy is used.  The number of points given to each
+   * centroid so far is reset.
+   *
+   * @param data Dataset to cluster.
+   * @param clusters Number of clusters to compute.
+   * @param centroids Matrix in which centroids are stored.
+   * @param initialGuess If true, then it is assumed that centroids contains the
+   *      initial cluster centroids.
+   */
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids,
+               const bool initialGuess = false);
+
+  /**
+   * Cluster the data as the other overload of Cluster() does, and then assign
+   * each point of the dataset to its closest centroid.
+   *
+   * @param data Dataset to cluster.
+   * @param clusters Number of clusters to compute.
+   * @param assignments Vector to store cluster assignments in.
+   * @param centroids Matrix in which centroids are stored.
+   * @param initialGuess If true, then it is assumed that centroids contains the
+   *      initial cluster centroids.
+   */
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::Row<size_t>& assignments,
+               arma::mat& centroids,
+               const bool initialGuess = false);
+
+  /**
+   * Update the given centroids with new points, in mini-batches of BatchSize()
+   * consecutive points.  The learning rates continue from the last call to
+   * Cluster() or Update() with the same number of centroids; otherwise they
+   * start over.  A std::invalid_argument is thrown if there are no centroids or
+   * their dimensionality is not that of the points.
+   *
+   * @param points New points.
+   * @param centroids Centroids to update.
+   */
+  void Update(const MatType& points, arma::mat& centroids);
+
+  /**
+   * Assign each point of the given data to its closest centroid.
+   *
+   * @param data Points to assign.
+   * @param centroids Centroids of the clusters.
+   * @param assignments Vector to store cluster assignments in.
+   */
+  void Assign(const MatType& data,
+              const arma::mat& centroids,
+              arma::Row<size_t>& assignments);
+
+  //! Get the number of points in each mini-batch.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each mini-batch.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the number of mini-batches Cluster() uses.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the number of mini-batches Cluster() uses.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the distance metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the distance metric.
+  MetricType& Metric() { return metric; }
+
+  //! Get the initial partitioning policy.
+  const InitialPartitionPolicy& Partitioner() const { return partitioner; }
+  //! Modify the initial partitioning policy.
+  InitialPartitionPolicy& Partitioner() { return partitioner; }
+
+  //! Get the number of points given to each centroid so far.
+  const arma::Col<size_t>& Counts() const { return counts; }
+
+  //! Serialize the mini-batch k-means object.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+ private:
+  //! Number of points in each mini-batch.
+  size_t batchSize;
+  //! Number of mini-batches Cluster() uses.
+  size_t maxIterations;
+  //! Instantiated distance metric.
+  MetricType metric;
+  //! Instantiated initial partitioning policy.
+  InitialPartitionPolicy partitioner;
+  //! Number of points given to each centroid so far.
+  arma::Col<size_t> counts;
+
+  /**
+   * Run one iteration with the points of the data with the given indices.
+   *
+   * @param data Dataset holding the points.
+   * @param batch Indices of the points of the mini-batch.
+   * @param centroids Centroids to update.
+   */
+  void Step(const MatType& data,
+            const std::vector<size_t>& batch,
+            arma::mat& centroids);
+
+  //! Return the index of the centroid closest to the given point of doubles.
+  template<typename VecType>
+  size_t ClosestCentroid(const VecType& point, const arma::mat& centroids);
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "mini_batch_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,244 @@
+/**
+ * @file mini_batch_kmeans_impl.hpp
+ *
+ * Implementation of mini-batch k-means clustering.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mini_batch_kmeans.hpp"
+#include "centroid_column.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename MatType>
+MiniBatchKMeans<MetricType, InitialPartitionPolicy, MatType>::MiniBatchKMeans(
+    const size_t batchSize,
+    const size_t maxIterations,
+    const MetricType metric,
+    const InitialPartitionPolicy partitioner) :
+    batchSize(batchSize),
+    maxIterations(maxIterations),
+    metric(metric),
+    partitioner(partitioner)
+{
+  if (batchSize == 0)
+    throw std::invalid_argument("MiniBatchKMeans: the batch size must be "
+        "positive");
+}
+
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename MatType>
+void MiniBatchKMeans<MetricType, InitialPartitionPolicy, MatType>::Cluster(
+    const MatType& data,
+    const size_t clusters,
+    arma::mat& centroids,
+    const bool initialGuess)
+{
+  if (clusters == 0 || clusters > data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "MiniBatchKMeans::Cluster(): can't find " << clusters << " clusters "
+        << "in " << data.n_cols << " points";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (initialGuess)
+  {
+    if (centroids.n_cols != clusters)
+      Log::Fatal << "MiniBatchKMeans::Cluster(): wrong number of initial "
+          << "cluster centroids (" << centroids.n_cols << ", should be "
+          << clusters << ")!" << std::endl;
+
+    if (centroids.n_rows != data.n_rows)
+      Log::Fatal << "MiniBatchKMeans::Cluster(): initial cluster centroids "
+          << "have wrong dimensionality (" << centroids.n_rows << ", should be "
+          << data.n_rows << ")!" << std::endl;
+  }
+  else
+  {
+    // As in KMeans, the partitioner gives either centroids or assignments.
+    arma::Row<size_t> assignments;
+    if (GetInitialAssignmentsOrCentroids(partitioner, data, clusters,
+        assignments, centroids))
+    {
+      arma::Row<size_t> initialCounts(clusters, arma::fill::zeros);
+      centroids.zeros(data.n_rows, clusters);
+      for (size_t i = 0; i < data.n_cols; ++i)
+      {
+        centroids.col(assignments[i]) += arma::vec(CentroidColumn(data.col(i)));
+        initialCounts[assignments[i]]++;
+      }
+
+      for (size_t i = 0; i < clusters; ++i)
+        if (initialCounts[i] != 0)
+          centroids.col(i) /= initialCounts[i];
+    }
+  }
+
+  counts.zeros(clusters);
+
+  // Sample each mini-batch with replacement, as in the paper.
+  std::vector<size_t> batch(std::min(batchSize, (size_t) data.n_cols));
+  for (size_t iteration = 0; iteration < maxIterations; ++iteration)
+  {
+    for (size_t i = 0; i < batch.size(); ++i)
+      batch[i] = math::RandInt(data.n_cols);
+
+    Step(data, batch, centroids);
+  }
+
+  Log::Info << "MiniBatchKMeans::Cluster(): ran " << maxIterations
+      << " mini-batches of " << batch.size() << " points." << std::endl;
+}
+
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename MatType>
+void MiniBatchKMeans<MetricType, InitialPartitionPolicy, MatType>::Cluster(
+    const MatType& data,
+    const size_t clusters,
+    arma::Row<size_t>& assignments,
+    arma::mat& centroids,
+    const bool initialGuess)
+{
+  Cluster(data, clusters, centroids, initialGuess);
+  Assign(data, centroids, assignments);
+}
+
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename MatType>
+void MiniBatchKMeans<MetricType, InitialPartitionPolicy, MatType>::Update(
+    const MatType& points,
+    arma::mat& centroids)
+{
+  if (centroids.n_cols == 0)
+    throw std::invalid_argument("MiniBatchKMeans::Update(): no centroids to "
+        "update; call Cluster() first or give initial centroids");
+
+  if (centroids.n_rows != points.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "MiniBatchKMeans::Update(): the centroids have dimensionality "
+        << centroids.n_rows << ", but the points have dimensionality "
+        << points.n_rows;
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Other centroids than the last ones have no learning rates yet.
+  if (counts.n_elem != centroids.n_cols)
+    counts.zeros(centroids.n_cols);
+
+  std::vector<size_t> batch;
+  for (size_t begin = 0; begin < points.n_cols; begin += batchSize)
+  {
+    const size_t end = std::min(begin + batchSize, (size_t) points.n_cols);
+    batch.resize(end - begin);
+    for (size_t i = 0; i < batch.size(); ++i)
+      batch[i] = begin + i;
+
+    Step(points, batch, centroids);
+  }
+}
+
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename MatType>
+void MiniBatchKMeans<MetricType, InitialPartitionPolicy, MatType>::Assign(
+    const MatType& data,
+    const arma::mat& centroids,
+    arma::Row<size_t>& assignments)
+{
+  // Calculate the assignments in parallel over the entire dataset.
+  assignments.set_size(data.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    assignments[i] = ClosestCentroid(CentroidColumn(data.col(i)), centroids);
+}
+
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename MatType>
+void MiniBatchKMeans<MetricType, InitialPartitionPolicy, MatType>::Step(
+    const MatType& data,
+    const std::vector<size_t>& batch,
+    arma::mat& centroids)
+{
+  // Find the closest centroid of every point of the batch before any centroid
+  // moves.
+  std::vector<size_t> closest(batch.size());
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) batch.size(); ++i)
+    closest[i] = ClosestCentroid(CentroidColumn(data.col(batch[i])),
+        centroids);
+
+  // Then move each centroid towards its points, with a learning rate of one
+  // over the number of points it has been given so far; each centroid is then
+  // the mean of all the points it was given.
+  for (size_t i = 0; i < batch.size(); ++i)
+  {
+    const size_t c = closest[i];
+    ++counts[c];
+
+    const double rate = 1.0 / counts[c];
+    centroids.col(c) += rate * (CentroidColumn(data.col(batch[i])) -
+        centroids.col(c));
+  }
+}
+
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename MatType>
+template<typename VecType>
+size_t MiniBatchKMeans<MetricType, InitialPartitionPolicy, MatType>::
+ClosestCentroid(const VecType& point, const arma::mat& centroids)
+{
+  double minDistance = std::numeric_limits<double>::infinity();
+  size_t closestCluster = centroids.n_cols; // Invalid value.
+
+  for (size_t j = 0; j < centroids.n_cols; ++j)
+  {
+    const double distance = metric.Evaluate(point, centroids.col(j));
+    if (distance < minDistance)
+    {
+      minDistance = distance;
+      closestCluster = j;
+    }
+  }
+
+  Log::Assert(closestCluster != centroids.n_cols);
+  return closestCluster;
+}
+
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename MatType>
+template<typename Archive>
+void MiniBatchKMeans<MetricType, InitialPartitionPolicy, MatType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(batchSize);
+  ar & BOOST_SERIALIZATION_NVP(maxIterations);
+  ar & BOOST_SERIALIZATION_NVP(metric);
+  ar & BOOST_SERIALIZATION_NVP(partitioner);
+  ar & BOOST_SERIALIZATION_NVP(counts);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
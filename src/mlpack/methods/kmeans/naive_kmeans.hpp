@@ -15,16 +15,44 @@
 #ifndef MLPACK_METHODS_KMEANS_NAIVE_KMEANS_HPP
 #define MLPACK_METHODS_KMEANS_NAIVE_KMEANS_HPP
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
 
 namespace mlpack {
 namespace kmeans {
 
+/**
+ * Whether NaiveKMeans can find the closest centroids of a block of points with
+ * one matrix product, which is the case for the Euclidean distance (squared or
+ * not) on dense data.
+ */
+template<typename MetricType, typename MatType>
+struct UsesBlockedDistances
+{
+  static const bool value = false;
+};
+
+//! Specialization for the Euclidean distance on dense matrices.
+template<bool TakeRoot, typename eT>
+struct UsesBlockedDistances<metric::LMetric<2, TakeRoot>, arma::Mat<eT>>
+{
+  static const bool value = true;
+};
+
 /**
  * This is an implementation of a single iteration of Lloyd's algorithm for
  * k-means.  If your intention is to run the full k-means algorithm, you are
  * looking for the mlpack::kmeans::KMeans class instead of this one.  This class
  * is used by KMeans as the actual implementation of the Lloyd iteration.
  *
+ * With the Euclidean distance on dense data, the points are handled in blocks:
+ * since ||x - c||^2 = ||x||^2 - 2 x^T c + ||c||^2, the closest centroid of each
+ * point of a block follows from ||c||^2 and the products of the block with all
+ * centroids, which are computed with one BLAS matrix product.  The blocks are
+ * small enough that these products stay in cache.  With other metrics or
+ * sparse data, the metric is evaluated for each point and centroid.  In both
+ * cases the points are split among all available OpenMP threads, each of which
+ * sums the points of each cluster separately.
+ *
  * @param MetricType Type of metric used with this implementation.
  * @param MatType Matrix type (arma::mat or arma::sp_mat).
  */
@@ -64,6 +92,38 @@ class NaiveKMeans
 
   //! Number of distance calculations.
   size_t distanceCalculations;
+
+  /**
+   * Add each point to the sum of its closest centroid, evaluating the metric
+   * for each point and centroid.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids Sums of the points of each cluster.
+   * @param counts Number of points in each cluster.
+   */
+  template<typename Metric = MetricType>
+  void AssignPoints(
+      const arma::mat& centroids,
+      arma::mat& newCentroids,
+      arma::Col<size_t>& counts,
+      const typename std::enable_if_t<
+          !UsesBlockedDistances<Metric, MatType>::value>* = 0);
+
+  /**
+   * Add each point to the sum of its closest centroid, finding the closest
+   * centroids of a block of points at once with a matrix product.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids Sums of the points of each cluster.
+   * @param counts Number of points in each cluster.
+   */
+  template<typename Metric = MetricType>
+  void AssignPoints(
+      const arma::mat& centroids,
+      arma::mat& newCentroids,
+      arma::Col<size_t>& counts,
+      const typename std::enable_if_t<
+          UsesBlockedDistances<Metric, MatType>::value>* = 0);
 };
 
 } // namespace kmeans
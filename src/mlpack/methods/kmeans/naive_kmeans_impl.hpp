@@ -4,7 +4,8 @@
  * @author Shikhar Bhardwaj
  *
  * An implementation of a naively-implemented step of the Lloyd algorithm for
- * k-means clustering, using OpenMP for parallelization over multiple threads.
+ * k-means clustering, using OpenMP for parallelization over multiple threads
+ * and, with the Euclidean distance on dense data, blocked matrix products.
  * This may still be the best choice for small datasets or datasets with very
  * high dimensionality.
  *
@@ -18,6 +19,7 @@
 
 // In case it hasn't been included yet.
 #include "naive_kmeans.hpp"
+#include "centroid_column.hpp"
 
 namespace mlpack {
 namespace kmeans {
@@ -40,7 +42,37 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   counts.zeros(centroids.n_cols);
 
   // Find the closest centroid to each point and update the new centroids.
-  // Computed in parallel over the complete dataset
+  AssignPoints(centroids, newCentroids, counts);
+
+  // Now normalize the centroid.
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+    if (counts(i) != 0)
+      newCentroids.col(i) /= counts(i);
+
+  distanceCalculations += centroids.n_cols * dataset.n_cols;
+
+  // Calculate cluster distortion for this iteration.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+template<typename MetricType, typename MatType>
+template<typename Metric>
+void NaiveKMeans<MetricType, MatType>::AssignPoints(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts,
+    const typename std::enable_if_t<
+        !UsesBlockedDistances<Metric, MatType>::value>*)
+{
+  // Computed in parallel over the complete dataset.
   #pragma omp parallel
   {
     // The current state of the K-means is private for each thread
@@ -69,7 +101,8 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
       Log::Assert(closestCluster != centroids.n_cols);
 
       // We now have the minimum distance centroid index.  Update that centroid.
-      localCentroids.unsafe_col(closestCluster) += dataset.col(i);
+      localCentroids.unsafe_col(closestCluster) +=
+          CentroidColumn(dataset.col(i));
       localCounts(closestCluster)++;
     }
     // Combine calculated state from each thread
@@ -79,24 +112,77 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
       counts += localCounts;
     }
   }
+}
 
-  // Now normalize the centroid.
-  for (size_t i = 0; i < centroids.n_cols; ++i)
-    if (counts(i) != 0)
-      newCentroids.col(i) /= counts(i);
+template<typename MetricType, typename MatType>
+template<typename Metric>
+void NaiveKMeans<MetricType, MatType>::AssignPoints(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts,
+    const typename std::enable_if_t<
+        UsesBlockedDistances<Metric, MatType>::value>*)
+{
+  // ||x||^2 is the same for every centroid, so the closest centroid to x is the
+  // one with the smallest ||c||^2 - 2 x^T c.
+  const arma::vec centroidNorms = arma::trans(arma::sum(arma::square(centroids),
+      0));
+  const double* norms = centroidNorms.memptr();
 
-  distanceCalculations += centroids.n_cols * dataset.n_cols;
+  // Keep the products of a block of points with all centroids at about 512kB,
+  // so that they are still in cache when the closest centroids are found.
+  const size_t blockSize = std::min(std::max((size_t) 65536 /
+      std::max((size_t) centroids.n_cols, (size_t) 1), (size_t) 32),
+      (size_t) 1024);
+  const size_t numBlocks = (dataset.n_cols + blockSize - 1) / blockSize;
 
-  // Calculate cluster distortion for this iteration.
-  double cNorm = 0.0;
-  for (size_t i = 0; i < centroids.n_cols; ++i)
+  #pragma omp parallel
   {
-    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
-        2.0);
-  }
-  distanceCalculations += centroids.n_cols;
+    // Each thread sums the points of each cluster separately.
+    arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
+        arma::fill::zeros);
+    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+    arma::mat products;
 
-  return std::sqrt(cNorm);
+    #pragma omp for
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize, (size_t) dataset.n_cols);
+
+      products = arma::trans(centroids) *
+          CentroidColumns(dataset.cols(begin, end - 1));
+
+      for (size_t i = 0; i < products.n_cols; ++i)
+      {
+        const double* pointProducts = products.colptr(i);
+
+        double minScore = std::numeric_limits<double>::infinity();
+        size_t closestCluster = centroids.n_cols; // Invalid value.
+        for (size_t j = 0; j < centroids.n_cols; ++j)
+        {
+          const double score = norms[j] - 2.0 * pointProducts[j];
+          if (score < minScore)
+          {
+            minScore = score;
+            closestCluster = j;
+          }
+        }
+
+        Log::Assert(closestCluster != centroids.n_cols);
+
+        localCentroids.unsafe_col(closestCluster) +=
+            CentroidColumn(dataset.col(begin + i));
+        localCounts(closestCluster)++;
+      }
+    }
+
+    #pragma omp critical
+    {
+      newCentroids += localCentroids;
+      counts += localCounts;
+    }
+  }
 }
 
 } // namespace kmeans
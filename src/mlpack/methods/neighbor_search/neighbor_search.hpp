@@ -16,7 +16,9 @@
 #include <mlpack/prereqs.hpp>
 #include <vector>
 #include <string>
+#include <mutex>
 
+#include <mlpack/core/util/shared_mutex.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/binary_space_tree/binary_space_tree.hpp>
@@ -40,7 +42,8 @@ enum NeighborSearchMode
   NAIVE_MODE,
   SINGLE_TREE_MODE,
   DUAL_TREE_MODE,
-  GREEDY_SINGLE_TREE_MODE
+  GREEDY_SINGLE_TREE_MODE,
+  BEST_FIRST_SINGLE_TREE_MODE
 };
 
 /**
@@ -57,6 +60,40 @@ enum NeighborSearchMode
  * can be found in the NearestNeighborSort class and the kernel::ExampleKernel
  * class.
  *
+ * If mlpack is compiled with OpenMP, Search() uses all available threads (see
+ * omp_set_num_threads()).  In naive and single-tree mode the query points are
+ * split among the threads; in dual-tree mode the query tree is split into many
+ * independent subtrees, which the threads pick up one at a time, largest
+ * first.  Each thread has its own NeighborSearchRules object, but all threads
+ * store their results in the same candidate lists, since no query point is
+ * handled by two threads.  Single-tree search with trees whose reference nodes
+ * cache distances in their statistics (such as cover trees) runs on one
+ * thread.
+ *
+ * With trees that support it (the rectangle trees) or in naive mode, reference
+ * points can be added with InsertPoints() and removed with DeletePoint()
+ * without rebuilding the reference tree.  The index of a reference point never
+ * changes until the next call to Train(), so it can serve as a stable
+ * identifier.  Search(), Train(), InsertPoints() and DeletePoint() may be
+ * called from different threads.  Train(), InsertPoints() and DeletePoint()
+ * run alone: each waits until all other calls are finished, and other calls
+ * wait for it.  Calls to Search() run at the same time, except for searches
+ * that modify the reference tree, which run alone too: monochromatic
+ * dual-tree search, single-tree search with trees that cache distances in
+ * their reference nodes, and search with the reference tree as the query tree.
+ *
+ * In BEST_FIRST_SINGLE_TREE_MODE, the reference nodes are visited in the order
+ * of their distance to the query point (see tree::BestFirstSingleTreeTraverser)
+ * and the search for each query point can be limited to a number of visited
+ * nodes (MaxVisits()) or a time (TimeLimit()).  This gives the best neighbors
+ * found within the budget, and ErrorBounds() gives, for each query point, the
+ * largest relative error those neighbors can have: the distance of each found
+ * neighbor is at most (1 + ErrorBounds()[i]) times the true distance.  If the
+ * budget isn't used up, the results are exact and the bounds are 0.  Epsilon()
+ * is ignored in this mode.  Spill trees with overlapping nodes (tau > 0) would
+ * give duplicate neighbors in this mode, so Search() throws
+ * std::invalid_argument for them.
+ *
  * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
  * @tparam MetricType The metric to use for computation.
  * @tparam MatType The type of data matrix.
@@ -224,6 +261,36 @@ class NeighborSearch
    */
   void Train(Tree&& referenceTree);
 
+  /**
+   * Add the given points to the reference set without rebuilding the reference
+   * tree.  The new points get the indices ReferenceSet().n_cols,
+   * ReferenceSet().n_cols + 1, and so on, in the order of the columns of
+   * newReferences; these indices are what Search() returns for them.  This is
+   * only possible with trees that can insert points (the rectangle trees) or
+   * in naive mode; otherwise, std::invalid_argument is thrown and Train() has
+   * to be called instead.
+   *
+   * Each call copies the reference set to grow it, so it is much faster to
+   * insert many points in one call than with one call per point.
+   *
+   * @param newReferences Points to add to the reference set.
+   */
+  void InsertPoints(const MatType& newReferences);
+
+  /**
+   * Remove the reference point with the given index without rebuilding the
+   * reference tree.  Its column stays in ReferenceSet(), so that the indices of
+   * the other points don't change, but it is never returned as a neighbor
+   * again.  In monochromatic search, the results for a deleted point are
+   * SIZE_MAX and SortPolicy::WorstDistance().  This is only possible with
+   * trees that can delete points (the rectangle trees); otherwise, and in naive
+   * mode without a reference tree, std::invalid_argument is thrown.
+   *
+   * @param index Index of the reference point to delete.
+   * @return false if there is no such point or it was already deleted.
+   */
+  bool DeletePoint(const size_t index);
+
   /**
    * For each point in the query set, compute the nearest neighbors and store
    * the output in the given matrices.  The matrices will be set to the size of
@@ -339,9 +406,38 @@ class NeighborSearch
   //! Modify the relative error to be considered in approximate search.
   double& Epsilon() { return epsilon; }
 
-  //! Access the reference dataset.
+  //! Get the maximum number of nodes visited for each query point in
+  //! BEST_FIRST_SINGLE_TREE_MODE (0 means no limit).
+  size_t MaxVisits() const { return maxVisits; }
+  //! Modify the maximum number of nodes visited for each query point in
+  //! BEST_FIRST_SINGLE_TREE_MODE (0 means no limit).
+  size_t& MaxVisits() { return maxVisits; }
+
+  //! Get the maximum search time in seconds for each query point in
+  //! BEST_FIRST_SINGLE_TREE_MODE (0 means no limit).
+  double TimeLimit() const { return timeLimit; }
+  //! Modify the maximum search time in seconds for each query point in
+  //! BEST_FIRST_SINGLE_TREE_MODE (0 means no limit).
+  double& TimeLimit() { return timeLimit; }
+
+  /**
+   * Get the bound on the relative error of the results of each query point in
+   * the last search in BEST_FIRST_SINGLE_TREE_MODE; DBL_MAX means that nothing
+   * is known (for instance, because fewer than k neighbors were found).  This
+   * is empty after a search in any other mode.
+   */
+  const arma::vec& ErrorBounds() const { return errorBounds; }
+
+  //! Access the reference dataset.  This includes any deleted points.
   const MatType& ReferenceSet() const { return *referenceSet; }
 
+  //! Return the number of reference points that were not deleted.
+  size_t NumReferencePoints() const
+  {
+    return referenceSet->n_cols - (size_t) std::count(
+        deletedReferences.begin(), deletedReferences.end(), true);
+  }
+
   //! Access the reference tree.
   const Tree& ReferenceTree() const { return *referenceTree; }
   //! Modify the reference tree.
@@ -368,6 +464,11 @@ class NeighborSearch
   NeighborSearchMode searchMode;
   //! Indicates the relative error to be considered in approximate search.
   double epsilon;
+  //! The maximum number of nodes visited for each query point in best-first
+  //! search.
+  size_t maxVisits;
+  //! The maximum search time for each query point in best-first search.
+  double timeLimit;
 
   //! Instantiation of metric.
   MetricType metric;
@@ -376,11 +477,101 @@ class NeighborSearch
   size_t baseCases;
   //! The total number of scores (applicable for non-naive search).
   size_t scores;
+  //! The relative error bounds of the last best-first search.
+  arma::vec errorBounds;
 
   //! If this is true, the reference tree bounds need to be reset on a call to
   //! Search() without a query set.
   bool treeNeedsReset;
 
+  //! Which reference points were deleted with DeletePoint(); empty if none
+  //! were.
+  std::vector<bool> deletedReferences;
+
+  //! Held exclusively to change the reference set or tree, and by searches
+  //! that modify the reference tree; all other searches share it, so they can
+  //! run at the same time.
+  util::SharedMutex searchMutex;
+  //! Protects baseCases, scores and errorBounds, which each search sets when
+  //! it finishes.
+  std::mutex resultsMutex;
+
+  /**
+   * Call search(threadRules, i) for each query point i in [0, numQueries),
+   * where threadRules is a rules object that stores its results in the
+   * candidate lists of the given rules object.  If parallel is true, the query
+   * points are split among all available threads.  The number of base cases
+   * and scores of each thread is added to the given rules object.
+   *
+   * @param rules Rules object holding the candidate lists.
+   * @param numQueries Number of query points.
+   * @param parallel Whether or not the query points may be handled by
+   *     different threads.
+   * @param search Function that searches for the neighbors of one query point.
+   */
+  template<typename RuleType, typename SearchFunction>
+  void SearchEachQuery(RuleType& rules,
+                       const size_t numQueries,
+                       const bool parallel,
+                       SearchFunction search);
+
+  /**
+   * Run the dual-tree traversal of the given query tree and the reference
+   * tree.  If parallel is true, the query tree is split into independent
+   * subtrees that are traversed by all available threads, and the number of
+   * base cases and scores of each thread is added to the given rules object.
+   *
+   * @param rules Rules object holding the candidate lists.
+   * @param queryTree Query tree to traverse.
+   * @param parallel Whether or not the query tree may be split; this must be
+   *     false if a point can belong to two subtrees (e.g., spill trees with
+   *     overlap).
+   */
+  template<typename RuleType>
+  void DualTreeSearch(RuleType& rules, Tree& queryTree, const bool parallel);
+
+  /**
+   * Search for the neighbors of each query point in [0, numQueries) with the
+   * best-first traverser, within the budget, and store the best score of the
+   * nodes that were not visited in bounds.  Query points for which skip(i) is
+   * true are not searched.
+   *
+   * @param rules Rules object holding the candidate lists.
+   * @param numQueries Number of query points.
+   * @param skip Function that tells whether a query point must be skipped.
+   * @param bounds Vector to store the best unvisited score of each query point
+   *     in.
+   */
+  template<typename RuleType, typename SkipFunction>
+  void BestFirstSearch(RuleType& rules,
+                       const size_t numQueries,
+                       SkipFunction skip,
+                       arma::vec& bounds);
+
+  /**
+   * Turn the best unvisited scores of a best-first search into relative error
+   * bounds on the given results, in place.
+   *
+   * @param distances Distances of the neighbors found for each query point.
+   * @param bounds Best unvisited score of each query point; overwritten with
+   *     the relative error bounds.
+   */
+  void ComputeErrorBounds(const arma::mat& distances, arma::vec& bounds);
+
+  /**
+   * Store the statistics of a finished search, so that BaseCases(), Scores()
+   * and ErrorBounds() return them.  Searches that run at the same time keep
+   * their statistics to themselves until this is called.
+   *
+   * @param searchBaseCases Number of base cases of the search.
+   * @param searchScores Number of scores of the search.
+   * @param searchErrorBounds Error bounds of the search (empty if it was not a
+   *     best-first search).
+   */
+  void StoreStatistics(const size_t searchBaseCases,
+                       const size_t searchScores,
+                       arma::vec&& searchErrorBounds);
+
   //! The NSModel class should have access to internal members.
   template<typename SortPol>
   friend class TrainVisitor;
@@ -15,13 +15,16 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/greedy_single_tree_traverser.hpp>
+#include <mlpack/core/tree/best_first_single_tree_traverser.hpp>
+#include <mlpack/core/tree/compact_tree.hpp>
 #include "neighbor_search_rules.hpp"
 #include <mlpack/core/tree/spill_tree/is_spill_tree.hpp>
 
 namespace mlpack {
 namespace neighbor {
 
-//! Call the tree constructor that does mapping.
+//! Call the tree constructor that does mapping.  Trees built here are compacted
+//! (see tree::CompactTree()) since their shape never changes.
 template<typename TreeType, typename MatType>
 TreeType* BuildTree(
     MatType&& dataset,
@@ -30,7 +33,9 @@ TreeType* BuildTree(
         tree::TreeTraits<TreeType>::RearrangesDataset, TreeType
     >* = 0)
 {
-  return new TreeType(std::forward<MatType>(dataset), oldFromNew);
+  TreeType* root = new TreeType(std::forward<MatType>(dataset), oldFromNew);
+  tree::CompactTree(*root);
+  return root;
 }
 
 //! Call the tree constructor that does not do mapping.
@@ -42,7 +47,124 @@ TreeType* BuildTree(
         !tree::TreeTraits<TreeType>::RearrangesDataset, TreeType
     >* = 0)
 {
-  return new TreeType(std::forward<MatType>(dataset));
+  TreeType* root = new TreeType(std::forward<MatType>(dataset));
+  tree::CompactTree(*root);
+  return root;
+}
+
+/**
+ * Whether single-tree search with NeighborSearchRules caches distances in the
+ * statistics of reference nodes; if so, two threads can't search the same
+ * reference tree at once.
+ */
+template<typename TreeType>
+struct CachesReferenceDistances
+{
+  static const bool value = tree::TreeTraits<TreeType>::FirstPointIsCentroid &&
+      tree::TreeTraits<TreeType>::HasSelfChildren;
+};
+
+//! Trees other than spill trees never have overlapping nodes.
+template<typename TreeType>
+bool HasOverlappingNodes(
+    const TreeType& /* node */,
+    const typename std::enable_if_t<
+        !tree::IsSpillTree<TreeType>::value, TreeType
+    >* = 0)
+{
+  return false;
+}
+
+//! Whether any node of the given spill tree overlaps its sibling, so that a
+//! reference point can belong to two nodes (that is, the tree was built with a
+//! positive tau).
+template<typename TreeType>
+bool HasOverlappingNodes(
+    const TreeType& node,
+    const typename std::enable_if_t<
+        tree::IsSpillTree<TreeType>::value, TreeType
+    >* = 0)
+{
+  if (node.Overlap())
+    return true;
+
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    if (HasOverlappingNodes(node.Child(i)))
+      return true;
+
+  return false;
+}
+
+/**
+ * Whether points can be inserted into and deleted from the tree after it is
+ * built, as NeighborSearch::InsertPoints() and NeighborSearch::DeletePoint()
+ * need.
+ */
+template<typename TreeType>
+struct SupportsPointUpdates
+{
+  static const bool value = false;
+};
+
+// The rectangle trees can insert and delete points.
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+struct SupportsPointUpdates<tree::RectangleTree<MetricType, StatisticType,
+    MatType, SplitType, DescentType, AuxiliaryInformationType>>
+{
+  static const bool value = true;
+};
+
+//! Insert the point with the given index into the tree.
+template<typename TreeType>
+void InsertIntoTree(
+    TreeType& tree,
+    const size_t point,
+    const typename std::enable_if_t<
+        SupportsPointUpdates<TreeType>::value, TreeType
+    >* = 0)
+{
+  tree.InsertPoint(point);
+}
+
+//! Trees that can't insert points are never updated.
+template<typename TreeType>
+void InsertIntoTree(
+    TreeType& /* tree */,
+    const size_t /* point */,
+    const typename std::enable_if_t<
+        !SupportsPointUpdates<TreeType>::value, TreeType
+    >* = 0)
+{
+  // Nothing to do.
+}
+
+//! Delete the point with the given index from the tree.
+template<typename TreeType>
+bool DeleteFromTree(
+    TreeType& tree,
+    const size_t point,
+    const typename std::enable_if_t<
+        SupportsPointUpdates<TreeType>::value, TreeType
+    >* = 0)
+{
+  return tree.DeletePoint(point);
+}
+
+//! Trees that can't delete points are never updated.
+template<typename TreeType>
+bool DeleteFromTree(
+    TreeType& /* tree */,
+    const size_t /* point */,
+    const typename std::enable_if_t<
+        !SupportsPointUpdates<TreeType>::value, TreeType
+    >* = 0)
+{
+  return false;
 }
 
 // Construct the object.
@@ -67,6 +189,8 @@ SingleTreeTraversalType>::NeighborSearch(MatType referenceSetIn,
     setOwner(mode == NAIVE_MODE),
     searchMode(mode),
     epsilon(epsilon),
+    maxVisits(0),
+    timeLimit(0.0),
     metric(metric),
     baseCases(0),
     scores(0),
@@ -96,6 +220,8 @@ SingleTreeTraversalType>::NeighborSearch(Tree referenceTree,
     setOwner(false),
     searchMode(mode),
     epsilon(epsilon),
+    maxVisits(0),
+    timeLimit(0.0),
     metric(metric),
     baseCases(0),
     scores(0),
@@ -124,6 +250,8 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearchMode mode,
     setOwner(true),
     searchMode(mode),
     epsilon(epsilon),
+    maxVisits(0),
+    timeLimit(0.0),
     metric(metric),
     baseCases(0),
     scores(0),
@@ -159,10 +287,14 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearch& other) :
     setOwner(!other.referenceTree),
     searchMode(other.searchMode),
     epsilon(other.epsilon),
+    maxVisits(other.maxVisits),
+    timeLimit(other.timeLimit),
     metric(other.metric),
     baseCases(other.baseCases),
     scores(other.scores),
-    treeNeedsReset(false)
+    errorBounds(other.errorBounds),
+    treeNeedsReset(false),
+    deletedReferences(other.deletedReferences)
 {
   // Nothing else to do.
 }
@@ -185,10 +317,14 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
     setOwner(other.setOwner),
     searchMode(other.searchMode),
     epsilon(other.epsilon),
+    maxVisits(other.maxVisits),
+    timeLimit(other.timeLimit),
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
     scores(other.scores),
-    treeNeedsReset(other.treeNeedsReset)
+    errorBounds(std::move(other.errorBounds)),
+    treeNeedsReset(other.treeNeedsReset),
+    deletedReferences(std::move(other.deletedReferences))
 {
   // Clear the other model.
   other.referenceSet = new MatType();
@@ -198,9 +334,13 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
   other.setOwner = true;
   other.searchMode = DUAL_TREE_MODE,
   other.epsilon = 0.0;
+  other.maxVisits = 0;
+  other.timeLimit = 0.0;
   other.baseCases = 0;
   other.scores = 0;
+  other.errorBounds.reset();
   other.treeNeedsReset = false;
+  other.deletedReferences.clear();
 }
 
 // Copy operator.
@@ -242,10 +382,14 @@ NeighborSearch<SortPolicy,
   setOwner = (other.referenceTree == NULL);
   searchMode = other.searchMode;
   epsilon = other.epsilon;
+  maxVisits = other.maxVisits;
+  timeLimit = other.timeLimit;
   metric = other.metric;
   baseCases = other.baseCases;
   scores = other.scores;
+  errorBounds = other.errorBounds;
   treeNeedsReset = false;
+  deletedReferences = other.deletedReferences;
 }
 
 // Move operator.
@@ -286,10 +430,14 @@ NeighborSearch<SortPolicy,
   setOwner = other.setOwner;
   searchMode = other.searchMode;
   epsilon = other.epsilon;
+  maxVisits = other.maxVisits;
+  timeLimit = other.timeLimit;
   metric = other.metric;
   baseCases = other.baseCases;
   scores = other.scores;
+  errorBounds = std::move(other.errorBounds);
   treeNeedsReset = other.treeNeedsReset;
+  deletedReferences = std::move(other.deletedReferences);
 
   // Reset the other object.
   other.referenceSet = new MatType();
@@ -299,9 +447,13 @@ NeighborSearch<SortPolicy,
   other.setOwner = true;
   other.searchMode = DUAL_TREE_MODE,
   other.epsilon = 0.0;
+  other.maxVisits = 0;
+  other.timeLimit = 0.0;
   other.baseCases = 0;
   other.scores = 0;
+  other.errorBounds.reset();
   other.treeNeedsReset = false;
+  other.deletedReferences.clear();
 }
 
 // Clean memory.
@@ -334,6 +486,9 @@ void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
 DualTreeTraversalType, SingleTreeTraversalType>::Train(
     const MatType& referenceSet)
 {
+  std::lock_guard<util::SharedMutex> lock(searchMutex);
+  deletedReferences.clear();
+
   // Clean up the old tree, if we built one.
   if (treeOwner && referenceTree)
   {
@@ -372,6 +527,9 @@ template<typename SortPolicy,
 void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
 DualTreeTraversalType, SingleTreeTraversalType>::Train(MatType&& referenceSetIn)
 {
+  std::lock_guard<util::SharedMutex> lock(searchMutex);
+  deletedReferences.clear();
+
   // Clean up the old tree, if we built one.
   if (treeOwner && referenceTree)
   {
@@ -416,6 +574,9 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(
     throw std::invalid_argument("cannot train on given reference tree when "
         "naive search (without trees) is desired");
 
+  std::lock_guard<util::SharedMutex> lock(searchMutex);
+  deletedReferences.clear();
+
   if (treeOwner && this->referenceTree)
   {
     oldFromNewReferences.clear();
@@ -446,6 +607,9 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree&& referenceTree)
     throw std::invalid_argument("cannot train on given reference tree when "
         "naive search (without trees) is desired");
 
+  std::lock_guard<util::SharedMutex> lock(searchMutex);
+  deletedReferences.clear();
+
   if (treeOwner && this->referenceTree)
   {
     oldFromNewReferences.clear();
@@ -461,6 +625,97 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree&& referenceTree)
   setOwner = false;
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::InsertPoints(
+    const MatType& newReferences)
+{
+  std::lock_guard<util::SharedMutex> lock(searchMutex);
+
+  if (referenceTree && !SupportsPointUpdates<Tree>::value)
+    throw std::invalid_argument("NeighborSearch::InsertPoints(): the tree type "
+        "can't insert points; call Train() to build a new tree instead");
+
+  if (newReferences.n_rows != referenceSet->n_rows &&
+      (referenceTree || referenceSet->n_cols > 0))
+  {
+    std::stringstream ss;
+    ss << "NeighborSearch::InsertPoints(): dimensionality of the new points ("
+        << newReferences.n_rows << ") is not equal to the dimensionality of "
+        << "the reference set (" << referenceSet->n_rows << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  if (newReferences.n_cols == 0)
+    return;
+
+  // Without a tree, we can only grow the reference set if we own it.
+  if (!referenceTree && !setOwner)
+  {
+    referenceSet = new MatType(*referenceSet);
+    setOwner = true;
+  }
+
+  // Either we or the tree own the reference set, so it may be modified.
+  MatType& references = const_cast<MatType&>(*referenceSet);
+  const size_t oldNumReferences = references.n_cols;
+  references.resize(newReferences.n_rows,
+      oldNumReferences + newReferences.n_cols);
+  references.cols(oldNumReferences, references.n_cols - 1) = newReferences;
+
+  if (referenceTree)
+  {
+    for (size_t i = oldNumReferences; i < references.n_cols; ++i)
+      InsertIntoTree(*referenceTree, i);
+  }
+
+  if (!deletedReferences.empty())
+    deletedReferences.resize(references.n_cols, false);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+bool NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::DeletePoint(const size_t index)
+{
+  std::lock_guard<util::SharedMutex> lock(searchMutex);
+
+  // Without a tree, the deleted points would be forgotten on serialization.
+  if (!referenceTree)
+    throw std::invalid_argument("NeighborSearch::DeletePoint(): points can "
+        "only be deleted from a reference tree, not in naive mode");
+
+  if (!SupportsPointUpdates<Tree>::value)
+    throw std::invalid_argument("NeighborSearch::DeletePoint(): the tree type "
+        "can't delete points; call Train() to build a new tree instead");
+
+  if (index >= referenceSet->n_cols ||
+      (!deletedReferences.empty() && deletedReferences[index]))
+    return false;
+
+  if (!DeleteFromTree(*referenceTree, index))
+    return false;
+
+  if (deletedReferences.empty())
+    deletedReferences.resize(referenceSet->n_cols, false);
+  deletedReferences[index] = true;
+
+  return true;
+}
+
 /**
  * Computes the best neighbors and stores them in resultingNeighbors and
  * distances.
@@ -480,18 +735,34 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     arma::Mat<size_t>& neighbors,
     arma::mat& distances)
 {
-  if (k > referenceSet->n_cols)
+  // Single-tree searches of trees that cache distances in the reference nodes
+  // modify the reference tree, so they can't share it with other searches.
+  util::SharedLock lock(searchMutex, CachesReferenceDistances<Tree>::value &&
+      searchMode != NAIVE_MODE && searchMode != DUAL_TREE_MODE);
+
+  const size_t numReferences = NumReferencePoints();
+  if (k > numReferences)
   {
     std::stringstream ss;
     ss << "Requested value of k (" << k << ") is greater than the number of "
-        << "points in the reference set (" << referenceSet->n_cols << ")";
+        << "points in the reference set (" << numReferences << ")";
     throw std::invalid_argument(ss.str());
   }
 
+  // The best-first traverser would find a point of two overlapping nodes twice.
+  if (searchMode == BEST_FIRST_SINGLE_TREE_MODE &&
+      HasOverlappingNodes(*referenceTree))
+    throw std::invalid_argument("NeighborSearch::Search(): best-first search "
+        "can't be used with a spill tree with overlapping nodes; build the "
+        "spill tree with tau = 0");
+
   Timer::Start("computing_neighbors");
 
-  baseCases = 0;
-  scores = 0;
+  // The statistics of this search are stored only when it is finished, since
+  // other searches may run at the same time.
+  size_t numBaseCases = 0;
+  size_t numScores = 0;
+  arma::vec bounds;
 
   // This will hold mappings for query points, if necessary.
   std::vector<size_t> oldFromNewQueries;
@@ -528,12 +799,16 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric, epsilon);
 
-      // The naive brute-force traversal.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        for (size_t j = 0; j < referenceSet->n_cols; ++j)
-          rules.BaseCase(i, j);
+      // The naive brute-force traversal, skipping deleted points.
+      SearchEachQuery(rules, querySet.n_cols, true,
+          [&](RuleType& threadRules, const size_t i)
+          {
+            for (size_t j = 0; j < referenceSet->n_cols; ++j)
+              if (deletedReferences.empty() || !deletedReferences[j])
+                threadRules.BaseCase(i, j);
+          });
 
-      baseCases += querySet.n_cols * referenceSet->n_cols;
+      numBaseCases += querySet.n_cols * numReferences;
 
       rules.GetResults(*neighborPtr, *distancePtr);
       break;
@@ -543,15 +818,17 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric, epsilon);
 
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      // Now traverse for each point.
+      SearchEachQuery(rules, querySet.n_cols,
+          !CachesReferenceDistances<Tree>::value,
+          [&](RuleType& threadRules, const size_t i)
+          {
+            SingleTreeTraversalType<RuleType> traverser(threadRules);
+            traverser.Traverse(i, *referenceTree);
+          });
 
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
+      numScores += rules.Scores();
+      numBaseCases += rules.BaseCases();
 
       Log::Info << rules.Scores() << " node combinations were scored."
           << std::endl;
@@ -573,13 +850,11 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, epsilon);
 
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
+      // We built the query tree, so no point belongs to two of its subtrees.
+      DualTreeSearch(rules, *queryTree, true);
 
-      traverser.Traverse(*queryTree, *referenceTree);
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
+      numScores += rules.Scores();
+      numBaseCases += rules.BaseCases();
 
       Log::Info << rules.Scores() << " node combinations were scored."
           << std::endl;
@@ -596,18 +871,22 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric);
 
-      // Create the traverser.
-      tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
+      // Now traverse for each point.
+      SearchEachQuery(rules, querySet.n_cols,
+          !CachesReferenceDistances<Tree>::value,
+          [&](RuleType& threadRules, const size_t i)
+          {
+            tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(
+                threadRules);
 
-      // Set the value of minBaseCases.
-      traverser.MinBaseCases() = k;
+            // Set the value of minBaseCases.
+            traverser.MinBaseCases() = k;
 
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+            traverser.Traverse(i, *referenceTree);
+          });
 
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
+      numScores += rules.Scores();
+      numBaseCases += rules.BaseCases();
 
       Log::Info << rules.Scores() << " node combinations were scored."
           << std::endl;
@@ -617,6 +896,23 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       rules.GetResults(*neighborPtr, *distancePtr);
       break;
     }
+    case BEST_FIRST_SINGLE_TREE_MODE:
+    {
+      // Create the helper object for the tree traversal.
+      RuleType rules(*referenceSet, querySet, k, metric);
+
+      BestFirstSearch(rules, querySet.n_cols,
+          [](const size_t /* i */) { return false; }, bounds);
+
+      numScores += rules.Scores();
+      numBaseCases += rules.BaseCases();
+
+      rules.GetResults(*neighborPtr, *distancePtr);
+
+      // The query points are never rearranged in this mode.
+      ComputeErrorBounds(*distancePtr, bounds);
+      break;
+    }
   }
 
   Timer::Stop("computing_neighbors");
@@ -679,6 +975,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       delete neighborPtr;
     }
   }
+
+  StoreStatistics(numBaseCases, numScores, std::move(bounds));
 } // Search()
 
 template<typename SortPolicy,
@@ -697,11 +995,21 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     arma::mat& distances,
     bool sameSet)
 {
-  if (k > referenceSet->n_cols)
+  // If the query tree is the reference tree, the traversal changes the
+  // statistics of the reference tree, so the search can't be shared.
+  bool exclusive;
+  {
+    util::SharedLock checkLock(searchMutex);
+    exclusive = (&queryTree == referenceTree);
+  }
+  util::SharedLock lock(searchMutex, exclusive);
+
+  const size_t numReferences = NumReferencePoints();
+  if (k > numReferences)
   {
     std::stringstream ss;
     ss << "Requested value of k (" << k << ") is greater than the number of "
-        << "points in the reference set (" << referenceSet->n_cols << ")";
+        << "points in the reference set (" << numReferences << ")";
     throw std::invalid_argument(ss.str());
   }
 
@@ -712,8 +1020,11 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   Timer::Start("computing_neighbors");
 
-  baseCases = 0;
-  scores = 0;
+  // The statistics of this search are stored only when it is finished, since
+  // other searches may run at the same time.
+  size_t numBaseCases = 0;
+  size_t numScores = 0;
+  arma::vec bounds;
 
   // Get a reference to the query set.
   const MatType& querySet = queryTree.Dataset();
@@ -732,12 +1043,12 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
   RuleType rules(*referenceSet, querySet, k, metric, epsilon, sameSet);
 
-  // Create the traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(queryTree, *referenceTree);
+  // A spill tree given to us may have overlapping nodes, so a query point could
+  // belong to two subtrees.
+  DualTreeSearch(rules, queryTree, !tree::IsSpillTree<Tree>::value);
 
-  scores += rules.Scores();
-  baseCases += rules.BaseCases();
+  numScores += rules.Scores();
+  numBaseCases += rules.BaseCases();
 
   Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
   Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
@@ -764,6 +1075,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     // Finished with temporary matrix.
     delete neighborPtr;
   }
+
+  StoreStatistics(numBaseCases, numScores, std::move(bounds));
 }
 
 template<typename SortPolicy,
@@ -780,26 +1093,43 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     arma::Mat<size_t>& neighbors,
     arma::mat& distances)
 {
-  if (k > referenceSet->n_cols)
+  // The dual-tree search traverses the reference tree as the query tree, and
+  // the single-tree search of some trees caches distances in it; both change
+  // the reference tree, so they can't share it with other searches.
+  util::SharedLock lock(searchMutex, searchMode == DUAL_TREE_MODE ||
+      (CachesReferenceDistances<Tree>::value && searchMode != NAIVE_MODE));
+
+  const size_t numReferences = NumReferencePoints();
+  if (k > numReferences)
   {
     std::stringstream ss;
     ss << "Requested value of k (" << k << ") is greater than the number of "
-        << "points in the reference set (" << referenceSet->n_cols << ")";
+        << "points in the reference set (" << numReferences << ")";
     throw std::invalid_argument(ss.str());
   }
-  if (k == referenceSet->n_cols)
+  if (k == numReferences)
   {
     std::stringstream ss;
     ss << "Requested value of k (" << k << ") is equal to the number of "
-        << "points in the reference set (" << referenceSet->n_cols << ") and "
+        << "points in the reference set (" << numReferences << ") and "
         << "no query set has been provided.";
     throw std::invalid_argument(ss.str());
   }
 
+  // The best-first traverser would find a point of two overlapping nodes twice.
+  if (searchMode == BEST_FIRST_SINGLE_TREE_MODE &&
+      HasOverlappingNodes(*referenceTree))
+    throw std::invalid_argument("NeighborSearch::Search(): best-first search "
+        "can't be used with a spill tree with overlapping nodes; build the "
+        "spill tree with tau = 0");
+
   Timer::Start("computing_neighbors");
 
-  baseCases = 0;
-  scores = 0;
+  // The statistics of this search are stored only when it is finished, since
+  // other searches may run at the same time.
+  size_t numBaseCases = 0;
+  size_t numScores = 0;
+  arma::vec bounds;
 
   arma::Mat<size_t>* neighborPtr = &neighbors;
   arma::mat* distancePtr = &distances;
@@ -818,32 +1148,46 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   // Create the helper object for the traversal.
   typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
+  // The error bounds of best-first search only hold for exact pruning.
+  RuleType rules(*referenceSet, *referenceSet, k, metric,
+      (searchMode == BEST_FIRST_SINGLE_TREE_MODE) ? 0.0 : epsilon,
       true /* don't return the same point as nearest neighbor */);
 
   switch (searchMode)
   {
     case NAIVE_MODE:
     {
-      // The naive brute-force solution.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        for (size_t j = 0; j < referenceSet->n_cols; ++j)
-          rules.BaseCase(i, j);
-
-      baseCases += referenceSet->n_cols * referenceSet->n_cols;
+      // The naive brute-force solution, skipping deleted points.
+      SearchEachQuery(rules, referenceSet->n_cols, true,
+          [&](RuleType& threadRules, const size_t i)
+          {
+            if (!deletedReferences.empty() && deletedReferences[i])
+              return;
+
+            for (size_t j = 0; j < referenceSet->n_cols; ++j)
+              if (deletedReferences.empty() || !deletedReferences[j])
+                threadRules.BaseCase(i, j);
+          });
+
+      numBaseCases += numReferences * numReferences;
       break;
     }
     case SINGLE_TREE_MODE:
     {
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
+      // Traverse for each point that was not deleted.
+      SearchEachQuery(rules, referenceSet->n_cols,
+          !CachesReferenceDistances<Tree>::value,
+          [&](RuleType& threadRules, const size_t i)
+          {
+            if (!deletedReferences.empty() && deletedReferences[i])
+              return;
 
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+            SingleTreeTraversalType<RuleType> traverser(threadRules);
+            traverser.Traverse(i, *referenceTree);
+          });
 
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
+      numScores += rules.Scores();
+      numBaseCases += rules.BaseCases();
 
       Log::Info << rules.Scores() << " node combinations were scored."
           << std::endl;
@@ -873,25 +1217,22 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
         }
       }
 
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
-
       if (tree::IsSpillTree<Tree>::value)
       {
         // For Dual Tree Search on SpillTree, the queryTree must be built with
         // non overlapping (tau = 0).
         Tree queryTree(*referenceSet);
-        traverser.Traverse(queryTree, *referenceTree);
+        DualTreeSearch(rules, queryTree, true);
       }
       else
       {
-        traverser.Traverse(*referenceTree, *referenceTree);
+        DualTreeSearch(rules, *referenceTree, true);
         // Next time we perform this search, we'll need to reset the tree.
         treeNeedsReset = true;
       }
 
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
+      numScores += rules.Scores();
+      numBaseCases += rules.BaseCases();
 
       Log::Info << rules.Scores() << " node combinations were scored."
           << std::endl;
@@ -904,18 +1245,25 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     }
     case GREEDY_SINGLE_TREE_MODE:
     {
-      // Create the traverser.
-      tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
+      // Traverse for each point that was not deleted.
+      SearchEachQuery(rules, referenceSet->n_cols,
+          !CachesReferenceDistances<Tree>::value,
+          [&](RuleType& threadRules, const size_t i)
+          {
+            if (!deletedReferences.empty() && deletedReferences[i])
+              return;
 
-      // Set the value of minBaseCases.
-      traverser.MinBaseCases() = k;
+            tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(
+                threadRules);
 
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+            // Set the value of minBaseCases.
+            traverser.MinBaseCases() = k;
+
+            traverser.Traverse(i, *referenceTree);
+          });
 
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
+      numScores += rules.Scores();
+      numBaseCases += rules.BaseCases();
 
       Log::Info << rules.Scores() << " node combinations were scored."
           << std::endl;
@@ -923,10 +1271,26 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
           << std::endl;
       break;
     }
+    case BEST_FIRST_SINGLE_TREE_MODE:
+    {
+      // Search for each point that was not deleted.
+      BestFirstSearch(rules, referenceSet->n_cols,
+          [&](const size_t i)
+          {
+            return !deletedReferences.empty() && deletedReferences[i];
+          }, bounds);
+
+      numScores += rules.Scores();
+      numBaseCases += rules.BaseCases();
+      break;
+    }
   }
 
   rules.GetResults(*neighborPtr, *distancePtr);
 
+  if (searchMode == BEST_FIRST_SINGLE_TREE_MODE)
+    ComputeErrorBounds(*distancePtr, bounds);
+
   Timer::Stop("computing_neighbors");
 
   // Do we need to map the reference indices?
@@ -947,10 +1311,237 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
         neighbors(j, refMapping) = oldFromNewReferences[(*neighborPtr)(j, i)];
     }
 
+    // Map the error bounds, if there are any.
+    if (!bounds.is_empty())
+    {
+      const arma::vec mappedBounds(bounds);
+      for (size_t i = 0; i < bounds.n_elem; ++i)
+        bounds[oldFromNewReferences[i]] = mappedBounds[i];
+    }
+
     // Finished with temporary matrices.
     delete neighborPtr;
     delete distancePtr;
   }
+
+  StoreStatistics(numBaseCases, numScores, std::move(bounds));
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType, typename SearchFunction>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::SearchEachQuery(
+    RuleType& rules,
+    const size_t numQueries,
+    const bool parallel,
+    SearchFunction search)
+{
+  #pragma omp parallel if (parallel)
+  {
+    // Each thread has its own rules, but they all share the candidate lists of
+    // rules.
+    RuleType threadRules(&rules);
+
+    // The time taken for each query point varies a lot, so hand them out a
+    // few at a time.
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) numQueries; ++i)
+      search(threadRules, (size_t) i);
+
+    #pragma omp critical
+    {
+      rules.BaseCases() += threadRules.BaseCases();
+      rules.Scores() += threadRules.Scores();
+    }
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType, typename SkipFunction>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::BestFirstSearch(
+    RuleType& rules,
+    const size_t numQueries,
+    SkipFunction skip,
+    arma::vec& bounds)
+{
+  // Until ComputeErrorBounds() is called, this holds the best score of the
+  // nodes that were not visited for each query point.
+  bounds.set_size(numQueries);
+  bounds.fill(DBL_MAX);
+
+  SearchEachQuery(rules, numQueries, !CachesReferenceDistances<Tree>::value,
+      [&](RuleType& threadRules, const size_t i)
+      {
+        if (skip(i))
+          return;
+
+        tree::BestFirstSingleTreeTraverser<Tree, RuleType> traverser(
+            threadRules);
+        traverser.MaxVisits() = maxVisits;
+        traverser.TimeLimit() = timeLimit;
+
+        traverser.Traverse(i, *referenceTree);
+
+        bounds[i] = traverser.UnvisitedScore();
+      });
+
+  Log::Info << rules.Scores() << " node combinations were scored."
+      << std::endl;
+  Log::Info << rules.BaseCases() << " base cases were calculated."
+      << std::endl;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::ComputeErrorBounds(
+    const arma::mat& distances,
+    arma::vec& bounds)
+{
+  for (size_t i = 0; i < bounds.n_elem; ++i)
+  {
+    // No reference point that was not visited can have a better score than
+    // unvisitedScore.  So if the score of the k'th neighbor found is worse, a
+    // true neighbor may have been missed, but its distance is at most a factor
+    // kthScore / unvisitedScore better than the one that was found.
+    const double unvisitedScore = bounds[i];
+    const double kthScore = SortPolicy::ConvertToScore(
+        distances(distances.n_rows - 1, i));
+
+    if (unvisitedScore >= kthScore)
+      bounds[i] = 0.0;
+    else if (kthScore == DBL_MAX || unvisitedScore == 0.0)
+      bounds[i] = DBL_MAX;
+    else
+      bounds[i] = kthScore / unvisitedScore - 1.0;
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::StoreStatistics(
+    const size_t searchBaseCases,
+    const size_t searchScores,
+    arma::vec&& searchErrorBounds)
+{
+  std::lock_guard<std::mutex> lock(resultsMutex);
+  baseCases = searchBaseCases;
+  scores = searchScores;
+  errorBounds = std::move(searchErrorBounds);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::DualTreeSearch(
+    RuleType& rules,
+    Tree& queryTree,
+    const bool parallel)
+{
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  if (!parallel || numThreads == 1)
+  {
+    DualTreeTraversalType<RuleType> traverser(rules);
+    traverser.Traverse(queryTree, *referenceTree);
+    return;
+  }
+
+  // Split the query tree into disjoint subtrees that together hold every query
+  // point, by repeatedly replacing the largest subtree with its children.
+  // Using many more subtrees than threads lets threads that finish early take
+  // on the remaining work.  A node that holds points of its own (other than
+  // the point of its self-child) can't be split.
+  std::vector<Tree*> subtrees(1, &queryTree);
+  const size_t maxSubtrees = 16 * numThreads;
+  while (subtrees.size() < maxSubtrees)
+  {
+    size_t largest = subtrees.size();
+    for (size_t i = 0; i < subtrees.size(); ++i)
+    {
+      const Tree& node = *subtrees[i];
+      if (node.NumChildren() == 0 || (node.NumPoints() > 0 &&
+          !tree::TreeTraits<Tree>::HasSelfChildren))
+        continue;
+
+      if (largest == subtrees.size() ||
+          node.NumDescendants() > subtrees[largest]->NumDescendants())
+        largest = i;
+    }
+
+    // Stop if nothing can be split anymore.
+    if (largest == subtrees.size())
+      break;
+
+    Tree* node = subtrees[largest];
+    subtrees[largest] = &node->Child(0);
+    for (size_t i = 1; i < node->NumChildren(); ++i)
+      subtrees.push_back(&node->Child(i));
+  }
+
+  // Traverse the largest subtrees first, so that the small ones can fill the
+  // gaps at the end.
+  std::sort(subtrees.begin(), subtrees.end(),
+      [](const Tree* a, const Tree* b)
+      {
+        return a->NumDescendants() > b->NumDescendants();
+      });
+
+  // The bounds of a subtree depend only on the nodes inside it (and on the
+  // untouched bounds of its ancestors), so the subtrees can be traversed
+  // independently.  Each traversal gets new rules, so that the traversal
+  // information of one subtree isn't used for another.
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+  {
+    RuleType subtreeRules(&rules);
+    DualTreeTraversalType<RuleType> traverser(subtreeRules);
+    traverser.Traverse(*subtrees[i], *referenceTree);
+
+    #pragma omp critical
+    {
+      rules.BaseCases() += subtreeRules.BaseCases();
+      rules.Scores() += subtreeRules.Scores();
+    }
+  }
 }
 
 //! Calculate the average relative error.
@@ -1066,6 +1657,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::serialize(
       referenceTree = NULL;
       oldFromNewReferences.clear();
       treeOwner = false;
+      deletedReferences.clear();
     }
   }
   else
@@ -1093,6 +1685,15 @@ DualTreeTraversalType, SingleTreeTraversalType>::serialize(
       referenceSet = &referenceTree->Dataset();
       metric = referenceTree->Metric(); // Get the metric from the tree.
       setOwner = false;
+
+      // The points deleted with DeletePoint() are the ones not in the tree.
+      deletedReferences.clear();
+      if (referenceTree->NumDescendants() < referenceSet->n_cols)
+      {
+        deletedReferences.resize(referenceSet->n_cols, true);
+        for (size_t i = 0; i < referenceTree->NumDescendants(); ++i)
+          deletedReferences[referenceTree->Descendant(i)] = false;
+      }
     }
   }
 
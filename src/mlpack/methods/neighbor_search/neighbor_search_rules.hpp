@@ -54,6 +54,19 @@ class NeighborSearchRules
                       const double epsilon = 0,
                       const bool sameSet = false);
 
+  /**
+   * Construct a NeighborSearchRules object that searches with the same data
+   * and settings as the given object, but stores the candidate neighbors it
+   * finds in the candidate lists of the given object.  This allows several
+   * threads to search for the neighbors of different query points at once;
+   * each query point must be handled by only one thread, and the given object
+   * must outlive this one.  The number of base cases and scores and the
+   * traversal info are not shared.
+   *
+   * @param shared Object whose candidate lists will be used.
+   */
+  explicit NeighborSearchRules(NeighborSearchRules* shared);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -179,8 +192,13 @@ class NeighborSearchRules
   typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
       CandidateList;
 
-  //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  //! Set of candidate neighbors for each point, if they are not shared with
+  //! another NeighborSearchRules object.
+  std::vector<CandidateList> candidateLists;
+
+  //! The candidate neighbors for each point (these may belong to another
+  //! NeighborSearchRules object).
+  CandidateList* candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -223,6 +223,46 @@ class ReferenceSetVisitor : public boost::static_visitor<const arma::mat&>
   const arma::mat& operator()(NSType *ns) const;
 };
 
+/**
+ * InsertPointsVisitor adds points to the reference set of the given NSType
+ * instance without rebuilding its tree.
+ */
+class InsertPointsVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The points to add.
+  const arma::mat& newReferences;
+
+ public:
+  //! Add the points to the reference set.
+  template<typename NSType>
+  void operator()(NSType* ns) const;
+
+  //! Construct the InsertPointsVisitor object with the given points.
+  InsertPointsVisitor(const arma::mat& newReferences) :
+      newReferences(newReferences)
+  {};
+};
+
+/**
+ * DeletePointVisitor removes a point from the reference set of the given
+ * NSType instance without rebuilding its tree.
+ */
+class DeletePointVisitor : public boost::static_visitor<bool>
+{
+ private:
+  //! The index of the point to delete.
+  const size_t index;
+
+ public:
+  //! Delete the point from the reference set.
+  template<typename NSType>
+  bool operator()(NSType* ns) const;
+
+  //! Construct the DeletePointVisitor object with the given index.
+  DeletePointVisitor(const size_t index) : index(index) {};
+};
+
 /**
  * DeleteVisitor deletes the given NSType instance.
  */
@@ -389,6 +429,21 @@ class NSModel
                   const NeighborSearchMode searchMode,
                   const double epsilon = 0);
 
+  /**
+   * Add points to the reference set without rebuilding the tree; see
+   * NeighborSearch::InsertPoints().  This is only possible with the rectangle
+   * trees or in naive mode.  The points will be projected onto the random
+   * basis, if one is used.
+   */
+  void InsertPoints(arma::mat&& newReferences);
+
+  /**
+   * Delete a point from the reference set without rebuilding the tree; see
+   * NeighborSearch::DeletePoint().  This is only possible with the rectangle
+   * trees.
+   */
+  bool DeletePoint(const size_t index);
+
   //! Perform neighbor search.  The query set will be reordered.
   void Search(arma::mat&& querySet,
               const size_t k,
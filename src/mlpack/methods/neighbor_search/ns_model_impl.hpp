@@ -252,6 +252,24 @@ const arma::mat& ReferenceSetVisitor::operator()(NSType* ns) const
   throw std::runtime_error("no neighbor search model initialized");
 }
 
+//! Add the points to the reference set of the given NSType.
+template<typename NSType>
+void InsertPointsVisitor::operator()(NSType* ns) const
+{
+  if (ns)
+    return ns->InsertPoints(newReferences);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Delete the point from the reference set of the given NSType.
+template<typename NSType>
+bool DeletePointVisitor::operator()(NSType* ns) const
+{
+  if (ns)
+    return ns->DeletePoint(index);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
 //! Clean memory, if necessary.
 template<typename NSType>
 void DeleteVisitor::operator()(NSType* ns) const
@@ -526,6 +544,26 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
   }
 }
 
+//! Add points to the reference set.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::InsertPoints(arma::mat&& newReferences)
+{
+  // We may need to map the new points randomly.
+  if (randomBasis)
+    newReferences = q * newReferences;
+
+  InsertPointsVisitor insert(newReferences);
+  boost::apply_visitor(insert, nSearch);
+}
+
+//! Delete a point from the reference set.
+template<typename SortPolicy>
+bool NSModel<SortPolicy>::DeletePoint(const size_t index)
+{
+  DeletePointVisitor deletePoint(index);
+  return boost::apply_visitor(deletePoint, nSearch);
+}
+
 //! Perform neighbor search.  The query set will be reordered.
 template<typename SortPolicy>
 void NSModel<SortPolicy>::Search(arma::mat&& querySet,
@@ -554,6 +592,10 @@ void NSModel<SortPolicy>::Search(arma::mat&& querySet,
       Log::Info << "greedy single-tree " << TreeName() << " search..."
           << std::endl;
       break;
+    case BEST_FIRST_SINGLE_TREE_MODE:
+      Log::Info << "best-first single-tree " << TreeName() << " search..."
+          << std::endl;
+      break;
   }
 
   BiSearchVisitor<SortPolicy> search(querySet, k, neighbors, distances,
@@ -584,6 +626,10 @@ void NSModel<SortPolicy>::Search(const size_t k,
       Log::Info << "greedy single-tree " << TreeName() << " search..."
           << std::endl;
       break;
+    case BEST_FIRST_SINGLE_TREE_MODE:
+      Log::Info << "best-first single-tree " << TreeName() << " search..."
+          << std::endl;
+      break;
   }
 
   if (Epsilon() != 0 && SearchMode() != NAIVE_MODE)
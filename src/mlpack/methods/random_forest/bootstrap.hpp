@@ -2,8 +2,8 @@
  * @file bootstrap.hpp
  * @author Ryan Curtin
  *
- * Implementation of the Bootstrap() function, which creates a bootstrapped
- * dataset from the given input dataset.
+ * Implementation of the Bootstrap() and CompactBootstrap() functions, which
+ * create a bootstrapped dataset from the given input dataset.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -35,15 +35,64 @@ void Bootstrap(const MatType& dataset,
   if (UseWeights)
     bootstrapWeights.set_size(weights.n_elem);
 
-  // Random sampling with replacement.
-  arma::uvec indices = arma::randi<arma::uvec>(dataset.n_cols,
-      arma::distr_param(0, dataset.n_cols - 1));
+  // Random sampling with replacement.  We use math::RandIndex() so that the
+  // samples come from the calling thread's generator (see
+  // math::ScopedRandomGenerator).
   for (size_t i = 0; i < dataset.n_cols; ++i)
   {
-    bootstrapDataset.col(i) = dataset.col(indices[i]);
-    bootstrapLabels[i] = labels[indices[i]];
+    const size_t index = math::RandIndex(dataset.n_cols);
+    bootstrapDataset.col(i) = dataset.col(index);
+    bootstrapLabels[i] = labels[index];
     if (UseWeights)
-      bootstrapWeights[i] = weights[indices[i]];
+      bootstrapWeights[i] = weights[index];
+  }
+}
+
+/**
+ * Given a dataset, create a compact bootstrap sample.  Points are sampled with
+ * replacement exactly as in Bootstrap(), but each sampled point is stored only
+ * once, and the number of times it was drawn is stored as its weight (times
+ * its original weight, if UseWeights is true).  Only about 63% of the dataset
+ * is copied, and no column is duplicated.
+ *
+ * Training a weighted model on the compact sample only approximates training
+ * on the full bootstrap sample: the weights give the same split gains, but
+ * anything that counts points instead of weights (such as the minimum leaf
+ * size of DecisionTree) sees each sampled point once, so the trees may differ.
+ */
+template<bool UseWeights,
+         typename MatType,
+         typename LabelsType,
+         typename WeightsType>
+void CompactBootstrap(const MatType& dataset,
+                      const LabelsType& labels,
+                      const WeightsType& weights,
+                      MatType& bootstrapDataset,
+                      LabelsType& bootstrapLabels,
+                      arma::rowvec& bootstrapWeights)
+{
+  // Count how many times each point is drawn.  We use math::RandIndex() so
+  // that the samples come from the calling thread's generator (see
+  // math::ScopedRandomGenerator).
+  arma::Row<size_t> counts(dataset.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    ++counts[math::RandIndex(dataset.n_cols)];
+
+  const size_t numDistinct = (size_t) arma::accu(counts > 0);
+  bootstrapDataset.set_size(dataset.n_rows, numDistinct);
+  bootstrapLabels.set_size(numDistinct);
+  bootstrapWeights.set_size(numDistinct);
+
+  size_t j = 0;
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    if (counts[i] == 0)
+      continue;
+
+    bootstrapDataset.col(j) = dataset.col(i);
+    bootstrapLabels[j] = labels[i];
+    bootstrapWeights[j] = UseWeights ? counts[i] * weights[i] : counts[i];
+    ++j;
   }
 }
 
@@ -35,7 +35,7 @@ class RandomForest
    * Construct the random forest without any training or specifying the number
    * of trees.  Predict() will throw an exception until Train() is called.
    */
-  RandomForest() { }
+  RandomForest() : maxConcurrentTrees(0) { }
 
   /**
    * Create a random forest, training on the given labeled training data with
@@ -257,6 +257,14 @@ class RandomForest
   //! Get the number of trees in the forest.
   size_t NumTrees() const { return trees.size(); }
 
+  //! Get the maximum number of trees that are built concurrently (0 means no
+  //! limit other than the number of OpenMP threads).
+  size_t MaxConcurrentTrees() const { return maxConcurrentTrees; }
+  //! Modify the maximum number of trees that are built concurrently.  Each tree
+  //! under construction holds its own bootstrap copy of the dataset, so this
+  //! bounds the peak memory usage of Train().
+  size_t& MaxConcurrentTrees() { return maxConcurrentTrees; }
+
   /**
    * Serialize the random forest.
    */
@@ -291,6 +299,9 @@ class RandomForest
 
   //! The trees in the forest.
   std::vector<DecisionTreeType> trees;
+
+  //! The maximum number of trees to build at once (0 means no limit).
+  size_t maxConcurrentTrees;
 };
 
 } // namespace tree
@@ -36,7 +36,8 @@ RandomForest<
                 const arma::Row<size_t>& labels,
                 const size_t numClasses,
                 const size_t numTrees,
-                const size_t minimumLeafSize)
+                const size_t minimumLeafSize) :
+    maxConcurrentTrees(0)
 {
   // Pass off work to the Train() method.
   data::DatasetInfo info; // Ignored.
@@ -64,7 +65,8 @@ RandomForest<
                 const arma::Row<size_t>& labels,
                 const size_t numClasses,
                 const size_t numTrees,
-                const size_t minimumLeafSize)
+                const size_t minimumLeafSize) :
+    maxConcurrentTrees(0)
 {
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
@@ -91,7 +93,8 @@ RandomForest<
                 const size_t numClasses,
                 const arma::rowvec& weights,
                 const size_t numTrees,
-                const size_t minimumLeafSize)
+                const size_t minimumLeafSize) :
+    maxConcurrentTrees(0)
 {
   // Pass off work to the Train() method.
   data::DatasetInfo info; // Ignored by Train().
@@ -119,7 +122,8 @@ RandomForest<
                 const size_t numClasses,
                 const arma::rowvec& weights,
                 const size_t numTrees,
-                const size_t minimumLeafSize)
+                const size_t minimumLeafSize) :
+    maxConcurrentTrees(0)
 {
   // Pass off work to the Train() method.
   Train<true, true>(dataset, datasetInfo, labels, numClasses, weights, numTrees,
@@ -203,7 +207,7 @@ void RandomForest<
 {
   // Pass off to Train().
   data::DatasetInfo info; // Ignored by Train().
-  Train<false, true>(dataset, info, labels, numClasses, weights, numTrees,
+  Train<true, false>(dataset, info, labels, numClasses, weights, numTrees,
       minimumLeafSize);
 }
 
@@ -429,42 +433,55 @@ void RandomForest<
          const size_t numTrees,
          const size_t minimumLeafSize)
 {
+  // Draw one seed per tree from the global generator before building anything.
+  // Each tree then draws all of its random numbers (bootstrap sampling and
+  // dimension selection) from its own generator, so the trained forest depends
+  // only on the random seed and not on the number of threads.
+  std::vector<uint32_t> seeds(numTrees);
+  for (size_t i = 0; i < numTrees; ++i)
+    seeds[i] = (uint32_t) math::RandGen()();
+
   // Train each tree individually.
   trees.resize(numTrees); // This will fill the vector with untrained trees.
 
-  #pragma omp parallel for
-  for (omp_size_t i = 0; i < numTrees; ++i)
+  // Every tree under construction holds its own bootstrap copy of the dataset,
+  // so limiting the number of threads limits peak memory usage.
+  int numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+  if (maxConcurrentTrees > 0 && (size_t) numThreads > maxConcurrentTrees)
+    numThreads = (int) maxConcurrentTrees;
+
+  // Trees can take very different amounts of time to build, so hand them out
+  // one at a time.
+  #pragma omp parallel for schedule(dynamic) num_threads(numThreads)
+  for (omp_size_t i = 0; i < (omp_size_t) numTrees; ++i)
   {
+    std::mt19937 treeRandGen(seeds[i]);
+    math::ScopedRandomGenerator scopedRandGen(treeRandGen);
+
+    // Sampled points are stored once, with their multiplicity as weight, so
+    // the trees are always trained with weights.  The minimum leaf size counts
+    // distinct points, so this approximates the full bootstrap sample.
     MatType bootstrapDataset;
     arma::Row<size_t> bootstrapLabels;
     arma::rowvec bootstrapWeights;
-    Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
+    CompactBootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
         bootstrapLabels, bootstrapWeights);
 
-    // Now build the decision tree.
-    if (UseWeights)
+    // Now build the decision tree.  The bootstrap sample is not needed
+    // afterwards, so the tree can take ownership of it.
+    if (UseDatasetInfo)
     {
-      if (UseDatasetInfo)
-      {
-        trees[i].Train(dataset, datasetInfo, labels, numClasses, weights,
-            minimumLeafSize);
-      }
-      else
-      {
-        trees[i].Train(dataset, labels, numClasses, weights, minimumLeafSize);
-      }
+      trees[i].Train(std::move(bootstrapDataset), datasetInfo,
+          std::move(bootstrapLabels), numClasses, std::move(bootstrapWeights),
+          minimumLeafSize);
     }
     else
     {
-      if (UseDatasetInfo)
-      {
-        trees[i].Train(dataset, datasetInfo, labels, numClasses,
-            minimumLeafSize);
-      }
-      else
-      {
-        trees[i].Train(dataset, labels, numClasses, minimumLeafSize);
-      }
+      trees[i].Train(std::move(bootstrapDataset), std::move(bootstrapLabels),
+          numClasses, std::move(bootstrapWeights), minimumLeafSize);
     }
   }
 }
@@ -30,6 +30,12 @@ class TrainVisitor;
  * algorithm; for more details on the actual algorithm, see the RangeSearchRules
  * class.
  *
+ * If OpenMP is available, every search uses all available threads: naive and
+ * single-tree searches split the query points among the threads, and dual-tree
+ * searches split the query tree into subtrees that are traversed
+ * independently.  Single-tree search with trees that cache distances in their
+ * nodes (such as the cover tree) is serial.
+ *
  * @tparam MetricType Metric to use for range search calculations.
  * @tparam MatType Type of data to use.
  * @tparam TreeType Type of tree to use; must satisfy the TreeType policy API.
@@ -312,6 +318,37 @@ class RangeSearch
   //! The total number of scores during the last search.
   size_t scores;
 
+  /**
+   * Call search(threadRules, i) for each query point i in [0, numQueries),
+   * where threadRules is a copy of the given rules object, and so stores its
+   * results in the same neighbor and distance lists.  If parallel is true, the
+   * query points are split among all available threads.
+   *
+   * @param rules Rules object to copy for each thread.
+   * @param numQueries Number of query points.
+   * @param parallel Whether or not the query points may be handled by
+   *     different threads.
+   * @param search Function that searches the range of one query point.
+   * @return The total number of base cases and scores of all copies.
+   */
+  template<typename RuleType, typename SearchFunction>
+  std::pair<size_t, size_t> SearchEachQuery(const RuleType& rules,
+                       const size_t numQueries,
+                       const bool parallel,
+                       SearchFunction search);
+
+  /**
+   * Run the dual-tree traversal of the given query tree and the reference
+   * tree.  The query tree is split into subtrees that are traversed by all
+   * available threads, each with its own copy of the given rules object.
+   *
+   * @param rules Rules object to copy for each subtree.
+   * @param queryTree Query tree to traverse.
+   * @return The total number of base cases and scores of all copies.
+   */
+  template<typename RuleType>
+  std::pair<size_t, size_t> DualTreeSearch(const RuleType& rules, Tree& queryTree);
+
   //! For access to mappings when building models.
   friend class TrainVisitor;
 };
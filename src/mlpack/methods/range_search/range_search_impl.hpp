@@ -18,9 +18,13 @@
 // The rules for traversal.
 #include "range_search_rules.hpp"
 
+#include <mlpack/core/tree/compact_tree.hpp>
+
 namespace mlpack {
 namespace range {
 
+//! Call the tree constructor that does mapping.  Trees built here are compacted
+//! (see tree::CompactTree()) since their shape never changes.
 template<typename TreeType, typename MatType>
 TreeType* BuildTree(
     MatType&& dataset,
@@ -28,7 +32,9 @@ TreeType* BuildTree(
     const typename std::enable_if<
         tree::TreeTraits<TreeType>::RearrangesDataset>::type* = 0)
 {
-  return new TreeType(std::forward<MatType>(dataset), oldFromNew);
+  TreeType* root = new TreeType(std::forward<MatType>(dataset), oldFromNew);
+  tree::CompactTree(*root);
+  return root;
 }
 
 //! Call the tree constructor that does not do mapping.
@@ -39,9 +45,23 @@ TreeType* BuildTree(
     const typename std::enable_if<
         !tree::TreeTraits<TreeType>::RearrangesDataset>::type* = 0)
 {
-  return new TreeType(std::forward<MatType>(dataset));
+  TreeType* root = new TreeType(std::forward<MatType>(dataset));
+  tree::CompactTree(*root);
+  return root;
 }
 
+/**
+ * Whether single-tree search with RangeSearchRules stores distances in the
+ * statistics of reference nodes; if so, two threads can't search the same
+ * reference tree at once.
+ */
+template<typename TreeType>
+struct CachesReferenceDistances
+{
+  static const bool value = tree::TreeTraits<TreeType>::FirstPointIsCentroid &&
+      tree::TreeTraits<TreeType>::HasSelfChildren;
+};
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
@@ -334,25 +354,34 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
         metric);
 
     // The naive brute-force solution.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
-
-    baseCases += (querySet.n_cols * referenceSet->n_cols);
+    const std::pair<size_t, size_t> counts = SearchEachQuery(rules,
+        querySet.n_cols, true,
+        [&](RuleType& threadRules, const size_t i)
+        {
+          for (size_t j = 0; j < referenceSet->n_cols; ++j)
+            threadRules.BaseCase(i, j);
+        });
+
+    baseCases += counts.first;
+    scores += counts.second;
   }
   else if (singleMode)
   {
-    // Create the traverser.
     RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
         metric);
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
 
-    baseCases += rules.BaseCases();
-    scores += rules.Scores();
+    // Now traverse for each point.
+    const std::pair<size_t, size_t> counts = SearchEachQuery(rules,
+        querySet.n_cols, !CachesReferenceDistances<Tree>::value,
+        [&](RuleType& threadRules, const size_t i)
+        {
+          typename Tree::template SingleTreeTraverser<RuleType>
+              traverser(threadRules);
+          traverser.Traverse(i, *referenceTree);
+        });
+
+    baseCases += counts.first;
+    scores += counts.second;
   }
   else // Dual-tree recursion.
   {
@@ -363,15 +392,13 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     Timer::Stop("range_search/tree_building");
     Timer::Start("range_search/computing_neighbors");
 
-    // Create the traverser.
     RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
         *distancePtr, metric);
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    const std::pair<size_t, size_t> counts = DualTreeSearch(rules,
+        *queryTree);
 
-    traverser.Traverse(*queryTree, *referenceTree);
-
-    baseCases += rules.BaseCases();
-    scores += rules.Scores();
+    baseCases += counts.first;
+    scores += counts.second;
 
     // Clean up tree memory.
     delete queryTree;
@@ -488,16 +515,12 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
       distances, metric);
 
-  // Create the traverser.
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-  traverser.Traverse(*queryTree, *referenceTree);
+  const std::pair<size_t, size_t> counts = DualTreeSearch(rules, *queryTree);
+  baseCases = counts.first;
+  scores = counts.second;
 
   Timer::Stop("range_search/computing_neighbors");
 
-  baseCases = rules.BaseCases();
-  scores = rules.Scores();
-
   // Do we need to map indices?
   if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
   {
@@ -555,37 +578,45 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
       *distancePtr, metric, true /* don't return the query in the results */);
 
+  baseCases = 0;
+  scores = 0;
+
   if (naive)
   {
     // The naive brute-force solution.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
-
-    baseCases = (referenceSet->n_cols * referenceSet->n_cols);
-    scores = 0;
+    const std::pair<size_t, size_t> counts = SearchEachQuery(rules,
+        referenceSet->n_cols, true,
+        [&](RuleType& threadRules, const size_t i)
+        {
+          for (size_t j = 0; j < referenceSet->n_cols; ++j)
+            threadRules.BaseCase(i, j);
+        });
+
+    baseCases += counts.first;
+    scores += counts.second;
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    baseCases = rules.BaseCases();
-    scores = rules.Scores();
+    // Now traverse for each point.
+    const std::pair<size_t, size_t> counts = SearchEachQuery(rules,
+        referenceSet->n_cols, !CachesReferenceDistances<Tree>::value,
+        [&](RuleType& threadRules, const size_t i)
+        {
+          typename Tree::template SingleTreeTraverser<RuleType>
+              traverser(threadRules);
+          traverser.Traverse(i, *referenceTree);
+        });
+
+    baseCases += counts.first;
+    scores += counts.second;
   }
   else // Dual-tree recursion.
   {
-    // Create the traverser.
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-    traverser.Traverse(*referenceTree, *referenceTree);
+    const std::pair<size_t, size_t> counts = DualTreeSearch(rules,
+        *referenceTree);
 
-    baseCases = rules.BaseCases();
-    scores = rules.Scores();
+    baseCases += counts.first;
+    scores += counts.second;
   }
 
   Timer::Stop("range_search/computing_neighbors");
@@ -618,6 +649,121 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
 }
 
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType, typename SearchFunction>
+std::pair<size_t, size_t>
+RangeSearch<MetricType, MatType, TreeType>::SearchEachQuery(
+    const RuleType& rules,
+    const size_t numQueries,
+    const bool parallel,
+    SearchFunction search)
+{
+  size_t totalBaseCases = 0;
+  size_t totalScores = 0;
+
+  #pragma omp parallel if (parallel)
+  {
+    // Each query point has its own result lists, so the copies of the rules
+    // never write to the same list.
+    RuleType threadRules(rules);
+
+    // The time taken for each query point varies a lot, so hand them out a
+    // few at a time.
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) numQueries; ++i)
+      search(threadRules, (size_t) i);
+
+    #pragma omp critical
+    {
+      totalBaseCases += threadRules.BaseCases();
+      totalScores += threadRules.Scores();
+    }
+  }
+
+  return std::make_pair(totalBaseCases, totalScores);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+std::pair<size_t, size_t>
+RangeSearch<MetricType, MatType, TreeType>::DualTreeSearch(
+    const RuleType& rules,
+    Tree& queryTree)
+{
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  // Split the query tree into disjoint subtrees that together hold every query
+  // point, by repeatedly replacing the largest subtree with its children.  A
+  // node that holds points of its own (other than the point of its self-child)
+  // can't be split.
+  std::vector<Tree*> subtrees(1, &queryTree);
+  const size_t maxSubtrees = (numThreads == 1) ? 1 : 16 * numThreads;
+  while (subtrees.size() < maxSubtrees)
+  {
+    size_t largest = subtrees.size();
+    for (size_t i = 0; i < subtrees.size(); ++i)
+    {
+      const Tree& node = *subtrees[i];
+      if (node.NumChildren() == 0 || (node.NumPoints() > 0 &&
+          !tree::TreeTraits<Tree>::HasSelfChildren))
+        continue;
+
+      if (largest == subtrees.size() ||
+          node.NumDescendants() > subtrees[largest]->NumDescendants())
+        largest = i;
+    }
+
+    // Stop if nothing can be split anymore.
+    if (largest == subtrees.size())
+      break;
+
+    Tree* node = subtrees[largest];
+    subtrees[largest] = &node->Child(0);
+    for (size_t i = 1; i < node->NumChildren(); ++i)
+      subtrees.push_back(&node->Child(i));
+  }
+
+  // Traverse the largest subtrees first, so that the small ones can fill the
+  // gaps at the end.
+  std::sort(subtrees.begin(), subtrees.end(),
+      [](const Tree* a, const Tree* b)
+      {
+        return a->NumDescendants() > b->NumDescendants();
+      });
+
+  // Each subtree gets a new copy of the rules, so that the traversal
+  // information of one subtree isn't used for another.
+  size_t totalBaseCases = 0;
+  size_t totalScores = 0;
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+  {
+    RuleType subtreeRules(rules);
+    typename Tree::template DualTreeTraverser<RuleType>
+        traverser(subtreeRules);
+    traverser.Traverse(*subtrees[i], *referenceTree);
+
+    #pragma omp critical
+    {
+      totalBaseCases += subtreeRules.BaseCases();
+      totalScores += subtreeRules.Scores();
+    }
+  }
+
+  return std::make_pair(totalBaseCases, totalScores);
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
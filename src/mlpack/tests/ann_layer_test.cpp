@@ -19,6 +19,8 @@
 #include <mlpack/methods/ann/init_rules/nguyen_widrow_init.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
 #include <mlpack/methods/ann/rnn.hpp>
+#include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
+#include <mlpack/methods/ann/loss_functions/cross_entropy_error.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -999,6 +1001,103 @@ BOOST_AUTO_TEST_CASE(ForwardGRULayerTest)
   BOOST_REQUIRE_LE(arma::as_scalar(arma::trans(output) * expectedOutput), 1e-2);
 }
 
+/**
+ * FastGRU layer numerical gradient test, with BPTT windows of the whole
+ * sequence and of part of it.
+ */
+BOOST_AUTO_TEST_CASE(GradientFastGRULayerTest)
+{
+  // FastGRU function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction(const size_t layerRho)
+    {
+      input = arma::randu(1, 2, 5);
+      target = arma::ones(1, 2, 5);
+      const size_t rho = 5;
+
+      model = new RNN<NegativeLogLikelihood<> >(rho);
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<IdentityLayer<> >();
+      model->Add<Linear<> >(1, 10);
+      model->Add<FastGRU<> >(10, 3, layerRho);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 2);
+      model->Gradient(model->Parameters(), 0, gradient, 2);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    RNN<NegativeLogLikelihood<> >* model;
+    arma::cube input, target;
+  };
+
+  GradientFunction function(5);
+  BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
+
+  GradientFunction truncatedFunction(3);
+  BOOST_REQUIRE_LE(CheckGradient(truncatedFunction), 1e-4);
+}
+
+/**
+ * Make sure that FastGRU gives the same predictions and gradients as GRU with
+ * the same parameters.
+ */
+BOOST_AUTO_TEST_CASE(FastGRUGRUTest)
+{
+  const size_t rho = 5;
+  arma::cube input = arma::randu(4, 6, rho);
+  arma::cube target(1, 6, rho);
+  for (size_t s = 0; s < rho; ++s)
+    for (size_t i = 0; i < 6; ++i)
+      target(0, i, s) = 1 + (i + s) % 3;
+
+  RNN<NegativeLogLikelihood<> > gruModel(rho);
+  gruModel.Add<IdentityLayer<> >();
+  gruModel.Add<Linear<> >(4, 6);
+  gruModel.Add<GRU<> >(6, 3, rho);
+  gruModel.Add<LogSoftMax<> >();
+
+  RNN<NegativeLogLikelihood<> > fastModel(rho);
+  fastModel.Add<IdentityLayer<> >();
+  fastModel.Add<Linear<> >(4, 6);
+  fastModel.Add<FastGRU<> >(6, 3, rho);
+  fastModel.Add<LogSoftMax<> >();
+
+  gruModel.Reset();
+  fastModel.Reset();
+  BOOST_REQUIRE_EQUAL(gruModel.Parameters().n_elem,
+      fastModel.Parameters().n_elem);
+  fastModel.Parameters() = gruModel.Parameters();
+
+  gruModel.Predictors() = input;
+  gruModel.Responses() = target;
+  fastModel.Predictors() = input;
+  fastModel.Responses() = target;
+
+  arma::mat gruGradient, fastGradient;
+  gruModel.Gradient(gruModel.Parameters(), 0, gruGradient, 6);
+  fastModel.Gradient(fastModel.Parameters(), 0, fastGradient, 6);
+  CheckMatrices(gruGradient, fastGradient);
+
+  // Predict in batches of different sizes.
+  arma::cube gruPredictions, fastPredictions;
+  gruModel.Predict(input, gruPredictions, 4);
+  fastModel.Predict(input, fastPredictions, 4);
+  CheckMatrices(gruPredictions, fastPredictions);
+}
+
 /**
  * Simple concat module test.
  */
@@ -1558,6 +1657,132 @@ BOOST_AUTO_TEST_CASE(GradientAtrousConvolutionLayerTest)
   BOOST_REQUIRE_LE(CheckGradient(function), 1e-3);
 }
 
+/**
+ * Check that a convolution layer with the im2col convolution rules gives the
+ * same results as the same layer with the naive convolution rules.
+ *
+ * @param naive Layer with the naive convolution rules.
+ * @param im2col Layer with the im2col convolution rules.
+ * @param inputSize Size of each input point.
+ * @param batchSize Number of input points.
+ * @param checkGradient Whether to check the gradient as well; the naive rules
+ *     only give the gradient of the bias for the last point of a batch.
+ */
+template<typename NaiveLayerType, typename Im2ColLayerType>
+void CheckIm2ColLayer(NaiveLayerType& naive,
+                      Im2ColLayerType& im2col,
+                      const size_t inputSize,
+                      const size_t batchSize,
+                      const bool checkGradient)
+{
+  naive.Parameters().randu();
+  im2col.Parameters() = naive.Parameters();
+  naive.Reset();
+  im2col.Reset();
+
+  arma::mat input = arma::randu<arma::mat>(inputSize, batchSize);
+  arma::mat naiveOutput, im2colOutput;
+  naive.Forward(std::move(input), std::move(naiveOutput));
+  im2col.Forward(std::move(input), std::move(im2colOutput));
+  CheckMatrices(im2colOutput, naiveOutput);
+
+  arma::mat error = arma::randu<arma::mat>(naiveOutput.n_rows, batchSize);
+  arma::mat naiveDelta, im2colDelta;
+  naive.Backward(std::move(input), std::move(error), std::move(naiveDelta));
+  im2col.Backward(std::move(input), std::move(error), std::move(im2colDelta));
+  CheckMatrices(im2colDelta, naiveDelta);
+
+  if (checkGradient)
+  {
+    arma::mat naiveGradient, im2colGradient;
+    naive.Gradient(std::move(input), std::move(error),
+        std::move(naiveGradient));
+    im2col.Gradient(std::move(input), std::move(error),
+        std::move(im2colGradient));
+    CheckMatrices(im2colGradient, naiveGradient);
+  }
+}
+
+/**
+ * Make sure that the convolution layers give the same results with the im2col
+ * convolution rules as with the naive ones.
+ */
+BOOST_AUTO_TEST_CASE(Im2ColConvolutionLayersTest)
+{
+  Convolution<> convolution(2, 3, 3, 3, 1, 1, 1, 1, 7, 6);
+  Convolution<Im2ColConvolution<ValidConvolution>,
+              Im2ColConvolution<FullConvolution>,
+              Im2ColConvolution<ValidConvolution>> im2colConvolution(2, 3, 3,
+      3, 1, 1, 1, 1, 7, 6);
+  CheckIm2ColLayer(convolution, im2colConvolution, 7 * 6 * 2, 1, true);
+  CheckIm2ColLayer(convolution, im2colConvolution, 7 * 6 * 2, 4, false);
+
+  AtrousConvolution<> atrous(2, 3, 3, 3, 1, 1, 0, 0, 7, 7, 2, 2);
+  AtrousConvolution<Im2ColConvolution<ValidConvolution>,
+                    Im2ColConvolution<FullConvolution>,
+                    Im2ColConvolution<ValidConvolution>> im2colAtrous(2, 3, 3,
+      3, 1, 1, 0, 0, 7, 7, 2, 2);
+  CheckIm2ColLayer(atrous, im2colAtrous, 7 * 7 * 2, 1, true);
+  CheckIm2ColLayer(atrous, im2colAtrous, 7 * 7 * 2, 3, false);
+
+  TransposedConvolution<> transposed(2, 3, 3, 3, 1, 1, 0, 0, 4, 4);
+  TransposedConvolution<Im2ColConvolution<ValidConvolution>,
+                        Im2ColConvolution<FullConvolution>,
+                        Im2ColConvolution<ValidConvolution>> im2colTransposed(
+      2, 3, 3, 3, 1, 1, 0, 0, 4, 4);
+  CheckIm2ColLayer(transposed, im2colTransposed, 4 * 4 * 2, 1, true);
+  CheckIm2ColLayer(transposed, im2colTransposed, 4 * 4 * 2, 3, false);
+}
+
+/**
+ * Convolution layer with the im2col convolution rules numerical gradient test,
+ * with a stride and padding.
+ */
+BOOST_AUTO_TEST_CASE(GradientIm2ColConvolutionLayerTest)
+{
+  typedef Convolution<Im2ColConvolution<ValidConvolution>,
+                      Im2ColConvolution<FullConvolution>,
+                      Im2ColConvolution<ValidConvolution>>
+      Im2ColConvolutionType;
+
+  // Add function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::randu(2 * 7 * 7, 2);
+      target = arma::mat("1 3");
+
+      model = new FFN<NegativeLogLikelihood<>, RandomInitialization,
+          Im2ColConvolutionType>();
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<Im2ColConvolutionType>(2, 2, 3, 3, 2, 2, 1, 1, 7, 7);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 2);
+      model->Gradient(model->Parameters(), 0, gradient, 2);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<NegativeLogLikelihood<>, RandomInitialization, Im2ColConvolutionType>*
+        model;
+    arma::mat input, target;
+  } function;
+
+  BOOST_REQUIRE_LE(CheckGradient(function), 1e-3);
+}
+
 /**
  * Tests the LayerNorm layer.
  */
@@ -1957,4 +2182,190 @@ BOOST_AUTO_TEST_CASE(GradientReparametrizationLayerBetaTest)
   BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
 }
 
+/**
+ * Run the forward and backward pass of the given double and single precision
+ * layers, and make sure the results are the same.
+ */
+template<typename LayerType, typename FloatLayerType>
+void CheckFloatLayer(LayerType& layer,
+                     FloatLayerType& floatLayer,
+                     arma::mat input,
+                     arma::mat error)
+{
+  arma::mat output, delta;
+  arma::fmat floatOutput, floatDelta;
+
+  arma::fmat floatInput = arma::conv_to<arma::fmat>::from(input);
+  arma::fmat floatError = arma::conv_to<arma::fmat>::from(error);
+
+  layer.Forward(std::move(input), std::move(output));
+  floatLayer.Forward(std::move(floatInput), std::move(floatOutput));
+  CheckMatrices(output, arma::conv_to<arma::mat>::from(floatOutput), 1e-2);
+
+  layer.Backward(std::move(input), std::move(error), std::move(delta));
+  floatLayer.Backward(std::move(floatInput), std::move(floatError),
+      std::move(floatDelta));
+  CheckMatrices(delta, arma::conv_to<arma::mat>::from(floatDelta), 1e-2);
+}
+
+/**
+ * Compute the gradient of the given double and single precision layers, and
+ * make sure the results are the same.
+ */
+template<typename LayerType, typename FloatLayerType>
+void CheckFloatGradient(LayerType& layer,
+                        FloatLayerType& floatLayer,
+                        arma::mat input,
+                        arma::mat error)
+{
+  arma::fmat floatInput = arma::conv_to<arma::fmat>::from(input);
+  arma::fmat floatError = arma::conv_to<arma::fmat>::from(error);
+
+  layer.Gradient(std::move(input), std::move(error),
+      std::move(layer.Gradient()));
+  floatLayer.Gradient(std::move(floatInput), std::move(floatError),
+      std::move(floatLayer.Gradient()));
+  CheckMatrices(layer.Gradient(),
+      arma::conv_to<arma::mat>::from(floatLayer.Gradient()), 1e-2);
+}
+
+/**
+ * Make sure the layers give the same results for single precision data as for
+ * double precision data.
+ */
+BOOST_AUTO_TEST_CASE(SinglePrecisionLayersTest)
+{
+  const size_t batchSize = 4;
+
+  // Linear and LinearNoBias.
+  {
+    Linear<> layer(10, 5);
+    Linear<arma::fmat, arma::fmat> floatLayer(10, 5);
+    layer.Parameters().randn();
+    floatLayer.Parameters() = arma::conv_to<arma::fmat>::from(
+        layer.Parameters());
+    layer.Reset();
+    floatLayer.Reset();
+
+    const arma::mat input = arma::randn(10, batchSize);
+    const arma::mat error = arma::randn(5, batchSize);
+    CheckFloatLayer(layer, floatLayer, input, error);
+    layer.Gradient().set_size(layer.Parameters().n_rows, 1);
+    floatLayer.Gradient().set_size(floatLayer.Parameters().n_rows, 1);
+    CheckFloatGradient(layer, floatLayer, input, error);
+  }
+
+  {
+    LinearNoBias<> layer(10, 5);
+    LinearNoBias<arma::fmat, arma::fmat> floatLayer(10, 5);
+    layer.Parameters().randn();
+    floatLayer.Parameters() = arma::conv_to<arma::fmat>::from(
+        layer.Parameters());
+    layer.Reset();
+    floatLayer.Reset();
+
+    const arma::mat input = arma::randn(10, batchSize);
+    const arma::mat error = arma::randn(5, batchSize);
+    CheckFloatLayer(layer, floatLayer, input, error);
+    layer.Gradient().set_size(layer.Parameters().n_rows, 1);
+    floatLayer.Gradient().set_size(floatLayer.Parameters().n_rows, 1);
+    CheckFloatGradient(layer, floatLayer, input, error);
+  }
+
+  // LogSoftMax.
+  {
+    LogSoftMax<> layer;
+    LogSoftMax<arma::fmat, arma::fmat> floatLayer;
+    CheckFloatLayer(layer, floatLayer, arma::randn(10, batchSize),
+        arma::randn(10, batchSize));
+  }
+
+  // BatchNorm and LayerNorm.
+  {
+    BatchNorm<> layer(10);
+    BatchNorm<arma::fmat, arma::fmat> floatLayer(10);
+    layer.Reset();
+    floatLayer.Reset();
+
+    const arma::mat input = arma::randn(10, batchSize);
+    const arma::mat error = arma::randn(10, batchSize);
+    CheckFloatLayer(layer, floatLayer, input, error);
+    CheckFloatGradient(layer, floatLayer, input, error);
+    CheckMatrices(layer.TrainingMean(),
+        arma::conv_to<arma::mat>::from(floatLayer.TrainingMean()), 1e-2);
+    CheckMatrices(layer.TrainingVariance(),
+        arma::conv_to<arma::mat>::from(floatLayer.TrainingVariance()), 1e-2);
+  }
+
+  {
+    LayerNorm<> layer(batchSize);
+    LayerNorm<arma::fmat, arma::fmat> floatLayer(batchSize);
+    layer.Reset();
+    floatLayer.Reset();
+
+    const arma::mat input = arma::randn(10, batchSize);
+    const arma::mat error = arma::randn(10, batchSize);
+    CheckFloatLayer(layer, floatLayer, input, error);
+    CheckFloatGradient(layer, floatLayer, input, error);
+  }
+
+  // Convolution, MaxPooling and MeanPooling on 2 maps of size 6 x 6.
+  {
+    Convolution<> layer(2, 3, 3, 3, 1, 1, 0, 0, 6, 6);
+    Convolution<arma::fmat, arma::fmat> floatLayer(2, 3, 3, 3, 1, 1, 0, 0, 6,
+        6);
+    layer.Parameters().randn();
+    floatLayer.Parameters() = arma::conv_to<arma::fmat>::from(
+        layer.Parameters());
+    layer.Reset();
+    floatLayer.Reset();
+
+    const arma::mat input = arma::randn(72, batchSize);
+    const arma::mat error = arma::randn(48, batchSize);
+    CheckFloatLayer(layer, floatLayer, input, error);
+    CheckFloatGradient(layer, floatLayer, input, error);
+  }
+
+  {
+    MaxPooling<> layer(2, 2, 2, 2);
+    MaxPooling<arma::fmat, arma::fmat> floatLayer(2, 2, 2, 2);
+    layer.InputWidth() = floatLayer.InputWidth() = 6;
+    layer.InputHeight() = floatLayer.InputHeight() = 6;
+    CheckFloatLayer(layer, floatLayer, arma::randn(72, batchSize),
+        arma::randn(18, batchSize));
+  }
+
+  {
+    MeanPooling<> layer(2, 2, 2, 2);
+    MeanPooling<arma::fmat, arma::fmat> floatLayer(2, 2, 2, 2);
+    layer.InputWidth() = floatLayer.InputWidth() = 6;
+    layer.InputHeight() = floatLayer.InputHeight() = 6;
+    CheckFloatLayer(layer, floatLayer, arma::randn(72, batchSize),
+        arma::randn(18, batchSize));
+  }
+}
+
+/**
+ * Make sure the losses of single precision data are the same as the losses of
+ * double precision data.
+ */
+BOOST_AUTO_TEST_CASE(SinglePrecisionLossTest)
+{
+  arma::mat input = arma::randu(10, 1000);
+  arma::mat target = arma::randu(10, 1000);
+  arma::fmat floatInput = arma::conv_to<arma::fmat>::from(input);
+  arma::fmat floatTarget = arma::conv_to<arma::fmat>::from(target);
+
+  MeanSquaredError<> mse;
+  MeanSquaredError<arma::fmat, arma::fmat> floatMSE;
+  BOOST_REQUIRE_CLOSE(mse.Forward(std::move(input), std::move(target)),
+      floatMSE.Forward(std::move(floatInput), std::move(floatTarget)), 1e-3);
+
+  CrossEntropyError<> crossEntropy;
+  CrossEntropyError<arma::fmat, arma::fmat> floatCrossEntropy;
+  BOOST_REQUIRE_CLOSE(crossEntropy.Forward(std::move(input),
+      std::move(target)), floatCrossEntropy.Forward(std::move(floatInput),
+      std::move(floatTarget)), 1e-3);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -16,6 +16,7 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -149,6 +150,10 @@ BOOST_AUTO_TEST_CASE(ValidConvolution2DTest)
   // speed up the computation.
   Convolution2DMethodTest<SVDConvolution<ValidConvolution> >(input, filter,
       output);
+
+  // Perform the convolution through im2col and a matrix product.
+  Convolution2DMethodTest<Im2ColConvolution<ValidConvolution> >(input,
+      filter, output);
 }
 
 /**
@@ -186,6 +191,10 @@ BOOST_AUTO_TEST_CASE(FullConvolution2DTest)
   // speed up the computation.
   Convolution2DMethodTest<SVDConvolution<FullConvolution> >(input, filter,
       output);
+
+  // Perform the convolution through im2col and a matrix product.
+  Convolution2DMethodTest<Im2ColConvolution<FullConvolution> >(input,
+      filter, output);
 }
 
 /**
@@ -231,6 +240,10 @@ BOOST_AUTO_TEST_CASE(ValidConvolution3DTest)
   // speed up the computation.
   Convolution3DMethodTest<SVDConvolution<ValidConvolution> >(inputCube,
       filterCube, outputCube);
+
+  // Perform the convolution through im2col and a matrix product.
+  Convolution3DMethodTest<Im2ColConvolution<ValidConvolution> >(inputCube,
+      filterCube, outputCube);
 }
 
 /**
@@ -280,6 +293,10 @@ BOOST_AUTO_TEST_CASE(FullConvolution3DTest)
   // speed up the computation.
   Convolution3DMethodTest<SVDConvolution<FullConvolution> >(inputCube,
       filterCube, outputCube);
+
+  // Perform the convolution through im2col and a matrix product.
+  Convolution3DMethodTest<Im2ColConvolution<FullConvolution> >(inputCube,
+      filterCube, outputCube);
 }
 
 /**
@@ -322,6 +339,10 @@ BOOST_AUTO_TEST_CASE(ValidConvolutionBatchTest)
   // speed up the computation.
   ConvolutionMethodBatchTest<SVDConvolution<ValidConvolution> >(input,
       filterCube, outputCube);
+
+  // Perform the convolution through im2col and a matrix product.
+  ConvolutionMethodBatchTest<Im2ColConvolution<ValidConvolution> >(input,
+      filterCube, outputCube);
 }
 
 /**
@@ -368,6 +389,99 @@ BOOST_AUTO_TEST_CASE(FullConvolutionBatchTest)
   // speed up the computation.
   ConvolutionMethodBatchTest<SVDConvolution<FullConvolution> >(input,
       filterCube, outputCube);
+
+  // Perform the convolution through im2col and a matrix product.
+  ConvolutionMethodBatchTest<Im2ColConvolution<FullConvolution> >(input,
+      filterCube, outputCube);
+}
+
+/**
+ * Make sure that the im2col convolution gives the same results as the naive
+ * convolution with strides and dilations.
+ */
+BOOST_AUTO_TEST_CASE(Im2ColStrideDilationTest)
+{
+  const arma::mat input = arma::randu<arma::mat>(11, 11);
+  const arma::mat filter = arma::randu<arma::mat>(3, 3);
+
+  const size_t strides[] = { 1, 2, 1, 2, 3 };
+  const size_t dilations[] = { 1, 1, 2, 2, 2 };
+  for (size_t i = 0; i < 5; ++i)
+  {
+    arma::mat naiveOutput, im2colOutput;
+    NaiveConvolution<ValidConvolution>::Convolution(input, filter, naiveOutput,
+        strides[i], strides[i], dilations[i], dilations[i]);
+    Im2ColConvolution<ValidConvolution>::Convolution(input, filter,
+        im2colOutput, strides[i], strides[i], dilations[i], dilations[i]);
+
+    CheckMatrices(im2colOutput, naiveOutput);
+  }
+
+  arma::mat naiveOutput, im2colOutput;
+  NaiveConvolution<FullConvolution>::Convolution(input, filter, naiveOutput, 1,
+      1, 2, 2);
+  Im2ColConvolution<FullConvolution>::Convolution(input, filter, im2colOutput,
+      1, 1, 2, 2);
+
+  CheckMatrices(im2colOutput, naiveOutput);
+}
+
+/**
+ * Check the batch convolution of several maps against a direct computation,
+ * and check that the transposed convolution and the filter gradient are its
+ * adjoints, with different strides and dilations in each direction.
+ */
+BOOST_AUTO_TEST_CASE(Im2ColBatchConvolutionTest)
+{
+  const size_t inMaps = 3, outMaps = 4, batchSize = 2, kW = 3, kH = 2;
+  const size_t dW = 2, dH = 1, dilationW = 1, dilationH = 2;
+
+  const arma::cube input(9, 8, inMaps * batchSize, arma::fill::randu);
+  const arma::mat filters(kW * kH * inMaps, outMaps, arma::fill::randu);
+
+  const size_t outRows = (9 - (kW - 1) * dilationW - 1) / dW + 1;
+  const size_t outCols = (8 - (kH - 1) * dilationH - 1) / dH + 1;
+  arma::cube output(outRows, outCols, outMaps * batchSize);
+  Im2ColConvolution<>::BatchConvolution(input, filters, kW, kH, output, dW, dH,
+      dilationW, dilationH);
+
+  for (size_t b = 0; b < batchSize; ++b)
+  {
+    for (size_t o = 0; o < outMaps; ++o)
+    {
+      for (size_t j = 0; j < outCols; ++j)
+      {
+        for (size_t i = 0; i < outRows; ++i)
+        {
+          double sum = 0.0;
+          for (size_t c = 0; c < inMaps; ++c)
+            for (size_t kj = 0; kj < kH; ++kj)
+              for (size_t ki = 0; ki < kW; ++ki)
+                sum += input(i * dW + ki * dilationW, j * dH + kj * dilationH,
+                    b * inMaps + c) * filters(ki + kj * kW + c * kW * kH, o);
+
+          BOOST_REQUIRE_CLOSE(output(i, j, b * outMaps + o), sum, 1e-5);
+        }
+      }
+    }
+  }
+
+  // <conv(x), e> = <x, conv^T(e)>.
+  const arma::cube error(outRows, outCols, outMaps * batchSize,
+      arma::fill::randu);
+  arma::cube inputError(9, 8, inMaps * batchSize, arma::fill::zeros);
+  Im2ColConvolution<>::BatchTransposedConvolution(error, filters, kW, kH,
+      inputError, dW, dH, dilationW, dilationH);
+
+  const double product = arma::accu(output % error);
+  BOOST_REQUIRE_CLOSE(arma::accu(input % inputError), product, 1e-5);
+
+  // <conv(x; w), e> = <w, dconv/dw(x, e)>.
+  arma::mat filterGradient(filters.n_rows, filters.n_cols);
+  Im2ColConvolution<>::BatchFilterGradient(input, error, kW, kH,
+      filterGradient, dW, dH, dilationW, dilationH);
+
+  BOOST_REQUIRE_CLOSE(arma::accu(filters % filterGradient), product, 1e-5);
 }
 
 BOOST_AUTO_TEST_SUITE_END();
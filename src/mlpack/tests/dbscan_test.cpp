@@ -271,4 +271,40 @@ BOOST_AUTO_TEST_CASE(GaussiansSingleModeTest)
   }
 }
 
+/**
+ * Make sure that batch mode, which searches the points in blocks, gives the
+ * same clustering as single mode, even when epsilon is large enough that every
+ * block holds only a few points.
+ */
+BOOST_AUTO_TEST_CASE(BatchModeBlocksTest)
+{
+  arma::mat points(3, 500, arma::fill::randu);
+  points.cols(250, 499) += 3.0;
+
+  // With a small epsilon many blocks of several points are searched; with a
+  // large epsilon every block holds a single point.
+  const double epsilons[] = { 0.1, 0.5, 2.0 };
+  for (const double epsilon : epsilons)
+  {
+    DBSCAN<> batch(epsilon, 3, true);
+    DBSCAN<> single(epsilon, 3, false);
+
+    arma::Row<size_t> batchAssignments, singleAssignments;
+    const size_t batchClusters = batch.Cluster(points, batchAssignments);
+    const size_t singleClusters = single.Cluster(points, singleAssignments);
+
+    BOOST_REQUIRE_EQUAL(batchClusters, singleClusters);
+    BOOST_REQUIRE_EQUAL(batchAssignments.n_elem, singleAssignments.n_elem);
+
+    // The cluster labels may be permuted, but the clusters must be the same.
+    std::map<size_t, size_t> labels;
+    for (size_t i = 0; i < batchAssignments.n_elem; ++i)
+    {
+      if (labels.count(batchAssignments[i]) == 0)
+        labels[batchAssignments[i]] = singleAssignments[i];
+      BOOST_REQUIRE_EQUAL(labels[batchAssignments[i]], singleAssignments[i]);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -309,6 +309,128 @@ BOOST_AUTO_TEST_CASE(BestBinaryNumericSplitSimpleSplitTest)
   BOOST_REQUIRE_LT(classProbabilities[0], 0.5);
 }
 
+/**
+ * Make sure that EvaluatePtr() gives the same results as Evaluate().
+ */
+BOOST_AUTO_TEST_CASE(FitnessFunctionEvaluatePtrTest)
+{
+  arma::Row<size_t> labels("0 0 1 2 2 2 1 0 1 2 2");
+  arma::rowvec weights(labels.n_elem, arma::fill::randu);
+
+  arma::vec counts(3, arma::fill::zeros);
+  arma::vec weightedCounts(3, arma::fill::zeros);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+  {
+    counts[labels[i]]++;
+    weightedCounts[labels[i]] += weights[i];
+  }
+
+  BOOST_REQUIRE_CLOSE(GiniGain::Evaluate<false>(labels, 3, weights),
+      GiniGain::EvaluatePtr(counts.memptr(), 3, arma::accu(counts)), 1e-5);
+  BOOST_REQUIRE_CLOSE(GiniGain::Evaluate<true>(labels, 3, weights),
+      GiniGain::EvaluatePtr(weightedCounts.memptr(), 3,
+      arma::accu(weightedCounts)), 1e-5);
+  BOOST_REQUIRE_CLOSE(InformationGain::Evaluate<false>(labels, 3, weights),
+      InformationGain::EvaluatePtr(counts.memptr(), 3, arma::accu(counts)),
+      1e-5);
+  BOOST_REQUIRE_CLOSE(InformationGain::Evaluate<true>(labels, 3, weights),
+      InformationGain::EvaluatePtr(weightedCounts.memptr(), 3,
+      arma::accu(weightedCounts)), 1e-5);
+}
+
+/**
+ * Check that the BinnedNumericSplit finds a perfect split when one exists.
+ */
+BOOST_AUTO_TEST_CASE(BinnedNumericSplitSimpleSplitTest)
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem);
+  weights.ones();
+
+  arma::vec classProbabilities;
+  BinnedNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = BinnedNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+  const double weightedGain =
+      BinnedNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+      labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+
+  // Make sure that a split was made, and that it is perfect.
+  BOOST_REQUIRE_GT(gain, bestGain);
+  BOOST_REQUIRE_EQUAL(gain, weightedGain);
+  BOOST_REQUIRE_SMALL(gain, 1e-5);
+
+  // The split point should be between 0.4 and 0.5.
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 1);
+  BOOST_REQUIRE_GT(classProbabilities[0], 0.4);
+  BOOST_REQUIRE_LT(classProbabilities[0], 0.5);
+  BOOST_REQUIRE_EQUAL(BinnedNumericSplit<GiniGain>::CalculateDirection(0.4,
+      classProbabilities, aux), 0);
+  BOOST_REQUIRE_EQUAL(BinnedNumericSplit<GiniGain>::CalculateDirection(0.5,
+      classProbabilities, aux), 1);
+}
+
+/**
+ * Check that the BinnedNumericSplit won't split if not enough points are given,
+ * or if all points have the same value.
+ */
+BOOST_AUTO_TEST_CASE(BinnedNumericSplitNoSplitTest)
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem);
+
+  arma::vec classProbabilities;
+  BinnedNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  // Minimum leaf size of 8 means no split is possible.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  double gain = BinnedNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain,
+      values, labels, 2, weights, 8, 1e-7, classProbabilities, aux);
+  BOOST_REQUIRE_EQUAL(gain, bestGain);
+
+  arma::vec constValues(labels.n_elem);
+  constValues.fill(0.3);
+  gain = BinnedNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain,
+      constValues, labels, 2, weights, 1, 1e-7, classProbabilities, aux);
+  BOOST_REQUIRE_EQUAL(gain, bestGain);
+}
+
+/**
+ * Make sure that a decision tree built with the BinnedNumericSplit gives
+ * reasonable results on a real dataset.
+ */
+BOOST_AUTO_TEST_CASE(BinnedNumericSplitDecisionTreeTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+  arma::Row<size_t> testLabels;
+  data::Load("vc2_test_labels.txt", testLabels);
+
+  DecisionTree<GiniGain, BinnedNumericSplit> d(dataset, labels, 3, 5);
+  DecisionTree<InformationGain, BinnedNumericSplit> d2(dataset, labels, 3, 5);
+
+  arma::Row<size_t> predictions, predictions2;
+  d.Classify(testDataset, predictions);
+  d2.Classify(testDataset, predictions2);
+
+  // This is the accuracy required of the exact splits in
+  // SimpleGeneralizationTest.
+  BOOST_REQUIRE_GT(arma::accu(predictions == testLabels),
+      0.75 * testDataset.n_cols);
+  BOOST_REQUIRE_GT(arma::accu(predictions2 == testLabels),
+      0.75 * testDataset.n_cols);
+}
+
 /**
  * Check that the BestBinaryNumericSplit won't split if not enough points are
  * given.
@@ -503,6 +503,145 @@ BOOST_AUTO_TEST_CASE(FFNMiscTest)
   movedModel = std::move(copiedModel);
 }
 
+/**
+ * Make sure that the layers of a copied network use the parameters of the
+ * copy.
+ */
+BOOST_AUTO_TEST_CASE(FFNCopyParametersTest)
+{
+  arma::mat input = arma::randu<arma::mat>(4, 10);
+
+  FFN<MeanSquaredError<>> model;
+  model.Add<Linear<>>(4, 3);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(3, 2);
+  model.ResetParameters();
+
+  FFN<MeanSquaredError<>> copiedModel(model);
+
+  // The copy predicts the same as the network it was copied from.
+  arma::mat prediction, copiedPrediction;
+  model.Predict(input, prediction);
+  copiedModel.Predict(input, copiedPrediction);
+  CheckMatrices(copiedPrediction, prediction);
+
+  // Changing the parameters of the copy changes its predictions, but not the
+  // ones of the original network.
+  copiedModel.Parameters().zeros();
+  copiedModel.Predict(input, copiedPrediction);
+  BOOST_REQUIRE_SMALL(arma::abs(copiedPrediction).max(), 1e-10);
+
+  arma::mat newPrediction;
+  model.Predict(input, newPrediction);
+  CheckMatrices(newPrediction, prediction);
+}
+
+/**
+ * Make sure that a copy of a trained network with a BatchNorm layer keeps the
+ * running statistics, so that it predicts the same as the original network.
+ */
+BOOST_AUTO_TEST_CASE(FFNCopyBatchNormTest)
+{
+  arma::mat input = arma::randu<arma::mat>(4, 100);
+  arma::mat response = arma::randu<arma::mat>(2, 100);
+
+  FFN<MeanSquaredError<>> model;
+  model.Add<Linear<>>(4, 3);
+  model.Add<BatchNorm<>>(3);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(3, 2);
+
+  RMSProp opt(0.01, 10, 0.88, 1e-8, 5 * input.n_cols, -1);
+  model.Train(input, response, opt);
+
+  FFN<MeanSquaredError<>> copiedModel(model);
+
+  arma::mat prediction, copiedPrediction;
+  model.Predict(input, prediction);
+  copiedModel.Predict(input, copiedPrediction);
+  CheckMatrices(copiedPrediction, prediction);
+}
+
+/**
+ * Make sure that resetting the parameters of a trained network also clears the
+ * running statistics of its BatchNorm layers.
+ */
+BOOST_AUTO_TEST_CASE(FFNResetParametersBatchNormTest)
+{
+  arma::mat input = arma::randu<arma::mat>(4, 100);
+  arma::mat response = arma::randu<arma::mat>(2, 100);
+
+  BatchNorm<>* batchNorm = new BatchNorm<>(3);
+
+  FFN<MeanSquaredError<>> model;
+  model.Add<Linear<>>(4, 3);
+  model.Add(batchNorm);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(3, 2);
+
+  RMSProp opt(0.01, 10, 0.88, 1e-8, 5 * input.n_cols, -1);
+  model.Train(input, response, opt);
+
+  BOOST_REQUIRE_GT(batchNorm->Stats().count(), 0.0);
+  BOOST_REQUIRE_EQUAL(batchNorm->TrainingMean().n_elem, 3);
+
+  model.ResetParameters();
+
+  BOOST_REQUIRE_EQUAL(batchNorm->Stats().count(), 0.0);
+  BOOST_REQUIRE_EQUAL(batchNorm->TrainingMean().n_elem, 0);
+}
+
+/**
+ * Make sure that shuffling only changes the order in which the points are
+ * visited: the data stays in place, and the mini-batches of an epoch still
+ * cover all the points.
+ */
+BOOST_AUTO_TEST_CASE(FFNShuffleTest)
+{
+  arma::mat data = arma::randu<arma::mat>(5, 40);
+  arma::mat responses = arma::randu<arma::mat>(2, 40);
+
+  FFN<MeanSquaredError<>> model;
+  model.Add<Linear<>>(5, 4);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(4, 2);
+  model.Predictors() = data;
+  model.Responses() = responses;
+  model.ResetParameters();
+
+  // Sum the objective and gradient of the mini-batches of one epoch.
+  double objective = 0.0;
+  arma::mat gradient, batchGradient;
+  for (size_t i = 0; i < data.n_cols; i += 10)
+  {
+    objective += model.EvaluateWithGradient(model.Parameters(), i,
+        batchGradient, 10);
+    if (i == 0)
+      gradient = batchGradient;
+    else
+      gradient += batchGradient;
+  }
+
+  model.Shuffle();
+  CheckMatrices(model.Predictors(), data);
+  CheckMatrices(model.Responses(), responses);
+
+  double shuffledObjective = 0.0;
+  arma::mat shuffledGradient;
+  for (size_t i = 0; i < data.n_cols; i += 10)
+  {
+    shuffledObjective += model.EvaluateWithGradient(model.Parameters(), i,
+        batchGradient, 10);
+    if (i == 0)
+      shuffledGradient = batchGradient;
+    else
+      shuffledGradient += batchGradient;
+  }
+
+  BOOST_REQUIRE_CLOSE(shuffledObjective, objective, 1e-5);
+  CheckMatrices(shuffledGradient, gradient, 1e-5);
+}
+
 /**
  * Test that serialization works ok.
  */
@@ -667,4 +806,31 @@ BOOST_AUTO_TEST_CASE(PartialForwardTest)
   CheckMatrices(output, arma::ones(10, 1) * 20);
 }
 
+/**
+ * Test that batched prediction gives the same results as predicting one point
+ * at a time, including when the number of points is not a multiple of the
+ * batch size.
+ */
+BOOST_AUTO_TEST_CASE(BatchedPredictTest)
+{
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  arma::mat data = arma::randu<arma::mat>(10, 103);
+
+  arma::mat singlePredictions, batchPredictions, fullPredictions;
+  model.Predict(data, singlePredictions, 1);
+  model.Predict(data, batchPredictions, 16);
+  model.Predict(data, fullPredictions, data.n_cols);
+
+  BOOST_REQUIRE_EQUAL(singlePredictions.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(singlePredictions.n_cols, data.n_cols);
+
+  CheckMatrices(singlePredictions, batchPredictions);
+  CheckMatrices(singlePredictions, fullPredictions);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
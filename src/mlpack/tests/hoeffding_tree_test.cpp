@@ -1462,4 +1462,121 @@ BOOST_AUTO_TEST_CASE(HoeffdingTreeModelSerializationTest)
   }
 }
 
+/**
+ * Make sure that streaming the training set from disk in chunks gives the same
+ * tree as training on it in memory, and that checkpoints can be loaded.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingTreeModelChunkedTrainingTest)
+{
+  // Generate data.
+  arma::mat dataset(3, 3000);
+  arma::Row<size_t> labels(3000);
+  for (size_t i = 0; i < 3000; i += 3)
+  {
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::Random();
+    dataset(2, i) = mlpack::math::Random();
+    labels[i] = 0;
+
+    dataset(0, i + 1) = mlpack::math::Random();
+    dataset(1, i + 1) = mlpack::math::Random() - 1.0;
+    dataset(2, i + 1) = mlpack::math::Random() + 0.5;
+    labels[i + 1] = 2;
+
+    dataset(0, i + 2) = mlpack::math::Random();
+    dataset(1, i + 2) = mlpack::math::Random() + 1.0;
+    dataset(2, i + 2) = mlpack::math::Random() + 0.8;
+    labels[i + 2] = 1;
+  }
+
+  // Save the dataset with the labels as the last dimension.
+  arma::mat fullDataset = arma::join_cols(dataset,
+      arma::conv_to<arma::rowvec>::from(labels));
+  BOOST_REQUIRE(data::Save("stream.mmat", fullDataset));
+
+  data::DatasetInfo info(3);
+  for (size_t i = 0; i < 4; ++i)
+  {
+    const HoeffdingTreeModel::TreeType type = (HoeffdingTreeModel::TreeType) i;
+
+    HoeffdingTreeModel m(type);
+    m.BuildModel(dataset, info, labels, 3, false, 0.99, 1000, 100, 100, 4, 100);
+
+    // Build the same model without any points, then stream them in chunks that
+    // don't evenly divide the dataset.
+    HoeffdingTreeModel streamed(type);
+    streamed.BuildModel(arma::mat(3, 0), info, arma::Row<size_t>(), 3, false,
+        0.99, 1000, 100, 100, 4, 100);
+    data::ChunkReader reader("stream.mmat", 700);
+    BOOST_REQUIRE_EQUAL(reader.Dimensionality(), 4);
+    const size_t numPoints = streamed.Train(reader, "checkpoint.bin", 1000);
+    BOOST_REQUIRE_EQUAL(numPoints, 3000);
+
+    // The checkpoint holds the final model.
+    HoeffdingTreeModel checkpoint;
+    BOOST_REQUIRE(data::Load("checkpoint.bin", "model", checkpoint));
+
+    BOOST_REQUIRE_EQUAL(m.NumNodes(), streamed.NumNodes());
+    BOOST_REQUIRE_EQUAL(m.NumNodes(), checkpoint.NumNodes());
+
+    arma::Row<size_t> predictions, streamedPredictions, checkpointPredictions;
+    m.Classify(dataset, predictions);
+    streamed.Classify(dataset, streamedPredictions);
+    checkpoint.Classify(dataset, checkpointPredictions);
+    for (size_t j = 0; j < 3000; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(predictions[j], streamedPredictions[j]);
+      BOOST_REQUIRE_EQUAL(predictions[j], checkpointPredictions[j]);
+    }
+  }
+
+  remove("stream.mmat");
+  remove("checkpoint.bin");
+}
+
+/**
+ * Make sure that streamed labels that are not less than the number of classes
+ * are rejected instead of being trained on.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingTreeModelChunkedTrainingLabelTest)
+{
+  arma::mat fullDataset = arma::randu<arma::mat>(4, 100);
+  fullDataset.row(3).fill(1);
+  fullDataset(3, 57) = 3;
+  BOOST_REQUIRE(data::Save("stream.mmat", fullDataset));
+
+  data::DatasetInfo info(3);
+  HoeffdingTreeModel m(HoeffdingTreeModel::GINI_HOEFFDING);
+  m.BuildModel(arma::mat(3, 0), info, arma::Row<size_t>(), 3, false, 0.99,
+      1000, 100, 100, 4, 100);
+  BOOST_REQUIRE_EQUAL(m.NumClasses(), 3);
+
+  data::ChunkReader reader("stream.mmat", 30);
+  BOOST_REQUIRE_THROW(m.Train(reader), std::invalid_argument);
+
+  remove("stream.mmat");
+}
+
+/**
+ * Make sure that streamed points whose dimensionality differs from that of the
+ * tree are rejected instead of being trained on.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingTreeModelChunkedTrainingDimensionalityTest)
+{
+  arma::mat fullDataset = arma::randu<arma::mat>(5, 100);
+  fullDataset.row(4).fill(1);
+  BOOST_REQUIRE(data::Save("stream.mmat", fullDataset));
+
+  data::DatasetInfo info(3);
+  HoeffdingTreeModel m(HoeffdingTreeModel::GINI_HOEFFDING);
+  m.BuildModel(arma::mat(3, 0), info, arma::Row<size_t>(), 3, false, 0.99,
+      1000, 100, 100, 4, 100);
+  BOOST_REQUIRE_EQUAL(m.Dimensionality(), 3);
+
+  data::ChunkReader reader("stream.mmat", 30);
+  BOOST_REQUIRE_THROW(m.Train(reader), std::invalid_argument);
+
+  remove("stream.mmat");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -112,6 +112,55 @@ BOOST_AUTO_TEST_CASE(LMetricZerosTest)
   BOOST_REQUIRE((LMetric<5, true>::Evaluate(a, a)) == 0);
 }
 
+/**
+ * Make sure that the LMetric kernels for dense vectors give the same results as
+ * the Armadillo expressions, for every length around the unrolling width, for
+ * columns of matrices, and for float and mixed float/double vectors.
+ */
+BOOST_AUTO_TEST_CASE(LMetricDenseKernelTest)
+{
+  for (size_t n = 1; n < 12; ++n)
+  {
+    arma::mat data(n, 2, arma::fill::randu);
+    arma::fmat fdata = arma::conv_to<arma::fmat>::from(data);
+
+    const arma::vec a = data.col(0);
+    const arma::vec b = data.col(1);
+
+    const double l1 = arma::accu(arma::abs(a - b));
+    const double l2 = arma::accu(arma::square(a - b));
+    const double lInf = arma::max(arma::abs(a - b));
+
+    BOOST_REQUIRE_CLOSE(ManhattanDistance::Evaluate(a, b), l1, 1e-5);
+    BOOST_REQUIRE_CLOSE(SquaredEuclideanDistance::Evaluate(a, b), l2, 1e-5);
+    BOOST_REQUIRE_CLOSE(EuclideanDistance::Evaluate(a, b), std::sqrt(l2),
+        1e-5);
+    BOOST_REQUIRE_CLOSE(ChebyshevDistance::Evaluate(a, b), lInf, 1e-5);
+
+    // Columns of a matrix.
+    BOOST_REQUIRE_CLOSE(ManhattanDistance::Evaluate(data.col(0),
+        data.col(1)), l1, 1e-5);
+    BOOST_REQUIRE_CLOSE(SquaredEuclideanDistance::Evaluate(data.col(0),
+        data.unsafe_col(1)), l2, 1e-5);
+    BOOST_REQUIRE_CLOSE(ChebyshevDistance::Evaluate(data.unsafe_col(0),
+        data.col(1)), lInf, 1e-5);
+
+    // Float and mixed vectors.
+    BOOST_REQUIRE_CLOSE(ManhattanDistance::Evaluate(fdata.col(0),
+        fdata.col(1)), (float) l1, 1e-3);
+    BOOST_REQUIRE_CLOSE(SquaredEuclideanDistance::Evaluate(fdata.col(0),
+        fdata.col(1)), (float) l2, 1e-3);
+    BOOST_REQUIRE_CLOSE(EuclideanDistance::Evaluate(fdata.col(0),
+        data.col(1)), (float) std::sqrt(l2), 1e-3);
+    BOOST_REQUIRE_CLOSE(ChebyshevDistance::Evaluate(data.col(0),
+        fdata.col(1)), lInf, 1e-3);
+  }
+
+  // Vectors of different sizes can't be compared.
+  arma::vec a(3, arma::fill::randu), b(4, arma::fill::randu);
+  BOOST_REQUIRE_THROW(EuclideanDistance::Evaluate(a, b), std::logic_error);
+}
+
 /**
  * Simple test of Mahalanobis distance with unset covariance matrix in
  * constructor.
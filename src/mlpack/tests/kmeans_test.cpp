@@ -24,6 +24,7 @@
 
 #include <boost/test/unit_test.hpp>
 #include <mlpack/methods/kmeans/kill_empty_clusters.hpp>
+#include <mlpack/methods/kmeans/mini_batch_kmeans.hpp>
 #include "test_tools.hpp"
 
 using namespace mlpack;
@@ -737,4 +738,241 @@ BOOST_AUTO_TEST_CASE(SampleInitializationTest)
   }
 }
 
+/**
+ * Make sure that k-means on float data finds the same clusters as k-means on
+ * the same data stored as doubles.
+ */
+BOOST_AUTO_TEST_CASE(FloatMatrixKMeansTest)
+{
+  arma::mat dataset = trans(kMeansData);
+  arma::fmat floatData = arma::conv_to<arma::fmat>::from(dataset);
+
+  // Start with one point of each class as the centroids.
+  arma::mat initialCentroids(2, 3);
+  initialCentroids.col(0) = dataset.col(0);
+  initialCentroids.col(1) = dataset.col(13);
+  initialCentroids.col(2) = dataset.col(20);
+
+  KMeans<> kmeans;
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      NaiveKMeans, arma::fmat> floatKMeans;
+
+  arma::Row<size_t> assignments, floatAssignments;
+  arma::mat centroids = initialCentroids;
+  arma::mat floatCentroids = initialCentroids;
+  kmeans.Cluster(dataset, 3, assignments, centroids, false, true);
+  floatKMeans.Cluster(floatData, 3, floatAssignments, floatCentroids, false,
+      true);
+
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], floatAssignments[i]);
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(centroids[i], floatCentroids[i], 1e-3);
+}
+
+/**
+ * The Euclidean distance, wrapped so that NaiveKMeans evaluates it for each
+ * point and centroid instead of using blocked matrix products.
+ */
+class PointwiseEuclideanDistance
+{
+ public:
+  template<typename VecTypeA, typename VecTypeB>
+  static double Evaluate(const VecTypeA& a, const VecTypeB& b)
+  {
+    return metric::EuclideanDistance::Evaluate(a, b);
+  }
+};
+
+/**
+ * Make sure that the blocked Lloyd iteration of NaiveKMeans gives the same
+ * centroids and counts as evaluating the metric for each point and centroid,
+ * with a few numbers of clusters so that the size of the blocks changes.  The
+ * metric is always evaluated on doubles, since distances between float points
+ * are rounded to floats.
+ */
+template<typename MatType>
+void CheckBlockedNaiveKMeans()
+{
+  MatType dataset = arma::conv_to<MatType>::from(
+      arma::randu<arma::mat>(20, 3000));
+  arma::mat data = arma::conv_to<arma::mat>::from(dataset);
+
+  const size_t clusters[] = { 1, 7, 150, 1000 };
+  for (size_t c = 0; c < 4; ++c)
+  {
+    const size_t k = clusters[c];
+    arma::mat centroids = arma::randu<arma::mat>(20, k);
+
+    metric::EuclideanDistance metric;
+    NaiveKMeans<metric::EuclideanDistance, MatType> blocked(dataset, metric);
+    PointwiseEuclideanDistance pointwiseMetric;
+    NaiveKMeans<PointwiseEuclideanDistance, arma::mat> pointwise(data,
+        pointwiseMetric);
+
+    arma::mat blockedCentroids, pointwiseCentroids;
+    arma::Col<size_t> blockedCounts, pointwiseCounts;
+    const double blockedNorm = blocked.Iterate(centroids, blockedCentroids,
+        blockedCounts);
+    const double pointwiseNorm = pointwise.Iterate(centroids,
+        pointwiseCentroids, pointwiseCounts);
+
+    BOOST_REQUIRE_EQUAL(arma::accu(blockedCounts), dataset.n_cols);
+    CheckMatrices(arma::conv_to<arma::Mat<size_t>>::from(blockedCounts),
+        arma::conv_to<arma::Mat<size_t>>::from(pointwiseCounts));
+    CheckMatrices(blockedCentroids, pointwiseCentroids);
+    BOOST_REQUIRE_CLOSE(blockedNorm, pointwiseNorm, 1e-5);
+    BOOST_REQUIRE_EQUAL(blocked.DistanceCalculations(),
+        pointwise.DistanceCalculations());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(BlockedNaiveKMeansTest)
+{
+  CheckBlockedNaiveKMeans<arma::mat>();
+  CheckBlockedNaiveKMeans<arma::fmat>();
+}
+
+/**
+ * Generate points from three well-separated Gaussians, and return the true
+ * means as columns of the given matrix.
+ */
+template<typename MatType>
+MatType MiniBatchKMeansData(const size_t points, arma::mat& means)
+{
+  means = arma::mat("0.0 10.0 -10.0; 0.0 10.0 5.0");
+
+  arma::mat data(2, points);
+  for (size_t i = 0; i < points; ++i)
+    data.col(i) = means.col(i % 3) + 0.5 * arma::randn<arma::vec>(2);
+
+  return arma::conv_to<MatType>::from(data);
+}
+
+/**
+ * Make sure that mini-batch k-means finds the means of three well-separated
+ * Gaussians and assigns each point to the right one.
+ */
+template<typename MatType>
+void CheckMiniBatchKMeans()
+{
+  arma::mat means;
+  MatType data = MiniBatchKMeansData<MatType>(3000, means);
+
+  // Start from one point of each Gaussian, in a different order.
+  arma::mat centroids(2, 3);
+  centroids.col(0) = arma::conv_to<arma::vec>::from(data.col(1));
+  centroids.col(1) = arma::conv_to<arma::vec>::from(data.col(2));
+  centroids.col(2) = arma::conv_to<arma::vec>::from(data.col(0));
+
+  MiniBatchKMeans<EuclideanDistance, SampleInitialization, MatType> kmeans(100,
+      50);
+  arma::Row<size_t> assignments;
+  kmeans.Cluster(data, 3, assignments, centroids, true);
+
+  BOOST_REQUIRE_EQUAL(kmeans.Counts().n_elem, 3);
+  BOOST_REQUIRE_EQUAL(arma::accu(kmeans.Counts()), 5000);
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    const size_t c = (i + 2) % 3;
+    BOOST_REQUIRE_LT(arma::norm(centroids.col(c) - means.col(i)), 0.2);
+  }
+
+  BOOST_REQUIRE_EQUAL(assignments.n_elem, data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], ((i % 3) + 2) % 3);
+}
+
+BOOST_AUTO_TEST_CASE(MiniBatchKMeansTest)
+{
+  CheckMiniBatchKMeans<arma::mat>();
+  CheckMiniBatchKMeans<arma::fmat>();
+}
+
+/**
+ * Make sure that mini-batch k-means finds good centroids without initial
+ * centroids.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchKMeansSampleInitializationTest)
+{
+  arma::mat means;
+  arma::mat data = MiniBatchKMeansData<arma::mat>(3000, means);
+
+  // Sample initialization may put two centroids in one Gaussian; try a few
+  // times.
+  bool success = false;
+  for (size_t trial = 0; trial < 5 && !success; ++trial)
+  {
+    MiniBatchKMeans<> kmeans(100, 50);
+    arma::mat centroids;
+    kmeans.Cluster(data, 3, centroids);
+
+    BOOST_REQUIRE_EQUAL(centroids.n_rows, 2);
+    BOOST_REQUIRE_EQUAL(centroids.n_cols, 3);
+
+    success = true;
+    for (size_t i = 0; i < 3; ++i)
+    {
+      arma::vec distances(3);
+      for (size_t j = 0; j < 3; ++j)
+        distances[j] = arma::norm(centroids.col(j) - means.col(i));
+      success &= (distances.min() < 0.2);
+    }
+  }
+
+  BOOST_REQUIRE_EQUAL(success, true);
+}
+
+/**
+ * Make sure that, with the per-center learning rates, updating a single
+ * centroid with new points gives the mean of those points, whatever the batch
+ * size.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchKMeansLearningRateTest)
+{
+  arma::mat data = arma::randu<arma::mat>(5, 1003);
+
+  const size_t batchSizes[] = { 1, 7, 1000, 5000 };
+  for (size_t b = 0; b < 4; ++b)
+  {
+    MiniBatchKMeans<> kmeans(batchSizes[b]);
+    arma::mat centroid(5, 1, arma::fill::zeros);
+    kmeans.Update(data, centroid);
+
+    BOOST_REQUIRE_EQUAL(kmeans.Counts()[0], 1003);
+    CheckMatrices(centroid, arma::mat(arma::mean(data, 1)));
+  }
+}
+
+/**
+ * Make sure that Update() keeps learning from where Cluster() stopped, as it
+ * would when new data is streamed in.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchKMeansUpdateTest)
+{
+  arma::mat means;
+  arma::mat data = MiniBatchKMeansData<arma::mat>(6000, means);
+
+  // Start with centroids far from the means, on only the first chunk.
+  arma::mat centroids = means + 3.0;
+  MiniBatchKMeans<> kmeans(100, 5);
+  kmeans.Cluster(data.cols(0, 999), 3, centroids, true);
+  BOOST_REQUIRE_EQUAL(arma::accu(kmeans.Counts()), 500);
+
+  for (size_t begin = 1000; begin < data.n_cols; begin += 1000)
+    kmeans.Update(data.cols(begin, begin + 999), centroids);
+
+  BOOST_REQUIRE_EQUAL(arma::accu(kmeans.Counts()), 5500);
+  for (size_t i = 0; i < 3; ++i)
+    BOOST_REQUIRE_LT(arma::norm(centroids.col(i) - means.col(i)), 0.2);
+
+  // Points of the wrong dimensionality, or no centroids, can't be used.
+  arma::mat noCentroids;
+  BOOST_REQUIRE_THROW(kmeans.Update(arma::randu<arma::mat>(3, 10), centroids),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(kmeans.Update(data, noCentroids), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
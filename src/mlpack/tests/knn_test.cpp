@@ -14,6 +14,10 @@
 #include <mlpack/methods/neighbor_search/ns_model.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/tree/example_tree.hpp>
+#include <mlpack/core/util/shared_mutex.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
@@ -1466,4 +1470,600 @@ BOOST_AUTO_TEST_CASE(GreedyTreeSearch)
       0);
 }
 
+// These tests are only compiled if the user has specified OpenMP to be used.
+#ifdef HAS_OPENMP
+/**
+ * Search with the given tree type and mode, once on one thread and once on
+ * four threads, and make sure the results are the same.  Four threads are used
+ * even on machines with fewer cores, so that the query tree is actually split.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckParallelSearch(const NeighborSearchMode mode)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 2000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 1500);
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, TreeType>
+      knn(referenceData, mode);
+
+  arma::Mat<size_t> serialNeighbors, parallelNeighbors;
+  arma::mat serialDistances, parallelDistances;
+
+  const int prevNumThreads = omp_get_max_threads();
+
+  // Bichromatic search.
+  omp_set_num_threads(1);
+  knn.Search(queryData, 5, serialNeighbors, serialDistances);
+  omp_set_num_threads(4);
+  knn.Search(queryData, 5, parallelNeighbors, parallelDistances);
+
+  CheckMatrices(serialNeighbors, parallelNeighbors);
+  CheckMatrices(serialDistances, parallelDistances);
+
+  // Monochromatic search.
+  omp_set_num_threads(1);
+  knn.Search(5, serialNeighbors, serialDistances);
+  omp_set_num_threads(4);
+  knn.Search(5, parallelNeighbors, parallelDistances);
+
+  omp_set_num_threads(prevNumThreads);
+
+  CheckMatrices(serialNeighbors, parallelNeighbors);
+  CheckMatrices(serialDistances, parallelDistances);
+}
+
+/**
+ * Make sure that searching on several threads gives the same results as
+ * searching on one thread, for every search mode and a few kinds of trees.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSearchTest)
+{
+  CheckParallelSearch<KDTree>(NAIVE_MODE);
+  CheckParallelSearch<KDTree>(SINGLE_TREE_MODE);
+  CheckParallelSearch<KDTree>(DUAL_TREE_MODE);
+  CheckParallelSearch<KDTree>(GREEDY_SINGLE_TREE_MODE);
+  CheckParallelSearch<KDTree>(BEST_FIRST_SINGLE_TREE_MODE);
+  CheckParallelSearch<BallTree>(DUAL_TREE_MODE);
+  CheckParallelSearch<StandardCoverTree>(SINGLE_TREE_MODE);
+  CheckParallelSearch<StandardCoverTree>(DUAL_TREE_MODE);
+  CheckParallelSearch<RTree>(DUAL_TREE_MODE);
+  CheckParallelSearch<Octree>(DUAL_TREE_MODE);
+}
+
+/**
+ * Make sure that a dual-tree search with a query tree gives the same results on
+ * one thread as on several threads.
+ */
+BOOST_AUTO_TEST_CASE(ParallelQueryTreeSearchTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 2000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 1500);
+
+  KNN knn(referenceData);
+  KNN::Tree queryTree(queryData);
+
+  arma::Mat<size_t> serialNeighbors, parallelNeighbors;
+  arma::mat serialDistances, parallelDistances;
+
+  const int prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  knn.Search(queryTree, 5, serialNeighbors, serialDistances);
+
+  // Reset the bounds of the query tree before searching again.
+  KNN::Tree otherQueryTree(queryData);
+  omp_set_num_threads(4);
+  knn.Search(otherQueryTree, 5, parallelNeighbors, parallelDistances);
+  omp_set_num_threads(prevNumThreads);
+
+  CheckMatrices(serialNeighbors, parallelNeighbors);
+  CheckMatrices(serialDistances, parallelDistances);
+}
+#endif
+
+/**
+ * Make sure that a search on float data gives the same neighbors as a search
+ * on the same data stored as doubles.
+ */
+BOOST_AUTO_TEST_CASE(FloatMatrixSearchTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(5, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(5, 300);
+  arma::fmat floatReferenceData = arma::conv_to<arma::fmat>::from(
+      referenceData);
+  arma::fmat floatQueryData = arma::conv_to<arma::fmat>::from(queryData);
+
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::fmat,
+      KDTree> FloatKNN;
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    const NeighborSearchMode searchMode = (mode == 0) ? NAIVE_MODE :
+        (mode == 1) ? SINGLE_TREE_MODE : DUAL_TREE_MODE;
+
+    KNN knn(referenceData, searchMode);
+    FloatKNN floatKnn(floatReferenceData, searchMode);
+
+    arma::Mat<size_t> neighbors, floatNeighbors;
+    arma::mat distances, floatDistances;
+    knn.Search(queryData, 3, neighbors, distances);
+    floatKnn.Search(floatQueryData, 3, floatNeighbors, floatDistances);
+
+    // Rounding to float may swap neighbors that are at nearly the same
+    // distance, so compare the distances only.
+    for (size_t i = 0; i < distances.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(distances[i], floatDistances[i], 1e-3);
+  }
+}
+
+/**
+ * Find the neighbors of the query points (or of the reference points, if
+ * querySet is empty) among the reference points that are not deleted with a
+ * naive search, and map the neighbors back to indices of the reference set.
+ */
+void NaiveSearchLivePoints(const arma::mat& referenceSet,
+                           const std::vector<bool>& deleted,
+                           const arma::mat& querySet,
+                           const size_t k,
+                           arma::Mat<size_t>& neighbors,
+                           arma::mat& distances)
+{
+  std::vector<size_t> liveIndices;
+  for (size_t i = 0; i < referenceSet.n_cols; ++i)
+    if (!deleted[i])
+      liveIndices.push_back(i);
+
+  arma::mat liveSet(referenceSet.n_rows, liveIndices.size());
+  for (size_t i = 0; i < liveIndices.size(); ++i)
+    liveSet.col(i) = referenceSet.col(liveIndices[i]);
+
+  KNN naive(liveSet, NAIVE_MODE);
+  if (querySet.n_cols > 0)
+    naive.Search(querySet, k, neighbors, distances);
+  else
+    naive.Search(k, neighbors, distances);
+
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+    neighbors[i] = liveIndices[neighbors[i]];
+}
+
+/**
+ * Insert points into and delete points from a NeighborSearch object with the
+ * given tree type, and make sure that the results are the same as those of a
+ * naive search on the remaining points.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckPointUpdates(const NeighborSearchMode mode)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 1000);
+  arma::mat newData = arma::randu<arma::mat>(4, 300);
+  arma::mat queryData = arma::randu<arma::mat>(4, 200);
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, TreeType>
+      knn(referenceData, mode);
+
+  knn.InsertPoints(arma::mat(newData.cols(0, 99)));
+  knn.InsertPoints(arma::mat(newData.cols(100, 299)));
+  BOOST_REQUIRE_EQUAL(knn.ReferenceSet().n_cols, 1300);
+
+  // The new points are appended to the reference set.
+  const arma::mat allData = arma::join_rows(referenceData, newData);
+  CheckMatrices(knn.ReferenceSet(), allData);
+
+  std::vector<bool> deleted(allData.n_cols, false);
+  size_t numDeleted = 0;
+  for (size_t i = 0; i < allData.n_cols; i += 7)
+  {
+    BOOST_REQUIRE(knn.DeletePoint(i));
+    deleted[i] = true;
+    ++numDeleted;
+  }
+
+  // Points that are already deleted or don't exist can't be deleted.
+  BOOST_REQUIRE(!knn.DeletePoint(0));
+  BOOST_REQUIRE(!knn.DeletePoint(allData.n_cols));
+  BOOST_REQUIRE_EQUAL(knn.NumReferencePoints(), allData.n_cols - numDeleted);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  knn.Search(queryData, 5, neighbors, distances);
+  NaiveSearchLivePoints(allData, deleted, queryData, 5, naiveNeighbors,
+      naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  // In monochromatic search, the deleted points have no neighbors.
+  knn.Search(5, neighbors, distances);
+  NaiveSearchLivePoints(allData, deleted, arma::mat(), 5, naiveNeighbors,
+      naiveDistances);
+
+  size_t liveIndex = 0;
+  for (size_t i = 0; i < allData.n_cols; ++i)
+  {
+    if (deleted[i])
+    {
+      for (size_t j = 0; j < 5; ++j)
+        BOOST_REQUIRE_EQUAL(neighbors(j, i), (size_t) -1);
+      continue;
+    }
+
+    for (size_t j = 0; j < 5; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors(j, i), naiveNeighbors(j, liveIndex));
+      BOOST_REQUIRE_CLOSE(distances(j, i), naiveDistances(j, liveIndex), 1e-5);
+    }
+    ++liveIndex;
+  }
+
+  // Naive search must skip the deleted points too.
+  knn.SearchMode() = NAIVE_MODE;
+  knn.Search(queryData, 5, neighbors, distances);
+  NaiveSearchLivePoints(allData, deleted, queryData, 5, naiveNeighbors,
+      naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
+/**
+ * Make sure that points can be inserted into and deleted from the reference
+ * set of the rectangle trees without rebuilding them.
+ */
+BOOST_AUTO_TEST_CASE(PointUpdatesTest)
+{
+  CheckPointUpdates<RTree>(SINGLE_TREE_MODE);
+  CheckPointUpdates<RTree>(DUAL_TREE_MODE);
+  CheckPointUpdates<RStarTree>(DUAL_TREE_MODE);
+  CheckPointUpdates<XTree>(SINGLE_TREE_MODE);
+  CheckPointUpdates<HilbertRTree>(DUAL_TREE_MODE);
+  CheckPointUpdates<RPlusTree>(SINGLE_TREE_MODE);
+}
+
+/**
+ * Make sure that points can be inserted in naive mode, but that trees that
+ * can't be updated and naive mode without a tree refuse updates.
+ */
+BOOST_AUTO_TEST_CASE(PointUpdatesUnsupportedTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 100);
+  arma::mat newData = arma::randu<arma::mat>(3, 10);
+
+  KNN naive(referenceData, NAIVE_MODE);
+  naive.InsertPoints(newData);
+  BOOST_REQUIRE_EQUAL(naive.ReferenceSet().n_cols, 110);
+  BOOST_REQUIRE_THROW(naive.DeletePoint(0), std::invalid_argument);
+
+  // The dimensionality must match.
+  BOOST_REQUIRE_THROW(naive.InsertPoints(arma::randu<arma::mat>(4, 10)),
+      std::invalid_argument);
+
+  KNN knn(referenceData);
+  BOOST_REQUIRE_THROW(knn.InsertPoints(newData), std::invalid_argument);
+  BOOST_REQUIRE_THROW(knn.DeletePoint(0), std::invalid_argument);
+  BOOST_REQUIRE_EQUAL(knn.ReferenceSet().n_cols, 100);
+}
+
+/**
+ * Make sure that NSModel passes point updates on to the NeighborSearch object,
+ * also with a random basis.
+ */
+BOOST_AUTO_TEST_CASE(KNNModelPointUpdatesTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 500);
+  arma::mat newData = arma::randu<arma::mat>(4, 100);
+  arma::mat queryData = arma::randu<arma::mat>(4, 100);
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    const bool randomBasis = (i == 1);
+    NSModel<NearestNeighborSort> model(NSModel<NearestNeighborSort>::R_TREE,
+        randomBasis);
+    model.BuildModel(arma::mat(referenceData), 20, DUAL_TREE_MODE);
+
+    model.InsertPoints(arma::mat(newData));
+    BOOST_REQUIRE_EQUAL(model.Dataset().n_cols, 600);
+
+    std::vector<bool> deleted(600, false);
+    for (size_t j = 1; j < 600; j += 5)
+    {
+      BOOST_REQUIRE(model.DeletePoint(j));
+      deleted[j] = true;
+    }
+
+    arma::Mat<size_t> neighbors, naiveNeighbors;
+    arma::mat distances, naiveDistances;
+    model.Search(arma::mat(queryData), 3, neighbors, distances);
+    NaiveSearchLivePoints(arma::join_rows(referenceData, newData), deleted,
+        queryData, 3, naiveNeighbors, naiveDistances);
+
+    CheckMatrices(neighbors, naiveNeighbors);
+    CheckMatrices(distances, naiveDistances);
+  }
+
+  NSModel<NearestNeighborSort> kdModel(NSModel<NearestNeighborSort>::KD_TREE);
+  kdModel.BuildModel(arma::mat(referenceData), 20, DUAL_TREE_MODE);
+  BOOST_REQUIRE_THROW(kdModel.InsertPoints(arma::mat(newData)),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that any number of threads can share a util::SharedMutex (as
+ * concurrent searches of NeighborSearch do), but that a writer waits until
+ * every reader is done.
+ */
+BOOST_AUTO_TEST_CASE(SharedMutexTest)
+{
+  util::SharedMutex mutex;
+
+  // Each reader holds the mutex until every reader has it, which only
+  // finishes if they can own the mutex at the same time.
+  std::atomic<size_t> readers(0);
+  std::thread threads[3];
+  for (size_t i = 0; i < 3; ++i)
+  {
+    threads[i] = std::thread([&]()
+        {
+          util::SharedLock lock(mutex);
+          ++readers;
+          while (readers < 3)
+            std::this_thread::yield();
+        });
+  }
+
+  for (size_t i = 0; i < 3; ++i)
+    threads[i].join();
+
+  BOOST_REQUIRE_EQUAL(readers.load(), 3);
+
+  std::atomic<bool> written(false);
+  mutex.lock_shared();
+  std::thread writer([&]()
+      {
+        std::lock_guard<util::SharedMutex> lock(mutex);
+        written = true;
+      });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  BOOST_CHECK(!written);
+
+  mutex.unlock_shared();
+  writer.join();
+  BOOST_REQUIRE(written);
+}
+
+/**
+ * Search with several threads while points are inserted and deleted, and make
+ * sure every search returns consistent results.
+ */
+BOOST_AUTO_TEST_CASE(ConcurrentSearchAndPointUpdatesTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 500);
+  arma::mat newData = arma::randu<arma::mat>(3, 200);
+  arma::mat queryData = arma::randu<arma::mat>(3, 50);
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, RTree>
+      knn(referenceData);
+
+  std::vector<arma::Mat<size_t>> neighbors(12);
+  std::vector<arma::mat> distances(12);
+  std::thread threads[4];
+  for (size_t t = 0; t < 4; ++t)
+  {
+    threads[t] = std::thread([&, t]()
+        {
+          for (size_t i = t; i < 12; i += 4)
+            knn.Search(queryData, 3, neighbors[i], distances[i]);
+        });
+  }
+
+  std::vector<bool> deleted(referenceData.n_cols + newData.n_cols, false);
+  for (size_t i = 0; i < newData.n_cols; i += 20)
+  {
+    knn.InsertPoints(arma::mat(newData.cols(i, i + 19)));
+    BOOST_CHECK(knn.DeletePoint(i));
+    deleted[i] = true;
+  }
+
+  for (size_t t = 0; t < 4; ++t)
+    threads[t].join();
+
+  // Points are only appended, so the indices of each result are still valid.
+  const arma::mat allData = arma::join_rows(referenceData, newData);
+  for (size_t i = 0; i < neighbors.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i].n_rows, 3);
+    BOOST_REQUIRE_EQUAL(neighbors[i].n_cols, queryData.n_cols);
+    for (size_t q = 0; q < queryData.n_cols; ++q)
+    {
+      for (size_t j = 0; j < 3; ++j)
+      {
+        BOOST_REQUIRE_LT(neighbors[i](j, q), allData.n_cols);
+        BOOST_REQUIRE_CLOSE(distances[i](j, q), EuclideanDistance::Evaluate(
+            queryData.col(q), allData.col(neighbors[i](j, q))), 1e-5);
+        if (j > 0)
+          BOOST_REQUIRE_LE(distances[i](j - 1, q), distances[i](j, q));
+      }
+    }
+  }
+
+  // Once the updates are done, the results must be exact.
+  arma::Mat<size_t> finalNeighbors, naiveNeighbors;
+  arma::mat finalDistances, naiveDistances;
+  knn.Search(queryData, 3, finalNeighbors, finalDistances);
+  NaiveSearchLivePoints(allData, deleted, queryData, 3, naiveNeighbors,
+      naiveDistances);
+
+  CheckMatrices(finalNeighbors, naiveNeighbors);
+  CheckMatrices(finalDistances, naiveDistances);
+}
+
+/**
+ * Search with the best-first traverser and no budget, and make sure the results
+ * are exact and the error bounds are zero.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckBestFirstExact()
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, TreeType>
+      knn(referenceData, BEST_FIRST_SINGLE_TREE_MODE);
+  KNN naive(referenceData, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+
+  knn.Search(queryData, 5, neighbors, distances);
+  naive.Search(queryData, 5, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+  BOOST_REQUIRE_EQUAL(knn.ErrorBounds().n_elem, queryData.n_cols);
+  BOOST_REQUIRE_EQUAL(arma::accu(knn.ErrorBounds() != 0.0), 0);
+
+  knn.Search(5, neighbors, distances);
+  naive.Search(5, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+  BOOST_REQUIRE_EQUAL(knn.ErrorBounds().n_elem, referenceData.n_cols);
+  BOOST_REQUIRE_EQUAL(arma::accu(knn.ErrorBounds() != 0.0), 0);
+
+  // Other modes don't give error bounds.
+  knn.SearchMode() = SINGLE_TREE_MODE;
+  knn.Search(5, neighbors, distances);
+  BOOST_REQUIRE_EQUAL(knn.ErrorBounds().n_elem, 0);
+}
+
+/**
+ * Make sure that best-first search without a budget is exact for a few kinds
+ * of trees.
+ */
+BOOST_AUTO_TEST_CASE(BestFirstExactTest)
+{
+  CheckBestFirstExact<KDTree>();
+  CheckBestFirstExact<BallTree>();
+  CheckBestFirstExact<StandardCoverTree>();
+  CheckBestFirstExact<RTree>();
+  CheckBestFirstExact<Octree>();
+}
+
+/**
+ * Make sure that the results of a best-first search that ran out of its budget
+ * are within the error bounds it gives.
+ */
+template<typename SortPolicy>
+void CheckBestFirstBounds(const size_t maxVisits, const double timeLimit)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(5, 3000);
+  arma::mat queryData = arma::randu<arma::mat>(5, 300);
+
+  NeighborSearch<SortPolicy> search(referenceData,
+      BEST_FIRST_SINGLE_TREE_MODE);
+  search.MaxVisits() = maxVisits;
+  search.TimeLimit() = timeLimit;
+  NeighborSearch<SortPolicy> naive(referenceData, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+
+  search.Search(queryData, 3, neighbors, distances);
+  naive.Search(queryData, 3, naiveNeighbors, naiveDistances);
+
+  const arma::vec& bounds = search.ErrorBounds();
+  BOOST_REQUIRE_EQUAL(bounds.n_elem, queryData.n_cols);
+
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+  {
+    BOOST_REQUIRE_GE(bounds[i], 0.0);
+    if (bounds[i] == DBL_MAX)
+      continue;
+
+    // The score of each neighbor found is within a factor (1 + bound) of the
+    // score of the true neighbor.
+    for (size_t j = 0; j < 3; ++j)
+    {
+      const double score = SortPolicy::ConvertToScore(distances(j, i));
+      const double trueScore = SortPolicy::ConvertToScore(
+          naiveDistances(j, i));
+      BOOST_REQUIRE_LE(score, (1.0 + bounds[i]) * trueScore * (1.0 + 1e-10));
+    }
+  }
+}
+
+/**
+ * Check the error bounds of a best-first search with a node budget and with a
+ * time budget.
+ */
+BOOST_AUTO_TEST_CASE(BestFirstBudgetTest)
+{
+  CheckBestFirstBounds<NearestNeighborSort>(4, 0.0);
+  CheckBestFirstBounds<NearestNeighborSort>(20, 0.0);
+  CheckBestFirstBounds<FurthestNeighborSort>(10, 0.0);
+  CheckBestFirstBounds<NearestNeighborSort>(0, 1e-6);
+
+  // With a budget of a few nodes, the search can't be exact for every query
+  // point, but it must do much less work.
+  arma::mat referenceData = arma::randu<arma::mat>(5, 3000);
+  arma::mat queryData = arma::randu<arma::mat>(5, 300);
+
+  KNN knn(referenceData, BEST_FIRST_SINGLE_TREE_MODE);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  knn.Search(queryData, 3, neighbors, distances);
+  const size_t exactBaseCases = knn.BaseCases();
+
+  knn.MaxVisits() = 4;
+  knn.Search(queryData, 3, neighbors, distances);
+
+  BOOST_REQUIRE_LT(knn.BaseCases(), exactBaseCases);
+  BOOST_REQUIRE_GT(arma::accu(knn.ErrorBounds() > 0.0), 0);
+
+  // A generous time limit changes nothing.
+  knn.MaxVisits() = 0;
+  knn.TimeLimit() = 100.0;
+  knn.Search(queryData, 3, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(knn.BaseCases(), exactBaseCases);
+  BOOST_REQUIRE_EQUAL(arma::accu(knn.ErrorBounds() != 0.0), 0);
+}
+
+/**
+ * Make sure that best-first search rejects a spill tree with overlapping nodes,
+ * which would give duplicate neighbors, but is exact on one without overlap.
+ */
+BOOST_AUTO_TEST_CASE(BestFirstSpillTreeTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(5, 500);
+  arma::mat queryData = arma::randu<arma::mat>(5, 100);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+
+  SpillKNN overlapping(SpillKNN::Tree(referenceData, 0.1 /* tau */),
+      BEST_FIRST_SINGLE_TREE_MODE);
+  BOOST_REQUIRE_THROW(overlapping.Search(queryData, 3, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(overlapping.Search(3, neighbors, distances),
+      std::invalid_argument);
+
+  SpillKNN separate(SpillKNN::Tree(referenceData, 0.0 /* tau */),
+      BEST_FIRST_SINGLE_TREE_MODE);
+  separate.Search(queryData, 3, neighbors, distances);
+
+  KNN naive(referenceData, NAIVE_MODE);
+  naive.Search(queryData, 3, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -12,6 +12,7 @@
 #include <sstream>
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/data/chunk_reader.hpp>
 #include <mlpack/core/data/load_arff.hpp>
 #include <mlpack/core/data/map_policies/missing_policy.hpp>
 
@@ -1994,4 +1995,244 @@ BOOST_AUTO_TEST_CASE(DatasetMapperNonUniqueTest)
   BOOST_REQUIRE_EQUAL(dm.UnmapString(nan, 0, 2), "cheese");
 }
 
+/**
+ * Make sure that a CSV large enough to be parsed in several chunks is loaded
+ * correctly, and that categorical values are mapped in the order in which they
+ * appear in the file.
+ */
+BOOST_AUTO_TEST_CASE(LargeCategoricalCSVLoadTest)
+{
+  const size_t numPoints = 200000;
+  const char* categories[] = { "red", "green", "blue" };
+
+  fstream f;
+  f.open("test.csv", fstream::out);
+  f.precision(12);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    f << i << ", " << (0.25 * i) << ", " << categories[(i / 3) % 3] << ", "
+        << (i % 10 == 0 ? -1.5 : 2.5) << endl;
+  }
+  f.close();
+
+  arma::mat matrix;
+  DatasetInfo info;
+  data::Load("test.csv", matrix, info, true);
+
+  BOOST_REQUIRE_EQUAL(matrix.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(matrix.n_cols, numPoints);
+
+  BOOST_REQUIRE(info.Type(0) == Datatype::numeric);
+  BOOST_REQUIRE(info.Type(1) == Datatype::numeric);
+  BOOST_REQUIRE(info.Type(2) == Datatype::categorical);
+  BOOST_REQUIRE(info.Type(3) == Datatype::numeric);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(2), 3);
+  BOOST_REQUIRE_EQUAL(info.UnmapString(0, 2), "red");
+  BOOST_REQUIRE_EQUAL(info.UnmapString(1, 2), "green");
+  BOOST_REQUIRE_EQUAL(info.UnmapString(2, 2), "blue");
+
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(matrix(0, i), (double) i);
+    BOOST_REQUIRE_EQUAL(matrix(1, i), 0.25 * i);
+    BOOST_REQUIRE_EQUAL(matrix(2, i), (double) ((i / 3) % 3));
+    BOOST_REQUIRE_EQUAL(matrix(3, i), (i % 10 == 0 ? -1.5 : 2.5));
+  }
+
+  // Now load it without transposing; each line is then a categorical
+  // dimension, since it holds a string.
+  arma::mat matrix2;
+  DatasetInfo info2;
+  data::Load("test.csv", matrix2, info2, true, false);
+
+  BOOST_REQUIRE_EQUAL(matrix2.n_rows, numPoints);
+  BOOST_REQUIRE_EQUAL(matrix2.n_cols, 4);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    BOOST_REQUIRE(info2.Type(i) == Datatype::categorical);
+    BOOST_REQUIRE_EQUAL(info2.NumMappings(i), 4);
+    for (size_t j = 0; j < 4; ++j)
+      BOOST_REQUIRE_EQUAL(matrix2(i, j), (double) j);
+  }
+
+  remove("test.csv");
+}
+
+/**
+ * Make sure that a matrix saved in the memory-mappable format can be mapped
+ * and loaded again.
+ */
+BOOST_AUTO_TEST_CASE(MappedMatrixTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 100);
+  BOOST_REQUIRE(data::Save("test.mmat", dataset));
+
+  // Map the matrix; no copy is made.
+  data::MappedMatrix<double> mapped;
+  BOOST_REQUIRE(mapped.Load("test.mmat"));
+  BOOST_REQUIRE_EQUAL(mapped.Matrix().n_rows, 5);
+  BOOST_REQUIRE_EQUAL(mapped.Matrix().n_cols, 100);
+  for (size_t i = 0; i < dataset.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(mapped.Matrix()[i], dataset[i]);
+
+  // The elements should start right after the 64-byte header.
+  BOOST_REQUIRE_EQUAL(((size_t) mapped.Matrix().memptr()) % 64, 0);
+
+  // Loading should give the same matrix, converted if necessary.
+  arma::mat loaded;
+  BOOST_REQUIRE(data::Load("test.mmat", loaded));
+  CheckMatrices(dataset, loaded);
+
+  arma::fmat floatLoaded;
+  BOOST_REQUIRE(data::Load("test.mmat", floatLoaded));
+  BOOST_REQUIRE_EQUAL(floatLoaded.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(floatLoaded.n_cols, 100);
+  for (size_t i = 0; i < dataset.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(floatLoaded[i], (float) dataset[i]);
+
+  arma::mat untransposed;
+  BOOST_REQUIRE(data::Load("test.mmat", untransposed, false, false));
+  CheckMatrices(dataset.t(), untransposed);
+
+  // Mapping with the wrong element type must fail.
+  data::MappedMatrix<float> wrongType;
+  Log::Warn.ignoreInput = true;
+  BOOST_REQUIRE(!wrongType.Load("test.mmat"));
+  BOOST_REQUIRE_EQUAL(wrongType.Matrix().n_elem, 0);
+  Log::Warn.ignoreInput = false;
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(wrongType.Load("test.mmat", true), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  remove("test.mmat");
+}
+
+/**
+ * Make sure a matrix whose element type the memory-mappable format can't hold
+ * is not saved in that format.
+ */
+BOOST_AUTO_TEST_CASE(MappedMatrixUnsupportedTypeTest)
+{
+  remove("test.mmat");
+  arma::Mat<unsigned char> dataset(5, 100);
+  dataset.fill(3);
+
+  Log::Warn.ignoreInput = true;
+  BOOST_REQUIRE(!data::Save("test.mmat", dataset));
+  Log::Warn.ignoreInput = false;
+
+  // No file should have been created.
+  std::ifstream in("test.mmat", std::ios::binary);
+  BOOST_REQUIRE(!in.is_open());
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(data::Save("test.mmat", dataset, true),
+      std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Make sure a truncated or foreign file is not accepted as a memory-mappable
+ * matrix.
+ */
+BOOST_AUTO_TEST_CASE(MappedMatrixBadFileTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 100);
+  BOOST_REQUIRE(data::Save("test.mmat", dataset));
+
+  // Truncate the file.
+  std::ifstream in("test.mmat", std::ios::binary);
+  std::string contents((std::istreambuf_iterator<char>(in)),
+      std::istreambuf_iterator<char>());
+  in.close();
+  std::ofstream out("test.mmat", std::ios::binary);
+  out.write(contents.data(), contents.size() - sizeof(double));
+  out.close();
+
+  Log::Warn.ignoreInput = true;
+  data::MappedMatrix<double> mapped;
+  BOOST_REQUIRE(!mapped.Load("test.mmat"));
+  arma::mat loaded;
+  BOOST_REQUIRE(!data::Load("test.mmat", loaded));
+
+  // Not a memory-mappable matrix at all.
+  out.open("test.mmat", std::ios::binary);
+  out << "this is not a matrix, but it is long enough to hold the header of "
+      << "one, so only the magic string gives it away" << std::endl;
+  out.close();
+  BOOST_REQUIRE(!mapped.Load("test.mmat"));
+  BOOST_REQUIRE(!data::Load("test.mmat", loaded));
+  Log::Warn.ignoreInput = false;
+
+  remove("test.mmat");
+}
+
+/**
+ * Make sure the ChunkReader returns the whole dataset, in order, for text and
+ * binary files.
+ */
+BOOST_AUTO_TEST_CASE(ChunkReaderTest)
+{
+  arma::mat dataset(3, 1000);
+  for (size_t i = 0; i < dataset.n_elem; ++i)
+    dataset[i] = (double) i;
+
+  fstream f;
+  f.open("test.csv", fstream::out);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    f << dataset(0, i) << ", " << dataset(1, i) << "," << dataset(2, i) << endl;
+    if (i % 100 == 0)
+      f << endl; // Blank lines should be skipped.
+  }
+  f.close();
+
+  BOOST_REQUIRE(data::Save("test.mmat", dataset));
+  arma::fmat floatDataset = arma::conv_to<arma::fmat>::from(dataset);
+  BOOST_REQUIRE(data::Save("test_float.mmat", floatDataset));
+
+  const char* files[] = { "test.csv", "test.mmat", "test_float.mmat" };
+  for (size_t i = 0; i < 3; ++i)
+  {
+    data::ChunkReader reader(files[i], 300);
+    BOOST_REQUIRE_EQUAL(reader.Dimensionality(), 3);
+    BOOST_REQUIRE_EQUAL(reader.ChunkSize(), 300);
+
+    size_t numPoints = 0;
+    size_t numChunks = 0;
+    arma::mat chunk;
+    while (reader.NextChunk(chunk))
+    {
+      BOOST_REQUIRE_EQUAL(chunk.n_rows, 3);
+      BOOST_REQUIRE_LE(chunk.n_cols, 300);
+      CheckMatrices(chunk, dataset.cols(numPoints,
+          numPoints + chunk.n_cols - 1));
+
+      numPoints += chunk.n_cols;
+      ++numChunks;
+    }
+
+    BOOST_REQUIRE_EQUAL(numPoints, 1000);
+    BOOST_REQUIRE_EQUAL(numChunks, 4);
+
+    // Nothing is left.
+    BOOST_REQUIRE(!reader.NextChunk(chunk));
+  }
+
+  // A malformed line gives an error when its chunk is reached.
+  f.open("test.csv", fstream::out);
+  f << "1, 2, 3" << endl;
+  f << "4, 5" << endl;
+  f.close();
+
+  data::ChunkReader reader("test.csv", 10);
+  arma::mat chunk;
+  BOOST_REQUIRE_THROW(reader.NextChunk(chunk), std::runtime_error);
+
+  remove("test.csv");
+  remove("test.mmat");
+  remove("test_float.mmat");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -394,4 +394,127 @@ BOOST_AUTO_TEST_CASE(AlgorithmsSimilarTest)
   CheckMatrices(naiveCentroid, dualCoverTreeCentroid);
 }
 
+/**
+ * Make sure that mini-batch k-means gives results of the right size.
+ */
+BOOST_AUTO_TEST_CASE(KmMiniBatchSizeCheck)
+{
+  int c = 3;
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Unable to load train dataset vc2.csv!");
+
+  size_t col = inputData.n_cols;
+  size_t row = inputData.n_rows;
+
+  SetInputParam("input", std::move(inputData));
+  SetInputParam("clusters", c);
+  SetInputParam("algorithm", std::string("minibatch"));
+  SetInputParam("batch_size", 50);
+  SetInputParam("max_iterations", 20);
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("output").n_rows, row + 1);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("output").n_cols, col);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("centroid").n_rows, row);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("centroid").n_cols, c);
+
+  // Every assignment must be a valid cluster.
+  BOOST_REQUIRE_LT(CLI::GetParam<arma::mat>("output").row(row).max(), c);
+}
+
+/**
+ * Make sure that the batch size must be positive.
+ */
+BOOST_AUTO_TEST_CASE(KmMiniBatchNonPositiveBatchSizeTest)
+{
+  SetInputParam("input", arma::mat(arma::randu<arma::mat>(3, 100)));
+  SetInputParam("clusters", 3);
+  SetInputParam("algorithm", std::string("minibatch"));
+  SetInputParam("batch_size", 0);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Make sure that the number of mini-batches must be positive, since mini-batch
+ * k-means has no convergence check to stop at.
+ */
+BOOST_AUTO_TEST_CASE(KmMiniBatchZeroIterationsTest)
+{
+  SetInputParam("input", arma::mat(arma::randu<arma::mat>(3, 100)));
+  SetInputParam("clusters", 3);
+  SetInputParam("algorithm", std::string("minibatch"));
+  SetInputParam("max_iterations", 0);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Make sure that mini-batch k-means can stream its points from a file, giving
+ * the same centroids as updating the model with each chunk of the file.
+ */
+BOOST_AUTO_TEST_CASE(KmMiniBatchStreamTest)
+{
+  arma::mat streamData = arma::randu<arma::mat>(4, 2500);
+  BOOST_REQUIRE(data::Save("kmeans_stream.csv", streamData));
+  // Use the values as they were written.
+  BOOST_REQUIRE(data::Load("kmeans_stream.csv", streamData));
+
+  arma::mat initCentroids = arma::randu<arma::mat>(4, 5);
+
+  // Only stream the file, starting from the given centroids; every chunk then
+  // updates them, and no random mini-batch is taken.
+  SetInputParam("input_file", std::string("kmeans_stream.csv"));
+  SetInputParam("chunk_size", 1000);
+  SetInputParam("clusters", 5);
+  SetInputParam("algorithm", std::string("minibatch"));
+  SetInputParam("batch_size", 100);
+  SetInputParam("initial_centroids", initCentroids);
+
+  mlpackMain();
+
+  arma::mat streamCentroids = std::move(CLI::GetParam<arma::mat>("centroid"));
+  BOOST_REQUIRE_EQUAL(streamCentroids.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(streamCentroids.n_cols, 5);
+
+  // The same centroids are found when each chunk updates the model directly.
+  MiniBatchKMeans<> kmeans(100);
+  arma::mat centroids = initCentroids;
+  kmeans.Update(streamData.cols(0, 999), centroids);
+  kmeans.Update(streamData.cols(1000, 1999), centroids);
+  kmeans.Update(streamData.cols(2000, 2499), centroids);
+
+  CheckMatrices(streamCentroids, centroids);
+
+  ResetKmSettings();
+
+  // The points of the file can't be labeled.
+  SetInputParam("input_file", std::string("kmeans_stream.csv"));
+  SetInputParam("clusters", 5);
+  SetInputParam("algorithm", std::string("minibatch"));
+  CLI::SetPassed("output");
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  ResetKmSettings();
+
+  // Only mini-batch k-means can stream.
+  SetInputParam("input_file", std::string("kmeans_stream.csv"));
+  SetInputParam("clusters", 5);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  remove("kmeans_stream.csv");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
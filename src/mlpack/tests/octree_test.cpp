@@ -346,4 +346,79 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
   delete textTree;
 }
 
+#ifdef HAS_OPENMP
+/**
+ * A statistic holding the number of points below a node, computed from the
+ * statistics of the children, to check that statistics are built bottom-up.
+ */
+class DescendantCountStat
+{
+ public:
+  DescendantCountStat() : count(0) { }
+
+  template<typename TreeType>
+  DescendantCountStat(TreeType& node) : count(node.NumPoints())
+  {
+    for (size_t i = 0; i < node.NumChildren(); ++i)
+      count += node.Child(i).Stat().Count();
+  }
+
+  size_t Count() const { return count; }
+
+ private:
+  size_t count;
+};
+
+/**
+ * Make sure that two octrees built from the same data are identical.
+ */
+template<typename TreeType>
+void CheckSameConstruction(const TreeType& a, const TreeType& b)
+{
+  BOOST_REQUIRE_EQUAL(a.NumChildren(), b.NumChildren());
+  BOOST_REQUIRE_EQUAL(a.NumPoints(), b.NumPoints());
+  BOOST_REQUIRE_EQUAL(a.NumDescendants(), b.NumDescendants());
+  BOOST_REQUIRE_EQUAL(a.Descendant(0), b.Descendant(0));
+  BOOST_REQUIRE_EQUAL(a.Stat().Count(), a.NumDescendants());
+  BOOST_REQUIRE_EQUAL(b.Stat().Count(), b.NumDescendants());
+  BOOST_REQUIRE_EQUAL(a.ParentDistance(), b.ParentDistance());
+  for (size_t d = 0; d < a.Bound().Dim(); ++d)
+  {
+    BOOST_REQUIRE_EQUAL(a.Bound()[d].Lo(), b.Bound()[d].Lo());
+    BOOST_REQUIRE_EQUAL(a.Bound()[d].Hi(), b.Bound()[d].Hi());
+  }
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameConstruction(a.Child(i), b.Child(i));
+}
+
+/**
+ * Make sure that an octree built on several threads is the same as an octree
+ * built on one thread, with the same mappings.
+ */
+BOOST_AUTO_TEST_CASE(ParallelConstructionTest)
+{
+  typedef Octree<EuclideanDistance, DescendantCountStat, arma::mat> TreeType;
+  arma::mat dataset(3, 50000, arma::fill::randu);
+
+  const int prevNumThreads = omp_get_max_threads();
+  std::vector<size_t> serialOldFromNew, parallelOldFromNew;
+  omp_set_num_threads(1);
+  TreeType serialTree(dataset, serialOldFromNew, 10);
+  omp_set_num_threads(4);
+  TreeType parallelTree(dataset, parallelOldFromNew, 10);
+  TreeType unmappedTree(dataset, 10);
+  omp_set_num_threads(prevNumThreads);
+
+  CheckMatrices(serialTree.Dataset(), parallelTree.Dataset());
+  CheckMatrices(serialTree.Dataset(), unmappedTree.Dataset());
+  BOOST_REQUIRE_EQUAL(serialOldFromNew.size(), parallelOldFromNew.size());
+  for (size_t i = 0; i < serialOldFromNew.size(); ++i)
+    BOOST_REQUIRE_EQUAL(serialOldFromNew[i], parallelOldFromNew[i]);
+
+  CheckSameConstruction(serialTree, parallelTree);
+  CheckSameConstruction(serialTree, unmappedTree);
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
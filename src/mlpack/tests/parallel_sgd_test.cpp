@@ -14,6 +14,11 @@
 #include <mlpack/core/optimizers/parallel_sgd/decay_policies/exponential_backoff.hpp>
 #include <mlpack/core/optimizers/parallel_sgd/sparse_test_function.hpp>
 #include <mlpack/core/optimizers/problems/generalized_rosenbrock_function.hpp>
+#include <mlpack/core/optimizers/parallel_sgd/dense_parallel_sgd.hpp>
+#include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <mlpack/methods/ann/ffn.hpp>
 
 // We need some thorough testing.
 #define private public
@@ -28,6 +33,8 @@ using namespace arma;
 using namespace mlpack;
 using namespace mlpack::optimization;
 using namespace mlpack::optimization::test;
+using namespace mlpack::regression;
+using namespace mlpack::ann;
 
 BOOST_AUTO_TEST_SUITE(ParallelSGDTest);
 
@@ -124,4 +131,151 @@ BOOST_AUTO_TEST_CASE(ExponentialBackoffDecayTest)
   BOOST_REQUIRE_EQUAL(decayPolicy.StepSize(211), 81);
 }
 
+/**
+ * Create a dataset of two Gaussians with the given number of points each, with
+ * labels 0 and 1.
+ */
+static void TwoGaussians(const size_t points,
+                         arma::mat& data,
+                         arma::Row<size_t>& labels)
+{
+  data = arma::join_rows(arma::randn<arma::mat>(3, points),
+      arma::randn<arma::mat>(3, points) + 3.0);
+  labels = arma::join_rows(arma::zeros<arma::Row<size_t>>(points),
+      arma::ones<arma::Row<size_t>>(points));
+}
+
+/**
+ * In synchronous mode, dense parallel SGD should take the same steps as
+ * mini-batch SGD, whatever the number of threads, for a function that sums
+ * over the points of a mini-batch.
+ */
+BOOST_AUTO_TEST_CASE(DenseParallelSGDSynchronousTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  TwoGaussians(500, data, labels);
+
+  LogisticRegressionFunction<> lrf(data, labels, 0.01);
+
+  // Twenty epochs of twenty mini-batches, without shuffling.
+  SGD<VanillaUpdate> sgd(0.01, 50, 20 * data.n_cols, -1.0, false);
+  arma::mat sgdCoordinates = lrf.InitialPoint();
+  const double sgdObjective = sgd.Optimize(lrf, sgdCoordinates);
+
+  size_t maxThreads = 1;
+  #ifdef HAS_OPENMP
+    maxThreads = omp_get_max_threads();
+  #endif
+
+  for (size_t threads = 1; threads <= std::min(maxThreads, (size_t) 4);
+      ++threads)
+  {
+    #ifdef HAS_OPENMP
+      omp_set_num_threads(threads);
+    #endif
+
+    DenseParallelSGD<ConstantStep> s(50, 20 * data.n_cols, -1.0, false, true,
+        ConstantStep(0.01));
+    arma::mat coordinates = lrf.InitialPoint();
+    const double objective = s.Optimize(lrf, coordinates);
+
+    BOOST_REQUIRE_CLOSE(objective, sgdObjective, 1e-5);
+    CheckMatrices(coordinates, sgdCoordinates, 1e-5);
+  }
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(maxThreads);
+  #endif
+}
+
+/**
+ * The maximum number of iterations counts points, as for SGD, so a limit that
+ * ends in the middle of an epoch and of a mini-batch should give the same
+ * result as SGD.
+ */
+BOOST_AUTO_TEST_CASE(DenseParallelSGDMaxIterationsTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  TwoGaussians(500, data, labels);
+
+  LogisticRegressionFunction<> lrf(data, labels, 0.01);
+
+  SGD<VanillaUpdate> sgd(0.01, 64, 2345, -1.0, false);
+  arma::mat sgdCoordinates = lrf.InitialPoint();
+  const double sgdObjective = sgd.Optimize(lrf, sgdCoordinates);
+
+  DenseParallelSGD<ConstantStep> s(64, 2345, -1.0, false, true,
+      ConstantStep(0.01));
+  arma::mat coordinates = lrf.InitialPoint();
+  const double objective = s.Optimize(lrf, coordinates);
+
+  BOOST_REQUIRE_CLOSE(objective, sgdObjective, 1e-5);
+  CheckMatrices(coordinates, sgdCoordinates, 1e-5);
+}
+
+/**
+ * Train logistic regression with the lock-free mode, and make sure the model
+ * is accurate.
+ */
+BOOST_AUTO_TEST_CASE(DenseParallelSGDLogisticRegressionTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  TwoGaussians(1000, data, labels);
+
+  LogisticRegressionFunction<> lrf(data, labels, 0.001);
+
+  DenseParallelSGD<ConstantStep> s(32, 0, 1e-5, true, false,
+      ConstantStep(0.01));
+  arma::mat coordinates = lrf.InitialPoint();
+  s.Optimize(lrf, coordinates);
+
+  LogisticRegression<> lr(data.n_rows, 0.001);
+  lr.Parameters() = coordinates;
+  BOOST_REQUIRE_GE(lr.ComputeAccuracy(data, labels), 95.0);
+}
+
+/**
+ * Train a feedforward network with both modes, and make sure it is accurate.
+ * The BatchNorm layer must have running statistics in the trained network for
+ * the predictions to be right.
+ */
+BOOST_AUTO_TEST_CASE(DenseParallelSGDFFNTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  TwoGaussians(500, data, labels);
+
+  // NegativeLogLikelihood needs labels that start at 1.
+  const arma::mat responses = arma::conv_to<arma::mat>::from(labels) + 1;
+
+  for (size_t synchronous = 0; synchronous < 2; ++synchronous)
+  {
+    FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+    model.Add<Linear<>>(data.n_rows, 8);
+    model.Add<BatchNorm<>>(8);
+    model.Add<SigmoidLayer<>>();
+    model.Add<Linear<>>(8, 2);
+    model.Add<LogSoftMax<>>();
+
+    DenseParallelSGD<ConstantStep> s(16, 50 * data.n_cols, -1.0, true,
+        (synchronous == 1), ConstantStep(0.01));
+    model.Train(data, responses, s);
+
+    arma::mat predictions;
+    model.Predict(data, predictions);
+
+    size_t correct = 0;
+    for (size_t i = 0; i < predictions.n_cols; ++i)
+    {
+      if (predictions.col(i).index_max() == labels[i])
+        ++correct;
+    }
+
+    BOOST_REQUIRE_GE((double) correct / data.n_cols, 0.95);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
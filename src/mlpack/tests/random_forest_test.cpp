@@ -96,6 +96,56 @@ BOOST_AUTO_TEST_CASE(BootstrapWeightsTest)
   }
 }
 
+/**
+ * Make sure compact bootstrap sampling stores each sampled point once, with its
+ * multiplicity as its weight.
+ */
+BOOST_AUTO_TEST_CASE(CompactBootstrapTest)
+{
+  arma::mat dataset(1, 1000);
+  dataset.row(0) = arma::linspace<arma::rowvec>(1000, 1999, 1000);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = i % 3;
+  arma::rowvec weights(1000);
+  weights.fill(0.5);
+
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    arma::mat bootstrapDataset;
+    arma::Row<size_t> bootstrapLabels;
+    arma::rowvec bootstrapWeights;
+
+    CompactBootstrap<false>(dataset, labels, weights, bootstrapDataset,
+        bootstrapLabels, bootstrapWeights);
+
+    BOOST_REQUIRE_EQUAL(bootstrapDataset.n_rows, 1);
+    BOOST_REQUIRE_LE(bootstrapDataset.n_cols, 1000);
+    BOOST_REQUIRE_EQUAL(bootstrapLabels.n_elem, bootstrapDataset.n_cols);
+    BOOST_REQUIRE_EQUAL(bootstrapWeights.n_elem, bootstrapDataset.n_cols);
+
+    // The multiplicities must add up to the size of the dataset.
+    BOOST_REQUIRE_CLOSE(arma::accu(bootstrapWeights), 1000.0, 1e-5);
+
+    // Each point must appear only once, with the right label.
+    for (size_t i = 0; i < bootstrapDataset.n_cols; ++i)
+    {
+      const size_t index = (size_t) bootstrapDataset(0, i) - 1000;
+      BOOST_REQUIRE_LT(index, 1000);
+      BOOST_REQUIRE_EQUAL(bootstrapLabels[i], labels[index]);
+      BOOST_REQUIRE_GE(bootstrapWeights[i], 1.0);
+      if (i > 0)
+        BOOST_REQUIRE_GT(bootstrapDataset(0, i), bootstrapDataset(0, i - 1));
+    }
+
+    // With weights, the multiplicities are multiplied by the original weights.
+    CompactBootstrap<true>(dataset, labels, weights, bootstrapDataset,
+        bootstrapLabels, bootstrapWeights);
+
+    BOOST_REQUIRE_CLOSE(arma::accu(bootstrapWeights), 500.0, 1e-5);
+  }
+}
+
 /**
  * Make sure an empty forest cannot predict.
  */
@@ -153,6 +203,41 @@ BOOST_AUTO_TEST_CASE(UnweightedNumericLearningTest)
   BOOST_REQUIRE_GE(rfCorrect, size_t(0.7 * testDataset.n_cols));
 }
 
+/**
+ * Make sure that the trained forest depends only on the random seed, and not on
+ * how many trees are built concurrently.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTrainingDeterminismTest)
+{
+  // Load the vc2 dataset.
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+
+  // Build one forest with no concurrency limit.
+  math::RandomSeed(1234);
+  RandomForest<GiniGain, RandomDimensionSelect> rf1(dataset, labels, 3,
+      20 /* 20 trees */, 5);
+
+  // Build another forest, one tree at a time.
+  math::RandomSeed(1234);
+  RandomForest<GiniGain, RandomDimensionSelect> rf2;
+  rf2.MaxConcurrentTrees() = 1;
+  rf2.Train(dataset, labels, 3, 20 /* 20 trees */, 5);
+
+  arma::Row<size_t> predictions1, predictions2;
+  arma::mat probabilities1, probabilities2;
+  rf1.Classify(testDataset, predictions1, probabilities1);
+  rf2.Classify(testDataset, predictions2, probabilities2);
+
+  CheckMatrices(predictions1, predictions2);
+  CheckMatrices(probabilities1, probabilities2);
+}
+
 /**
  * Test weighted numeric learning, making sure that we get better performance
  * than a single decision tree.
@@ -311,8 +396,10 @@ BOOST_AUTO_TEST_CASE(LeafSize1Test)
   arma::Row<size_t> labels;
   data::Load("vc2_labels.txt", labels);
 
-  // Build a random forest with a leaf size of 1.
-  RandomForest<> rf(dataset, labels, 3, 10 /* 10 trees */, 1);
+  // Build a random forest with a leaf size of 1.  Each tree only sees a
+  // bootstrap sample, so we need enough trees that every point is in the
+  // training set of most of them.
+  RandomForest<> rf(dataset, labels, 3, 100 /* 100 trees */, 1);
 
   // Predict on the training set.
   arma::Row<size_t> predictions;
@@ -351,6 +438,9 @@ BOOST_AUTO_TEST_CASE(LeafSizeDatasetTest)
   arma::mat probabilities;
   rf.Classify(dataset, predictions, probabilities);
 
+  // Every tree is a single leaf, so every point gets the same probabilities.
+  // Those are averaged over the bootstrap samples of each tree, so they are
+  // only approximately the class frequencies of the full dataset.
   BOOST_REQUIRE_EQUAL(probabilities.n_rows, 3);
   BOOST_REQUIRE_EQUAL(probabilities.n_cols, dataset.n_cols);
   BOOST_REQUIRE_EQUAL(predictions.n_elem, dataset.n_cols);
@@ -358,7 +448,10 @@ BOOST_AUTO_TEST_CASE(LeafSizeDatasetTest)
   {
     BOOST_REQUIRE_EQUAL(predictions[i], majorityClass);
     for (size_t j = 0; j < probabilities.n_rows; ++j)
-      BOOST_REQUIRE_CLOSE(probabilities(j, i), majorityProbs[j], 1e-5);
+    {
+      BOOST_REQUIRE_CLOSE(probabilities(j, i), probabilities(j, 0), 1e-5);
+      BOOST_REQUIRE_SMALL(probabilities(j, i) - majorityProbs[j], 0.05);
+    }
   }
 }
 
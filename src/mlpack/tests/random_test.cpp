@@ -97,4 +97,32 @@ BOOST_AUTO_TEST_CASE(WeightedRandomTest)
   }
 }
 
+// Make sure RandNormal() and RandIndex() draw from a ScopedRandomGenerator, so
+// that two generators with the same seed give the same values.
+BOOST_AUTO_TEST_CASE(ScopedRandomGeneratorNormalTest)
+{
+  std::vector<double> normals[2];
+  std::vector<size_t> indices[2];
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    // Leave a cached normal value in the global distribution.
+    RandNormal();
+
+    std::mt19937 generator(42);
+    ScopedRandomGenerator scopedGenerator(generator);
+    for (size_t i = 0; i < 5; ++i)
+    {
+      normals[trial].push_back(RandNormal());
+      indices[trial].push_back(RandIndex(1000));
+    }
+  }
+
+  for (size_t i = 0; i < 5; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(normals[0][i], normals[1][i]);
+    BOOST_REQUIRE_EQUAL(indices[0][i], indices[1][i]);
+    BOOST_REQUIRE_LT(indices[0][i], 1000);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -1696,4 +1696,175 @@ BOOST_AUTO_TEST_CASE(MoveOperatorNaiveTest)
   }
 }
 
+#ifdef HAS_OPENMP
+/**
+ * Make sure that the results of two searches are the same, up to order.
+ */
+void CheckSameResults(const vector<vector<size_t>>& neighbors1,
+                      const vector<vector<double>>& distances1,
+                      const vector<vector<size_t>>& neighbors2,
+                      const vector<vector<double>>& distances2)
+{
+  vector<vector<pair<double, size_t>>> sorted1, sorted2;
+  SortResults(neighbors1, distances1, sorted1);
+  SortResults(neighbors2, distances2, sorted2);
+
+  BOOST_REQUIRE_EQUAL(sorted1.size(), sorted2.size());
+  for (size_t i = 0; i < sorted1.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(sorted1[i].size(), sorted2[i].size());
+    for (size_t j = 0; j < sorted1[i].size(); ++j)
+    {
+      BOOST_REQUIRE_EQUAL(sorted1[i][j].second, sorted2[i][j].second);
+      BOOST_REQUIRE_CLOSE(sorted1[i][j].first, sorted2[i][j].first, 1e-5);
+    }
+  }
+}
+
+/**
+ * Search with the given tree type and mode, once on one thread and once on
+ * four threads, and make sure the results are the same.  Four threads are used
+ * even on machines with fewer cores, so that the query tree is actually split.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckParallelSearch(const bool naive, const bool singleMode)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 800);
+
+  RangeSearch<EuclideanDistance, arma::mat, TreeType> rs(referenceData, naive,
+      singleMode);
+
+  vector<vector<size_t>> serialNeighbors, parallelNeighbors;
+  vector<vector<double>> serialDistances, parallelDistances;
+
+  const int prevNumThreads = omp_get_max_threads();
+
+  // Bichromatic search.
+  omp_set_num_threads(1);
+  rs.Search(queryData, Range(0.05, 0.15), serialNeighbors, serialDistances);
+  omp_set_num_threads(4);
+  rs.Search(queryData, Range(0.05, 0.15), parallelNeighbors,
+      parallelDistances);
+
+  CheckSameResults(serialNeighbors, serialDistances, parallelNeighbors,
+      parallelDistances);
+
+  // Monochromatic search.
+  omp_set_num_threads(1);
+  rs.Search(Range(0.05, 0.15), serialNeighbors, serialDistances);
+  omp_set_num_threads(4);
+  rs.Search(Range(0.05, 0.15), parallelNeighbors, parallelDistances);
+
+  omp_set_num_threads(prevNumThreads);
+
+  CheckSameResults(serialNeighbors, serialDistances, parallelNeighbors,
+      parallelDistances);
+}
+
+/**
+ * Make sure that searching on many threads gives the same results as searching
+ * on one thread, for each search mode and a few tree types.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSearchTest)
+{
+  CheckParallelSearch<KDTree>(true, false);
+  CheckParallelSearch<KDTree>(false, true);
+  CheckParallelSearch<KDTree>(false, false);
+  CheckParallelSearch<BallTree>(false, true);
+  CheckParallelSearch<BallTree>(false, false);
+  CheckParallelSearch<StandardCoverTree>(false, true);
+  CheckParallelSearch<StandardCoverTree>(false, false);
+  CheckParallelSearch<RTree>(false, false);
+}
+#endif
+
+/**
+ * Make sure that a range search on float data gives the same results as a
+ * search on the same data stored as doubles.
+ */
+BOOST_AUTO_TEST_CASE(FloatMatrixSearchTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+  arma::fmat floatReferenceData = arma::conv_to<arma::fmat>::from(
+      referenceData);
+  arma::fmat floatQueryData = arma::conv_to<arma::fmat>::from(queryData);
+
+  // Points exactly on the edge of the range may be included on one side and
+  // not the other, so use a range that has (almost surely) no such points.
+  const Range range(0.1, 0.2);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    const bool naive = (mode == 0);
+    const bool singleMode = (mode == 1);
+
+    RangeSearch<> rs(referenceData, naive, singleMode);
+    RangeSearch<EuclideanDistance, arma::fmat> floatRs(floatReferenceData,
+        naive, singleMode);
+
+    vector<vector<size_t>> neighbors, floatNeighbors;
+    vector<vector<double>> distances, floatDistances;
+    rs.Search(queryData, range, neighbors, distances);
+    floatRs.Search(floatQueryData, range, floatNeighbors, floatDistances);
+
+    vector<vector<pair<double, size_t>>> sorted, floatSorted;
+    SortResults(neighbors, distances, sorted);
+    SortResults(floatNeighbors, floatDistances, floatSorted);
+
+    BOOST_REQUIRE_EQUAL(sorted.size(), floatSorted.size());
+    for (size_t i = 0; i < sorted.size(); ++i)
+    {
+      BOOST_REQUIRE_EQUAL(sorted[i].size(), floatSorted[i].size());
+      for (size_t j = 0; j < sorted[i].size(); ++j)
+      {
+        BOOST_REQUIRE_EQUAL(sorted[i][j].second, floatSorted[i][j].second);
+        BOOST_REQUIRE_CLOSE(sorted[i][j].first, floatSorted[i][j].first,
+            1e-3);
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that the number of base cases is counted the same way in each
+ * search mode: once per distance evaluation, and only for the last search.
+ */
+BOOST_AUTO_TEST_CASE(BaseCaseCountTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 200);
+  arma::mat queryData = arma::randu<arma::mat>(3, 150);
+
+  RangeSearch<> naive(referenceData, true);
+  vector<vector<size_t>> neighbors;
+  vector<vector<double>> distances;
+
+  naive.Search(queryData, Range(0.05, 0.15), neighbors, distances);
+  BOOST_REQUIRE_EQUAL(naive.BaseCases(), 150 * 200);
+  naive.Search(queryData, Range(0.05, 0.15), neighbors, distances);
+  BOOST_REQUIRE_EQUAL(naive.BaseCases(), 150 * 200);
+
+  // A point is not compared with itself.
+  naive.Search(Range(0.05, 0.15), neighbors, distances);
+  BOOST_REQUIRE_EQUAL(naive.BaseCases(), 200 * 199);
+
+  // The tree searches can't do more base cases than the naive search, and
+  // shouldn't count earlier searches either.
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    RangeSearch<> rs(referenceData, false, (mode == 1));
+    rs.Search(queryData, Range(0.05, 0.15), neighbors, distances);
+    const size_t baseCases = rs.BaseCases();
+    BOOST_REQUIRE_GT(baseCases, 0);
+    BOOST_REQUIRE_LE(baseCases, 150 * 200);
+
+    rs.Search(queryData, Range(0.05, 0.15), neighbors, distances);
+    BOOST_REQUIRE_LE(rs.BaseCases(), 150 * 200);
+    BOOST_REQUIRE_LT(rs.BaseCases(), 2 * baseCases);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
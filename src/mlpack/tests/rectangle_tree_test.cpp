@@ -1384,4 +1384,180 @@ BOOST_AUTO_TEST_CASE(RectangleTreeMoveDatasetTest)
   BOOST_REQUIRE_EQUAL(tree.Dataset().n_cols, 1000);
 }
 
+/**
+ * Bulk load a tree of the given type and check that it is a valid tree that
+ * holds every point once and gives the same nearest neighbors as a naive
+ * search, also after some points were deleted from it.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckBulkLoad(const BulkLoadType bulkLoad)
+{
+  arma::mat dataset;
+  dataset.randu(5, 2000); // 2000 points in 5 dimensions.
+
+  typedef TreeType<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeTypeT;
+  TreeTypeT tree(dataset, bulkLoad, 20, 6, 5, 2);
+
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 2000);
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckNumDescendants(tree);
+  CheckFills(tree);
+  BOOST_REQUIRE_EQUAL(GetMinLevel(tree), GetMaxLevel(tree));
+
+  arma::Col<size_t> found(dataset.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < tree.NumDescendants(); ++i)
+    ++found[tree.Descendant(i)];
+  for (size_t i = 0; i < found.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(found[i], 1);
+
+  // The tree must still be valid after deletions.
+  TreeTypeT deletedTree(tree);
+  const size_t numDeleted = 100;
+  for (size_t i = 0; i < numDeleted; ++i)
+    BOOST_REQUIRE(deletedTree.DeletePoint(1999 - i));
+
+  BOOST_REQUIRE_EQUAL(deletedTree.NumDescendants(), 2000 - numDeleted);
+  CheckContainment(deletedTree);
+  CheckExactContainment(deletedTree);
+  CheckHierarchy(deletedTree);
+  CheckNumDescendants(deletedTree);
+  BOOST_REQUIRE_EQUAL(GetMinLevel(deletedTree), GetMaxLevel(deletedTree));
+
+  // Dual-tree search with the bulk-loaded tree.
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, TreeType>
+      knn1(std::move(tree), DUAL_TREE_MODE);
+
+  arma::Mat<size_t> neighbors1;
+  arma::mat distances1;
+  knn1.Search(5, neighbors1, distances1);
+
+  // Nearest neighbor search the naive way.
+  KNN knn2(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors2;
+  arma::mat distances2;
+  knn2.Search(5, neighbors2, distances2);
+
+  for (size_t i = 0; i < neighbors1.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors1[i], neighbors2[i]);
+    BOOST_REQUIRE_EQUAL(distances1[i], distances2[i]);
+  }
+}
+
+/**
+ * Bulk load a tree of the given type whose sibling nodes must not overlap (the
+ * R+ and R++ trees), and check that it holds every point once, that its nodes
+ * do not overlap, and that it gives the same nearest neighbors as a naive
+ * search.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckNonOverlappingBulkLoad(const BulkLoadType bulkLoad)
+{
+  arma::mat dataset;
+  dataset.randu(5, 2000); // 2000 points in 5 dimensions.
+
+  typedef TreeType<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeTypeT;
+  TreeTypeT tree(dataset, bulkLoad, 20, 6, 5, 2);
+
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 2000);
+  CheckContainment(tree);
+  CheckHierarchy(tree);
+  CheckNumDescendants(tree);
+  CheckOverlap(tree);
+  BOOST_REQUIRE_EQUAL(GetMinLevel(tree), GetMaxLevel(tree));
+
+  arma::Col<size_t> found(dataset.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < tree.NumDescendants(); ++i)
+    ++found[tree.Descendant(i)];
+  for (size_t i = 0; i < found.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(found[i], 1);
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, TreeType>
+      knn1(std::move(tree), SINGLE_TREE_MODE);
+
+  arma::Mat<size_t> neighbors1;
+  arma::mat distances1;
+  knn1.Search(5, neighbors1, distances1);
+
+  KNN knn2(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors2;
+  arma::mat distances2;
+  knn2.Search(5, neighbors2, distances2);
+
+  for (size_t i = 0; i < neighbors1.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors1[i], neighbors2[i]);
+    BOOST_REQUIRE_EQUAL(distances1[i], distances2[i]);
+  }
+}
+
+// Test that Sort-Tile-Recursive bulk loading gives valid trees.
+BOOST_AUTO_TEST_CASE(STRBulkLoadTest)
+{
+  CheckBulkLoad<RTree>(STR_BULK_LOAD);
+  CheckBulkLoad<RStarTree>(STR_BULK_LOAD);
+  CheckBulkLoad<XTree>(STR_BULK_LOAD);
+  CheckBulkLoad<HilbertRTree>(STR_BULK_LOAD);
+  CheckNonOverlappingBulkLoad<RPlusTree>(STR_BULK_LOAD);
+  CheckNonOverlappingBulkLoad<RPlusPlusTree>(STR_BULK_LOAD);
+}
+
+// Test that Hilbert curve bulk loading gives valid trees.
+BOOST_AUTO_TEST_CASE(HilbertBulkLoadTest)
+{
+  CheckBulkLoad<RTree>(HILBERT_BULK_LOAD);
+  CheckBulkLoad<RStarTree>(HILBERT_BULK_LOAD);
+  CheckBulkLoad<XTree>(HILBERT_BULK_LOAD);
+  CheckBulkLoad<HilbertRTree>(HILBERT_BULK_LOAD);
+  CheckNonOverlappingBulkLoad<RPlusTree>(HILBERT_BULK_LOAD);
+  CheckNonOverlappingBulkLoad<RPlusPlusTree>(HILBERT_BULK_LOAD);
+}
+
+// Make sure that the R+ and R++ trees are not packed directly, since packing
+// could make their sibling nodes overlap.
+BOOST_AUTO_TEST_CASE(NonOverlappingTreesCanNotPackNodesTest)
+{
+  bool b = CanPackNodes<RTreeSplit, NoAuxiliaryInformation>::value;
+  BOOST_REQUIRE_EQUAL(b, true);
+
+  b = CanPackNodes<RPlusTreeSplit<RPlusTreeSplitPolicy, MinimalCoverageSweep>,
+      NoAuxiliaryInformation>::value;
+  BOOST_REQUIRE_EQUAL(b, false);
+
+  b = CanPackNodes<RPlusTreeSplit<RPlusPlusTreeSplitPolicy,
+      MinimalSplitsNumberSweep>, RPlusPlusTreeAuxiliaryInformation>::value;
+  BOOST_REQUIRE_EQUAL(b, false);
+}
+
+// Make sure that a bulk-loaded tree packs its leaves, and that a dataset that
+// fits into one leaf gives a tree with only the root.
+BOOST_AUTO_TEST_CASE(BulkLoadFillTest)
+{
+  arma::mat dataset;
+  dataset.randu(3, 1000);
+
+  typedef RTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  TreeType tree(dataset, STR_BULK_LOAD, 20, 6, 5, 2);
+
+  // 1000 points need 50 full leaves, which need 10 nodes, which need 2 nodes
+  // below the root.
+  BOOST_REQUIRE_EQUAL(tree.NumChildren(), 2);
+  BOOST_REQUIRE_EQUAL(tree.TreeDepth(), 4);
+
+  TreeType smallTree(arma::mat(dataset.cols(0, 19)), HILBERT_BULK_LOAD, 20, 6,
+      5, 2);
+  BOOST_REQUIRE(smallTree.IsLeaf());
+  BOOST_REQUIRE_EQUAL(smallTree.Count(), 20);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -883,6 +883,14 @@ BOOST_AUTO_TEST_CASE(GRUBatchSizeTest)
   BatchSizeTest<GRU<>>();
 }
 
+/**
+ * Ensure fast GRUs work with larger batch sizes.
+ */
+BOOST_AUTO_TEST_CASE(FastGRUBatchSizeTest)
+{
+  BatchSizeTest<FastGRU<>>();
+}
+
 /**
  * Make sure the RNN can be properly serialized.
  */
@@ -836,6 +836,50 @@ BOOST_AUTO_TEST_CASE(KNNTest)
   CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
 }
 
+/**
+ * Make sure that the points deleted from a NeighborSearch object stay deleted
+ * after serialization.
+ */
+BOOST_AUTO_TEST_CASE(KNNPointUpdatesTest)
+{
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      RTree> RTreeKNN;
+  arma::mat dataset = arma::randu<arma::mat>(5, 1000);
+
+  RTreeKNN knn(dataset, DUAL_TREE_MODE);
+  knn.InsertPoints(arma::randu<arma::mat>(5, 100));
+  for (size_t i = 0; i < 1100; i += 3)
+    knn.DeletePoint(i);
+
+  RTreeKNN knnXml, knnText, knnBinary;
+
+  SerializeObjectAll(knn, knnXml, knnText, knnBinary);
+
+  BOOST_REQUIRE_EQUAL(knnXml.NumReferencePoints(), knn.NumReferencePoints());
+  BOOST_REQUIRE_EQUAL(knnText.NumReferencePoints(), knn.NumReferencePoints());
+  BOOST_REQUIRE_EQUAL(knnBinary.NumReferencePoints(),
+      knn.NumReferencePoints());
+
+  // The deleted points must not come back in naive search either.
+  knn.SearchMode() = NAIVE_MODE;
+  knnXml.SearchMode() = NAIVE_MODE;
+  knnText.SearchMode() = NAIVE_MODE;
+  knnBinary.SearchMode() = NAIVE_MODE;
+
+  arma::mat querySet = arma::randu<arma::mat>(5, 100);
+
+  arma::mat distances, xmlDistances, textDistances, binaryDistances;
+  arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+
+  knn.Search(querySet, 5, neighbors, distances);
+  knnXml.Search(querySet, 5, xmlNeighbors, xmlDistances);
+  knnText.Search(querySet, 5, textNeighbors, textDistances);
+  knnBinary.Search(querySet, 5, binaryNeighbors, binaryDistances);
+
+  CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
+  CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+}
+
 BOOST_AUTO_TEST_CASE(SoftmaxRegressionTest)
 {
   using regression::SoftmaxRegression;
@@ -147,4 +147,121 @@ BOOST_AUTO_TEST_CASE(DisabledTimingTest)
   BOOST_REQUIRE(Timer::Get("test_timer") == std::chrono::microseconds(0));
 }
 
+/**
+ * Timers started while another timer is running should be nested in it, and
+ * each position in the hierarchy should keep its own statistics.
+ */
+BOOST_AUTO_TEST_CASE(NestedTimerProfileTest)
+{
+  Timer::ResetAll();
+  Timer::EnableTiming();
+
+  Timer::Start("outer");
+  for (size_t i = 0; i < 3; ++i)
+  {
+    Timer::Start("inner");
+    Timer::Stop("inner");
+  }
+  Timer::Stop("outer");
+
+  // The same timer at the top level.
+  Timer::Start("inner");
+  Timer::Stop("inner");
+
+  // Running timers aren't part of the profile.
+  Timer::Start("running");
+
+  std::vector<TimerProfile> profile = CLI::GetSingleton().timer.GetProfile();
+  Timer::Stop("running");
+  Timer::DisableTiming();
+
+  BOOST_REQUIRE_EQUAL(profile.size(), 3);
+
+  BOOST_REQUIRE_EQUAL(profile[0].path, "inner");
+  BOOST_REQUIRE_EQUAL(profile[0].calls, 1);
+  BOOST_REQUIRE_EQUAL(profile[0].Depth(), 0);
+
+  BOOST_REQUIRE_EQUAL(profile[1].path, "outer");
+  BOOST_REQUIRE_EQUAL(profile[1].calls, 1);
+
+  BOOST_REQUIRE_EQUAL(profile[2].path, "outer/inner");
+  BOOST_REQUIRE_EQUAL(profile[2].name, "inner");
+  BOOST_REQUIRE_EQUAL(profile[2].calls, 3);
+  BOOST_REQUIRE_EQUAL(profile[2].Depth(), 1);
+  BOOST_REQUIRE(profile[2].min <= profile[2].Average());
+  BOOST_REQUIRE(profile[2].Average() <= profile[2].max);
+  BOOST_REQUIRE(profile[2].total <= profile[1].total);
+  BOOST_REQUIRE_EQUAL(profile[2].threadTotals.size(), 1);
+
+  // The flat total still counts both positions.
+  BOOST_REQUIRE(Timer::Get("inner") == profile[0].total + profile[2].total);
+}
+
+/**
+ * The profile should count the threads that ran each timer.
+ */
+BOOST_AUTO_TEST_CASE(MultithreadTimerProfileTest)
+{
+  Timer::ResetAll();
+  Timer::EnableTiming();
+
+  std::thread threads[3];
+  for (size_t i = 0; i < 3; ++i)
+  {
+    threads[i] = std::thread([]()
+        {
+          Timer::Start("thread_timer");
+          Timer::Stop("thread_timer");
+        });
+  }
+
+  for (size_t i = 0; i < 3; ++i)
+    threads[i].join();
+
+  std::vector<TimerProfile> profile = CLI::GetSingleton().timer.GetProfile();
+  Timer::DisableTiming();
+
+  BOOST_REQUIRE_EQUAL(profile.size(), 1);
+  BOOST_REQUIRE_EQUAL(profile[0].calls, 3);
+  BOOST_REQUIRE_EQUAL(profile[0].threadTotals.size(), 3);
+}
+
+/**
+ * Make sure that the JSON profile and the trace hold each timer.
+ */
+BOOST_AUTO_TEST_CASE(TimerProfileOutputTest)
+{
+  Timer::ResetAll();
+  Timer::EnableTiming();
+  Timer::EnableTracing();
+
+  Timer::Start("outer");
+  Timer::Start("inner");
+  Timer::Stop("inner");
+  Timer::Start("inner");
+  Timer::Stop("inner");
+  Timer::Stop("outer");
+
+  std::ostringstream profile, trace;
+  CLI::GetSingleton().timer.WriteProfile(profile);
+  CLI::GetSingleton().timer.WriteTrace(trace);
+
+  Timer::DisableTracing();
+  Timer::DisableTiming();
+
+  BOOST_REQUIRE_NE(profile.str().find("\"path\": \"outer/inner\""),
+      std::string::npos);
+  BOOST_REQUIRE_NE(profile.str().find("\"calls\": 2"), std::string::npos);
+
+  // There should be one event for each run.
+  size_t events = 0;
+  size_t pos = 0;
+  while ((pos = trace.str().find("\"ph\": \"X\"", pos)) != std::string::npos)
+  {
+    ++events;
+    ++pos;
+  }
+  BOOST_REQUIRE_EQUAL(events, 3);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
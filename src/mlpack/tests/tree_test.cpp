@@ -1778,6 +1778,193 @@ BOOST_AUTO_TEST_CASE(BinarySpaceTreeMoveConstructorTest)
   BOOST_REQUIRE_EQUAL(tree2.NumChildren(), 2);
 }
 
+/**
+ * Make sure that two binary space trees have the same shape, points, and
+ * bounds, and that every node points to its parent and to the right dataset.
+ */
+template<typename TreeType>
+void CheckSameBinarySpaceTree(const TreeType& a, const TreeType& b)
+{
+  BOOST_REQUIRE_EQUAL(a.Begin(), b.Begin());
+  BOOST_REQUIRE_EQUAL(a.Count(), b.Count());
+  BOOST_REQUIRE_EQUAL(a.NumChildren(), b.NumChildren());
+  BOOST_REQUIRE_EQUAL(&a.Dataset(), &a.Parent()->Dataset());
+  BOOST_REQUIRE_EQUAL(&b.Dataset(), &b.Parent()->Dataset());
+  for (size_t d = 0; d < a.Bound().Dim(); ++d)
+  {
+    BOOST_REQUIRE_EQUAL(a.Bound()[d].Lo(), b.Bound()[d].Lo());
+    BOOST_REQUIRE_EQUAL(a.Bound()[d].Hi(), b.Bound()[d].Hi());
+  }
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(a.Child(i).Parent(), &a);
+    BOOST_REQUIRE_EQUAL(b.Child(i).Parent(), &b);
+    CheckSameBinarySpaceTree(a.Child(i), b.Child(i));
+  }
+}
+
+/**
+ * Make sure that a compacted tree has the same shape as the original tree, that
+ * its nodes are stored in breadth-first order, and that copies and moves of it
+ * work.
+ */
+BOOST_AUTO_TEST_CASE(BinarySpaceTreeCompactTest)
+{
+  arma::mat dataset(5, 1000);
+  dataset.randu();
+
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  TreeType tree(dataset, 10);
+  TreeType original(tree);
+
+  BOOST_REQUIRE(!tree.IsCompact());
+  tree.Compact();
+  BOOST_REQUIRE(tree.IsCompact());
+
+  // Compacting twice does nothing.
+  tree.Compact();
+  BOOST_REQUIRE(tree.IsCompact());
+
+  BOOST_REQUIRE_EQUAL(tree.Dataset().n_cols, original.Dataset().n_cols);
+  for (size_t i = 0; i < tree.NumChildren(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(tree.Child(i).Parent(), &tree);
+    CheckSameBinarySpaceTree(tree.Child(i), original.Child(i));
+  }
+
+  // In breadth-first order, the nodes of each level follow the nodes of the
+  // previous level, and siblings are adjacent.
+  std::queue<const TreeType*> queue;
+  queue.push(&tree.Child(0));
+  queue.push(&tree.Child(1));
+  const TreeType* first = &tree.Child(0);
+  size_t index = 0;
+  while (!queue.empty())
+  {
+    const TreeType* node = queue.front();
+    queue.pop();
+
+    BOOST_REQUIRE_EQUAL(node, first + index);
+    ++index;
+
+    if (!node->IsLeaf())
+    {
+      BOOST_REQUIRE_EQUAL(&node->Child(1), &node->Child(0) + 1);
+      queue.push(&node->Child(0));
+      queue.push(&node->Child(1));
+    }
+  }
+
+  // Only the root can be compacted.
+  BOOST_REQUIRE_THROW(tree.Child(0).Compact(), std::invalid_argument);
+
+  // A copy is not compacted, but is the same tree.
+  TreeType copy(tree);
+  BOOST_REQUIRE(!copy.IsCompact());
+  for (size_t i = 0; i < copy.NumChildren(); ++i)
+    CheckSameBinarySpaceTree(copy.Child(i), original.Child(i));
+
+  // A moved tree keeps its nodes.
+  TreeType moved(std::move(tree));
+  BOOST_REQUIRE(moved.IsCompact());
+  BOOST_REQUIRE(!tree.IsCompact());
+  BOOST_REQUIRE_EQUAL(tree.NumChildren(), 0);
+  for (size_t i = 0; i < moved.NumChildren(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(moved.Child(i).Parent(), &moved);
+    CheckSameBinarySpaceTree(moved.Child(i), original.Child(i));
+  }
+}
+
+#ifdef HAS_OPENMP
+/**
+ * A statistic holding the number of points below a node, computed from the
+ * statistics of the children, to check that statistics are built bottom-up.
+ */
+class DescendantCountStat
+{
+ public:
+  DescendantCountStat() : count(0) { }
+
+  template<typename TreeType>
+  DescendantCountStat(TreeType& node) : count(node.NumPoints())
+  {
+    for (size_t i = 0; i < node.NumChildren(); ++i)
+      count += node.Child(i).Stat().Count();
+  }
+
+  size_t Count() const { return count; }
+
+ private:
+  size_t count;
+};
+
+/**
+ * Make sure that two trees built from the same data are identical.
+ */
+template<typename TreeType>
+void CheckSameConstruction(const TreeType& a, const TreeType& b)
+{
+  BOOST_REQUIRE_EQUAL(a.Begin(), b.Begin());
+  BOOST_REQUIRE_EQUAL(a.Count(), b.Count());
+  BOOST_REQUIRE_EQUAL(a.NumChildren(), b.NumChildren());
+  BOOST_REQUIRE_EQUAL(a.Stat().Count(), a.NumDescendants());
+  BOOST_REQUIRE_EQUAL(b.Stat().Count(), b.NumDescendants());
+  BOOST_REQUIRE_EQUAL(a.ParentDistance(), b.ParentDistance());
+  BOOST_REQUIRE_EQUAL(a.FurthestDescendantDistance(),
+      b.FurthestDescendantDistance());
+  for (size_t d = 0; d < a.Bound().Dim(); ++d)
+  {
+    BOOST_REQUIRE_EQUAL(a.Bound()[d].Lo(), b.Bound()[d].Lo());
+    BOOST_REQUIRE_EQUAL(a.Bound()[d].Hi(), b.Bound()[d].Hi());
+  }
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameConstruction(a.Child(i), b.Child(i));
+}
+
+/**
+ * Build a tree on one thread and on four threads, and make sure the trees and
+ * the mappings are the same.
+ */
+template<typename TreeType>
+void CheckParallelConstruction()
+{
+  arma::mat dataset(4, 50000, arma::fill::randu);
+
+  const int prevNumThreads = omp_get_max_threads();
+  std::vector<size_t> serialOldFromNew, parallelOldFromNew;
+  omp_set_num_threads(1);
+  TreeType serialTree(dataset, serialOldFromNew, 10);
+  omp_set_num_threads(4);
+  TreeType parallelTree(dataset, parallelOldFromNew, 10);
+  TreeType unmappedTree(dataset, 10);
+  omp_set_num_threads(prevNumThreads);
+
+  CheckMatrices(serialTree.Dataset(), parallelTree.Dataset());
+  CheckMatrices(serialTree.Dataset(), unmappedTree.Dataset());
+  BOOST_REQUIRE_EQUAL(serialOldFromNew.size(), parallelOldFromNew.size());
+  for (size_t i = 0; i < serialOldFromNew.size(); ++i)
+    BOOST_REQUIRE_EQUAL(serialOldFromNew[i], parallelOldFromNew[i]);
+
+  CheckSameConstruction(serialTree, parallelTree);
+  CheckSameConstruction(serialTree, unmappedTree);
+}
+
+/**
+ * Make sure that trees built on several threads are the same as trees built on
+ * one thread.
+ */
+BOOST_AUTO_TEST_CASE(BinarySpaceTreeParallelConstructionTest)
+{
+  CheckParallelConstruction<KDTree<EuclideanDistance, DescendantCountStat,
+      arma::mat>>();
+  CheckParallelConstruction<MeanSplitKDTree<EuclideanDistance,
+      DescendantCountStat, arma::mat>>();
+}
+#endif
+
 template<typename TreeType>
 void RecurseTreeCountLeaves(const TreeType& node, arma::vec& counts)
 {
@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 
 #include <mlpack/core.hpp>
 #include <boost/test/unit_test.hpp>
@@ -51,4 +52,47 @@ BOOST_AUTO_TEST_CASE(TestUnion)
   BOOST_REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
 }
 
+BOOST_AUTO_TEST_CASE(TestConcurrentUnion)
+{
+  static const size_t testSize = 10;
+  ConcurrentUnionFind testUnionFind(testSize);
+
+  for (size_t i = 0; i < testSize; i++)
+    BOOST_REQUIRE(testUnionFind.Find(i) == i);
+
+  testUnionFind.Union(0, 1);
+  testUnionFind.Union(2, 3);
+  testUnionFind.Union(0, 2);
+  testUnionFind.Union(5, 0);
+  testUnionFind.Union(0, 6);
+
+  BOOST_REQUIRE(testUnionFind.Find(0) == testUnionFind.Find(1));
+  BOOST_REQUIRE(testUnionFind.Find(2) == testUnionFind.Find(3));
+  BOOST_REQUIRE(testUnionFind.Find(1) == testUnionFind.Find(5));
+  BOOST_REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
+  BOOST_REQUIRE(testUnionFind.Find(4) != testUnionFind.Find(0));
+
+  // The root of each component is its smallest index.
+  BOOST_REQUIRE_EQUAL(testUnionFind.Find(6), 0);
+  BOOST_REQUIRE_EQUAL(testUnionFind.Find(4), 4);
+}
+
+/**
+ * Union many pairs of points on all threads at once, and make sure the
+ * components are right: point i is connected to point i + 2, so the even and
+ * the odd points form two components.
+ */
+BOOST_AUTO_TEST_CASE(TestParallelConcurrentUnion)
+{
+  static const size_t testSize = 100000;
+  ConcurrentUnionFind testUnionFind(testSize);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) testSize - 2; ++i)
+    testUnionFind.Union((size_t) i + 2, (size_t) i);
+
+  for (size_t i = 0; i < testSize; i++)
+    BOOST_REQUIRE_EQUAL(testUnionFind.Find(i), i % 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END();